@@ -0,0 +1,141 @@
+//+=============================================================================
+//
+// file :         GpibBusMonitor.cpp
+//
+// description :  C++ source for the GpibBusMonitor class. A spare board in
+//                listen-only mode records the bus traffic in background
+//                (BCStartMonitor command): the bus attributes give its
+//                utilization and bandwidth, BCDumpMonitor writes the
+//                capture.
+//
+// project :      TANGO Device Server
+//
+// copyleft :     European Synchrotron Radiation Facility
+//                BP 220, Grenoble 38043
+//                FRANCE
+//
+//-=============================================================================
+
+#include <tango.h>
+#include <GpibBusMonitor.h>
+
+namespace GpibDeviceServer_ns
+{
+
+/**
+ * Pause after a read error, us.
+ */
+#define BUS_MONITOR_ERROR_PERIOD	100000
+
+//+----------------------------------------------------------------------------
+//
+// method : 		GpibBusMonitor::GpibBusMonitor()
+//
+// description : 	Constructor, starts the thread.
+//
+// in : - b : Board in listen-only mode, deleted with the thread.
+//      - l : Bus lock of the board.
+//
+//-----------------------------------------------------------------------------
+GpibBusMonitor::GpibBusMonitor(gpibBoard *b, omni_mutex &l)
+	:omni_thread(), board(b), bus(l), stopping(false)
+{
+	start_undetached();
+}
+
+//+----------------------------------------------------------------------------
+//
+// method : 		GpibBusMonitor::getStats()
+//
+// description : 	Bus statistics of the monitor.
+//
+//-----------------------------------------------------------------------------
+void GpibBusMonitor::getStats(gpibMonitorStats &stats, string &e)
+{
+	omni_mutex_lock lock(mutex);
+	monitor.getStats(stats);
+	e = error;
+}
+
+//+----------------------------------------------------------------------------
+//
+// method : 		GpibBusMonitor::dump()
+//
+// description : 	Write the capture in a file. The cycles are copied
+//			under the lock, the file is written without it.
+//
+//-----------------------------------------------------------------------------
+long GpibBusMonitor::dump(const string &file)
+{
+	vector<gpibBusCycle> cycles;
+	{
+		omni_mutex_lock lock(mutex);
+		monitor.getCycles(cycles);
+	}
+	return gpibMonitorDump(file, cycles);
+}
+
+//+----------------------------------------------------------------------------
+//
+// method : 		GpibBusMonitor::stop()
+//
+// description : 	Stop the thread, after its current read (at most the
+//			board time out). The object is deleted by join().
+//
+//-----------------------------------------------------------------------------
+void GpibBusMonitor::stop()
+{
+	stopping = true;
+	join(NULL);
+}
+
+//+----------------------------------------------------------------------------
+//
+// method : 		GpibBusMonitor::run_undetached()
+//
+// description : 	Read the bus until stopped, then put the board back
+//			in normal mode.
+//
+//-----------------------------------------------------------------------------
+void *GpibBusMonitor::run_undetached(void *)
+{
+	gpibBusCycle *cycles = new gpibBusCycle[GPIB_MONITOR_READ];
+
+	while (stopping == false)
+	{
+		long   n = 0;
+		string e;
+		try
+		{
+			omni_mutex_lock lock(bus);
+			n = board->monitorRead(cycles, GPIB_MONITOR_READ);
+		}
+		catch (gpibDeviceException ex)
+		{
+			e = ex.getiberrMessage();
+		}
+		{
+			omni_mutex_lock lock(mutex);
+			if ( (e.length() > 0) && (error.length() == 0) )
+				GPIB_LOG_ERROR("bus monitor read failed: %s", e.c_str(), 0, 0);
+			error = e;
+			monitor.add(cycles, n, gpibClock());
+		}
+		if (e.length() > 0)
+			omni_thread::sleep(0, BUS_MONITOR_ERROR_PERIOD * 1000);
+	}
+
+	delete [] cycles;
+	try
+	{
+		omni_mutex_lock lock(bus);
+		board->setListenOnly(false);
+	}
+	catch (gpibDeviceException ex)
+	{
+	}
+	delete board;
+	return NULL;
+}
+
+}	// namespace
@@ -0,0 +1,57 @@
+//=============================================================================
+//
+// file :        GpibBusMonitor.h
+//
+// description : Include for the GpibBusMonitor class, which records the
+//               traffic of a gpib bus with a spare listen-only board.
+//
+// project :     gpidDeviceServer
+//
+// copyleft :    European Synchrotron Radiation Facility
+//               BP 220, Grenoble 38043
+//               FRANCE
+//
+//=============================================================================
+#ifndef _GPIBBUSMONITOR_H
+#define _GPIBBUSMONITOR_H
+
+#include <tango.h>
+#include "gpibDevice.h"
+
+namespace GpibDeviceServer_ns
+{
+
+/**
+ * This thread reads back to back the bytes seen by a board in listen-only
+ * mode on the bus, and decodes them with a gpibMonitor: bus utilization,
+ * bandwidth per talker and per listener, and a capture of the last
+ * GPIB_MONITOR_CYCLES bytes. The board must not be the controller of the
+ * bus: it is a spare board on the same cable.
+ */
+class GpibBusMonitor : public omni_thread
+{
+public:
+	// Owns board, in listen-only mode, read under its bus lock.
+	GpibBusMonitor(gpibBoard *board, omni_mutex &bus);
+
+	// Statistics, error gets the reason of the last read error ("" if
+	// none).
+	void getStats(gpibMonitorStats &stats, string &error);
+	long dump(const string &file);	// gpibMonitorDump() of the capture.
+	void stop();	// Stop the monitor and delete the thread.
+
+protected:
+	void *run_undetached(void *);
+
+private:
+	gpibBoard          *board;
+	omni_mutex         &bus;
+	volatile bool       stopping;
+	omni_mutex          mutex;
+	gpibMonitor         monitor;
+	string              error;
+};
+
+}	// namespace
+
+#endif	// _GPIBBUSMONITOR_H
@@ -152,10 +152,32 @@ static const char *RcsId = "$Header: /users/chaize/newsvn/cvsroot/Communication/
 //  GetSerialPoll             |  get_serial_poll()
 //  GetDevicePad              |  get_device_pad()
 //  GetBoardIndex             |  get_board_index()
+//  ReloadProperties          |  reload_properties()
+//  GetLatencyStats           |  get_latency_stats()
+//  ResetLatencyStats         |  reset_latency_stats()
+//  DumpTrace                 |  dump_trace()
+//  BCTriggerList             |  bctrigger_list()
+//  BCSnapshotGroup           |  bcsnapshot_group()
+//  BCWriteMany               |  bcwrite_many()
+//  BCSerialPollAll           |  bcserial_poll_all()
+//  PPollConfig               |  ppoll_config()
+//  PPollUnconfig             |  ppoll_unconfig()
+//  BCParallelPoll            |  bcparallel_poll()
+//  BCStartFastPoll           |  bcstart_fast_poll()
+//  BCStopFastPoll            |  bcstop_fast_poll()
+//  BCWriteReadMany           |  bcwrite_read_many()
+//  BCSetHS488                |  bcset_hs488()
+//  BCTestHS488               |  bctest_hs488()
+//  BCTuneBus                 |  bctune_bus()
+//  BCGetConnectedDeviceListSAD|  bcget_connected_device_list_sad()
+//  BCStartMonitor            |  bcstart_monitor()
+//  BCStopMonitor             |  bcstop_monitor()
+//  BCDumpMonitor             |  bcdump_monitor()
 //
 //===================================================================
 
 #include <tango.h>
+#include <algorithm>
 #include <GpibDeviceServer.h>
 #include <GpibDeviceServerClass.h>
 #include "gpibDevice.h"
@@ -164,6 +186,30 @@ static const char *RcsId = "$Header: /users/chaize/newsvn/cvsroot/Communication/
 namespace GpibDeviceServer_ns
 {
 
+/*
+ * always_executed_hook() start and end, and driver call time at its end,
+ * for the command run by the thread (see command_inout_4).
+ */
+#ifdef WIN32
+static __declspec(thread) long long hook_start = 0;
+static __declspec(thread) long long hook_end = 0;
+static __declspec(thread) long long hook_io = 0;
+#else
+static __thread long long hook_start = 0;
+static __thread long long hook_end = 0;
+static __thread long long hook_io = 0;
+#endif
+
+/*
+ * Stamps the hook times on every exit of always_executed_hook().
+ */
+class HookStamp
+{
+public:
+	HookStamp()  { hook_start = gpibClock(); }
+	~HookStamp() { hook_end = gpibClock(); hook_io = gpibThreadIoTime(); }
+};
+
 //+----------------------------------------------------------------------------
 //
 // method : 		GpibDeviceServer::GpibDeviceServer(string &s)
@@ -178,7 +224,12 @@ GpibDeviceServer::GpibDeviceServer(Tango::DeviceClass *cl,string &s):Tango::Devi
 {
 	gpib_device = NULL;
 	board0 = NULL;
+	fast_poll = NULL;
+	bus_monitor = NULL;
+	bus_monitor_board = -1;
 	gpibDeviceAddress = -1;
+	open_pending = false;
+	lazy_pending = false;
 	init_device();
 }
 
@@ -186,7 +237,12 @@ GpibDeviceServer::GpibDeviceServer(Tango::DeviceClass *cl,const char *s):Tango::
 {
 	gpib_device = NULL;
 	board0 = NULL;
+	fast_poll = NULL;
+	bus_monitor = NULL;
+	bus_monitor_board = -1;
 	gpibDeviceAddress = -1;
+	open_pending = false;
+	lazy_pending = false;
 	init_device();
 }
 
@@ -195,7 +251,12 @@ GpibDeviceServer::GpibDeviceServer(Tango::DeviceClass *cl,const char *s,const ch
 {
 	gpib_device = NULL;
 	board0 = NULL;
+	fast_poll = NULL;
+	bus_monitor = NULL;
+	bus_monitor_board = -1;
 	gpibDeviceAddress = -1;
+	open_pending = false;
+	lazy_pending = false;
 	init_device();
 }
 
@@ -209,12 +270,36 @@ GpibDeviceServer::GpibDeviceServer(Tango::DeviceClass *cl,const char *s,const ch
 //-----------------------------------------------------------------------------
 void GpibDeviceServer::delete_device()
 {
-	// AJOUT
-	//	Delete device's allocated object
-	//	delete gpib_device;
-	//	gpib_device = NULL;
-	// board 0 ?
-	// TODO  clear & close ....
+	GpibDeviceServerClass	*ds_class =
+	    (static_cast<GpibDeviceServerClass *>(get_device_class()));
+	    
+	// Do not let a background open run on a deleted device. The lock
+	// is not held by cancel(): the lane takes it at the end of its open.
+	bool	pending;
+	{
+		omni_mutex_lock lock(open_mutex);
+		pending = open_pending;
+	}
+	if ( (pending == true) && (ds_class->init_pool != NULL) )
+		ds_class->init_pool->cancel(this);
+	{
+		omni_mutex_lock lock(open_mutex);
+		open_pending = false;
+	}
+	
+	if (ds_class->metrics != NULL)
+		ds_class->metrics->remove(device_name);
+	
+	//	Delete device's allocated objects. The board is not set
+	//	offline: it is shared with the other devices on it.
+	stop_fast_poll();
+	stop_bus_monitor();
+	release_gpib_device();
+	if (board0 != NULL)
+	{
+		delete board0;
+		board0 = NULL;
+	}
 }
 
 
@@ -233,20 +318,52 @@ void GpibDeviceServer::init_device()
 	// Initialise variables to default values
 	//--------------------------------------------
 	get_device_property();
-	
-	cout << "Starting Tango GPIB server (Built on " << __DATE__ << " " << __TIME__ << ")." << endl;
+	init_from_properties();
+}
+
+
+//+----------------------------------------------------------------------------
+//
+// method : 		GpibDeviceServer::init_from_properties()
+//
+// description : 	Initialise the device with its current property
+//			values: init_device() after the properties are read,
+//			and ReloadProperties.
+//
+//-----------------------------------------------------------------------------
+void GpibDeviceServer::init_from_properties()
+{
+	INFO_STREAM << "Starting Tango GPIB server (Built on " << __DATE__ << " " << __TIME__ << ")." << endl;
 	
 	dev_open = false;	// No gpib device opened.
+	attr_ServiceRequestMask_read = 0;
+	attr_ParallelPoll_read = 0;
+	ppoll_time = 0;
+	for (int b = 0; b < GPIB_HIST_BUCKETS; b++)
+		attr_LatencyBuckets_read[b] = (Tango::DevDouble) gpibHistogram::bucketLimit(b);
+	open_method = GPIB_OPEN_UNKNOWN;
+	lazy_pending = false;
+	
+	// Not deleted when the device is initialised again without
+	// delete_device() (ReloadProperties).
+	stop_fast_poll();
+	stop_bus_monitor();
+	if (board0 != NULL)
+	{
+		delete board0;
+		board0 = NULL;
+	}
 	
 	try
 	{
 		INFO_STREAM << "Looking for Board for Tango device:" << device_name << endl;
 		board0 = new gpibBoard( gpibBoardName );
-		cout << "gpib board '" << gpibBoardName << "' has been found." << endl;
+		INFO_STREAM << "gpib board '" << gpibBoardName << "' has been found." << endl;
 	}
 	catch (gpibDeviceException e)
 	{
-		cout << "No GPIB board found (gpibBoardName = '"<< gpibBoardName <<"'). " << endl;
+		WARN_STREAM << "No GPIB board found (gpibBoardName = '"<< gpibBoardName <<"'). " << endl;
+		GPIB_LOG_ERROR("%s: no GPIB board found", gpibBoardName.c_str(), 0, 0);
 	}
 	
 	// come here when successfully created board object;
@@ -257,375 +374,2037 @@ void GpibDeviceServer::init_device()
 	
 	// Test board0 against NULL to avoid core dump !
 	if (board0 != NULL) boardind = board0->getBoardInd();
+	apply_board_config();
 	
 	// gpib_device is initialised in Constructor !
-	if (gpib_device != NULL)
-	{
-		delete gpib_device;
-		gpib_device = NULL;
-	}
-	
-	
-	// Try to open device, controlled by the board gpibBoardName,
-	// by name if its name (= gpibDeviceName) exists in DB
-	// --> use the 1st constructor for gpibDevice class.
-	if ((dev_open == false) && (gpibDeviceName.length() != 0))
-	{
-		cout << "Trying to open gpib device (assigned beforehand with ibconf): '" << gpibBoardName << "::" << gpibDeviceName <<" : ";
-		
-		try
-		{
-			if(gpib_device != NULL)
-			{
-				delete gpib_device;// AJOUT
-				gpib_device = NULL;
-			}
-			
-			gpib_device = new gpibDevice(gpibDeviceName, gpibBoardName);
-			
-			// Force exception if device not listening (Off)
-			int sb = gpib_device->isAlive();
-			
-			if (sb <=0)
-				throw gpibDeviceException((string)"init_device()",(string)"Device is not listening",(string)"gpib_device->isAlive() returns value <= 0",(string)"", 0, 0);
-			dev_open = true;
-			cout << "SUCCESS." << endl;
-		}
-		catch (gpibDeviceException f)
-		{
-			cout << "FAILED (more info on ERROR_STREAM)" << endl;
-			if (gpib_device) delete gpib_device;// AJOUT
-			set_state(Tango::FAULT);
-			set_status("Gpib device is not responding.");
-			gpib_device = NULL;
-			
-			ERROR_STREAM << "gpibDeviceException from " << f.getDeviceName() << endl;
-			ERROR_STREAM << f.getMessage() << endl;
-			ERROR_STREAM << f.getiberrMessage() << endl;
-			ERROR_STREAM << f.getibstaMessage() << endl;
-		}
-		catch (...)
-		{
-			cout << "UNEXPECTED EXCEPTION !!!" << endl;
-			exit(-1);
-		}
-	}
+	release_gpib_device();
 	
+	GpibDeviceServerClass	*ds_class =
+	    (static_cast<GpibDeviceServerClass *>(get_device_class()));
+	if (ds_class->metrics != NULL)
+		ds_class->metrics->add(device_name, &counters,
+		                       (board0 != NULL) ? boardind : GPIB_DEFAULT_BOARD);
 	
-	// try to open device by name if gpibDeviceName exists in DB
-	// assuming that the board index is 0 (i.e. the gpibBoardName = gpib0
-	// in case it was not put in DB --> use the 2nd constructor for
-	// gpibDevice class).
-	if ((dev_open == false) && (gpibDeviceName.length() != 0))
+	// With LazyOpen, the device is opened by the first command which
+	// needs it (see open_on_first_use).
+	if (lazyOpen == true)
 	{
-		cout << "Trying to open gpib device (assigned beforehand with ibconf): 0::" << gpibDeviceName <<" : ";
-		
-		try
-		{
-			if (gpib_device != NULL)
-			{
-				delete gpib_device;// AJOUT
-				gpib_device = NULL;
-			}
-			
-			gpib_device = new gpibDevice( gpibDeviceName );
-			// Force exception if device not listening (Off)
-			int sb = gpib_device->isAlive();
-			
-			if (sb <=0)
-				throw gpibDeviceException((string)"init_device()",(string)"Device is not listening",(string)"gpib_device->isAlive() returns value <= 0",(string)"", 0, 0);
-			dev_open = true;
-			cout << "SUCCESS." << endl;
-		}
-		catch (gpibDeviceException f)
-		{
-			cout << "FAILED (more info on ERROR_STREAM)" << endl;
-			if (gpib_device) delete gpib_device;// AJOUT
-			set_state(Tango::FAULT);
-			set_status("Gpib device is not responding.");
-			gpib_device = NULL;
-			
-			ERROR_STREAM << "gpibDeviceException from " << f.getDeviceName() << endl;
-			ERROR_STREAM << f.getMessage() << endl;
-			ERROR_STREAM << f.getiberrMessage() << endl;
-			ERROR_STREAM << f.getibstaMessage() << endl;
-		}
-		catch (...)
-		{
-			cout << "UNEXPECTED EXCEPTION !!!" << endl;
-			exit(-1);
-		}
+		lazy_pending = true;
+		set_state(Tango::STANDBY);
+		set_status("Gpib device will be opened on first use.");
+		return;
 	}
 	
-	
-	// Try to open device, controlled by the board gpibBoardName,
-	// by address if its primary address (= gpibDeviceAddress) exists in DB
-	// --> use the 3rd constructor for gpibDevice class. This is newly
-	//     added constructor to allow gpib device with given primary
-	//     address to be controlled by other than gpib0 board
-	if ((dev_open == false) && (gpibBoardName.length() != 0) && (gpibDeviceAddress != -1))
+	// At server startup, devices are opened in background by the class
+	// init pool: isAlive() timeouts of devices which are off do not delay
+	// the server. The device stays in INIT until its open is done.
+	if (ds_class->async_init == true)
 	{
-		cout << "Trying to open gpib device " << gpibBoardName <<"::" << gpibDeviceAddress << " : ";
-		try
-		{
-			if (gpib_device != NULL)
-			{
-				delete gpib_device;// AJOUT
-				gpib_device = NULL;
-			}
-			
-			gpib_device = new gpibDevice( gpibDeviceAddress, gpibBoardName );
-			// Force exception if device not listening (Off)
-			int sb = gpib_device->isAlive();
-			
-			if (sb <=0)
-				throw gpibDeviceException((string)"init_device()",(string)"Device is not listening",(string)"gpib_device->isAlive() returns value <= 0",(string)"", 0, 0);
-			dev_open = true;
-			cout << "SUCCESS." << endl;
-		}
-		catch (gpibDeviceException f)
 		{
-			cout << "FAILED (more info on ERROR_STREAM)" << endl;
-			if (gpib_device) delete gpib_device;// AJOUT
-			set_state(Tango::FAULT);
-			set_status("Gpib device is not responding.");
-			gpib_device = NULL;
-			
-			ERROR_STREAM << "gpibDeviceException from " << f.getDeviceName() << endl;
-			ERROR_STREAM << f.getMessage() << endl;
-			ERROR_STREAM << f.getiberrMessage() << endl;
-			ERROR_STREAM << f.getibstaMessage() << endl;
-		}
-		catch (...)
-		{
-			cout << "UNEXPECTED EXCEPTION !!!" << endl;
-			exit(-1);
+			omni_mutex_lock lock(open_mutex);
+			open_pending = true;
 		}
+		set_state(Tango::INIT);
+		set_status("Gpib device is being opened.");
+		ds_class->init_pool->submit(this);
+		return;
 	}
 	
+	open_device();
+	set_open_state();
+}
+
+
+//+----------------------------------------------------------------------------
+//
+// method : 		GpibDeviceServer::open_in_background()
+//
+// description : 	Called by a GpibInitPool lane to open the device
+//			queued by init_device().
+//
+//-----------------------------------------------------------------------------
+void GpibDeviceServer::open_in_background()
+{
+	open_device();
+	set_open_state();
 	
-	// Try to open device by address if its primary address
-	// (= gpibDeviceAddress) exists in DB assuming that the board index
-	// is 0 (board = gpib0) -> use the 4th constructor for the
-	// gpibDevice class.
-	
-	if ((dev_open == false) && (gpibDeviceAddress != -1))
-	{
-		cout << "Trying to open gpib device board0::" << gpibDeviceAddress << " : ";
-		try
-		{
-			gpib_device = new gpibDevice((int) gpibDeviceAddress);
-			
-			// Force exception if device not listening (Off)
-			int sb = gpib_device->isAlive();
-			
-			if (sb <=0)
-				throw gpibDeviceException((string)"init_device()",(string)"Device is not listening",(string)"gpib_device->isAlive() returns value <= 0",(string)"", 0, 0);
-			dev_open = true;
-			cout << "SUCCESS." << endl;
-		}
-		catch (gpibDeviceException f)
-		{
-			cout << "FAILED (more info on ERROR_STREAM)" << endl;
-			if (gpib_device) delete gpib_device;// AJOUT
-			set_state(Tango::FAULT);
-			set_status("Gpib device is not responding.");
-			gpib_device = NULL;
-			
-			ERROR_STREAM << "gpibDeviceException from " << f.getDeviceName() << endl;
-			ERROR_STREAM << f.getMessage() << endl;
-			ERROR_STREAM << f.getiberrMessage() << endl;
-			ERROR_STREAM << f.getibstaMessage() << endl;
-		}
-		catch (...)
-		{
-			cout << "UNEXPECTED EXCEPTION !!!" << endl;
-			exit(-1);
-		}
-	}
-	
+	omni_mutex_lock lock(open_mutex);
+	open_pending = false;
+}
+
+
+//+----------------------------------------------------------------------------
+//
+// method : 		GpibDeviceServer::set_open_state()
+//
+// description : 	Set the state and status after open_device(): ON, or
+//			FAULT when no open method worked. open_device() runs
+//			on init pool lanes too: the state is only set here,
+//			under open_mutex.
+//
+//-----------------------------------------------------------------------------
+void GpibDeviceServer::set_open_state()
+{
+	omni_mutex_lock lock(open_mutex);
 	if (gpib_device != NULL)
 	{
-		gpib_device->setTimeOut(gpibDeviceTimeOut);	// Set Time Out.
 		set_state(Tango::ON);
 		set_status("Gpib device is OK.");
 	}
+	else
+	{
+		set_state(Tango::FAULT);
+		set_status("Gpib device is not responding.");
+	}
 }
 
 
 //+----------------------------------------------------------------------------
 //
-// method : 		GpibDeviceServer::readDeviceProperies()
+// method : 		GpibDeviceServer::open_device()
 //
-// description : 	Read the device properties from database.
+// description : 	Open the gpib device with the first gpibDevice
+//			constructor which gives a device answering to isAlive().
+//			The open and probe methods which worked at the previous
+//			start are read from the GpibCached* properties and tried
+//			first. The full search is only done when they fail.
 //
 //-----------------------------------------------------------------------------
-void GpibDeviceServer::get_device_property()
+void GpibDeviceServer::open_device()
 {
-	//	Initialize your default values here.
-	//------------------------------------------
-	gpibDeviceTimeOut = 13; 		/* 10s predefined value */
-	gpibDeviceAddress = 0xFF;		/* Unused set to zero	*/
-	gpibDeviceName = "";			/* Unused set to zero	*/
-	gpibDeviceSecondaryAddress = 0;		/* Unused set to zero	*/
-	
-	//	Read device properties from database.(Automatic code generation)
-	//-------------------------------------------------------------
-	Tango::DbData	dev_prop;
-	dev_prop.push_back(Tango::DbDatum("GpibDeviceName"));
-	dev_prop.push_back(Tango::DbDatum("GpibDeviceAddress"));
-	dev_prop.push_back(Tango::DbDatum("GpibDeviceTimeOut"));
-	dev_prop.push_back(Tango::DbDatum("GpibDeviceSecondaryAddress"));
-	dev_prop.push_back(Tango::DbDatum("GpibBoardName"));
-	
-	//	Call database and extract values
-	//--------------------------------------------
-	if (Tango::Util::instance()->_UseDb==true)
-		get_db_device()->get_property(dev_prop);
-	Tango::DbDatum	def_prop, cl_prop;
-	GpibDeviceServerClass	*ds_class =
-	    (static_cast<GpibDeviceServerClass *>(get_device_class()));
-	int	i = -1;
+	int method;
 	
-	//      Try to initialize GpibDeviceName from class property
-	cl_prop = ds_class->get_class_property(dev_prop[++i].name);
-	if (cl_prop.is_empty()==false)	cl_prop  >>  gpibDeviceName;
-	else {
-		//      Try to initialize GpibDeviceName from default device value
-		def_prop = ds_class->get_default_device_property(dev_prop[i].name);
-		if (def_prop.is_empty()==false)	def_prop  >>  gpibDeviceName;
+	if (gpibCachedOpenMethod != GPIB_OPEN_UNKNOWN)
+	{
+		try_open((GpibOpenMethod) gpibCachedOpenMethod,
+		         (GpibProbeMethod) gpibCachedProbeMethod);
 	}
-	//	And try to extract GpibDeviceName value from database
-	if (dev_prop[i].is_empty()==false)	dev_prop[i]  >>  gpibDeviceName;
 	
-	//	Try to initialize GpibDeviceAddress from class property
-	cl_prop = ds_class->get_class_property(dev_prop[++i].name);
-	if (cl_prop.is_empty()==false)	cl_prop  >>  gpibDeviceAddress;
-	else {
-		//	Try to initialize GpibDeviceAddress from default device value
-		def_prop = ds_class->get_default_device_property(dev_prop[i].name);
-		if (def_prop.is_empty()==false)	def_prop  >>  gpibDeviceAddress;
+	for (method = GPIB_OPEN_BY_NAME_ON_BOARD; method <= GPIB_OPEN_BY_ADDRESS; method++)
+	{
+		if ( (dev_open == true) || (method == gpibCachedOpenMethod) )
+			continue;
+		try_open((GpibOpenMethod) method, GPIB_PROBE_UNKNOWN);
 	}
-	//	And try to extract GpibDeviceAddress value from database
-	if (dev_prop[i].is_empty()==false)	dev_prop[i]  >>  gpibDeviceAddress;
 	
-	//	Try to initialize GpibDeviceTimeOut from class property
-	cl_prop = ds_class->get_class_property(dev_prop[++i].name);
-	if (cl_prop.is_empty()==false)	cl_prop  >>  gpibDeviceTimeOut;
-	else {
-		//	Try to initialize GpibDeviceTimeOut from default device value
-		def_prop = ds_class->get_default_device_property(dev_prop[i].name);
-		if (def_prop.is_empty()==false)	def_prop  >>  gpibDeviceTimeOut;
-	}
-	//	And try to extract GpibDeviceTimeOut value from database
-	if (dev_prop[i].is_empty()==false)	dev_prop[i]  >>  gpibDeviceTimeOut;
+	if (dev_open == true)
+		write_discovery_cache();
+}
+
+
+//+----------------------------------------------------------------------------
+//
+// method : 		GpibDeviceServer::try_open()
+//
+// description : 	Try to open the gpib device with one of the gpibDevice
+//			constructors. The device must answer to isAlive().
+//
+// in : - method : gpibDevice constructor to use.
+//      - probe : isAlive() method to preset, GPIB_PROBE_UNKNOWN to search.
+//
+// returns : true when the device is open.
+//
+//-----------------------------------------------------------------------------
+bool GpibDeviceServer::try_open(GpibOpenMethod method, GpibProbeMethod probe)
+{
+	string target;		// Board and ibconf name of the device.
+	long   pad = -1;
 	
-	//	Try to initialize GpibDeviceSecondaryAddress from class property
-	cl_prop = ds_class->get_class_property(dev_prop[++i].name);
-	if (cl_prop.is_empty()==false)	cl_prop  >>  gpibDeviceSecondaryAddress;
-	else {
-		//	Try to initialize GpibDeviceSecondaryAddress from default device value
-		def_prop = ds_class->get_default_device_property(dev_prop[i].name);
-		if (def_prop.is_empty()==false)	def_prop  >>  gpibDeviceSecondaryAddress;
+	switch (method)
+	{
+		// Try to open device, controlled by the board gpibBoardName,
+		// by name if its name (= gpibDeviceName) exists in DB
+		// --> use the 1st constructor for gpibDevice class.
+		case GPIB_OPEN_BY_NAME_ON_BOARD:
+			if (gpibDeviceName.length() == 0)
+				return false;
+			target = gpibBoardName + "::" + gpibDeviceName;
+			break;
+			
+		// try to open device by name if gpibDeviceName exists in DB
+		// assuming that the board index is 0 (i.e. the gpibBoardName = gpib0
+		// in case it was not put in DB --> use the 2nd constructor for
+		// gpibDevice class).
+		case GPIB_OPEN_BY_NAME:
+			if (gpibDeviceName.length() == 0)
+				return false;
+			target = "gpib0::" + gpibDeviceName;
+			break;
+			
+		// Try to open device, controlled by the board gpibBoardName,
+		// by address if its primary address (= gpibDeviceAddress) exists in DB
+		// --> use the 3rd constructor for gpibDevice class. This is newly
+		//     added constructor to allow gpib device with given primary
+		//     address to be controlled by other than gpib0 board
+		case GPIB_OPEN_BY_ADDRESS_ON_BOARD:
+			if ( (gpibBoardName.length() == 0) || (gpibDeviceAddress == -1) )
+				return false;
+			target = gpibBoardName;
+			pad = gpibDeviceAddress;
+			break;
+			
+		// Try to open device by address if its primary address
+		// (= gpibDeviceAddress) exists in DB assuming that the board index
+		// is 0 (board = gpib0) -> use the 4th constructor for the
+		// gpibDevice class.
+		case GPIB_OPEN_BY_ADDRESS:
+			if (gpibDeviceAddress == -1)
+				return false;
+			target = "gpib0";
+			pad = gpibDeviceAddress;
+			break;
+			
+		default:
+			return false;
 	}
-	//	And try to extract GpibDeviceSecondaryAddress value from database
-	if (dev_prop[i].is_empty()==false)	dev_prop[i]  >>  gpibDeviceSecondaryAddress;
 	
-	//	Try to initialize GpibBoardName from class property
-	cl_prop = ds_class->get_class_property(dev_prop[++i].name);
-	if (cl_prop.is_empty()==false)	cl_prop  >>  gpibBoardName;
-	else {
-		//	Try to initialize GpibBoardName from default device value
-		def_prop = ds_class->get_default_device_property(dev_prop[i].name);
-		if (def_prop.is_empty()==false)	def_prop  >>  gpibBoardName;
+	try
+	{
+		release_gpib_device();
+		
+		switch (method)
+		{
+			case GPIB_OPEN_BY_NAME_ON_BOARD:
+				gpib_device = new gpibDevice(gpibDeviceName, gpibBoardName);
+				break;
+			case GPIB_OPEN_BY_NAME:
+				gpib_device = new gpibDevice(gpibDeviceName);
+				break;
+			case GPIB_OPEN_BY_ADDRESS_ON_BOARD:
+				gpib_device = new gpibDevice(gpibDeviceAddress, gpibBoardName,
+				                             gpibDeviceSecondaryAddress);
+				break;
+			default:
+				gpib_device = new gpibDevice((int) gpibDeviceAddress,
+				                             (int) gpibDeviceSecondaryAddress);
+				break;
+		}
+		gpib_device->setLatency(&latency);
+		gpib_device->setCounters(&counters);
+		
+		if (probe != GPIB_PROBE_UNKNOWN)
+			gpib_device->setProbeMethod(probe);
+			
+		// Force exception if device not listening (Off)
+		int sb = gpib_device->isAlive();
+		
+		if (sb <=0)
+			throw gpibDeviceException((string)"init_device()",(string)"Device is not listening",(string)"gpib_device->isAlive() returns value <= 0",(string)"", 0, 0);
+		gpib_device->setTimeOut(gpibDeviceTimeOut);	// Set Time Out.
+		apply_termination();
+		dev_open = true;
+		open_method = method;
+		INFO_STREAM << "gpib device " << target << " (pad " << pad << ") opened." << endl;
+		GPIB_LOG_INFO("open %s (pad %d): success", target.c_str(), pad, 0);
 	}
-	//	And try to extract GpibBoardName value from database
-	if (dev_prop[i].is_empty()==false)	dev_prop[i]  >>  gpibBoardName;
-	
-	
-	
-	//	End of Automatic code generation
-	//-------------------------------------------------------------
-	
-	if ( (dev_prop[0].is_empty() == true) && (dev_prop[1].is_empty() == true) )
+	catch (gpibDeviceException f)
 	{
-		cout << "Mandatory properties 'gpibDeviceName' and 'gpibDeviceAddress' are not defined" << endl;
-		cout << "in the Database. Please define at least one of them. Exiting." << endl;
-		exit(-1);
+		GPIB_LOG_ERROR("open %s (pad %d): failed, iberr %d", target.c_str(), pad, f.getErrorValue());
+		release_gpib_device();
+		
+		ERROR_STREAM << "gpibDeviceException from " << f.getDeviceName() << endl;
+		ERROR_STREAM << f.getMessage() << endl;
+		ERROR_STREAM << f.getiberrMessage() << endl;
+		ERROR_STREAM << f.getibstaMessage() << endl;
+	}
+	catch (...)
+	{
+		// Opens run on init pool lanes and command threads: a failed
+		// open must not stop the server.
+		GPIB_LOG_ERROR("open %s (pad %d): unexpected exception", target.c_str(), pad, 0);
+		ERROR_STREAM << "Unexpected exception while opening " << target << endl;
+		release_gpib_device();
 	}
+	return dev_open;
 }
 
 
 //+----------------------------------------------------------------------------
 //
-// method : 		GpibDeviceServer::always_executed_hook()
+// method : 		GpibDeviceServer::check_latency_alarm()
 //
-// description : 	method always executed before any command is executed
+// description : 	Compare the p99 latency of each operation with the
+//			LatencyAlarmP99 property. Return true, and the status
+//			to display, when one is above its threshold.
 //
 //-----------------------------------------------------------------------------
-void GpibDeviceServer::always_executed_hook()
+bool GpibDeviceServer::check_latency_alarm(string &status)
 {
-	short sb;
-	if ( (board0 != NULL) && (gpib_device != NULL) && (dev_open == true) )
+	if (latencyAlarmP99.empty())
+		return false;
+		
+	for (int op = 0; op < GPIB_NB_OP; op++)
 	{
-		try
-		{
-			sb = gpib_device->isAlive(); 		// Try to get Status byte
-			if (sb != 0)
-			{
-				set_state(Tango::ON);
-				set_status("GPIB Device is On.");
-			}
-			else
-			{
-				set_state(Tango::FAULT);
-				set_status("GPIB Device is Off.");
-			}
-		}
-		catch (gpibDeviceException e)
+		double limit = (latencyAlarmP99.size() == 1) ? latencyAlarmP99[0] :
+		               (op < (int) latencyAlarmP99.size()) ? latencyAlarmP99[op] : 0;
+		if (limit <= 0)
+			continue;
+		long long p99 = latency.hist[op].percentile(99.0);
+		if (p99 > limit)
 		{
-			set_state(Tango::FAULT);
-			set_status("GPIB Device is not responding.");
+			ostringstream os;
+			os << "GPIB Device is On. p99 latency of " << gpibOpName(op) << " is "
+			   << p99 << " us (alarm at " << limit << " us).";
+			status = os.str();
+			return true;
 		}
 	}
-	else
-	{
-		Tango::Except::throw_exception(
-		    (const char *) ("gpibDeviceException on	"+ gpibDeviceName).c_str(),
-		    (const char *) "This device is not reachable by server : maybe is the device off ?",
-		    (const char *) "An error occurs when looking for device.",
-		    Tango::ERR
-		);
-	}
+	return false;
 }
 
 
-//+------------------------------------------------------------------
-/**
-*	method:	GpibDeviceServer::write
-*
-*	description:	method to execute "Write"
+//+----------------------------------------------------------------------------
+//
+// method : 		GpibDeviceServer::get_board_counters
+//
+// description : 	Return the counters of the device board, shared by all
+//			the devices of the server on this board, or NULL if no
+//			board has been found.
+//
+//-----------------------------------------------------------------------------
+gpibCounters *GpibDeviceServer::get_board_counters()
+{
+	if (board0 == NULL)
+		return NULL;
+	return gpibBoardCounters(board0->getBoardInd());
+}
+
+
+//+----------------------------------------------------------------------------
+//
+// method : 		GpibDeviceServer::get_board
+//
+// description : 	Return the board of the device, for the board level
+//			(BC) group commands. Throw if no board has been found.
+//
+//-----------------------------------------------------------------------------
+gpibBoard *GpibDeviceServer::get_board()
+{
+	if (board0 == NULL)
+	{
+		Tango::Except::throw_exception(
+		    (const char *) "GPIB_NO_BOARD",
+		    (const char *) ("No GPIB board found (gpibBoardName = '" + gpibBoardName + "')").c_str(),
+		    (const char *) "GpibDeviceServer::get_board",
+		    Tango::ERR
+		);
+	}
+	return board0;
+}
+
+
+//+----------------------------------------------------------------------------
+//
+// method : 		GpibDeviceServer::get_bus_mutex
+//
+// description : 	Return the bus lock of the board of the device, taken
+//			by the group commands. Throw if no board has been found.
+//
+//-----------------------------------------------------------------------------
+omni_mutex &GpibDeviceServer::get_bus_mutex()
+{
+	GpibDeviceServerClass	*ds_class =
+	    (static_cast<GpibDeviceServerClass *>(get_device_class()));
+
+	return ds_class->get_bus_mutex(get_board()->getBoardInd());
+}
+
+
+//+----------------------------------------------------------------------------
+//
+// method : 		GpibDeviceServer::wall_time
+//
+// description : 	Convert a gpibClock() time to seconds since the epoch.
+//
+//-----------------------------------------------------------------------------
+double GpibDeviceServer::wall_time(long long t)
+{
+	unsigned long sec, nsec;
+	omni_thread::get_time(&sec, &nsec);
+	return (double) sec + nsec * 1e-9 - (gpibClock() - t) * 1e-9;
+}
+
+
+//+----------------------------------------------------------------------------
+//
+// method : 		GpibDeviceServer::stop_fast_poll
+//
+// description : 	Stop the background parallel poll, if running.
+//
+//-----------------------------------------------------------------------------
+void GpibDeviceServer::stop_fast_poll()
+{
+	if (fast_poll != NULL)
+	{
+		fast_poll->stop();
+		fast_poll = NULL;
+	}
+}
+
+
+//+----------------------------------------------------------------------------
+//
+// method : 		GpibDeviceServer::stop_bus_monitor
+//
+// description : 	Stop the passive bus monitor, if running.
+//
+//-----------------------------------------------------------------------------
+void GpibDeviceServer::stop_bus_monitor()
+{
+	if (bus_monitor != NULL)
+	{
+		GpibDeviceServerClass	*ds_class =
+		    (static_cast<GpibDeviceServerClass *>(get_device_class()));
+		
+		bus_monitor->stop();
+		bus_monitor = NULL;
+		ds_class->release_monitor_board(bus_monitor_board, device_name);
+		bus_monitor_board = -1;
+	}
+}
+
+
+//+----------------------------------------------------------------------------
+//
+// method : 		GpibDeviceServer::release_gpib_device()
+//
+// description : 	Set the gpib device offline and delete it. Deleting the
+//			gpibDevice alone leaves its handle open in the driver.
+//
+//-----------------------------------------------------------------------------
+void GpibDeviceServer::release_gpib_device()
+{
+	if (gpib_device == NULL)
+		return;
+		
+	try
+	{
+		gpib_device->setOffLine();
+	}
+	catch (gpibDeviceException e)
+	{
+		GPIB_DEBUG_STREAM << "setOffLine error on " << e.getDeviceName() << endl;
+	}
+	delete gpib_device;
+	gpib_device = NULL;
+	dev_open = false;
+}
+
+
+//+----------------------------------------------------------------------------
+//
+// method : 		GpibDeviceServer::apply_termination()
+//
+// description : 	Give the GpibDeviceEOS / GpibDeviceEOT properties to the
+//			driver. A -1 value keeps the driver setting.
+//			Also applies StickyAddressing.
+//
+//-----------------------------------------------------------------------------
+void GpibDeviceServer::apply_termination()
+{
+	if (gpibDeviceEOS != -1)
+		gpib_device->setEOS(gpibDeviceEOS);
+	if (gpibDeviceEOT != -1)
+		gpib_device->setEOT(gpibDeviceEOT);
+	gpib_device->setStickyAddressing(stickyAddressing);
+}
+
+
+//+----------------------------------------------------------------------------
+//
+// method : 		GpibDeviceServer::write_discovery_cache()
+//
+// description : 	Save the open and probe methods of the open device in
+//			the GpibCachedOpenMethod / GpibCachedProbeMethod
+//			properties. The database is only written when they
+//			changed.
+//
+//-----------------------------------------------------------------------------
+void GpibDeviceServer::write_discovery_cache()
+{
+	Tango::DevShort probe = (Tango::DevShort) gpib_device->getProbeMethod();
+	
+	if ( (gpibCachedOpenMethod == open_method) && (gpibCachedProbeMethod == probe) )
+		return;
+		
+	gpibCachedOpenMethod = open_method;
+	gpibCachedProbeMethod = probe;
+	
+	if (Tango::Util::instance()->_UseDb == false)
+		return;
+		
+	Tango::DbData	data;
+	Tango::DbDatum	open_prop("GpibCachedOpenMethod");
+	Tango::DbDatum	probe_prop("GpibCachedProbeMethod");
+	open_prop << gpibCachedOpenMethod;
+	probe_prop << gpibCachedProbeMethod;
+	data.push_back(open_prop);
+	data.push_back(probe_prop);
+	try
+	{
+		get_db_device()->put_property(data);
+	}
+	catch (Tango::DevFailed &e)
+	{
+		ERROR_STREAM << "Cannot save discovery cache of " << device_name << endl;
+	}
+}
+
+
+//+----------------------------------------------------------------------------
+//
+// method : 		GpibDeviceServer::board_property_name()
+//
+// description : 	Name of the class property which keeps a board
+//			setting for the board of the device, e.g.
+//			GpibBoardHS488_gpib0: all the devices of the bus
+//			share it.
+//
+// in : - name : Name of the setting (device property name).
+//
+//-----------------------------------------------------------------------------
+string GpibDeviceServer::board_property_name(const char *name)
+{
+	return string(name) + "_" + gpibBoardName;
+}
+
+
+//+----------------------------------------------------------------------------
+//
+// method : 		GpibDeviceServer::read_board_properties()
+//
+// description : 	Read the board settings saved by the commands in the
+//			class properties of the board. They replace the
+//			device properties, which are only the defaults of a
+//			board without saved settings.
+//
+//-----------------------------------------------------------------------------
+void GpibDeviceServer::read_board_properties()
+{
+	if (Tango::Util::instance()->_UseDb == false)
+		return;
+	
+	Tango::DbData	data;
+	data.push_back(Tango::DbDatum(board_property_name("GpibBoardHS488")));
+	data.push_back(Tango::DbDatum(board_property_name("GpibBoardTiming")));
+	data.push_back(Tango::DbDatum(board_property_name("GpibBoardDMA")));
+	try
+	{
+		get_device_class()->get_db_class()->get_property(data);
+	}
+	catch (Tango::DevFailed &e)
+	{
+		ERROR_STREAM << "Cannot read the settings of " << gpibBoardName << endl;
+		return;
+	}
+	if (data[0].is_empty()==false)	data[0]  >>  gpibBoardHS488;
+	if (data[1].is_empty()==false)	data[1]  >>  gpibBoardTiming;
+	if (data[2].is_empty()==false)	data[2]  >>  gpibBoardDMA;
+}
+
+
+//+----------------------------------------------------------------------------
+//
+// method : 		GpibDeviceServer::apply_board_config()
+//
+// description : 	Give the board settings of the properties to the
+//			board (-1 = keep the driver setting). A failure
+//			does not stop the device init.
+//
+//-----------------------------------------------------------------------------
+void GpibDeviceServer::apply_board_config()
+{
+	if (board0 == NULL)
+		return;
+	read_board_properties();
+	try
+	{
+		if (gpibBoardTiming != -1)
+			board0->setTiming(gpibBoardTiming);
+		if (gpibBoardDMA != -1)
+			board0->setDMA(gpibBoardDMA);
+		if (gpibBoardHS488 != -1)
+			board0->setHS488(gpibBoardHS488);
+	}
+	catch (gpibDeviceException e)
+	{
+		WARN_STREAM << "Cannot configure " << gpibBoardName << ": " << e.getiberrMessage() << endl;
+		GPIB_LOG_ERROR("%s: cannot apply the board properties", gpibBoardName.c_str(), 0, 0);
+	}
+}
+
+
+//+----------------------------------------------------------------------------
+//
+// method : 		GpibDeviceServer::write_board_property()
+//
+// description : 	Save a board setting changed by a command in the
+//			class property of the board (board_property_name),
+//			so that the other devices of the bus read it too.
+//
+// in : - name : Property name.
+//      - value : New value.
+//
+//-----------------------------------------------------------------------------
+void GpibDeviceServer::write_board_property(const char *name, Tango::DevShort value)
+{
+	if (Tango::Util::instance()->_UseDb == false)
+		return;
+		
+	Tango::DbData	data;
+	Tango::DbDatum	prop(board_property_name(name));
+	prop << value;
+	data.push_back(prop);
+	try
+	{
+		get_device_class()->get_db_class()->put_property(data);
+	}
+	catch (Tango::DevFailed &e)
+	{
+		ERROR_STREAM << "Cannot save " << name << " of " << gpibBoardName << endl;
+	}
+}
+
+
+//+----------------------------------------------------------------------------
+//
+// method : 		GpibDeviceServer::write_idn_cache()
+//
+// description : 	Save the last known answer of the device to "*IDN?"
+//			in the GpibCachedIdn property, when it changed.
+//
+// in : - idn : Answer of the device.
+//
+//-----------------------------------------------------------------------------
+void GpibDeviceServer::write_idn_cache(const string &idn)
+{
+	if ( (idn.length() == 0) || (idn == gpibCachedIdn) )
+		return;
+		
+	gpibCachedIdn = idn;
+	
+	if (Tango::Util::instance()->_UseDb == false)
+		return;
+		
+	Tango::DbData	data;
+	Tango::DbDatum	idn_prop("GpibCachedIdn");
+	idn_prop << gpibCachedIdn;
+	data.push_back(idn_prop);
+	try
+	{
+		get_db_device()->put_property(data);
+	}
+	catch (Tango::DevFailed &e)
+	{
+		ERROR_STREAM << "Cannot save *IDN? cache of " << device_name << endl;
+	}
+}
+
+
+//+----------------------------------------------------------------------------
+//
+// method : 		GpibDeviceServer::read_device_property()
+//
+// description : 	Read the device properties from database, without
+//			changing the device.
+//
+// out :		GpibDeviceProperties p : The property values
+//
+// returns :	false when both GpibDeviceName and GpibDeviceAddress
+//			are missing.
+//
+//-----------------------------------------------------------------------------
+bool GpibDeviceServer::read_device_property(GpibDeviceProperties &p)
+{
+	//	Initialize your default values here.
+	//------------------------------------------
+	p.gpibDeviceTimeOut = 13; 		/* 10s predefined value */
+	p.gpibDeviceAddress = 0xFF;		/* Unused set to zero	*/
+	p.gpibDeviceName = "";			/* Unused set to zero	*/
+	p.gpibDeviceSecondaryAddress = 0;		/* None			*/
+	p.gpibCachedOpenMethod = GPIB_OPEN_UNKNOWN;	/* Full search		*/
+	p.gpibCachedProbeMethod = GPIB_PROBE_UNKNOWN;	/* Full search		*/
+	p.gpibCachedIdn = "";
+	p.lazyOpen = false;				/* Open at init		*/
+	p.gpibDeviceEOS = -1;				/* Keep driver setting	*/
+	p.gpibDeviceEOT = -1;				/* Keep driver setting	*/
+	p.latencyAlarmP99.clear();			/* No alarm		*/
+	p.gpibBoardHS488 = -1;				/* Keep driver setting	*/
+	p.gpibBoardTiming = -1;				/* Keep driver setting	*/
+	p.gpibBoardDMA = -1;				/* Keep driver setting	*/
+	p.stickyAddressing = false;			/* UNT UNL after I/O	*/
+	
+	//	Read device properties from database.(Automatic code generation)
+	//-------------------------------------------------------------
+	Tango::DbData	dev_prop;
+	dev_prop.push_back(Tango::DbDatum("GpibDeviceName"));
+	dev_prop.push_back(Tango::DbDatum("GpibDeviceAddress"));
+	dev_prop.push_back(Tango::DbDatum("GpibDeviceTimeOut"));
+	dev_prop.push_back(Tango::DbDatum("GpibDeviceSecondaryAddress"));
+	dev_prop.push_back(Tango::DbDatum("GpibBoardName"));
+	dev_prop.push_back(Tango::DbDatum("GpibCachedOpenMethod"));
+	dev_prop.push_back(Tango::DbDatum("GpibCachedProbeMethod"));
+	dev_prop.push_back(Tango::DbDatum("GpibCachedIdn"));
+	dev_prop.push_back(Tango::DbDatum("LazyOpen"));
+	dev_prop.push_back(Tango::DbDatum("GpibDeviceEOS"));
+	dev_prop.push_back(Tango::DbDatum("GpibDeviceEOT"));
+	dev_prop.push_back(Tango::DbDatum("LatencyAlarmP99"));
+	dev_prop.push_back(Tango::DbDatum("GpibBoardHS488"));
+	dev_prop.push_back(Tango::DbDatum("GpibBoardTiming"));
+	dev_prop.push_back(Tango::DbDatum("GpibBoardDMA"));
+	dev_prop.push_back(Tango::DbDatum("StickyAddressing"));
+	
+	//	Call database and extract values
+	//--------------------------------------------
+	GpibDeviceServerClass	*ds_class =
+	    (static_cast<GpibDeviceServerClass *>(get_device_class()));
+	if (Tango::Util::instance()->_UseDb==true)
+	{
+		//	At startup, device_factory has already read them
+		if (ds_class->get_prefetched_property(device_name, dev_prop) == false)
+			get_db_device()->get_property(dev_prop);
+	}
+	Tango::DbDatum	def_prop, cl_prop;
+	int	i = -1;
+	
+	//      Try to initialize GpibDeviceName from class property
+	cl_prop = ds_class->get_class_property(dev_prop[++i].name);
+	if (cl_prop.is_empty()==false)	cl_prop  >>  p.gpibDeviceName;
+	else {
+		//      Try to initialize GpibDeviceName from default device value
+		def_prop = ds_class->get_default_device_property(dev_prop[i].name);
+		if (def_prop.is_empty()==false)	def_prop  >>  p.gpibDeviceName;
+	}
+	//	And try to extract GpibDeviceName value from database
+	if (dev_prop[i].is_empty()==false)	dev_prop[i]  >>  p.gpibDeviceName;
+	
+	//	Try to initialize GpibDeviceAddress from class property
+	cl_prop = ds_class->get_class_property(dev_prop[++i].name);
+	if (cl_prop.is_empty()==false)	cl_prop  >>  p.gpibDeviceAddress;
+	else {
+		//	Try to initialize GpibDeviceAddress from default device value
+		def_prop = ds_class->get_default_device_property(dev_prop[i].name);
+		if (def_prop.is_empty()==false)	def_prop  >>  p.gpibDeviceAddress;
+	}
+	//	And try to extract GpibDeviceAddress value from database
+	if (dev_prop[i].is_empty()==false)	dev_prop[i]  >>  p.gpibDeviceAddress;
+	
+	//	Try to initialize GpibDeviceTimeOut from class property
+	cl_prop = ds_class->get_class_property(dev_prop[++i].name);
+	if (cl_prop.is_empty()==false)	cl_prop  >>  p.gpibDeviceTimeOut;
+	else {
+		//	Try to initialize GpibDeviceTimeOut from default device value
+		def_prop = ds_class->get_default_device_property(dev_prop[i].name);
+		if (def_prop.is_empty()==false)	def_prop  >>  p.gpibDeviceTimeOut;
+	}
+	//	And try to extract GpibDeviceTimeOut value from database
+	if (dev_prop[i].is_empty()==false)	dev_prop[i]  >>  p.gpibDeviceTimeOut;
+	
+	//	Try to initialize GpibDeviceSecondaryAddress from class property
+	cl_prop = ds_class->get_class_property(dev_prop[++i].name);
+	if (cl_prop.is_empty()==false)	cl_prop  >>  p.gpibDeviceSecondaryAddress;
+	else {
+		//	Try to initialize GpibDeviceSecondaryAddress from default device value
+		def_prop = ds_class->get_default_device_property(dev_prop[i].name);
+		if (def_prop.is_empty()==false)	def_prop  >>  p.gpibDeviceSecondaryAddress;
+	}
+	//	And try to extract GpibDeviceSecondaryAddress value from database
+	if (dev_prop[i].is_empty()==false)	dev_prop[i]  >>  p.gpibDeviceSecondaryAddress;
+	
+	//	Try to initialize GpibBoardName from class property
+	cl_prop = ds_class->get_class_property(dev_prop[++i].name);
+	if (cl_prop.is_empty()==false)	cl_prop  >>  p.gpibBoardName;
+	else {
+		//	Try to initialize GpibBoardName from default device value
+		def_prop = ds_class->get_default_device_property(dev_prop[i].name);
+		if (def_prop.is_empty()==false)	def_prop  >>  p.gpibBoardName;
+	}
+	//	And try to extract GpibBoardName value from database
+	if (dev_prop[i].is_empty()==false)	dev_prop[i]  >>  p.gpibBoardName;
+
+	//	Try to initialize GpibCachedOpenMethod from class property
+	cl_prop = ds_class->get_class_property(dev_prop[++i].name);
+	if (cl_prop.is_empty()==false)	cl_prop  >>  p.gpibCachedOpenMethod;
+	else {
+		//	Try to initialize GpibCachedOpenMethod from default device value
+		def_prop = ds_class->get_default_device_property(dev_prop[i].name);
+		if (def_prop.is_empty()==false)	def_prop  >>  p.gpibCachedOpenMethod;
+	}
+	//	And try to extract GpibCachedOpenMethod value from database
+	if (dev_prop[i].is_empty()==false)	dev_prop[i]  >>  p.gpibCachedOpenMethod;
+
+	//	Try to initialize GpibCachedProbeMethod from class property
+	cl_prop = ds_class->get_class_property(dev_prop[++i].name);
+	if (cl_prop.is_empty()==false)	cl_prop  >>  p.gpibCachedProbeMethod;
+	else {
+		//	Try to initialize GpibCachedProbeMethod from default device value
+		def_prop = ds_class->get_default_device_property(dev_prop[i].name);
+		if (def_prop.is_empty()==false)	def_prop  >>  p.gpibCachedProbeMethod;
+	}
+	//	And try to extract GpibCachedProbeMethod value from database
+	if (dev_prop[i].is_empty()==false)	dev_prop[i]  >>  p.gpibCachedProbeMethod;
+
+	//	Try to initialize GpibCachedIdn from class property
+	cl_prop = ds_class->get_class_property(dev_prop[++i].name);
+	if (cl_prop.is_empty()==false)	cl_prop  >>  p.gpibCachedIdn;
+	else {
+		//	Try to initialize GpibCachedIdn from default device value
+		def_prop = ds_class->get_default_device_property(dev_prop[i].name);
+		if (def_prop.is_empty()==false)	def_prop  >>  p.gpibCachedIdn;
+	}
+	//	And try to extract GpibCachedIdn value from database
+	if (dev_prop[i].is_empty()==false)	dev_prop[i]  >>  p.gpibCachedIdn;
+
+	//	Try to initialize LazyOpen from class property
+	cl_prop = ds_class->get_class_property(dev_prop[++i].name);
+	if (cl_prop.is_empty()==false)	cl_prop  >>  p.lazyOpen;
+	else {
+		//	Try to initialize LazyOpen from default device value
+		def_prop = ds_class->get_default_device_property(dev_prop[i].name);
+		if (def_prop.is_empty()==false)	def_prop  >>  p.lazyOpen;
+	}
+	//	And try to extract LazyOpen value from database
+	if (dev_prop[i].is_empty()==false)	dev_prop[i]  >>  p.lazyOpen;
+
+	//	Try to initialize GpibDeviceEOS from class property
+	cl_prop = ds_class->get_class_property(dev_prop[++i].name);
+	if (cl_prop.is_empty()==false)	cl_prop  >>  p.gpibDeviceEOS;
+	else {
+		//	Try to initialize GpibDeviceEOS from default device value
+		def_prop = ds_class->get_default_device_property(dev_prop[i].name);
+		if (def_prop.is_empty()==false)	def_prop  >>  p.gpibDeviceEOS;
+	}
+	//	And try to extract GpibDeviceEOS value from database
+	if (dev_prop[i].is_empty()==false)	dev_prop[i]  >>  p.gpibDeviceEOS;
+
+	//	Try to initialize GpibDeviceEOT from class property
+	cl_prop = ds_class->get_class_property(dev_prop[++i].name);
+	if (cl_prop.is_empty()==false)	cl_prop  >>  p.gpibDeviceEOT;
+	else {
+		//	Try to initialize GpibDeviceEOT from default device value
+		def_prop = ds_class->get_default_device_property(dev_prop[i].name);
+		if (def_prop.is_empty()==false)	def_prop  >>  p.gpibDeviceEOT;
+	}
+	//	And try to extract GpibDeviceEOT value from database
+	if (dev_prop[i].is_empty()==false)	dev_prop[i]  >>  p.gpibDeviceEOT;
+
+	//	Try to initialize LatencyAlarmP99 from class property
+	cl_prop = ds_class->get_class_property(dev_prop[++i].name);
+	if (cl_prop.is_empty()==false)	cl_prop  >>  p.latencyAlarmP99;
+	else {
+		//	Try to initialize LatencyAlarmP99 from default device value
+		def_prop = ds_class->get_default_device_property(dev_prop[i].name);
+		if (def_prop.is_empty()==false)	def_prop  >>  p.latencyAlarmP99;
+	}
+	//	And try to extract LatencyAlarmP99 value from database
+	if (dev_prop[i].is_empty()==false)	dev_prop[i]  >>  p.latencyAlarmP99;
+
+	//	Try to initialize GpibBoardHS488 from class property
+	cl_prop = ds_class->get_class_property(dev_prop[++i].name);
+	if (cl_prop.is_empty()==false)	cl_prop  >>  p.gpibBoardHS488;
+	else {
+		//	Try to initialize GpibBoardHS488 from default device value
+		def_prop = ds_class->get_default_device_property(dev_prop[i].name);
+		if (def_prop.is_empty()==false)	def_prop  >>  p.gpibBoardHS488;
+	}
+	//	And try to extract GpibBoardHS488 value from database
+	if (dev_prop[i].is_empty()==false)	dev_prop[i]  >>  p.gpibBoardHS488;
+
+	//	Try to initialize GpibBoardTiming from class property
+	cl_prop = ds_class->get_class_property(dev_prop[++i].name);
+	if (cl_prop.is_empty()==false)	cl_prop  >>  p.gpibBoardTiming;
+	else {
+		//	Try to initialize GpibBoardTiming from default device value
+		def_prop = ds_class->get_default_device_property(dev_prop[i].name);
+		if (def_prop.is_empty()==false)	def_prop  >>  p.gpibBoardTiming;
+	}
+	//	And try to extract GpibBoardTiming value from database
+	if (dev_prop[i].is_empty()==false)	dev_prop[i]  >>  p.gpibBoardTiming;
+
+	//	Try to initialize GpibBoardDMA from class property
+	cl_prop = ds_class->get_class_property(dev_prop[++i].name);
+	if (cl_prop.is_empty()==false)	cl_prop  >>  p.gpibBoardDMA;
+	else {
+		//	Try to initialize GpibBoardDMA from default device value
+		def_prop = ds_class->get_default_device_property(dev_prop[i].name);
+		if (def_prop.is_empty()==false)	def_prop  >>  p.gpibBoardDMA;
+	}
+	//	And try to extract GpibBoardDMA value from database
+	if (dev_prop[i].is_empty()==false)	dev_prop[i]  >>  p.gpibBoardDMA;
+
+	//	Try to initialize StickyAddressing from class property
+	cl_prop = ds_class->get_class_property(dev_prop[++i].name);
+	if (cl_prop.is_empty()==false)	cl_prop  >>  p.stickyAddressing;
+	else {
+		//	Try to initialize StickyAddressing from default device value
+		def_prop = ds_class->get_default_device_property(dev_prop[i].name);
+		if (def_prop.is_empty()==false)	def_prop  >>  p.stickyAddressing;
+	}
+	//	And try to extract StickyAddressing value from database
+	if (dev_prop[i].is_empty()==false)	dev_prop[i]  >>  p.stickyAddressing;
+	
+	
+	
+	//	End of Automatic code generation
+	//-------------------------------------------------------------
+	
+	//	The device name or address is mandatory.
+	return ( (dev_prop[0].is_empty() == false) || (dev_prop[1].is_empty() == false) );
+}
+
+
+//+----------------------------------------------------------------------------
+//
+// method : 		GpibDeviceServer::readDeviceProperies()
+//
+// description : 	Read the device properties from database.
+//
+//-----------------------------------------------------------------------------
+void GpibDeviceServer::get_device_property()
+{
+	GpibDeviceProperties	p;
+	
+	if (read_device_property(p) == false)
+	{
+		cout << "Mandatory properties 'gpibDeviceName' and 'gpibDeviceAddress' are not defined" << endl;
+		cout << "in the Database. Please define at least one of them. Exiting." << endl;
+		exit(-1);
+	}
+	set_device_property(p);
+}
+
+
+//+----------------------------------------------------------------------------
+//
+// method : 		GpibDeviceServer::set_device_property()
+//
+// description : 	Give the values read by read_device_property() to
+//			the device.
+//
+//-----------------------------------------------------------------------------
+void GpibDeviceServer::set_device_property(const GpibDeviceProperties &p)
+{
+	gpibDeviceName = p.gpibDeviceName;
+	gpibDeviceAddress = p.gpibDeviceAddress;
+	gpibDeviceTimeOut = p.gpibDeviceTimeOut;
+	gpibDeviceSecondaryAddress = p.gpibDeviceSecondaryAddress;
+	gpibBoardName = p.gpibBoardName;
+	gpibCachedOpenMethod = p.gpibCachedOpenMethod;
+	gpibCachedProbeMethod = p.gpibCachedProbeMethod;
+	gpibCachedIdn = p.gpibCachedIdn;
+	lazyOpen = p.lazyOpen;
+	gpibDeviceEOS = p.gpibDeviceEOS;
+	gpibDeviceEOT = p.gpibDeviceEOT;
+	latencyAlarmP99 = p.latencyAlarmP99;
+	gpibBoardHS488 = p.gpibBoardHS488;
+	gpibBoardTiming = p.gpibBoardTiming;
+	gpibBoardDMA = p.gpibBoardDMA;
+	stickyAddressing = p.stickyAddressing;
+}
+
+
+//+----------------------------------------------------------------------------
+//
+// method : 		GpibDeviceServer::always_executed_hook()
+//
+// description : 	method always executed before any command is executed
+//
+//-----------------------------------------------------------------------------
+void GpibDeviceServer::always_executed_hook()
+{
+	HookStamp stamp;
+	short sb;
+	
+	// Device still opened in background: report INIT, do not probe it.
+	{
+		omni_mutex_lock lock(open_mutex);
+		if (open_pending == true)
+			return;
+	}
+	
+	// Device not opened yet (LazyOpen): State and Status must not open it.
+	if (lazy_pending == true)
+		return;
+	
+	if ( (board0 != NULL) && (gpib_device != NULL) && (dev_open == true) )
+	{
+		// Driver calls of this command are traced from here.
+		gpib_device->setRequestStart(gpibClock());
+		try
+		{
+			sb = gpib_device->isAlive(); 		// Try to get Status byte
+			string alarm;
+			if ( (sb != 0) && check_latency_alarm(alarm) )
+			{
+				set_state(Tango::ALARM);
+				set_status(alarm);
+			}
+			else if (sb != 0)
+			{
+				set_state(Tango::ON);
+				set_status("GPIB Device is On.");
+			}
+			else
+			{
+				set_state(Tango::FAULT);
+				set_status("GPIB Device is Off.");
+			}
+		}
+		catch (gpibDeviceException e)
+		{
+			set_state(Tango::FAULT);
+			set_status("GPIB Device is not responding.");
+		}
+	}
+	else
+	{
+		Tango::Except::throw_exception(
+		    (const char *) ("gpibDeviceException on	"+ gpibDeviceName).c_str(),
+		    (const char *) "This device is not reachable by server : maybe is the device off ?",
+		    (const char *) "An error occurs when looking for device.",
+		    Tango::ERR
+		);
+	}
+}
+
+
+//+----------------------------------------------------------------------------
+//
+// method : 		GpibDeviceServer::command_inout_4
+// 
+// description : 	Command request entry point of Tango clients (IDL 4).
+//			The call is timed around the Tango implementation,
+//			which takes the serialization lock, runs
+//			always_executed_hook() and the command, to split it in
+//			GpibStage for the latency breakdown. The CORBA dispatch
+//			and marshaling are outside: they are the difference
+//			between the client latency and the total stage.
+//
+//-----------------------------------------------------------------------------
+CORBA::Any *GpibDeviceServer::command_inout_4(const char *in_cmd, const CORBA::Any &in_data,
+                                              Tango::DevSource source, const Tango::ClntIdent &cl_ident)
+{
+	long long t0 = gpibClock();
+	long long io0 = gpibThreadIoTime();
+	CORBA::Any *out;
+	
+	hook_start = 0;
+	try
+	{
+		out = Tango::Device_4Impl::command_inout_4(in_cmd, in_data, source, cl_ident);
+	}
+	catch (...)
+	{
+		record_breakdown(in_cmd, t0, io0);
+		save_hs488_fallback();
+		throw;
+	}
+	record_breakdown(in_cmd, t0, io0);
+	save_hs488_fallback();
+	return out;
+}
+
+
+//+----------------------------------------------------------------------------
+//
+// method : 		GpibDeviceServer::save_hs488_fallback
+// 
+// description : 	When a transfer error of the command put the board
+//			back to the standard handshake (gpibHS488Fallback), save
+//			it in the GpibBoardHS488 class property of the board,
+//			as BCTestHS488 does: the next Init must not enable
+//			HS488 again.
+//
+//-----------------------------------------------------------------------------
+void GpibDeviceServer::save_hs488_fallback()
+{
+	if (gpibHS488Fallback() < 0)
+		return;
+	WARN_STREAM << "HS488 disabled on " << gpibBoardName << " after a transfer error" << endl;
+	write_board_property("GpibBoardHS488", 0);
+}
+
+
+//+----------------------------------------------------------------------------
+//
+// method : 		GpibDeviceServer::record_breakdown
+// 
+// description : 	Record the stages of the command which started at t0,
+//			with the thread driver call time io0. Commands which do
+//			not run always_executed_hook() only get io, other and
+//			total.
+//
+//-----------------------------------------------------------------------------
+void GpibDeviceServer::record_breakdown(const char *cmd, long long t0, long long io0)
+{
+	long long t1 = gpibClock();
+	long long ns[GPIB_NB_STAGE];
+	
+	ns[GPIB_STAGE_TOTAL] = t1 - t0;
+	if ( (hook_start >= t0) && (hook_end >= hook_start) )
+	{
+		ns[GPIB_STAGE_WAIT] = hook_start - t0;
+		ns[GPIB_STAGE_PROBE] = hook_end - hook_start;
+		ns[GPIB_STAGE_IO] = gpibThreadIoTime() - hook_io;
+	}
+	else
+	{
+		ns[GPIB_STAGE_WAIT] = 0;
+		ns[GPIB_STAGE_PROBE] = 0;
+		ns[GPIB_STAGE_IO] = gpibThreadIoTime() - io0;
+	}
+	ns[GPIB_STAGE_OTHER] = ns[GPIB_STAGE_TOTAL] - ns[GPIB_STAGE_WAIT]
+	                       - ns[GPIB_STAGE_PROBE] - ns[GPIB_STAGE_IO];
+	if (ns[GPIB_STAGE_OTHER] < 0)
+		ns[GPIB_STAGE_OTHER] = 0;
+	
+	// Tango command names are not case sensitive.
+	string key(cmd);
+	transform(key.begin(), key.end(), key.begin(), ::tolower);
+	
+	omni_mutex_lock lock(breakdown_mutex);
+	map<string, GpibBreakdown>::iterator b = breakdown.find(key);
+	if (b == breakdown.end())
+	{
+		if (breakdown_order.size() >= GPIB_MAX_BREAKDOWN)
+			return;
+		b = breakdown.insert(make_pair(key, GpibBreakdown())).first;
+		b->second.command = cmd;
+		breakdown_order.push_back(key);
+	}
+	for (int s = 0; s < GPIB_NB_STAGE; s++)
+		b->second.stage[s].record(ns[s] / 1000);
+}
+
+
+//+----------------------------------------------------------------------------
+//
+// method : 		GpibDeviceServer::read_attr_hardware
+// 
+// description : 	Hardware acquisition for attributes.
+//
+//-----------------------------------------------------------------------------
+void GpibDeviceServer::read_attr_hardware(vector<long> &attr_list)
+{
+	GPIB_DEBUG_STREAM << "GpibDeviceServer::read_attr_hardware(vector<long> &attr_list) entering... "<< endl;
+	//	Add your own code here
+}
+
+
+//+----------------------------------------------------------------------------
+//
+// method : 		GpibDeviceServer::read_LatencyHistogram
+// 
+// description : 	Extract real attribute values for <op>LatencyHistogram
+//			acquisition result. The spectrum stops at the last
+//			non empty bucket.
+//
+//-----------------------------------------------------------------------------
+void GpibDeviceServer::read_LatencyHistogram(Tango::Attribute &attr, int op)
+{
+	GPIB_DEBUG_STREAM << "GpibDeviceServer::read_LatencyHistogram(Tango::Attribute &attr) entering... "<< endl;
+	
+	gpibHistogram &h = latency.hist[op];
+	long n = 0;
+	for (int b = 0; b < GPIB_HIST_BUCKETS; b++)
+	{
+		attr_LatencyHistogram_read[op][b] = (Tango::DevLong64) h.bucketCount(b);
+		if (attr_LatencyHistogram_read[op][b] != 0)
+			n = b + 1;
+	}
+	attr.set_value(attr_LatencyHistogram_read[op], n);
+}
+
+
+//+----------------------------------------------------------------------------
+//
+// method : 		GpibDeviceServer::read_LatencyBuckets
+// 
+// description : 	Extract real attribute values for LatencyBuckets
+//			acquisition result.
+//
+//-----------------------------------------------------------------------------
+void GpibDeviceServer::read_LatencyBuckets(Tango::Attribute &attr)
+{
+	GPIB_DEBUG_STREAM << "GpibDeviceServer::read_LatencyBuckets(Tango::Attribute &attr) entering... "<< endl;
+	attr.set_value(attr_LatencyBuckets_read, GPIB_HIST_BUCKETS);
+}
+
+
+//+----------------------------------------------------------------------------
+//
+// method : 		GpibDeviceServer::read_Counter
+// 
+// description : 	Extract real attribute values for a counter of the
+//			device or of its board. The counters are not reset:
+//			they count since the server start.
+//
+//-----------------------------------------------------------------------------
+void GpibDeviceServer::read_Counter(Tango::Attribute &attr, int counter, bool board)
+{
+	GPIB_DEBUG_STREAM << "GpibDeviceServer::read_Counter(Tango::Attribute &attr) entering... "<< endl;
+	
+	gpibCounters *c = (board == true) ? get_board_counters() : &counters;
+	attr_Counter_read[board][counter] = (c != NULL) ? (Tango::DevLong64) c->get(counter) : 0;
+	attr.set_value(&attr_Counter_read[board][counter]);
+}
+
+
+//+----------------------------------------------------------------------------
+//
+// method : 		GpibDeviceServer::read_ErrorCounts
+// 
+// description : 	Extract real attribute values for ErrorCounts or
+//			BoardErrorCounts, indexed by iberr.
+//
+//-----------------------------------------------------------------------------
+void GpibDeviceServer::read_ErrorCounts(Tango::Attribute &attr, bool board)
+{
+	GPIB_DEBUG_STREAM << "GpibDeviceServer::read_ErrorCounts(Tango::Attribute &attr) entering... "<< endl;
+	
+	gpibCounters *c = (board == true) ? get_board_counters() : &counters;
+	for (int e = 0; e < GPIB_NB_IBERR; e++)
+		attr_ErrorCounts_read[board][e] = (c != NULL) ? (Tango::DevLong64) c->getError(e) : 0;
+	attr.set_value(attr_ErrorCounts_read[board], GPIB_NB_IBERR);
+}
+
+
+//+----------------------------------------------------------------------------
+//
+// method : 		GpibDeviceServer::read_BreakdownCommands
+// 
+// description : 	Extract real attribute values for BreakdownCommands
+//			acquisition result.
+//
+//-----------------------------------------------------------------------------
+void GpibDeviceServer::read_BreakdownCommands(Tango::Attribute &attr)
+{
+	GPIB_DEBUG_STREAM << "GpibDeviceServer::read_BreakdownCommands(Tango::Attribute &attr) entering... "<< endl;
+	
+	omni_mutex_lock lock(breakdown_mutex);
+	long n = breakdown_order.size();
+	Tango::DevString *names = new Tango::DevString[n];
+	for (long i = 0; i < n; i++)
+		names[i] = CORBA::string_dup(breakdown[breakdown_order[i]].command.c_str());
+	attr.set_value(names, n, 0, true);
+}
+
+
+//+----------------------------------------------------------------------------
+//
+// method : 		GpibDeviceServer::read_BreakdownCount
+// 
+// description : 	Extract real attribute values for BreakdownCount
+//			acquisition result.
+//
+//-----------------------------------------------------------------------------
+void GpibDeviceServer::read_BreakdownCount(Tango::Attribute &attr)
+{
+	GPIB_DEBUG_STREAM << "GpibDeviceServer::read_BreakdownCount(Tango::Attribute &attr) entering... "<< endl;
+	
+	omni_mutex_lock lock(breakdown_mutex);
+	long n = breakdown_order.size();
+	for (long i = 0; i < n; i++)
+		attr_BreakdownCount_read[i] =
+		    (Tango::DevLong64) breakdown[breakdown_order[i]].stage[GPIB_STAGE_TOTAL].count();
+	attr.set_value(attr_BreakdownCount_read, n);
+}
+
+
+//+----------------------------------------------------------------------------
+//
+// method : 		GpibDeviceServer::read_BreakdownMean
+// 
+// description : 	Extract real attribute values for BreakdownMean
+//			acquisition result.
+//
+//-----------------------------------------------------------------------------
+void GpibDeviceServer::read_BreakdownMean(Tango::Attribute &attr)
+{
+	GPIB_DEBUG_STREAM << "GpibDeviceServer::read_BreakdownMean(Tango::Attribute &attr) entering... "<< endl;
+	
+	omni_mutex_lock lock(breakdown_mutex);
+	long n = breakdown_order.size();
+	for (long i = 0; i < n; i++)
+	{
+		GpibBreakdown &b = breakdown[breakdown_order[i]];
+		for (int s = 0; s < GPIB_NB_STAGE; s++)
+			attr_BreakdownMean_read[i * GPIB_NB_STAGE + s] = b.stage[s].mean();
+	}
+	attr.set_value(attr_BreakdownMean_read, GPIB_NB_STAGE, n);
+}
+
+
+//+----------------------------------------------------------------------------
+//
+// method : 		GpibDeviceServer::read_BreakdownP99
+// 
+// description : 	Extract real attribute values for BreakdownP99
+//			acquisition result.
+//
+//-----------------------------------------------------------------------------
+void GpibDeviceServer::read_BreakdownP99(Tango::Attribute &attr)
+{
+	GPIB_DEBUG_STREAM << "GpibDeviceServer::read_BreakdownP99(Tango::Attribute &attr) entering... "<< endl;
+	
+	omni_mutex_lock lock(breakdown_mutex);
+	long n = breakdown_order.size();
+	for (long i = 0; i < n; i++)
+	{
+		GpibBreakdown &b = breakdown[breakdown_order[i]];
+		for (int s = 0; s < GPIB_NB_STAGE; s++)
+			attr_BreakdownP99_read[i * GPIB_NB_STAGE + s] = (Tango::DevDouble) b.stage[s].percentile(99.0);
+	}
+	attr.set_value(attr_BreakdownP99_read, GPIB_NB_STAGE, n);
+}
+
+//+----------------------------------------------------------------------------
+//
+// method : 		GpibDeviceServer::read_ServiceRequestMask
+// 
+// description : 	Extract real attribute values for ServiceRequestMask
+//			acquisition result.
+//
+//-----------------------------------------------------------------------------
+void GpibDeviceServer::read_ServiceRequestMask(Tango::Attribute &attr)
+{
+	GPIB_DEBUG_STREAM << "GpibDeviceServer::read_ServiceRequestMask(Tango::Attribute &attr) entering... "<< endl;
+	attr.set_value(&attr_ServiceRequestMask_read);
+}
+
+//+----------------------------------------------------------------------------
+//
+// method : 		GpibDeviceServer::read_ParallelPoll
+// 
+// description : 	Extract real attribute values for ParallelPoll acquisition
+//			result: the last byte of the fast poll while it runs,
+//			else of BCParallelPoll. The date is the poll time.
+//
+//-----------------------------------------------------------------------------
+void GpibDeviceServer::read_ParallelPoll(Tango::Attribute &attr)
+{
+	GPIB_DEBUG_STREAM << "GpibDeviceServer::read_ParallelPoll(Tango::Attribute &attr) entering... "<< endl;
+	
+	long long t = ppoll_time;
+	if (fast_poll != NULL)
+	{
+		int    r;
+		string error;
+		fast_poll->get(r, t, error);
+		if (r < 0)
+			t = 0;
+		else
+			attr_ParallelPoll_read = r;
+	}
+	if (t == 0)
+	{
+		attr.set_quality(Tango::ATTR_INVALID);
+		return;
+	}
+	
+	double        w = wall_time(t);
+	Tango::TimeVal tv;
+	tv.tv_sec = (long) w;
+	tv.tv_usec = (long) ((w - tv.tv_sec) * 1e6);
+	tv.tv_nsec = 0;
+	attr.set_value(&attr_ParallelPoll_read);
+	attr.set_date(tv);
+}
+
+//+----------------------------------------------------------------------------
+//
+// method : 		GpibDeviceServer::read_BusUtilization
+// 
+// description : 	Extract real attribute values for BusUtilization
+//			acquisition result: busy time of the bus during the
+//			last monitor period, %. Invalid if the monitor is not
+//			running or cannot read the bus.
+//
+//-----------------------------------------------------------------------------
+void GpibDeviceServer::read_BusUtilization(Tango::Attribute &attr)
+{
+	GPIB_DEBUG_STREAM << "GpibDeviceServer::read_BusUtilization(Tango::Attribute &attr) entering... "<< endl;
+	
+	gpibMonitorStats stats;
+	string           error;
+	if (bus_monitor != NULL)
+		bus_monitor->getStats(stats, error);
+	if ( (bus_monitor == NULL) || (error.length() > 0) )
+	{
+		attr.set_quality(Tango::ATTR_INVALID);
+		return;
+	}
+	attr_BusUtilization_read = stats.utilization * 100.0;
+	attr.set_value(&attr_BusUtilization_read);
+}
+
+//+----------------------------------------------------------------------------
+//
+// method : 		GpibDeviceServer::read_Bandwidth
+// 
+// description : 	Extract real attribute values for TalkerBandwidth or
+//			ListenerBandwidth, indexed by primary address (last
+//			index: talker or listener unknown).
+//
+//-----------------------------------------------------------------------------
+void GpibDeviceServer::read_Bandwidth(Tango::Attribute &attr, bool listener)
+{
+	GPIB_DEBUG_STREAM << "GpibDeviceServer::read_Bandwidth(Tango::Attribute &attr) entering... "<< endl;
+	
+	gpibMonitorStats stats;
+	string           error;
+	if (bus_monitor != NULL)
+		bus_monitor->getStats(stats, error);
+	if ( (bus_monitor == NULL) || (error.length() > 0) )
+	{
+		attr.set_quality(Tango::ATTR_INVALID);
+		return;
+	}
+	double *rate = (listener == true) ? stats.listener_rate : stats.talker_rate;
+	for (int a = 0; a < GPIB_MONITOR_ADDRS; a++)
+		attr_Bandwidth_read[listener][a] = rate[a];
+	attr.set_value(attr_Bandwidth_read[listener], GPIB_MONITOR_ADDRS);
+}
+
+
+//+------------------------------------------------------------------
+/**
+*	method:	GpibDeviceServer::write
+*
+*	description:	method to execute "Write"
 *	This command send a string to the device. Throws devFailed on error.
 *
-* @param	argin	String to send to the device
+* @param	argin	String to send to the device
+*
+*/
+//+------------------------------------------------------------------
+void GpibDeviceServer::write(Tango::DevString argin)
+{
+	GPIB_DEBUG_STREAM << "GpibDeviceServer::write(): entering... !" << endl;
+	
+	//	Add your own code to control device here
+	
+	throwExceptionIfDeviceIsClosed();
+	
+	try
+	{
+		gpib_device->write(argin);
+	}
+	catch (gpibDeviceException e)
+	{
+		GPIB_DEBUG_STREAM << "Write command error on " << e.getDeviceName() << endl;
+		Tango::Except::throw_exception(
+		    (const char *) ("gpibDeviceException on " + e.getDeviceName() ).c_str(),
+		    (const char *) e.getiberrMessage().c_str(),
+		    (const char *) e.getibstaMessage().c_str(),
+		    Tango::ERR
+		);
+	}
+}
+
+
+//+------------------------------------------------------------------
+/**
+*	method:	GpibDeviceServer::read
+*
+*	description:	method to execute "Read"
+*	This command reads a string from a gpib device. 
+*      Throws an DevFailed exception on error
+*
+* @return	Returned string.
+*
+*/
+//+------------------------------------------------------------------
+Tango::DevString GpibDeviceServer::read()
+{
+	//	POGO has generated a method core with argout allocation.
+	//	If you would like to use a static reference without copying,
+	//	See "TANGO Device Server Programmer's Manual"
+	//		(chapter : Writing a TANGO DS / Exchanging data)
+	//------------------------------------------------------------
+	Tango::DevString	argout  = new char[RD_BUFFER_SIZE+1]; // AJOUT +1
+	string ret = "";
+	GPIB_DEBUG_STREAM << "GpibDeviceServer::read(): entering... !" << endl;
+	
+	//	Add your own code to control device here
+	
+	try
+	{
+		throwExceptionIfDeviceIsClosed();
+	}
+	catch (Tango::DevFailed &e)
+	{
+		delete[] argout;
+		throw;
+	}
+	
+	try
+	{
+		ret = gpib_device->read();
+		memset(argout,0, (RD_BUFFER_SIZE+1));   // AJOUT +1
+		strcpy(argout, ret.c_str() );
+	}
+	catch (gpibDeviceException e)
+	{
+		GPIB_DEBUG_STREAM << "Read command error on " << e.getDeviceName() << endl;
+		delete[] argout;
+		//cout << "Read error: err="<< e.getErrorValue()<<" state="<< e.getStateValue() << endl;
+		Tango::Except::throw_exception(
+		    (const char *) ("gpibDeviceException on " + e.getDeviceName() ).c_str(),
+		    (const char *) e.getiberrMessage().c_str(),
+		    (const char *) e.getibstaMessage().c_str(),
+		    Tango::ERR
+		);
+	}
+	return argout;
+}
+
+
+//+------------------------------------------------------------------
+/**
+*	method:	GpibDeviceServer::close
+*
+*	description:	method to execute "Close"
+*	Close a previously opened gpib device.
+*	Throws exception on error.
+*
+*
+*/
+//+------------------------------------------------------------------
+void GpibDeviceServer::close()
+{
+	GPIB_DEBUG_STREAM << "GpibDeviceServer::close(): entering... !" << endl;
+	
+	//	Add your own code to control device here
+	
+	throwExceptionIfDeviceIsClosed();
+	
+	try
+	{
+		gpib_device->setOffLine();
+		if(gpib_device)
+		{
+			delete gpib_device;
+			gpib_device = NULL;
+		}
+		dev_open = false;
+		set_state(Tango::OFF);
+		
+	} catch (gpibDeviceException e) {
+	
+		GPIB_DEBUG_STREAM << "Close command error on " << e.getDeviceName() << endl;
+		Tango::Except::throw_exception(
+		    (const char *) ("gpibDeviceException on " + e.getDeviceName() ).c_str(),
+		    (const char *) e.getiberrMessage().c_str(),
+		    (const char *) e.getibstaMessage().c_str(),
+		    Tango::ERR
+		);
+	}
+}
+
+
+//+------------------------------------------------------------------
+/**
+*	method:	GpibDeviceServer::read_long_string
+*
+*	description:	method to execute "ReadLongString"
+*	For most gpib device the read command is enough to talk with the device.
+*      In certain case, the gpibDevice returns a very big string, which is
+*      larger than the read buffer. For concret example, 
+*      on :CALC:DATA? command, the hp3588 returns 400 strings representing a
+*	spectrum, for a total size > 4Kbytes. This method reads these sort of 
+*      long string.
+*	For efficiency, its better to use the read command instead of 
+*      readLongString. This method is provided for exceptionnal case. 
+*      Throws DevFailed on error.
+*
+* @param	argin	Max expected string length.
+* @return	The readed string.
+*
+*/
+//+------------------------------------------------------------------
+Tango::DevString GpibDeviceServer::read_long_string(Tango::DevLong argin)
+{
+	//	POGO has generated a method core with argout allocation.
+	//	If you would like to use a static reference without copying,
+	//	See "TANGO Device Server Programmer's Manual"
+	//		(chapter : Writing a TANGO DS / Exchanging data)
+	//------------------------------------------------------------
+	Tango::DevString	argout  = new char[argin];
+	string ret = "";
+	GPIB_DEBUG_STREAM << "GpibDeviceServer::read_long_string(): entering... !" << endl;
+	
+	//	Add your own code to control device here
+	
+	try
+	{
+		throwExceptionIfDeviceIsClosed();
+	}
+	catch (Tango::DevFailed &e)
+	{
+		delete[] argout;
+		throw;
+	}
+	
+	try
+	{
+		ret = gpib_device->read(argin);
+		strcpy(argout, ret.c_str() );
+		
+	} catch (gpibDeviceException e) {
+	
+		GPIB_DEBUG_STREAM << "ReadLongString command error on " << e.getDeviceName() << endl;
+		delete[] argout;
+		Tango::Except::throw_exception(
+		    (const char *) ("gpibDeviceException on " + e.getDeviceName() ).c_str(),
+		    (const char *) e.getiberrMessage().c_str(),
+		    (const char *) e.getibstaMessage().c_str(),
+		    Tango::ERR
+		);
+	}
+	return argout;
+}
+
+
+//+------------------------------------------------------------------
+/**
+*	method:	GpibDeviceServer::get_name
+*
+*	description:	method to execute "GetName"
+*	Return the gpib device name, as defined on the gpib Driver 
+*      (see them with ibconf tool).
+*	Throws DevFailed on error
+*
+* @return	gpib device name
+*
+*/
+//+------------------------------------------------------------------
+Tango::DevString GpibDeviceServer::get_name()
+{
+	//	POGO has generated a method core with argout allocation.
+	//	If you would like to use a static reference without copying,
+	//	See "TANGO Device Server Programmer's Manual"
+	//		(chapter : Writing a TANGO DS / Exchanging data)
+	//------------------------------------------------------------
+	Tango::DevString	argout  = new char[RD_BUFFER_SIZE+1]; // AJOUT +1
+	string ret = "";
+	GPIB_DEBUG_STREAM << "GpibDeviceServer::get_name(): entering... !" << endl;
+	
+	//	Add your own code to control device here
+	
+	try
+	{
+		throwExceptionIfDeviceIsClosed();
+	}
+	catch (Tango::DevFailed &e)
+	{
+		delete[] argout;
+		throw;
+	}
+	
+	try
+	{
+		ret = gpib_device->getName();
+		memset(argout,0, (RD_BUFFER_SIZE+1));  // AJOUT +1
+		strcpy(argout, ret.c_str() );
+		
+	} catch (gpibDeviceException e) {
+	
+		GPIB_DEBUG_STREAM << "getName command error on " << e.getDeviceName() << endl;
+		delete[] argout;
+		Tango::Except::throw_exception(
+		    (const char *) ("gpibDeviceException on " + e.getDeviceName() ).c_str(),
+		    (const char *) e.getiberrMessage().c_str(),
+		    (const char *) e.getibstaMessage().c_str(),
+		    Tango::ERR
+		);
+	}
+	return argout;
+}
+
+
+//+------------------------------------------------------------------
+/**
+*	method:	GpibDeviceServer::local
+*
+*	description:	method to execute "Local"
+*	Set the gpib device in local mode. Throws DevFailed on error.
+*
+*
+*/
+//+------------------------------------------------------------------
+void GpibDeviceServer::local()
+{
+	GPIB_DEBUG_STREAM << "GpibDeviceServer::local(): entering... !" << endl;
+	
+	//	Add your own code to control device here
+	
+	throwExceptionIfDeviceIsClosed();
+	
+	try
+	{
+		gpib_device->goToLocalMode();
+		
+	} catch (gpibDeviceException e) {
+	
+		GPIB_DEBUG_STREAM << "Local command error on " << e.getDeviceName() << endl;
+		Tango::Except::throw_exception(
+		    (const char *) ("gpibDeviceException on " + e.getDeviceName() ).c_str(),
+		    (const char *) e.getiberrMessage().c_str(),
+		    (const char *) e.getibstaMessage().c_str(),
+		    Tango::ERR
+		);
+	}
+}
+
+
+//+------------------------------------------------------------------
+/**
+*	method:	GpibDeviceServer::remote
+*
+*	description:	method to execute "Remote"
+*	Set the gpib device in remote mode. This command is here for 
+*      compatibility, since network access to a gpib Device will 
+*      automatically turn it to remote mode.
+*	Throws DevFailed on error.
+*
+*
+*/
+//+------------------------------------------------------------------
+void GpibDeviceServer::remote()
+{
+	GPIB_DEBUG_STREAM << "GpibDeviceServer::remote(): entering... !" << endl;
+	
+	//	Add your own code to control device here
+	
+	throwExceptionIfDeviceIsClosed();
+	
+	try
+	{
+		gpib_device->goToRemoteMode();
+		
+	} catch (gpibDeviceException e) {
+	
+		GPIB_DEBUG_STREAM << "Remote command error on " << e.getDeviceName() << endl;
+		Tango::Except::throw_exception(
+		    (const char *) ("gpibDeviceException on " + e.getDeviceName() ).c_str(),
+		    (const char *) e.getiberrMessage().c_str(),
+		    (const char *) e.getibstaMessage().c_str(),
+		    Tango::ERR
+		);
+	}
+}
+
+
+//+------------------------------------------------------------------
+/**
+*	method:	GpibDeviceServer::getiberr
+*
+*	description:	method to execute "Getiberr"
+*	This command returns last gpib device error code (lib gpib iberr).
+*	Throws DevFailed on error.
+*
+* @return	no argout
+*
+*/
+//+------------------------------------------------------------------
+Tango::DevLong GpibDeviceServer::getiberr()
+{
+	Tango::DevLong	argout ;
+	GPIB_DEBUG_STREAM << "GpibDeviceServer::getiberr(): entering... !" << endl;
+	
+	//	Add your own code to control device here
+	
+	throwExceptionIfDeviceIsClosed();
+	
+	argout = gpib_device->getiberr(); // This is soft command. No gpibDeviceException here.
+	return argout;
+}
+
+
+//+------------------------------------------------------------------
+/**
+*	method:	GpibDeviceServer::getibsta
+*
+*	description:	method to execute "Getibsta"
+*	This command returns last gpib device state code (lib gpib ibsta).
+*	Throws DevFailed on error.
+*
+* @return	no argout
+*
+*/
+//+------------------------------------------------------------------
+Tango::DevLong GpibDeviceServer::getibsta()
+{
+	Tango::DevLong	argout ;
+	GPIB_DEBUG_STREAM << "GpibDeviceServer::getibsta(): entering... !" << endl;
+	
+	//	Add your own code to control device here
+	throwExceptionIfDeviceIsClosed();
+	argout = gpib_device->getibsta(); // This is soft command. No gpibDeviceException here.
+	return argout;
+}
+
+
+//+------------------------------------------------------------------
+/**
+*	method:	GpibDeviceServer::getibcnt
+*
+*	description:	method to execute "Getibcnt"
+*	This command returns last gpib device count var (lib gpib ibcnt).
+*	Throws DevFailed on error.
+*
+* @return	no argout
+*
+*/
+//+------------------------------------------------------------------
+Tango::DevULong GpibDeviceServer::getibcnt()
+{
+	Tango::DevULong	argout ;
+	GPIB_DEBUG_STREAM << "GpibDeviceServer::getibcnt(): entering... !" << endl;
+	
+	//	Add your own code to control device here
+	
+	throwExceptionIfDeviceIsClosed();
+	argout = gpib_device->getibcnt(); // This is soft command. No gpibDeviceException here.
+	return argout;
+}
+
+
+//+------------------------------------------------------------------
+/**
+*	method:	GpibDeviceServer::clear
+*
+*	description:	method to execute "Clear"
+*	This command clears the gpib device. Throws DevFailed exception on error.
+*
+*
+*/
+//+------------------------------------------------------------------
+void GpibDeviceServer::clear()
+{
+	GPIB_DEBUG_STREAM << "GpibDeviceServer::clear(): entering... !" << endl;
+	
+	//	Add your own code to control device here
+	
+	throwExceptionIfDeviceIsClosed();
+	
+	try
+	{
+		gpib_device->clear();
+		
+	} catch (gpibDeviceException e) {
+		GPIB_DEBUG_STREAM << "Clear command error on " << e.getDeviceName() << endl;
+		Tango::Except::throw_exception(
+		    (const char *) ("gpibDeviceException on " + e.getDeviceName() ).c_str(),
+		    (const char *) e.getiberrMessage().c_str(),
+		    (const char *) e.getibstaMessage().c_str(),
+		    Tango::ERR
+		);
+	}
+}
+
+
+//+------------------------------------------------------------------
+/**
+*	method:	GpibDeviceServer::set_time_out
+*
+*	description:	method to execute "SetTimeOut"
+*	This command set Time Out value for the gpib device.
+*	Warning these values are predefined, cf gpibDevice.h
+*	accepted value are [0-15]. Throws DevFailed exception on error.
+*
+* @param	argin	accepted value are [0-15]
+*
+*/
+//+------------------------------------------------------------------
+void GpibDeviceServer::set_time_out(Tango::DevShort argin)
+{
+	GPIB_DEBUG_STREAM << "GpibDeviceServer::set_time_out(): entering... !" << endl;
+	
+	//	Add your own code to control device here
+	
+	throwExceptionIfDeviceIsClosed();
+	
+	try
+	{
+		gpib_device->setTimeOut(argin);
+		
+	} catch (gpibDeviceException e) {
+		GPIB_DEBUG_STREAM << "SetTimeOut command error on " << e.getDeviceName() << endl;
+		Tango::Except::throw_exception(
+		    (const char *) ("gpibDeviceException on " + e.getDeviceName() ).c_str(),
+		    (const char *) e.getiberrMessage().c_str(),
+		    (const char *) e.getibstaMessage().c_str(),
+		    Tango::ERR
+		);
+	}
+}
+
+
+//+------------------------------------------------------------------
+/**
+*	method:	GpibDeviceServer::bcsend_ifc
+*
+*	description:	method to execute "BCsendIFC"
+*	This commands send IFC to the gpib Board0.
+*	So the board becomes Controller In Charge and devices are cleared.
+*	All commands beginning with'BC' are Board Commands.
+*	Throws DevFailed exception on error.
+*
+*
+*/
+//+------------------------------------------------------------------
+void GpibDeviceServer::bcsend_ifc()
+{
+	GPIB_DEBUG_STREAM << "GpibDeviceServer::bcsend_ifc(): entering... !" << endl;
+	
+	//	Add your own code to control device here
+	
+	// We don't check that board0 is open since this is done in the init_device method.
+	try
+	{
+		omni_mutex_lock bus(get_bus_mutex());
+		board0->sendIFC();
+		
+	} catch (gpibDeviceException e) {
+		GPIB_DEBUG_STREAM << "BCsendIFC command error on " << e.getDeviceName() << endl;
+		Tango::Except::throw_exception(
+		    (const char *) ("gpibDeviceException on " + e.getDeviceName() ).c_str(),
+		    (const char *) e.getiberrMessage().c_str(),
+		    (const char *) e.getibstaMessage().c_str(),
+		    Tango::ERR
+		);
+	}
+}
+
+
+//+------------------------------------------------------------------
+/**
+*	method:	GpibDeviceServer::bcclr
+*
+*	description:	method to execute "BCclr"
+*	This command clears a specified device.
+*	Throws DevFailed exception on error.
+*
+* @param	argin	handler of the device to clear.
+*
+*/
+//+------------------------------------------------------------------
+void GpibDeviceServer::bcclr(Tango::DevLong argin)
+{
+	GPIB_DEBUG_STREAM << "GpibDeviceServer::bcclr(): entering... !" << endl;
+	
+	//	Add your own code to control device here
+	
+	// We don't check that board0 is open since this is done in the init_device method.
+	try
+	{
+		omni_mutex_lock bus(get_bus_mutex());
+		board0->clr(argin);
+		
+	} catch (gpibDeviceException e) {
+		GPIB_DEBUG_STREAM << "BCclr command error on " << e.getDeviceName() << endl;
+		Tango::Except::throw_exception(
+		    (const char *) ("gpibDeviceException on " + e.getDeviceName() ).c_str(),
+		    (const char *) e.getiberrMessage().c_str(),
+		    (const char *) e.getibstaMessage().c_str(),
+		    Tango::ERR
+		);
+	}
+}
+
+
+//+------------------------------------------------------------------
+/**
+*	method:	GpibDeviceServer::get_device_id
+*
+*	description:	method to execute "GetDeviceID"
+*	This command return internal gpib device ID.
+*	This is usefull for board command using this ID to acces devices, as BCclr cmd.
+*	Throws DevFailed exception on error.
+*
+* @return	no argout
 *
 */
 //+------------------------------------------------------------------
-void GpibDeviceServer::write(Tango::DevString argin)
+Tango::DevLong GpibDeviceServer::get_device_id()
 {
-	DEBUG_STREAM << "GpibDeviceServer::write(): entering... !" << endl;
+	Tango::DevLong	argout ;
+	GPIB_DEBUG_STREAM << "GpibDeviceServer::get_device_id(): entering... !" << endl;
 	
 	//	Add your own code to control device here
 	
 	throwExceptionIfDeviceIsClosed();
 	
+	argout = gpib_device->getDeviceID(); // This is soft command. No gpibDeviceException here.
+	return argout;
+}
+
+
+//+------------------------------------------------------------------
+/**
+*	method:	GpibDeviceServer::bcllo
+*
+*	description:	method to execute "BCllo"
+*	This command send a local lockout to the specified device.
+*	Throws DevFailed exception on error.
+*
+* @param	argin	Device ID
+*
+*/
+//+------------------------------------------------------------------
+void GpibDeviceServer::bcllo(Tango::DevLong argin)
+{
+	GPIB_DEBUG_STREAM << "GpibDeviceServer::bcllo(): entering... !" << endl;
+	
+	//	Add your own code to control device here
+	
 	try
 	{
-		gpib_device->write(argin);
+		omni_mutex_lock bus(get_bus_mutex());
+		board0->llo(argin);
+		
+	} catch (gpibDeviceException e) {
+		GPIB_DEBUG_STREAM << "BCllo command error on " << e.getDeviceName() << endl;
+		Tango::Except::throw_exception(
+		    (const char *) ("gpibDeviceException on " + e.getDeviceName() ).c_str(),
+		    (const char *) e.getiberrMessage().c_str(),
+		    (const char *) e.getibstaMessage().c_str(),
+		    Tango::ERR
+		);
 	}
-	catch (gpibDeviceException e)
+}
+
+
+//+------------------------------------------------------------------
+/**
+*	method:	GpibDeviceServer::bccmd
+*
+*	description:	method to execute "BCcmd"
+*	Send a GPIB command message.
+*	This method is not used to transmit programming instruction to devices
+*	this kind of instructions are transmitted with the read / write methods.
+*	As done in write method, cmd automatically append EOS, as defined with
+*	setEOS method.
+*
+* @param	argin	Command string.
+*
+*/
+//+------------------------------------------------------------------
+void GpibDeviceServer::bccmd(Tango::DevString argin)
+{
+	GPIB_DEBUG_STREAM << "GpibDeviceServer::bccmd(): entering... !" << endl;
+	
+	//	Add your own code to control device here
+	
+	try
 	{
-		DEBUG_STREAM << "Write command error on " << e.getDeviceName() << endl;
+		omni_mutex_lock bus(get_bus_mutex());
+		board0->cmd(argin);
+		
+	} catch (gpibDeviceException e) {
+		GPIB_DEBUG_STREAM << "BCcmd command error on " << e.getDeviceName() << endl;
 		Tango::Except::throw_exception(
 		    (const char *) ("gpibDeviceException on " + e.getDeviceName() ).c_str(),
 		    (const char *) e.getiberrMessage().c_str(),
@@ -638,52 +2417,225 @@ void GpibDeviceServer::write(Tango::DevString argin)
 
 //+------------------------------------------------------------------
 /**
-*	method:	GpibDeviceServer::read
+*	method:	GpibDeviceServer::open
 *
-*	description:	method to execute "Read"
-*	This command reads a string from a gpib device. 
-*      Throws an DevFailed exception on error
+*	description:	method to execute "Open"
+*	This command opens a gpib device using the gpibDeviceAddress property,
+*      assuming that the device is controlled by the board gpib0.
+*      Therefore it uses the 4th gpibDevice constructor.
+*	This command should not be used since gpib device is open on device 
+*      server initialisation.
+*	Its provided in case of problem to do it manually. 
+*      Throws DevFailed exception on error.
+*	This command is allowed on fault to accept reconnection.
 *
-* @return	Returned string.
 *
 */
 //+------------------------------------------------------------------
-Tango::DevString GpibDeviceServer::read()
+void GpibDeviceServer::open()
 {
-	//	POGO has generated a method core with argout allocation.
-	//	If you would like to use a static reference without copying,
-	//	See "TANGO Device Server Programmer's Manual"
-	//		(chapter : Writing a TANGO DS / Exchanging data)
-	//------------------------------------------------------------
-	Tango::DevString	argout  = new char[RD_BUFFER_SIZE+1]; // AJOUT +1
-	string ret = "";
-	DEBUG_STREAM << "GpibDeviceServer::read(): entering... !" << endl;
+	GPIB_DEBUG_STREAM << "GpibDeviceServer::open(): entering... !" << endl;
 	
 	//	Add your own code to control device here
 	
-	if ( !dev_open )	// Trying to read a non-open device. Generate exception.
+	lazy_pending = false;	// Explicit open replaces the lazy one.
+	
+	if ( dev_open )	// Trying to open an already opened device. Generate exception.
 	{
-		DEBUG_STREAM << "Read command error." << endl;
-		delete[] argout;
+		GPIB_DEBUG_STREAM << "Open command error." << endl;
 		Tango::Except::throw_exception(
 		    (const char *) "gpibDeviceException.",
-		    (const char *) "Attempt to read a not opened device.",
-		    (const char *) "Device must be open before read operation.",
+		    (const char *) "Attempt to open an already open device.",
+		    (const char *) "Device must be closed before open operation.",
 		    Tango::ERR
 		);
 	}
 	
 	try
 	{
-		ret = gpib_device->read();
-		memset(argout,0, (RD_BUFFER_SIZE+1));   // AJOUT +1
-		strcpy(argout, ret.c_str() );
+		release_gpib_device();	// Left by a failed open.
+		gpib_device = new gpibDevice( gpibDeviceAddress );
+		gpib_device->setLatency(&latency);
+		gpib_device->setCounters(&counters);
+		//	    gpib_device->write("AYT"); 	// Are You There ?
+		if (gpib_device->isAlive() )
+		{
+			dev_open = true;
+			set_state(Tango::ON);
+			set_status("Gpib device is OK.");
+		}
+		else
+		{
+			set_state(Tango::FAULT);
+			set_status("Gpib device is not responding.");
+			string name = gpib_device->getName();
+			GPIB_DEBUG_STREAM << "Open command error on " << name << endl;
+			release_gpib_device();
+			Tango::Except::throw_exception(
+			    (const char *) ("gpibDeviceException on " + name ).c_str(),
+			    (const char *) "Open command error.",
+			    (const char *) "gpib device is not responding.",
+			    Tango::ERR
+			);
+		}
+	} catch (gpibDeviceException e) {
+		set_state(Tango::FAULT);
+		set_status("Gpib device is not responding.");
+		release_gpib_device();
+		GPIB_DEBUG_STREAM << "Open command error on " << e.getDeviceName() << endl;
+		Tango::Except::throw_exception(
+		    (const char *) ("gpibDeviceException on " + e.getDeviceName() ).c_str(),
+		    (const char *) e.getiberrMessage().c_str(),
+		    (const char *) e.getibstaMessage().c_str(),
+		    Tango::ERR
+		);
 	}
-	catch (gpibDeviceException e)
+}
+
+
+//+------------------------------------------------------------------
+/**
+*	method:	GpibDeviceServer::open_by_name
+*
+*	description:	method to execute "OpenByName"
+*	This command opens a gpib device using the gpibDeviceName property,
+*      assuming that the device is controlled by the board gpib0.
+*      Therefore it uses the 2nd gpibDevice constructor.
+*	This command should not be used since gpib device is opened on 
+*      device server initialisation.
+*	It is provided in case of problem to do it manually. 
+*      Throws DevFailed exception on error.
+*	This command is allowed on fault to accept reconnection.
+*
+*
+*/
+//+------------------------------------------------------------------
+void GpibDeviceServer::open_by_name()
+{
+	GPIB_DEBUG_STREAM << "GpibDeviceServer::open_by_name(): entering... !" << endl;
+	
+	//	Add your own code to control device here
+	
+	lazy_pending = false;	// Explicit open replaces the lazy one.
+	
+	if ( dev_open )	// Trying to open an already opened device. Generate exception.
+	{
+		GPIB_DEBUG_STREAM << "OpenByName command error." << endl;
+		Tango::Except::throw_exception(
+		    (const char *) "gpibDeviceException.",
+		    (const char *) "Attempt to OpenByName an already open device.",
+		    (const char *) "Device must be closed before OpenByName operation.",
+		    Tango::ERR
+		);
+	}
+	
+	try
+	{
+		release_gpib_device();	// Left by a failed open.
+		gpib_device = new gpibDevice( gpibDeviceName );
+		gpib_device->setLatency(&latency);
+		gpib_device->setCounters(&counters);
+		//	    gpib_device->write("AYT"); 	// Are You There ?
+		
+		if (gpib_device->isAlive() )
+		{
+			dev_open = true;
+			set_state(Tango::ON);
+			set_status("Gpib device is OK.");
+		}
+		else
+		{
+			set_state(Tango::FAULT);
+			set_status("Gpib device is not responding.");
+			string name = gpib_device->getName();
+			GPIB_DEBUG_STREAM << "OpenByName command error on " << name << endl;
+			release_gpib_device();
+			Tango::Except::throw_exception(
+			    (const char *) ("gpibDeviceException on " + name ).c_str(),
+			    (const char *) "OpenByName command error.",
+			    (const char *) "gpib device is not responding.",
+			    Tango::ERR
+			);
+		}
+	} 
+	catch (gpibDeviceException e) 
+	{
+		set_state(Tango::FAULT);
+		set_status("Gpib device is not responding.");
+		release_gpib_device();
+		GPIB_DEBUG_STREAM << "OpenByName command error on " << e.getDeviceName() << endl;
+		Tango::Except::throw_exception(
+		    (const char *) ("gpibDeviceException on " + e.getDeviceName() ).c_str(),
+		    (const char *) e.getiberrMessage().c_str(),
+		    (const char *) e.getibstaMessage().c_str(),
+		    Tango::ERR
+		);
+	}
+}
+
+
+//+------------------------------------------------------------------
+/**
+*	method:	GpibDeviceServer::bcget_connected_device_list
+*
+*	description:	method to execute "BCGetConnectedDeviceList"
+*	This command returns the string array :
+*	
+*	+ primary address + secondary address for 1st device found
+*	
+*	+ primary address + secondary address for 2d device found
+*	ect ....
+*	ex:
+*	HEWLETT-PACKARD,3589A,3343A00642,A.00.03 PAD=6 SAD=0
+*
+* @return	list of connected device on the GPIB bus
+*
+*/
+//+------------------------------------------------------------------
+Tango::DevVarStringArray *GpibDeviceServer::bcget_connected_device_list()
+{
+	//	Add your own code to control device here
+	GPIB_DEBUG_STREAM << "GpibDeviceServer::get_connected_device_list(): entering... !" << endl;
+	
+	return connected_devices(false);
+}
+
+
+//+----------------------------------------------------------------------------
+//
+// method : 		GpibDeviceServer::connected_devices()
+//
+// description : 	List the devices of the bus, "*IDN? PAD=x SAD=y" each,
+//			for BCGetConnectedDeviceList and, with the secondary
+//			addresses scanned, BCGetConnectedDeviceListSAD.
+//
+//-----------------------------------------------------------------------------
+Tango::DevVarStringArray *GpibDeviceServer::connected_devices(bool secondaries)
+{
+	Tango::DevVarStringArray	*argout  = new Tango::DevVarStringArray();	
+	try
+	{
+		omni_mutex_lock bus(get_bus_mutex());
+		vector<gpibDeviceInfo> &devInfo = get_board()->getConnectedDeviceList(secondaries);
+		argout->length(devInfo.size() );
+		for (long i = 0; i < devInfo.size(); i++)
+		{
+			ostringstream os1;
+			ostringstream os2;
+			
+			os1 << devInfo[i].dev_pad;
+			string pad = " PAD=" + os1.str();
+			
+			os2 << devInfo[i].dev_sad;
+			string sad = " SAD=" + os2.str();
+			(*argout)[i] = CORBA::string_dup( (devInfo[i].dev_idn + pad + sad  ).c_str() );
+		}
+	} 
+	catch (gpibDeviceException e) 
 	{
-		DEBUG_STREAM << "Read command error on " << e.getDeviceName() << endl;
-		delete[] argout;
-		//cout << "Read error: err="<< e.getErrorValue()<<" state="<< e.getStateValue() << endl;
+		GPIB_DEBUG_STREAM << "getConnectedDeviceList command error on " << e.getDeviceName() << endl;
+		delete argout;
+		
 		Tango::Except::throw_exception(
 		    (const char *) ("gpibDeviceException on " + e.getDeviceName() ).c_str(),
 		    (const char *) e.getiberrMessage().c_str(),
@@ -697,18 +2649,20 @@ Tango::DevString GpibDeviceServer::read()
 
 //+------------------------------------------------------------------
 /**
-*	method:	GpibDeviceServer::close
+*	method:	GpibDeviceServer::trigger
 *
-*	description:	method to execute "Close"
-*	Close a previously opened gpib device.
-*	Throws exception on error.
+*	description:	method to execute "Trigger"
+*	This command sends a trigger signal to the GPIB device.
+*	If the device was previously set up, it can make its measurment, 
+*      and send it on the bus.
+*	Measure is now get with a read command.
 *
 *
 */
 //+------------------------------------------------------------------
-void GpibDeviceServer::close()
+void GpibDeviceServer::trigger()
 {
-	DEBUG_STREAM << "GpibDeviceServer::close(): entering... !" << endl;
+	GPIB_DEBUG_STREAM << "GpibDeviceServer::trigger(): entering... !" << endl;
 	
 	//	Add your own code to control device here
 	
@@ -716,18 +2670,10 @@ void GpibDeviceServer::close()
 	
 	try
 	{
-		gpib_device->setOffLine();
-		if(gpib_device)
-		{
-			delete gpib_device;
-			gpib_device = NULL;
-		}
-		dev_open = false;
-		set_state(Tango::OFF);
+		gpib_device->trigger();
 		
 	} catch (gpibDeviceException e) {
-	
-		DEBUG_STREAM << "Close command error on " << e.getDeviceName() << endl;
+		GPIB_DEBUG_STREAM << "Trigger command error on " << e.getDeviceName() << endl;
 		Tango::Except::throw_exception(
 		    (const char *) ("gpibDeviceException on " + e.getDeviceName() ).c_str(),
 		    (const char *) e.getiberrMessage().c_str(),
@@ -740,57 +2686,48 @@ void GpibDeviceServer::close()
 
 //+------------------------------------------------------------------
 /**
-*	method:	GpibDeviceServer::read_long_string
+*	method:	GpibDeviceServer::write_read
 *
-*	description:	method to execute "ReadLongString"
-*	For most gpib device the read command is enough to talk with the device.
-*      In certain case, the gpibDevice returns a very big string, which is
-*      larger than the read buffer. For concret example, 
-*      on :CALC:DATA? command, the hp3588 returns 400 strings representing a
-*	spectrum, for a total size > 4Kbytes. This method reads these sort of 
-*      long string.
-*	For efficiency, its better to use the read command instead of 
-*      readLongString. This method is provided for exceptionnal case. 
-*      Throws DevFailed on error.
+*	description:	method to execute "WriteRead"
+*	This command perform a write on the GPIB device, and then perform 
+*      a read to get the answer, before returning it.
 *
-* @param	argin	Max expected string length.
-* @return	The readed string.
+* @param	argin	String to send to the gpib device.
+* @return	String returned by the gpib Device.
 *
 */
 //+------------------------------------------------------------------
-Tango::DevString GpibDeviceServer::read_long_string(Tango::DevLong argin)
+Tango::DevString GpibDeviceServer::write_read(Tango::DevString argin)
 {
 	//	POGO has generated a method core with argout allocation.
 	//	If you would like to use a static reference without copying,
 	//	See "TANGO Device Server Programmer's Manual"
 	//		(chapter : Writing a TANGO DS / Exchanging data)
 	//------------------------------------------------------------
-	Tango::DevString	argout  = new char[argin];
+	Tango::DevString	argout  = new char[RD_BUFFER_SIZE+1]; // AJOUT +1
 	string ret = "";
-	DEBUG_STREAM << "GpibDeviceServer::read_long_string(): entering... !" << endl;
+	
+	GPIB_DEBUG_STREAM << "GpibDeviceServer::write_read(): entering... !" << endl;
 	
 	//	Add your own code to control device here
 	
-	if ( !dev_open )	// Trying to read a non-open device. Generate exception.
-	{
-		delete[] argout;
-		DEBUG_STREAM << "ReadLongString command error." << endl;
-		Tango::Except::throw_exception(
-		    (const char *) "gpibDeviceException.",
-		    (const char *) "Attempt to read a not opened device.",
-		    (const char *) "Device must be open before read operation.",
-		    Tango::ERR
-		);
-	}
+	throwExceptionIfDeviceIsClosed();
 	
 	try
 	{
-		ret = gpib_device->read(argin);
+		ret = gpib_device->writeRead(argin);
+		memset(argout,0, (RD_BUFFER_SIZE+1));  // AJOUT +1
 		strcpy(argout, ret.c_str() );
 		
+		// Keep the last known identification of the device.
+		string query = string(argin).substr(0, 5);
+		for (unsigned int i = 0; i < query.length(); i++)
+			query[i] = toupper(query[i]);
+		if (query == "*IDN?")
+			write_idn_cache(ret);
+		
 	} catch (gpibDeviceException e) {
-	
-		DEBUG_STREAM << "ReadLongString command error on " << e.getDeviceName() << endl;
+		GPIB_DEBUG_STREAM << "WriteRead command error on " << e.getDeviceName() << endl;
 		delete[] argout;
 		Tango::Except::throw_exception(
 		    (const char *) ("gpibDeviceException on " + e.getDeviceName() ).c_str(),
@@ -805,52 +2742,41 @@ Tango::DevString GpibDeviceServer::read_long_string(Tango::DevLong argin)
 
 //+------------------------------------------------------------------
 /**
-*	method:	GpibDeviceServer::get_name
+*	method:	GpibDeviceServer::config
 *
-*	description:	method to execute "GetName"
-*	Return the gpib device name, as defined on the gpib Driver 
-*      (see them with ibconf tool).
-*	Throws DevFailed on error
+*	description:	method to execute "Config"
+*	index 0 of input array is the GPIB option to modify.
+*	index 1 is the new value to associate to this option.
 *
-* @return	gpib device name
+* @param	argin	Array of 2 long.
 *
 */
 //+------------------------------------------------------------------
-Tango::DevString GpibDeviceServer::get_name()
+void GpibDeviceServer::config(const Tango::DevVarLongArray *argin)
 {
-	//	POGO has generated a method core with argout allocation.
-	//	If you would like to use a static reference without copying,
-	//	See "TANGO Device Server Programmer's Manual"
-	//		(chapter : Writing a TANGO DS / Exchanging data)
-	//------------------------------------------------------------
-	Tango::DevString	argout  = new char[RD_BUFFER_SIZE+1]; // AJOUT +1
-	string ret = "";
-	DEBUG_STREAM << "GpibDeviceServer::get_name(): entering... !" << endl;
+	GPIB_DEBUG_STREAM << "GpibDeviceServer::config(): entering... !" << endl;
 	
 	//	Add your own code to control device here
 	
-	if ( !dev_open )	// Trying to read a non-open device. Generate exception.
-	{
-		delete[] argout;
-		DEBUG_STREAM << "getName command error." << endl;
+	throwExceptionIfDeviceIsClosed();
+	
+	// Check parameter number.
+	if (argin->length() != 2) {
+		GPIB_DEBUG_STREAM << "GpibDeviceServer::config(): Wrong input parameter number." << endl;
 		Tango::Except::throw_exception(
-		    (const char *) "gpibDeviceException.",
-		    (const char *) "Attempt to getName from a not opened device.",
-		    (const char *) "Device must be open before getName operation.",
+		    (const char *) ("gpibDeviceException on " + gpib_device->getName() ).c_str(),
+		    (const char *) "GpibDeviceServer::config(): Wrong input parameter number.",
+		    (const char *) "Two parameters are needed.",
 		    Tango::ERR
 		);
 	}
 	
 	try
 	{
-		ret = gpib_device->getName();
-		memset(argout,0, (RD_BUFFER_SIZE+1));  // AJOUT +1
-		strcpy(argout, ret.c_str() );
+		gpib_device->config( (*argin)[0], (*argin)[1] );
 		
 	} catch (gpibDeviceException e) {
-	
-		DEBUG_STREAM << "getName command error on " << e.getDeviceName() << endl;
-		delete[] argout;
+		GPIB_DEBUG_STREAM << "Config command error on " << e.getDeviceName() << endl;
 		Tango::Except::throw_exception(
 		    (const char *) ("gpibDeviceException on " + e.getDeviceName() ).c_str(),
 		    (const char *) e.getiberrMessage().c_str(),
@@ -858,35 +2784,43 @@ Tango::DevString GpibDeviceServer::get_name()
 		    Tango::ERR
 		);
 	}
-	return argout;
 }
 
 
 //+------------------------------------------------------------------
 /**
-*	method:	GpibDeviceServer::local
+*	method:	GpibDeviceServer::bcconfig
 *
-*	description:	method to execute "Local"
-*	Set the gpib device in local mode. Throws DevFailed on error.
+*	description:	method to execute "BCConfig"
+*	Same method than Config, but sent on gpib Board instead of GPIB device.
 *
+* @param	argin	Array of 2 long.
 *
 */
 //+------------------------------------------------------------------
-void GpibDeviceServer::local()
+void GpibDeviceServer::bcconfig(const Tango::DevVarLongArray *argin)
 {
-	DEBUG_STREAM << "GpibDeviceServer::local(): entering... !" << endl;
+	GPIB_DEBUG_STREAM << "GpibDeviceServer::bcconfig(): entering... !" << endl;
 	
 	//	Add your own code to control device here
 	
-	throwExceptionIfDeviceIsClosed();
+	if (argin->length() != 2) {
+		GPIB_DEBUG_STREAM << "GpibDeviceServer::bcconfig(): Wrong input parameter number." << endl;
+		Tango::Except::throw_exception(
+		    (const char *) ("gpibDeviceException on " + gpib_device->getName() ).c_str(),
+		    (const char *) "GpibDeviceServer::bcconfig(): Wrong input parameter number.",
+		    (const char *) "Two parameters are needed.",
+		    Tango::ERR
+		);
+	}
 	
 	try
 	{
-		gpib_device->goToLocalMode();
+		omni_mutex_lock bus(get_bus_mutex());
+		board0->config( (*argin)[0], (*argin)[1]);
 		
 	} catch (gpibDeviceException e) {
-	
-		DEBUG_STREAM << "Local command error on " << e.getDeviceName() << endl;
+		GPIB_DEBUG_STREAM << "BCConfig command error on " << e.getDeviceName() << endl;
 		Tango::Except::throw_exception(
 		    (const char *) ("gpibDeviceException on " + e.getDeviceName() ).c_str(),
 		    (const char *) e.getiberrMessage().c_str(),
@@ -899,141 +2833,220 @@ void GpibDeviceServer::local()
 
 //+------------------------------------------------------------------
 /**
-*	method:	GpibDeviceServer::remote
+*	method:	GpibDeviceServer::send_bin_data
 *
-*	description:	method to execute "Remote"
-*	Set the gpib device in remote mode. This command is here for 
-*      compatibility, since network access to a gpib Device will 
-*      automatically turn it to remote mode.
-*	Throws DevFailed on error.
+*	description:	method to execute "SendBinData"
+*	This command send an array of binary data to the device 
+*      through the GPIB bus.
+*	Throws devFailed on error.
 *
+* @param	argin	Array of binary data to send to the device
 *
 */
 //+------------------------------------------------------------------
-void GpibDeviceServer::remote()
+void GpibDeviceServer::send_bin_data(const Tango::DevVarCharArray *argin)
 {
-	DEBUG_STREAM << "GpibDeviceServer::remote(): entering... !" << endl;
+	GPIB_DEBUG_STREAM << "GpibDeviceServer::send_bin_data(): entering... !" << endl;
 	
 	//	Add your own code to control device here
 	
 	throwExceptionIfDeviceIsClosed();
 	
-	try
+	char *data =  new char[argin->length()];
+	// check if memory is allocated
+	if (data == NULL)
 	{
-		gpib_device->goToRemoteMode();
-		
-	} catch (gpibDeviceException e) {
+		GPIB_DEBUG_STREAM << "send_bin_data can not allocate memory." <<endl;
+		Tango::Except::throw_exception(
+		    (const char*) "gpibDeviceException.",
+		    (const char*) "memory not allocated.",
+		    (const char*) "malloc() in send_bin_data().",
+		    Tango::ERR
+		);
+	}
 	
-		DEBUG_STREAM << "Remote command error on " << e.getDeviceName() << endl;
+	// sendData expected a char* and not a Tango::DevVarCharArray *
+	for(int i = 0; i < argin->length(); i++)
+		data[i] = (*argin)[i];
+		
+	try
+	{
+		gpib_device->sendData(data, argin->length());
+		delete[] data;
+	}
+	catch (gpibDeviceException e) {
+		if(data) delete[] data;
+		GPIB_DEBUG_STREAM << "send_bin_data command error on " << e.getDeviceName() << endl;
 		Tango::Except::throw_exception(
-		    (const char *) ("gpibDeviceException on " + e.getDeviceName() ).c_str(),
-		    (const char *) e.getiberrMessage().c_str(),
-		    (const char *) e.getibstaMessage().c_str(),
+		    (const char*) ("gpibDeviceException on " + e.getDeviceName() ).c_str(),
+		    (const char*) e.getiberrMessage().c_str(),
+		    (const char*) e.getibstaMessage().c_str(),
 		    Tango::ERR
 		);
 	}
+	catch(...)
+	{
+		if(data) delete[] data;
+		FATAL_STREAM << "send_bin_data catch(...) case " << endl;
+	}
 }
 
 
 //+------------------------------------------------------------------
 /**
-*	method:	GpibDeviceServer::getiberr
+*	method:	GpibDeviceServer::receive_bin_data
 *
-*	description:	method to execute "Getiberr"
-*	This command returns last gpib device error code (lib gpib iberr).
-*	Throws DevFailed on error.
+*	description:	method to execute "ReceiveBinData"
+*	This command reads an array of binary data from a gpib device.
+*	Up to 65536 bytes. In generaly, a Gpib device can send or receive 64Ko.
+*	Throws an DevFailed exception on error
 *
-* @return	no argout
+* @param	argin	length of the data to receive from the Gpib device
+* @return	Array of binary data
 *
 */
 //+------------------------------------------------------------------
-Tango::DevLong GpibDeviceServer::getiberr()
+Tango::DevVarCharArray *GpibDeviceServer::receive_bin_data(Tango::DevLong argin)
 {
-	Tango::DevLong	argout ;
-	DEBUG_STREAM << "GpibDeviceServer::getiberr(): entering... !" << endl;
+	//	POGO has generated a method core with argout allocation.
+	//	If you would like to use a static reference without copying,
+	//	See "TANGO Device Server Programmer's Manual"
+	//		(chapter : Writing a TANGO DS / Exchanging data)
+	//------------------------------------------------------------
+	GPIB_DEBUG_STREAM << "GpibDeviceServer::receive_bin_data(): entering... !" << endl;
 	
 	//	Add your own code to control device here
 	
 	throwExceptionIfDeviceIsClosed();
 	
-	argout = gpib_device->getiberr(); // This is soft command. No gpibDeviceException here.
-	return argout;
-}
-
-
-//+------------------------------------------------------------------
-/**
-*	method:	GpibDeviceServer::getibsta
-*
-*	description:	method to execute "Getibsta"
-*	This command returns last gpib device state code (lib gpib ibsta).
-*	Throws DevFailed on error.
-*
-* @return	no argout
-*
-*/
-//+------------------------------------------------------------------
-Tango::DevLong GpibDeviceServer::getibsta()
-{
-	Tango::DevLong	argout ;
-	DEBUG_STREAM << "GpibDeviceServer::getibsta(): entering... !" << endl;
+	long nb_data = argin;
+	char	*response;
+	
+	try
+	{
+		response = gpib_device->receiveData(nb_data);
+		
+	}
+	catch (gpibDeviceException e) {
+		GPIB_DEBUG_STREAM << "receive_bin_data command error on " << e.getDeviceName() << endl;
+		//if (argout) delete argout;
+		Tango::Except::throw_exception(
+		    (const char*)(("gpibDeviceException on " + e.getDeviceName() ).c_str()),
+		    (const char*)e.getiberrMessage().c_str(),
+		    (const char*)e.getibstaMessage().c_str(),
+		    Tango::ERR
+		);
+	}
+	
+	Tango::DevVarCharArray *argout = new Tango::DevVarCharArray();
+	argout->length(nb_data);
+	
+	// check if memory is allocated
+	if (argout == NULL)
+	{
+		GPIB_DEBUG_STREAM << "receive_bin_data can not allocate memory." << endl;
+		Tango::Except::throw_exception(
+		    (const char*) "gpibDeviceException.",
+		    (const char*) "memory not allocated.",
+		    (const char*) "new Tango::DevVarCharArray() failed in receive_bin_data().",
+		    Tango::ERR
+		);
+	}
+	
+	for (long i = 0; i < nb_data; i++)
+		(*argout)[i] = response[i];
+		
+	delete [] response;
 	
-	//	Add your own code to control device here
-	throwExceptionIfDeviceIsClosed();
-	argout = gpib_device->getibsta(); // This is soft command. No gpibDeviceException here.
 	return argout;
 }
 
 
 //+------------------------------------------------------------------
 /**
-*	method:	GpibDeviceServer::getibcnt
+*	method:	GpibDeviceServer::bcget_config
 *
-*	description:	method to execute "Getibcnt"
-*	This command returns last gpib device count var (lib gpib ibcnt).
-*	Throws DevFailed on error.
+*	description:	method to execute "BCGetConfig"
+*	Returns a value for one configuration option for a GPIB Board.
+*	Throws Tango::DevFailed exception on error.
 *
-* @return	no argout
+* @param	argin	Configuration option index (see ibask table)
+* @return	Value for wanted configuration option
 *
 */
 //+------------------------------------------------------------------
-Tango::DevULong GpibDeviceServer::getibcnt()
+Tango::DevShort GpibDeviceServer::bcget_config(Tango::DevShort argin)
 {
-	Tango::DevULong	argout ;
-	DEBUG_STREAM << "GpibDeviceServer::getibcnt(): entering... !" << endl;
+	Tango::DevShort	argout ;
+	GPIB_DEBUG_STREAM << "GpibDeviceServer::bcget_config(): entering... !" << endl;
 	
 	//	Add your own code to control device here
 	
-	throwExceptionIfDeviceIsClosed();
-	argout = gpib_device->getibcnt(); // This is soft command. No gpibDeviceException here.
+	// We don't check that board0 is open since this is done in
+	// the init_device method.
+	
+	// TODO: should test the value od argin = config. option index
+	//       since this is not done in getconfig() function inside
+	//       gpibDevice class.
+	
+	try
+	{
+		argout = (Tango::DevShort)board0->getconfig(argin);
+	}
+	catch (gpibDeviceException e)
+	{
+		GPIB_DEBUG_STREAM << "BCGetConfig command error on " << e.getDeviceName() << endl;
+		argout = 0;
+		Tango::Except::throw_exception(
+		    (const char *) ("gpibDeviceException on " + e.getDeviceName() ).c_str(),
+		    (const char *) e.getiberrMessage().c_str(),
+		    (const char *) e.getibstaMessage().c_str(),
+		    Tango::ERR
+		);
+	}
 	return argout;
+	
+	// if would work without exceptions, then instead of the last
+	// try/catch block above would have just the following 2 lines:
+	//argout = (Tango::DevShort)board0->getconfig(argin);
+	//return argout;
 }
 
 
 //+------------------------------------------------------------------
 /**
-*	method:	GpibDeviceServer::clear
+*	method:	GpibDeviceServer::get_config
 *
-*	description:	method to execute "Clear"
-*	This command clears the gpib device. Throws DevFailed exception on error.
+*	description:	method to execute "GetConfig"
+*	Get a value for one configuration option for a GPIB device.
+*	Throws Tango::DevFailed exception on error.
 *
+* @param	argin	Configuration option index (see ibask table)
+* @return	Value for wanted configuration option
 *
 */
 //+------------------------------------------------------------------
-void GpibDeviceServer::clear()
+Tango::DevShort GpibDeviceServer::get_config(Tango::DevShort argin)
 {
-	DEBUG_STREAM << "GpibDeviceServer::clear(): entering... !" << endl;
+	Tango::DevShort	argout ;
+	GPIB_DEBUG_STREAM << "GpibDeviceServer::get_config(): entering... !" << endl;
 	
 	//	Add your own code to control device here
 	
 	throwExceptionIfDeviceIsClosed();
 	
+	// TODO: should test the value od argin = config. option index
+	//       since this is not done in getconfig() function inside
+	//       gpibDevice class.
+	
 	try
 	{
-		gpib_device->clear();
-		
-	} catch (gpibDeviceException e) {
-		DEBUG_STREAM << "Clear command error on " << e.getDeviceName() << endl;
+		argout = (Tango::DevShort)gpib_device->getconfig(argin);
+	}
+	catch (gpibDeviceException e)
+	{
+		GPIB_DEBUG_STREAM << "GetConfig command error on " << e.getDeviceName() << endl;
+		argout = 0;
 		Tango::Except::throw_exception(
 		    (const char *) ("gpibDeviceException on " + e.getDeviceName() ).c_str(),
 		    (const char *) e.getiberrMessage().c_str(),
@@ -1041,25 +3054,32 @@ void GpibDeviceServer::clear()
 		    Tango::ERR
 		);
 	}
+	return argout;
+	
+	// if would work without exceptions, then instead of the last
+	// try/catch block above would have just the following 2 lines:
+	//argout = (Tango::DevShort)gpib_device->getconfig(argin);
+	//return argout;
 }
 
 
 //+------------------------------------------------------------------
 /**
-*	method:	GpibDeviceServer::set_time_out
+*	method:	GpibDeviceServer::listener_check
 *
-*	description:	method to execute "SetTimeOut"
-*	This command set Time Out value for the gpib device.
-*	Warning these values are predefined, cf gpibDevice.h
-*	accepted value are [0-15]. Throws DevFailed exception on error.
+*	description:	method to execute "ListenerCheck"
+*	This command returns the status of listener check on device and returns
+*	1, when device responds (= is alive) and 0, when not.
+*	Throws Tango::DevFailed exception on error.
 *
-* @param	argin	accepted value are [0-15]
+* @return	Flag telling if selected GPIB device is alive
 *
 */
 //+------------------------------------------------------------------
-void GpibDeviceServer::set_time_out(Tango::DevShort argin)
+Tango::DevShort GpibDeviceServer::listener_check()
 {
-	DEBUG_STREAM << "GpibDeviceServer::set_time_out(): entering... !" << endl;
+	Tango::DevShort	argout ;
+	GPIB_DEBUG_STREAM << "GpibDeviceServer::listener_check(): entering... !" << endl;
 	
 	//	Add your own code to control device here
 	
@@ -1067,10 +3087,12 @@ void GpibDeviceServer::set_time_out(Tango::DevShort argin)
 	
 	try
 	{
-		gpib_device->setTimeOut(argin);
-		
-	} catch (gpibDeviceException e) {
-		DEBUG_STREAM << "SetTimeOut command error on " << e.getDeviceName() << endl;
+		argout = (Tango::DevShort)gpib_device->isAlive();
+	}
+	catch (gpibDeviceException e)
+	{
+		GPIB_DEBUG_STREAM << "ListenerCheck command error on " << e.getDeviceName() << endl;
+		argout = 0;
 		Tango::Except::throw_exception(
 		    (const char *) ("gpibDeviceException on " + e.getDeviceName() ).c_str(),
 		    (const char *) e.getiberrMessage().c_str(),
@@ -1078,35 +3100,44 @@ void GpibDeviceServer::set_time_out(Tango::DevShort argin)
 		    Tango::ERR
 		);
 	}
+	return argout;
+	
+	// if would work without exceptions, then instead of the last
+	// try/catch block above would have just the following 2 lines:
+	//argout = (Tango::DevShort)gpib_device->isAlive();
+	//return argout;
 }
 
 
 //+------------------------------------------------------------------
 /**
-*	method:	GpibDeviceServer::bcsend_ifc
+*	method:	GpibDeviceServer::get_serial_poll
 *
-*	description:	method to execute "BCsendIFC"
-*	This commands send IFC to the gpib Board0.
-*	So the board becomes Controller In Charge and devices are cleared.
-*	All commands beginning with'BC' are Board Commands.
-*	Throws DevFailed exception on error.
+*	description:	method to execute "GetSerialPoll"
+*	This command returns the serial poll byte of device.
+*	Throws Tango::DevFailed exception on error.
 *
+* @return	Serial poll status byte
 *
 */
 //+------------------------------------------------------------------
-void GpibDeviceServer::bcsend_ifc()
+Tango::DevShort GpibDeviceServer::get_serial_poll()
 {
-	DEBUG_STREAM << "GpibDeviceServer::bcsend_ifc(): entering... !" << endl;
+	Tango::DevShort	argout ;
+	GPIB_DEBUG_STREAM << "GpibDeviceServer::get_serial_poll(): entering... !" << endl;
 	
 	//	Add your own code to control device here
 	
-	// We don't check that board0 is open since this is done in the init_device method.
+	throwExceptionIfDeviceIsClosed();
+	
 	try
 	{
-		board0->sendIFC();
-		
-	} catch (gpibDeviceException e) {
-		DEBUG_STREAM << "BCsendIFC command error on " << e.getDeviceName() << endl;
+		argout = (Tango::DevShort)gpib_device->getSerialPoll();
+	}
+	catch (gpibDeviceException e)
+	{
+		GPIB_DEBUG_STREAM << "GetSerialPoll command error on " << e.getDeviceName() << endl;
+		argout = 0;
 		Tango::Except::throw_exception(
 		    (const char *) ("gpibDeviceException on " + e.getDeviceName() ).c_str(),
 		    (const char *) e.getiberrMessage().c_str(),
@@ -1114,207 +3145,317 @@ void GpibDeviceServer::bcsend_ifc()
 		    Tango::ERR
 		);
 	}
+	return argout;
+	
+	// if would work without exceptions, then instead of the last
+	// try/catch block above would have just the following 2 lines:
+	//argout = (Tango::DevShort)gpib_device->getSerialPoll();
+	//return argout;
 }
 
 
 //+------------------------------------------------------------------
 /**
-*	method:	GpibDeviceServer::bcclr
+*	method:	GpibDeviceServer::get_device_pad
 *
-*	description:	method to execute "BCclr"
-*	This command clears a specified device.
-*	Throws DevFailed exception on error.
+*	description:	method to execute "GetDevicePad"
+*	This command returns the primary address of device,
+*	which has possible values 0->30.
+*	Throws Tango::DevFailed exception on error.
 *
-* @param	argin	handler of the device to clear.
+* @return	Device primary address
 *
 */
 //+------------------------------------------------------------------
-void GpibDeviceServer::bcclr(Tango::DevLong argin)
+Tango::DevShort GpibDeviceServer::get_device_pad()
 {
-	DEBUG_STREAM << "GpibDeviceServer::bcclr(): entering... !" << endl;
+	Tango::DevShort	argout ;
+	GPIB_DEBUG_STREAM << "GpibDeviceServer::get_device_pad(): entering... !" << endl;
 	
 	//	Add your own code to control device here
 	
-	// We don't check that board0 is open since this is done in the init_device method.
-	try
-	{
-		board0->clr(argin);
-		
-	} catch (gpibDeviceException e) {
-		DEBUG_STREAM << "BCclr command error on " << e.getDeviceName() << endl;
-		Tango::Except::throw_exception(
-		    (const char *) ("gpibDeviceException on " + e.getDeviceName() ).c_str(),
-		    (const char *) e.getiberrMessage().c_str(),
-		    (const char *) e.getibstaMessage().c_str(),
-		    Tango::ERR
-		);
-	}
+	throwExceptionIfDeviceIsClosed();
+	
+	argout = (Tango::DevShort)gpib_device->getDeviceAddr(); // This is soft
+	// command. No gpibDeviceException here.
+	
+	return argout;
 }
 
 
 //+------------------------------------------------------------------
 /**
-*	method:	GpibDeviceServer::get_device_id
+*	method:	GpibDeviceServer::get_board_index
 *
-*	description:	method to execute "GetDeviceID"
-*	This command return internal gpib device ID.
-*	This is usefull for board command using this ID to acces devices, as BCclr cmd.
-*	Throws DevFailed exception on error.
+*	description:	method to execute "GetBoardIndex"
+*	This command returns the board index.
+*	It is the number N at the end of the name /dev/gpibN.
+*	Throws Tango::DevFailed exception on error.
 *
-* @return	no argout
+* @return	Board Index (starts with 0)
 *
 */
 //+------------------------------------------------------------------
-Tango::DevLong GpibDeviceServer::get_device_id()
+Tango::DevShort GpibDeviceServer::get_board_index()
 {
-	Tango::DevLong	argout ;
-	DEBUG_STREAM << "GpibDeviceServer::get_device_id(): entering... !" << endl;
+	Tango::DevShort	argout ;
+	GPIB_DEBUG_STREAM << "GpibDeviceServer::get_board_index(): entering... !" << endl;
 	
 	//	Add your own code to control device here
-	
 	throwExceptionIfDeviceIsClosed();
 	
-	argout = gpib_device->getDeviceID(); // This is soft command. No gpibDeviceException here.
+	argout = (Tango::DevShort)boardind;
 	return argout;
 }
 
 
 //+------------------------------------------------------------------
 /**
-*	method:	GpibDeviceServer::bcllo
+*	method:	GpibDeviceServer::reload_properties
 *
-*	description:	method to execute "BCllo"
-*	This command send a local lockout to the specified device.
-*	Throws DevFailed exception on error.
+*	description:	method to execute "ReloadProperties"
+*	Read the device properties again and apply the changed ones on the
+*	open device (time out, EOS, EOT), without the Init command.
+*	The device is opened again only when its name, address or board changed.
+*	The device is not changed when GpibDeviceName and GpibDeviceAddress
+*	are both missing: the command fails.
 *
-* @param	argin	Device ID
+* @return	Changed properties
 *
 */
 //+------------------------------------------------------------------
-void GpibDeviceServer::bcllo(Tango::DevLong argin)
+Tango::DevVarStringArray *GpibDeviceServer::reload_properties()
 {
-	DEBUG_STREAM << "GpibDeviceServer::bcllo(): entering... !" << endl;
+	//	POGO has generated a method core with argout allocation.
+	//	If you would like to use a static reference without copying,
+	//	See "TANGO Device Server Programmer's Manual"
+	//		(chapter : Writing a TANGO DS / Exchanging data)
+	//------------------------------------------------------------
+	Tango::DevVarStringArray	*argout  = new Tango::DevVarStringArray();
+	GPIB_DEBUG_STREAM << "GpibDeviceServer::reload_properties(): entering... !" << endl;
 	
 	//	Add your own code to control device here
 	
-	try
+	// The background open uses the properties and the gpib device.
 	{
-		board0->llo(argin);
-		
-	} catch (gpibDeviceException e) {
-		DEBUG_STREAM << "BCllo command error on " << e.getDeviceName() << endl;
+		omni_mutex_lock lock(open_mutex);
+		if (open_pending == true)
+		{
+			delete argout;
+			Tango::Except::throw_exception(
+			    (const char *) "gpibDeviceException.",
+			    (const char *) "Gpib device is still being opened.",
+			    (const char *) "Wait for the device to leave the INIT state.",
+			    Tango::ERR
+			);
+		}
+	}
+	
+	// Nothing is changed on the device before the new values are checked.
+	GpibDeviceProperties	p;
+	if (read_device_property(p) == false)
+	{
+		delete argout;
 		Tango::Except::throw_exception(
-		    (const char *) ("gpibDeviceException on " + e.getDeviceName() ).c_str(),
-		    (const char *) e.getiberrMessage().c_str(),
-		    (const char *) e.getibstaMessage().c_str(),
+		    (const char *) "GPIB_NO_PROPERTY",
+		    (const char *) "Mandatory properties 'gpibDeviceName' and 'gpibDeviceAddress' are not defined: define at least one of them.",
+		    (const char *) "GpibDeviceServer::reload_properties",
 		    Tango::ERR
 		);
 	}
+	
+	vector<string>	changes;
+	if (p.gpibDeviceName != gpibDeviceName)
+		changes.push_back("GpibDeviceName");
+	if (p.gpibBoardName != gpibBoardName)
+		changes.push_back("GpibBoardName");
+	if (p.gpibDeviceAddress != gpibDeviceAddress)
+		changes.push_back("GpibDeviceAddress");
+	if (p.gpibDeviceSecondaryAddress != gpibDeviceSecondaryAddress)
+		changes.push_back("GpibDeviceSecondaryAddress");
+		
+	// The device is not the same one: open it again.
+	if (changes.empty() == false)
+	{
+		set_device_property(p);
+		release_gpib_device();
+		init_from_properties();
+	}
+	else
+	{
+		Tango::DevShort	old_tmo = gpibDeviceTimeOut;
+		Tango::DevLong	old_eos = gpibDeviceEOS;
+		Tango::DevShort	old_eot = gpibDeviceEOT;
+		Tango::DevBoolean	old_sticky = stickyAddressing;
+		
+		if (p.gpibDeviceTimeOut != old_tmo)
+			changes.push_back("GpibDeviceTimeOut");
+		if (p.gpibDeviceEOS != old_eos)
+			changes.push_back("GpibDeviceEOS");
+		if (p.gpibDeviceEOT != old_eot)
+			changes.push_back("GpibDeviceEOT");
+		if (p.stickyAddressing != old_sticky)
+			changes.push_back("StickyAddressing");
+		set_device_property(p);
+			
+		// A closed device gets the new values when it is opened.
+		if ( (changes.empty() == false) && (dev_open == true) )
+		{
+			try
+			{
+				if (gpibDeviceTimeOut != old_tmo)
+					gpib_device->setTimeOut(gpibDeviceTimeOut);
+				if ( (gpibDeviceEOS != old_eos) || (gpibDeviceEOT != old_eot) ||
+				     (stickyAddressing != old_sticky) )
+					apply_termination();
+			}
+			catch (gpibDeviceException e)
+			{
+				delete argout;
+				GPIB_DEBUG_STREAM << "ReloadProperties command error on " << e.getDeviceName() << endl;
+				Tango::Except::throw_exception(
+				    (const char *) ("gpibDeviceException on " + e.getDeviceName() ).c_str(),
+				    (const char *) e.getiberrMessage().c_str(),
+				    (const char *) e.getibstaMessage().c_str(),
+				    Tango::ERR
+				);
+			}
+		}
+	}
+	
+	argout->length(changes.size());
+	for (unsigned int i = 0; i < changes.size(); i++)
+		(*argout)[i] = CORBA::string_dup(changes[i].c_str());
+	return argout;
+}
+
+
+//+------------------------------------------------------------------
+/**
+*	method:	GpibDeviceServer::get_latency_stats
+*
+*	description:	method to execute "GetLatencyStats"
+*	This command returns the latency statistics of the gpib operations
+*	(write, read, writeRead, binary, probe) since the server start or
+*	the last ResetLatencyStats.
+*
+* @return	One line per operation: count, p50, p90, p99, p99.9 and max latency in us
+*
+*/
+//+------------------------------------------------------------------
+Tango::DevVarStringArray *GpibDeviceServer::get_latency_stats()
+{
+	GPIB_DEBUG_STREAM << "GpibDeviceServer::get_latency_stats(): entering... !" << endl;
+	
+	//	Add your own code to control device here
+	
+	Tango::DevVarStringArray	*argout  = new Tango::DevVarStringArray();
+	argout->length(GPIB_NB_OP);
+	for (int op = 0; op < GPIB_NB_OP; op++)
+	{
+		gpibHistogram &h = latency.hist[op];
+		ostringstream os;
+		os << gpibOpName(op) << " count=" << h.count()
+		   << " p50=" << h.percentile(50.0)
+		   << " p90=" << h.percentile(90.0)
+		   << " p99=" << h.percentile(99.0)
+		   << " p99.9=" << h.percentile(99.9)
+		   << " max=" << h.max() << " us";
+		(*argout)[op] = CORBA::string_dup(os.str().c_str());
+	}
+	return argout;
+}
+
+
+//+------------------------------------------------------------------
+/**
+*	method:	GpibDeviceServer::reset_latency_stats
+*
+*	description:	method to execute "ResetLatencyStats"
+*	This command clears the latency histograms and the command latency
+*	breakdown of the device.
+*	It also clears a latency alarm (LatencyAlarmP99).
+*
+*/
+//+------------------------------------------------------------------
+void GpibDeviceServer::reset_latency_stats()
+{
+	GPIB_DEBUG_STREAM << "GpibDeviceServer::reset_latency_stats(): entering... !" << endl;
+	
+	//	Add your own code to control device here
+	
+	latency.reset();
+	
+	omni_mutex_lock lock(breakdown_mutex);
+	breakdown.clear();
+	breakdown_order.clear();
 }
 
 
 //+------------------------------------------------------------------
 /**
-*	method:	GpibDeviceServer::bccmd
+*	method:	GpibDeviceServer::dump_trace
 *
-*	description:	method to execute "BCcmd"
-*	Send a GPIB command message.
-*	This method is not used to transmit programming instruction to devices
-*	this kind of instructions are transmitted with the read / write methods.
-*	As done in write method, cmd automatically append EOS, as defined with
-*	setEOS method.
+*	description:	method to execute "DumpTrace"
+*	This command writes the flight recorder of the server (the last gpib
+*	driver calls of all its devices: time, duration, wait, ibcnt, ibsta
+*	and iberr) in a file, in Chrome trace-event JSON format.
 *
-* @param	argin	Command string.
+* @param	argin	File name
+* @return	Number of driver calls written
 *
 */
 //+------------------------------------------------------------------
-void GpibDeviceServer::bccmd(Tango::DevString argin)
+Tango::DevLong GpibDeviceServer::dump_trace(Tango::DevString argin)
 {
-	DEBUG_STREAM << "GpibDeviceServer::bccmd(): entering... !" << endl;
+	GPIB_DEBUG_STREAM << "GpibDeviceServer::dump_trace(): entering... !" << endl;
 	
 	//	Add your own code to control device here
 	
-	try
+	long n = gpibTraceDump(string(argin));
+	if (n < 0)
 	{
-		board0->cmd(argin);
-		
-	} catch (gpibDeviceException e) {
-		DEBUG_STREAM << "BCcmd command error on " << e.getDeviceName() << endl;
 		Tango::Except::throw_exception(
-		    (const char *) ("gpibDeviceException on " + e.getDeviceName() ).c_str(),
-		    (const char *) e.getiberrMessage().c_str(),
-		    (const char *) e.getibstaMessage().c_str(),
+		    (const char *) "GPIB_TRACE_ERROR",
+		    (const char *) ("Cannot write the trace file " + string(argin)).c_str(),
+		    (const char *) "GpibDeviceServer::dump_trace",
 		    Tango::ERR
 		);
 	}
+	return (Tango::DevLong) n;
 }
 
 
 //+------------------------------------------------------------------
 /**
-*	method:	GpibDeviceServer::open
+*	method:	GpibDeviceServer::bctrigger_list
 *
-*	description:	method to execute "Open"
-*	This command opens a gpib device using the gpibDeviceAddress property,
-*      assuming that the device is controlled by the board gpib0.
-*      Therefore it uses the 4th gpibDevice constructor.
-*	This command should not be used since gpib device is open on device 
-*      server initialisation.
-*	Its provided in case of problem to do it manually. 
-*      Throws DevFailed exception on error.
-*	This command is allowed on fault to accept reconnection.
+*	description:	method to execute "BCTriggerList"
+*	This command triggers a group of devices of the board with one Group
+*	Execute Trigger: the devices are all addressed as listeners, then the
+*	GET command is sent once on the bus.
 *
+* @param	argin	Addresses of the devices (pad, or pad + 256 * sad) to trigger
 *
 */
 //+------------------------------------------------------------------
-void GpibDeviceServer::open()
+void GpibDeviceServer::bctrigger_list(const Tango::DevVarLongArray *argin)
 {
-	DEBUG_STREAM << "GpibDeviceServer::open(): entering... !" << endl;
+	GPIB_DEBUG_STREAM << "GpibDeviceServer::bctrigger_list(): entering... !" << endl;
 	
 	//	Add your own code to control device here
 	
-	if ( dev_open )	// Trying to open an already opened device. Generate exception.
+	vector<int> pads;
+	for (unsigned long i = 0; i < argin->length(); i++)
+		pads.push_back((*argin)[i]);
+	try
 	{
-		DEBUG_STREAM << "Open command error." << endl;
-		Tango::Except::throw_exception(
-		    (const char *) "gpibDeviceException.",
-		    (const char *) "Attempt to open an already open device.",
-		    (const char *) "Device must be closed before open operation.",
-		    Tango::ERR
-		);
+		omni_mutex_lock bus(get_bus_mutex());
+		get_board()->triggerList(pads);
 	}
-	
-	try
+	catch (gpibDeviceException e)
 	{
-		gpib_device = new gpibDevice( gpibDeviceAddress );
-		//	    gpib_device->write("AYT"); 	// Are You There ?
-		if (gpib_device->isAlive() )
-		{
-			dev_open = true;
-			set_state(Tango::ON);
-			set_status("Gpib device is OK.");
-		}
-		else
-		{
-			set_state(Tango::FAULT);
-			set_status("Gpib device is not responding.");
-			DEBUG_STREAM << "Open command error on " << gpib_device->getName() << endl;
-			Tango::Except::throw_exception(
-			    (const char *) ("gpibDeviceException on " + gpib_device->getName() ).c_str(),
-			    (const char *) "Open command error.",
-			    (const char *) "gpib device is not responding.",
-			    Tango::ERR
-			);
-		}
-	} catch (gpibDeviceException e) {
-		set_state(Tango::FAULT);
-		set_status("Gpib device is not responding.");
-		if (gpib_device)
-		{
-			delete gpib_device; // AJOUT
-			gpib_device = NULL;
-		}
-		DEBUG_STREAM << "Open command error on " << e.getDeviceName() << endl;
+		GPIB_DEBUG_STREAM << "BCTriggerList command error on " << e.getDeviceName() << endl;
 		Tango::Except::throw_exception(
 		    (const char *) ("gpibDeviceException on " + e.getDeviceName() ).c_str(),
 		    (const char *) e.getiberrMessage().c_str(),
@@ -1327,72 +3468,44 @@ void GpibDeviceServer::open()
 
 //+------------------------------------------------------------------
 /**
-*	method:	GpibDeviceServer::open_by_name
+*	method:	GpibDeviceServer::bcsnapshot_group
 *
-*	description:	method to execute "OpenByName"
-*	This command opens a gpib device using the gpibDeviceName property,
-*      assuming that the device is controlled by the board gpib0.
-*      Therefore it uses the 2nd gpibDevice constructor.
-*	This command should not be used since gpib device is opened on 
-*      device server initialisation.
-*	It is provided in case of problem to do it manually. 
-*      Throws DevFailed exception on error.
-*	This command is allowed on fault to accept reconnection.
+*	description:	method to execute "BCSnapshotGroup"
+*	This command takes a synchronized snapshot of a group of devices of the
+*	board: they are triggered with one Group Execute Trigger, then their
+*	measurements are read back to back, after sending them the query if
+*	given (e.g. "FETCH?"). Replies are returned in the order of the
+*	addresses; for a failed read, the reply is empty and iberr is set.
+*	Times are in seconds since the epoch.
 *
+* @param	argin	Addresses of the devices (pad, or pad + 256 * sad), query sent before each read (optional)
+* @return	Replies, trigger time then time and iberr (-1 = ok) of each reply
 *
 */
 //+------------------------------------------------------------------
-void GpibDeviceServer::open_by_name()
+Tango::DevVarDoubleStringArray *GpibDeviceServer::bcsnapshot_group(const Tango::DevVarLongStringArray *argin)
 {
-	DEBUG_STREAM << "GpibDeviceServer::open_by_name(): entering... !" << endl;
+	GPIB_DEBUG_STREAM << "GpibDeviceServer::bcsnapshot_group(): entering... !" << endl;
 	
 	//	Add your own code to control device here
 	
-	if ( dev_open )	// Trying to open an already opened device. Generate exception.
-	{
-		DEBUG_STREAM << "OpenByName command error." << endl;
-		Tango::Except::throw_exception(
-		    (const char *) "gpibDeviceException.",
-		    (const char *) "Attempt to OpenByName an already open device.",
-		    (const char *) "Device must be closed before OpenByName operation.",
-		    Tango::ERR
-		);
-	}
+	vector<int>       pads;
+	vector<gpibReply> replies;
+	string            query;
+	long long         t;
 	
+	for (unsigned long i = 0; i < argin->lvalue.length(); i++)
+		pads.push_back(argin->lvalue[i]);
+	if (argin->svalue.length() > 0)
+		query = argin->svalue[0].in();
 	try
 	{
-		gpib_device = new gpibDevice( gpibDeviceName );
-		//	    gpib_device->write("AYT"); 	// Are You There ?
-		
-		if (gpib_device->isAlive() )
-		{
-			dev_open = true;
-			set_state(Tango::ON);
-			set_status("Gpib device is OK.");
-		}
-		else
-		{
-			set_state(Tango::FAULT);
-			set_status("Gpib device is not responding.");
-			DEBUG_STREAM << "OpenByName command error on " << gpib_device->getName() << endl;
-			Tango::Except::throw_exception(
-			    (const char *) ("gpibDeviceException on " + gpib_device->getName() ).c_str(),
-			    (const char *) "OpenByName command error.",
-			    (const char *) "gpib device is not responding.",
-			    Tango::ERR
-			);
-		}
-	} 
-	catch (gpibDeviceException e) 
+		omni_mutex_lock bus(get_bus_mutex());
+		t = get_board()->snapshotGroup(pads, query, replies);
+	}
+	catch (gpibDeviceException e)
 	{
-		set_state(Tango::FAULT);
-		set_status("Gpib device is not responding.");
-		if (gpib_device)
-		{
-			delete gpib_device; // AJOUT
-			gpib_device = NULL;
-		}
-		DEBUG_STREAM << "OpenByName command error on " << e.getDeviceName() << endl;
+		GPIB_DEBUG_STREAM << "BCSnapshotGroup command error on " << e.getDeviceName() << endl;
 		Tango::Except::throw_exception(
 		    (const char *) ("gpibDeviceException on " + e.getDeviceName() ).c_str(),
 		    (const char *) e.getiberrMessage().c_str(),
@@ -1400,55 +3513,63 @@ void GpibDeviceServer::open_by_name()
 		    Tango::ERR
 		);
 	}
+	
+	Tango::DevVarDoubleStringArray	*argout  = new Tango::DevVarDoubleStringArray();
+	argout->dvalue.length(1 + 2 * replies.size());
+	argout->svalue.length(replies.size());
+	argout->dvalue[0] = wall_time(t);
+	for (unsigned long i = 0; i < replies.size(); i++)
+	{
+		argout->dvalue[1 + 2 * i] = wall_time(replies[i].time);
+		argout->dvalue[2 + 2 * i] = replies[i].iberr;
+		argout->svalue[i] = CORBA::string_dup(replies[i].data.c_str());
+	}
+	return argout;
 }
 
 
 //+------------------------------------------------------------------
 /**
-*	method:	GpibDeviceServer::bcget_connected_device_list
+*	method:	GpibDeviceServer::bcwrite_many
 *
-*	description:	method to execute "BCGetConnectedDeviceList"
-*	This command returns the string array :
-*	
-*	+ primary address + secondary address for 1st device found
-*	
-*	+ primary address + secondary address for 2d device found
-*	ect ....
-*	ex:
-*	HEWLETT-PACKARD,3589A,3343A00642,A.00.03 PAD=6 SAD=0
+*	description:	method to execute "BCWriteMany"
+*	This command writes the same string to a group of devices of the board
+*	(e.g. *RST or a range setting): the devices are all addressed as
+*	listeners, then the bytes are sent once on the bus.
 *
-* @return	list of connected device on the GPIB bus
+* @param	argin	Addresses of the devices (pad, or pad + 256 * sad), string to write
+* @return	Number of bytes written
 *
 */
 //+------------------------------------------------------------------
-Tango::DevVarStringArray *GpibDeviceServer::bcget_connected_device_list()
+Tango::DevLong GpibDeviceServer::bcwrite_many(const Tango::DevVarLongStringArray *argin)
 {
+	GPIB_DEBUG_STREAM << "GpibDeviceServer::bcwrite_many(): entering... !" << endl;
+	
 	//	Add your own code to control device here
-	DEBUG_STREAM << "GpibDeviceServer::get_connected_device_list(): entering... !" << endl;
 	
-	Tango::DevVarStringArray	*argout  = new Tango::DevVarStringArray();	
+	Tango::DevLong	argout = 0;
+	vector<int>	pads;
+	
+	if (argin->svalue.length() != 1)
+	{
+		Tango::Except::throw_exception(
+		    (const char *) "GPIB_WRONG_ARGUMENT",
+		    (const char *) "BCWriteMany expects the addresses and one string",
+		    (const char *) "GpibDeviceServer::bcwrite_many",
+		    Tango::ERR
+		);
+	}
+	for (unsigned long i = 0; i < argin->lvalue.length(); i++)
+		pads.push_back(argin->lvalue[i]);
 	try
 	{
-		vector<gpibDeviceInfo> &devInfo = board0->getConnectedDeviceList();
-		argout->length(devInfo.size() );
-		for (long i = 0; i < devInfo.size(); i++)
-		{
-			ostringstream os1;
-			ostringstream os2;
-			
-			os1 << devInfo[i].dev_pad;
-			string pad = " PAD=" + os1.str();
-			
-			os2 << devInfo[i].dev_sad;
-			string sad = " SAD=" + os2.str();
-			(*argout)[i] = CORBA::string_dup( (devInfo[i].dev_idn + pad + sad  ).c_str() );
-		}
-	} 
-	catch (gpibDeviceException e) 
+		omni_mutex_lock bus(get_bus_mutex());
+		argout = get_board()->writeMany(pads, string(argin->svalue[0].in()));
+	}
+	catch (gpibDeviceException e)
 	{
-		DEBUG_STREAM << "getConnectedDeviceList command error on " << e.getDeviceName() << endl;
-		delete argout;
-		
+		GPIB_DEBUG_STREAM << "BCWriteMany command error on " << e.getDeviceName() << endl;
 		Tango::Except::throw_exception(
 		    (const char *) ("gpibDeviceException on " + e.getDeviceName() ).c_str(),
 		    (const char *) e.getiberrMessage().c_str(),
@@ -1462,31 +3583,38 @@ Tango::DevVarStringArray *GpibDeviceServer::bcget_connected_device_list()
 
 //+------------------------------------------------------------------
 /**
-*	method:	GpibDeviceServer::trigger
+*	method:	GpibDeviceServer::bcserial_poll_all
 *
-*	description:	method to execute "Trigger"
-*	This command sends a trigger signal to the GPIB device.
-*	If the device was previously set up, it can make its measurment, 
-*      and send it on the bus.
-*	Measure is now get with a read command.
+*	description:	method to execute "BCSerialPollAll"
+*	This command serial polls a group of devices of the board in one bus
+*	operation (AllSpoll) and returns their status bytes, in the order of
+*	the addresses. The devices requesting service are also set in the
+*	ServiceRequestMask attribute.
 *
+* @param	argin	Addresses of the devices (pad, or pad + 256 * sad) to poll
+* @return	Status byte of each device, -1 if it did not answer
 *
 */
 //+------------------------------------------------------------------
-void GpibDeviceServer::trigger()
+Tango::DevVarLongArray *GpibDeviceServer::bcserial_poll_all(const Tango::DevVarLongArray *argin)
 {
-	DEBUG_STREAM << "GpibDeviceServer::trigger(): entering... !" << endl;
+	GPIB_DEBUG_STREAM << "GpibDeviceServer::bcserial_poll_all(): entering... !" << endl;
 	
 	//	Add your own code to control device here
 	
-	throwExceptionIfDeviceIsClosed();
+	vector<int> pads;
+	vector<int> status;
 	
+	for (unsigned long i = 0; i < argin->length(); i++)
+		pads.push_back((*argin)[i]);
 	try
 	{
-		gpib_device->trigger();
-		
-	} catch (gpibDeviceException e) {
-		DEBUG_STREAM << "Trigger command error on " << e.getDeviceName() << endl;
+		omni_mutex_lock bus(get_bus_mutex());
+		get_board()->serialPollAll(pads, status);
+	}
+	catch (gpibDeviceException e)
+	{
+		GPIB_DEBUG_STREAM << "BCSerialPollAll command error on " << e.getDeviceName() << endl;
 		Tango::Except::throw_exception(
 		    (const char *) ("gpibDeviceException on " + e.getDeviceName() ).c_str(),
 		    (const char *) e.getiberrMessage().c_str(),
@@ -1494,47 +3622,57 @@ void GpibDeviceServer::trigger()
 		    Tango::ERR
 		);
 	}
+	
+	Tango::DevVarLongArray	*argout  = new Tango::DevVarLongArray();
+	argout->length(status.size());
+	attr_ServiceRequestMask_read = 0;
+	for (unsigned long i = 0; i < status.size(); i++)
+	{
+		(*argout)[i] = status[i];
+		if ( (status[i] >= 0) && (status[i] & 0x40) )
+			attr_ServiceRequestMask_read |= 1 << GPIB_ADDR_PAD(pads[i]);
+	}
+	return argout;
 }
 
 
 //+------------------------------------------------------------------
 /**
-*	method:	GpibDeviceServer::write_read
+*	method:	GpibDeviceServer::ppoll_config
 *
-*	description:	method to execute "WriteRead"
-*	This command perform a write on the GPIB device, and then perform 
-*      a read to get the answer, before returning it.
+*	description:	method to execute "PPollConfig"
+*	This command configures the gpib device to answer parallel polls: it
+*	drives the data line when its individual status (ist) equals sense.
+*	The line is then read by BCParallelPoll and the ParallelPoll attribute.
 *
-* @param	argin	String to send to the gpib device.
-* @return	String returned by the gpib Device.
+* @param	argin	[data line (1 to 8), sense (0 or 1)]
 *
 */
 //+------------------------------------------------------------------
-Tango::DevString GpibDeviceServer::write_read(Tango::DevString argin)
+void GpibDeviceServer::ppoll_config(const Tango::DevVarLongArray *argin)
 {
-	//	POGO has generated a method core with argout allocation.
-	//	If you would like to use a static reference without copying,
-	//	See "TANGO Device Server Programmer's Manual"
-	//		(chapter : Writing a TANGO DS / Exchanging data)
-	//------------------------------------------------------------
-	Tango::DevString	argout  = new char[RD_BUFFER_SIZE+1]; // AJOUT +1
-	string ret = "";
-	
-	DEBUG_STREAM << "GpibDeviceServer::write_read(): entering... !" << endl;
+	GPIB_DEBUG_STREAM << "GpibDeviceServer::ppoll_config(): entering... !" << endl;
 	
 	//	Add your own code to control device here
 	
 	throwExceptionIfDeviceIsClosed();
 	
+	if (argin->length() != 2) {
+		GPIB_DEBUG_STREAM << "GpibDeviceServer::ppoll_config(): Wrong input parameter number." << endl;
+		Tango::Except::throw_exception(
+		    (const char *) ("gpibDeviceException on " + gpib_device->getName() ).c_str(),
+		    (const char *) "GpibDeviceServer::ppoll_config(): Wrong input parameter number.",
+		    (const char *) "Two parameters are needed: data line and sense.",
+		    Tango::ERR
+		);
+	}
+	
 	try
 	{
-		ret = gpib_device->writeRead(argin);
-		memset(argout,0, (RD_BUFFER_SIZE+1));  // AJOUT +1
-		strcpy(argout, ret.c_str() );
+		gpib_device->ppollConfig( (*argin)[0], (*argin)[1]);
 		
 	} catch (gpibDeviceException e) {
-		DEBUG_STREAM << "WriteRead command error on " << e.getDeviceName() << endl;
-		delete[] argout;
+		GPIB_DEBUG_STREAM << "PPollConfig command error on " << e.getDeviceName() << endl;
 		Tango::Except::throw_exception(
 		    (const char *) ("gpibDeviceException on " + e.getDeviceName() ).c_str(),
 		    (const char *) e.getiberrMessage().c_str(),
@@ -1542,47 +3680,32 @@ Tango::DevString GpibDeviceServer::write_read(Tango::DevString argin)
 		    Tango::ERR
 		);
 	}
-	return argout;
 }
 
 
 //+------------------------------------------------------------------
 /**
-*	method:	GpibDeviceServer::config
-*
-*	description:	method to execute "Config"
-*	index 0 of input array is the GPIB option to modify.
-*	index 1 is the new value to associate to this option.
+*	method:	GpibDeviceServer::ppoll_unconfig
 *
-* @param	argin	Array of 2 long.
+*	description:	method to execute "PPollUnconfig"
+*	This command stops the gpib device answering parallel polls.
 *
 */
 //+------------------------------------------------------------------
-void GpibDeviceServer::config(const Tango::DevVarLongArray *argin)
+void GpibDeviceServer::ppoll_unconfig()
 {
-	DEBUG_STREAM << "GpibDeviceServer::config(): entering... !" << endl;
+	GPIB_DEBUG_STREAM << "GpibDeviceServer::ppoll_unconfig(): entering... !" << endl;
 	
 	//	Add your own code to control device here
 	
 	throwExceptionIfDeviceIsClosed();
 	
-	// Check parameter number.
-	if (argin->length() != 2) {
-		DEBUG_STREAM << "GpibDeviceServer::config(): Wrong input parameter number." << endl;
-		Tango::Except::throw_exception(
-		    (const char *) ("gpibDeviceException on " + gpib_device->getName() ).c_str(),
-		    (const char *) "GpibDeviceServer::config(): Wrong input parameter number.",
-		    (const char *) "Two parameters are needed.",
-		    Tango::ERR
-		);
-	}
-	
 	try
 	{
-		gpib_device->config( (*argin)[0], (*argin)[1] );
+		gpib_device->ppollUnconfig();
 		
 	} catch (gpibDeviceException e) {
-		DEBUG_STREAM << "Config command error on " << e.getDeviceName() << endl;
+		GPIB_DEBUG_STREAM << "PPollUnconfig command error on " << e.getDeviceName() << endl;
 		Tango::Except::throw_exception(
 		    (const char *) ("gpibDeviceException on " + e.getDeviceName() ).c_str(),
 		    (const char *) e.getiberrMessage().c_str(),
@@ -1595,37 +3718,32 @@ void GpibDeviceServer::config(const Tango::DevVarLongArray *argin)
 
 //+------------------------------------------------------------------
 /**
-*	method:	GpibDeviceServer::bcconfig
+*	method:	GpibDeviceServer::bcparallel_poll
 *
-*	description:	method to execute "BCConfig"
-*	Same method than Config, but sent on gpib Board instead of GPIB device.
+*	description:	method to execute "BCParallelPoll"
+*	This command parallel polls the board: one bus cycle returns the state
+*	of up to 8 devices, bit n being set by the devices configured on data
+*	line n+1 (see PPollConfig).
 *
-* @param	argin	Array of 2 long.
+* @return	Parallel poll response byte
 *
 */
 //+------------------------------------------------------------------
-void GpibDeviceServer::bcconfig(const Tango::DevVarLongArray *argin)
+Tango::DevLong GpibDeviceServer::bcparallel_poll()
 {
-	DEBUG_STREAM << "GpibDeviceServer::bcconfig(): entering... !" << endl;
+	GPIB_DEBUG_STREAM << "GpibDeviceServer::bcparallel_poll(): entering... !" << endl;
 	
 	//	Add your own code to control device here
 	
-	if (argin->length() != 2) {
-		DEBUG_STREAM << "GpibDeviceServer::bcconfig(): Wrong input parameter number." << endl;
-		Tango::Except::throw_exception(
-		    (const char *) ("gpibDeviceException on " + gpib_device->getName() ).c_str(),
-		    (const char *) "GpibDeviceServer::bcconfig(): Wrong input parameter number.",
-		    (const char *) "Two parameters are needed.",
-		    Tango::ERR
-		);
-	}
-	
 	try
 	{
-		board0->config( (*argin)[0], (*argin)[1]);
-		
-	} catch (gpibDeviceException e) {
-		DEBUG_STREAM << "BCConfig command error on " << e.getDeviceName() << endl;
+		omni_mutex_lock bus(get_bus_mutex());
+		attr_ParallelPoll_read = get_board()->parallelPoll();
+		ppoll_time = gpibClock();
+	}
+	catch (gpibDeviceException e)
+	{
+		GPIB_DEBUG_STREAM << "BCParallelPoll command error on " << e.getDeviceName() << endl;
 		Tango::Except::throw_exception(
 		    (const char *) ("gpibDeviceException on " + e.getDeviceName() ).c_str(),
 		    (const char *) e.getiberrMessage().c_str(),
@@ -1633,175 +3751,171 @@ void GpibDeviceServer::bcconfig(const Tango::DevVarLongArray *argin)
 		    Tango::ERR
 		);
 	}
+	return attr_ParallelPoll_read;
 }
 
 
 //+------------------------------------------------------------------
 /**
-*	method:	GpibDeviceServer::send_bin_data
+*	method:	GpibDeviceServer::bcstart_fast_poll
 *
-*	description:	method to execute "SendBinData"
-*	This command send an array of binary data to the device 
-*      through the GPIB bus.
-*	Throws devFailed on error.
+*	description:	method to execute "BCStartFastPoll"
+*	This command starts parallel polling the board in background. The
+*	ParallelPoll attribute then returns the last response byte without any
+*	bus access. A running fast poll is restarted with the new period.
 *
-* @param	argin	Array of binary data to send to the device
+* @param	argin	Period of the polls, us (1000 to 1000000)
 *
 */
 //+------------------------------------------------------------------
-void GpibDeviceServer::send_bin_data(const Tango::DevVarCharArray *argin)
+void GpibDeviceServer::bcstart_fast_poll(Tango::DevLong argin)
 {
-	DEBUG_STREAM << "GpibDeviceServer::send_bin_data(): entering... !" << endl;
+	GPIB_DEBUG_STREAM << "GpibDeviceServer::bcstart_fast_poll(): entering... !" << endl;
 	
 	//	Add your own code to control device here
-	
-	throwExceptionIfDeviceIsClosed();
-	
-	char *data =  new char[argin->length()];
-	// check if memory is allocated
-	if (data == NULL)
+	
+	if ( (argin < GPIB_FAST_POLL_MIN_PERIOD) || (argin > GPIB_FAST_POLL_MAX_PERIOD) )
 	{
-		DEBUG_STREAM << "send_bin_data can not allocate memory." <<endl;
 		Tango::Except::throw_exception(
-		    (const char*) "gpibDeviceException.",
-		    (const char*) "memory not allocated.",
-		    (const char*) "malloc() in send_bin_data().",
+		    (const char *) "GPIB_BAD_PERIOD",
+		    (const char *) "Fast poll period must be between 1000 and 1000000 us",
+		    (const char *) "GpibDeviceServer::bcstart_fast_poll",
 		    Tango::ERR
 		);
 	}
+	get_board();
+	stop_fast_poll();
 	
-	// sendData expected a char* and not a Tango::DevVarCharArray *
-	for(int i = 0; i < argin->length(); i++)
-		data[i] = (*argin)[i];
-		
+	// The thread polls with its own board object: board0 is used by
+	// the commands meanwhile. They share the bus lock.
 	try
 	{
-		gpib_device->sendData(data, argin->length());
-		delete[] data;
+		fast_poll = new GpibFastPoll(new gpibBoard(gpibBoardName), argin, get_bus_mutex());
 	}
-	catch (gpibDeviceException e) {
-		if(data) delete[] data;
-		DEBUG_STREAM << "send_bin_data command error on " << e.getDeviceName() << endl;
+	catch (gpibDeviceException e)
+	{
+		GPIB_DEBUG_STREAM << "BCStartFastPoll command error on " << e.getDeviceName() << endl;
 		Tango::Except::throw_exception(
-		    (const char*) ("gpibDeviceException on " + e.getDeviceName() ).c_str(),
-		    (const char*) e.getiberrMessage().c_str(),
-		    (const char*) e.getibstaMessage().c_str(),
+		    (const char *) ("gpibDeviceException on " + e.getDeviceName() ).c_str(),
+		    (const char *) e.getiberrMessage().c_str(),
+		    (const char *) e.getibstaMessage().c_str(),
 		    Tango::ERR
 		);
 	}
-	catch(...)
-	{
-		if(data) delete[] data;
-		FATAL_STREAM << "send_bin_data catch(...) case " << endl;
-	}
 }
 
 
 //+------------------------------------------------------------------
 /**
-*	method:	GpibDeviceServer::receive_bin_data
-*
-*	description:	method to execute "ReceiveBinData"
-*	This command reads an array of binary data from a gpib device.
-*	Up to 65536 bytes. In generaly, a Gpib device can send or receive 64Ko.
-*	Throws an DevFailed exception on error
+*	method:	GpibDeviceServer::bcstop_fast_poll
 *
-* @param	argin	length of the data to receive from the Gpib device
-* @return	Array of binary data
+*	description:	method to execute "BCStopFastPoll"
+*	This command stops the background parallel poll of the board.
 *
 */
 //+------------------------------------------------------------------
-Tango::DevVarCharArray *GpibDeviceServer::receive_bin_data(Tango::DevLong argin)
+void GpibDeviceServer::bcstop_fast_poll()
 {
-	//	POGO has generated a method core with argout allocation.
-	//	If you would like to use a static reference without copying,
-	//	See "TANGO Device Server Programmer's Manual"
-	//		(chapter : Writing a TANGO DS / Exchanging data)
-	//------------------------------------------------------------
-	DEBUG_STREAM << "GpibDeviceServer::receive_bin_data(): entering... !" << endl;
+	GPIB_DEBUG_STREAM << "GpibDeviceServer::bcstop_fast_poll(): entering... !" << endl;
 	
 	//	Add your own code to control device here
 	
-	throwExceptionIfDeviceIsClosed();
+	stop_fast_poll();
+}
+
+
+//+------------------------------------------------------------------
+/**
+*	method:	GpibDeviceServer::bcwrite_read_many
+*
+*	description:	method to execute "BCWriteReadMany"
+*	This command sends the same query to a group of devices of the board
+*	and reads their replies back to back, in one command. Replies are
+*	returned in the order of the addresses; a device which fails does not
+*	throw: its reply is empty and its iberr is set. The bus lock of the board
+*	is held meanwhile: fast poll and bus monitor wait for the end.
+*
+* @param	argin	Addresses of the devices (pad, or pad + 256 * sad), query (e.g. :MEAS?)
+* @return	iberr (-1 = ok) and reply of each device
+*
+*/
+//+------------------------------------------------------------------
+Tango::DevVarLongStringArray *GpibDeviceServer::bcwrite_read_many(const Tango::DevVarLongStringArray *argin)
+{
+	GPIB_DEBUG_STREAM << "GpibDeviceServer::bcwrite_read_many(): entering... !" << endl;
 	
-	long nb_data = argin;
-	char	*response;
+	//	Add your own code to control device here
 	
-	try
+	vector<int>       pads;
+	vector<gpibReply> replies;
+	
+	if (argin->svalue.length() != 1)
 	{
-		response = gpib_device->receiveData(nb_data);
-		
-	}
-	catch (gpibDeviceException e) {
-		DEBUG_STREAM << "receive_bin_data command error on " << e.getDeviceName() << endl;
-		//if (argout) delete argout;
 		Tango::Except::throw_exception(
-		    (const char*)(("gpibDeviceException on " + e.getDeviceName() ).c_str()),
-		    (const char*)e.getiberrMessage().c_str(),
-		    (const char*)e.getibstaMessage().c_str(),
+		    (const char *) "GPIB_WRONG_ARGUMENT",
+		    (const char *) "BCWriteReadMany expects the addresses and one query",
+		    (const char *) "GpibDeviceServer::bcwrite_read_many",
 		    Tango::ERR
 		);
 	}
-	
-	Tango::DevVarCharArray *argout = new Tango::DevVarCharArray();
-	argout->length(nb_data);
-	
-	// check if memory is allocated
-	if (argout == NULL)
+	for (unsigned long i = 0; i < argin->lvalue.length(); i++)
+		pads.push_back(argin->lvalue[i]);
+	try
+	{
+		omni_mutex_lock bus(get_bus_mutex());
+		get_board()->writeReadMany(pads, string(argin->svalue[0].in()), replies);
+	}
+	catch (gpibDeviceException e)
 	{
-		DEBUG_STREAM << "receive_bin_data can not allocate memory." << endl;
+		GPIB_DEBUG_STREAM << "BCWriteReadMany command error on " << e.getDeviceName() << endl;
 		Tango::Except::throw_exception(
-		    (const char*) "gpibDeviceException.",
-		    (const char*) "memory not allocated.",
-		    (const char*) "new Tango::DevVarCharArray() failed in receive_bin_data().",
+		    (const char *) ("gpibDeviceException on " + e.getDeviceName() ).c_str(),
+		    (const char *) e.getiberrMessage().c_str(),
+		    (const char *) e.getibstaMessage().c_str(),
 		    Tango::ERR
 		);
 	}
 	
-	for (long i = 0; i < nb_data; i++)
-		(*argout)[i] = response[i];
-		
-	delete [] response;
-	
+	Tango::DevVarLongStringArray	*argout  = new Tango::DevVarLongStringArray();
+	argout->lvalue.length(replies.size());
+	argout->svalue.length(replies.size());
+	for (unsigned long i = 0; i < replies.size(); i++)
+	{
+		argout->lvalue[i] = replies[i].iberr;
+		argout->svalue[i] = CORBA::string_dup(replies[i].data.c_str());
+	}
 	return argout;
 }
 
 
 //+------------------------------------------------------------------
 /**
-*	method:	GpibDeviceServer::bcget_config
+*	method:	GpibDeviceServer::bcset_hs488
 *
-*	description:	method to execute "BCGetConfig"
-*	Returns a value for one configuration option for a GPIB Board.
-*	Throws Tango::DevFailed exception on error.
+*	description:	method to execute "BCSetHS488"
+*	This command enables the HS488 high speed handshake of the board for the
+*	given total cable length, or disables it (0). The value is saved in the
+*	GpibBoardHS488 class property of the board (e.g. GpibBoardHS488_gpib0).
+*	BCTestHS488 checks a device first.
 *
-* @param	argin	Configuration option index (see ibask table)
-* @return	Value for wanted configuration option
+* @param	argin	Cable length in meters (1 to 15), 0 = standard handshake
 *
 */
 //+------------------------------------------------------------------
-Tango::DevShort GpibDeviceServer::bcget_config(Tango::DevShort argin)
+void GpibDeviceServer::bcset_hs488(Tango::DevShort argin)
 {
-	Tango::DevShort	argout ;
-	DEBUG_STREAM << "GpibDeviceServer::bcget_config(): entering... !" << endl;
+	GPIB_DEBUG_STREAM << "GpibDeviceServer::bcset_hs488(): entering... !" << endl;
 	
 	//	Add your own code to control device here
 	
-	// We don't check that board0 is open since this is done in
-	// the init_device method.
-	
-	// TODO: should test the value od argin = config. option index
-	//       since this is not done in getconfig() function inside
-	//       gpibDevice class.
-	
 	try
 	{
-		argout = (Tango::DevShort)board0->getconfig(argin);
+		omni_mutex_lock bus(get_bus_mutex());
+		get_board()->setHS488(argin);
 	}
 	catch (gpibDeviceException e)
 	{
-		DEBUG_STREAM << "BCGetConfig command error on " << e.getDeviceName() << endl;
-		argout = 0;
+		GPIB_DEBUG_STREAM << "BCSetHS488 command error on " << e.getDeviceName() << endl;
 		Tango::Except::throw_exception(
 		    (const char *) ("gpibDeviceException on " + e.getDeviceName() ).c_str(),
 		    (const char *) e.getiberrMessage().c_str(),
@@ -1809,49 +3923,65 @@ Tango::DevShort GpibDeviceServer::bcget_config(Tango::DevShort argin)
 		    Tango::ERR
 		);
 	}
-	return argout;
-	
-	// if would work without exceptions, then instead of the last
-	// try/catch block above would have just the following 2 lines:
-	//argout = (Tango::DevShort)board0->getconfig(argin);
-	//return argout;
+	gpibBoardHS488 = argin;
+	write_board_property("GpibBoardHS488", gpibBoardHS488);
 }
 
 
 //+------------------------------------------------------------------
 /**
-*	method:	GpibDeviceServer::get_config
+*	method:	GpibDeviceServer::bctest_hs488
 *
-*	description:	method to execute "GetConfig"
-*	Get a value for one configuration option for a GPIB device.
-*	Throws Tango::DevFailed exception on error.
+*	description:	method to execute "BCTestHS488"
+*	This command checks HS488 on a device: the reply to the query is read
+*	with the standard handshake, then with HS488 for the cable length. If
+*	the device follows, HS488 stays enabled on the board; else the device is
+*	cleared and the board goes back to the standard handshake. The result is
+*	saved in the GpibBoardHS488 class property of the board.
 *
-* @param	argin	Configuration option index (see ibask table)
-* @return	Value for wanted configuration option
+* @param	argin	[address, size, cable length], query returning size bytes (e.g. a waveform)
+* @return	[bytes, standard bytes/s, HS488 bytes/s (0 = failed), HS488 enabled (0/1), iberr (-1 = ok)]
 *
 */
 //+------------------------------------------------------------------
-Tango::DevShort GpibDeviceServer::get_config(Tango::DevShort argin)
+Tango::DevVarDoubleArray *GpibDeviceServer::bctest_hs488(const Tango::DevVarLongStringArray *argin)
 {
-	Tango::DevShort	argout ;
-	DEBUG_STREAM << "GpibDeviceServer::get_config(): entering... !" << endl;
+	GPIB_DEBUG_STREAM << "GpibDeviceServer::bctest_hs488(): entering... !" << endl;
 	
 	//	Add your own code to control device here
 	
-	throwExceptionIfDeviceIsClosed();
-	
-	// TODO: should test the value od argin = config. option index
-	//       since this is not done in getconfig() function inside
-	//       gpibDevice class.
+	gpibSpeedTest	r;
 	
+	if ( (argin->lvalue.length() != 3) || (argin->svalue.length() != 1) )
+	{
+		Tango::Except::throw_exception(
+		    (const char *) "GPIB_WRONG_ARGUMENT",
+		    (const char *) "BCTestHS488 expects [address, size, cable length] and a query",
+		    (const char *) "GpibDeviceServer::bctest_hs488",
+		    Tango::ERR
+		);
+	}
 	try
 	{
-		argout = (Tango::DevShort)gpib_device->getconfig(argin);
+		omni_mutex_lock bus(get_bus_mutex());
+		get_board()->testHS488(argin->lvalue[0], string(argin->svalue[0].in()),
+		                       argin->lvalue[1], argin->lvalue[2], r);
 	}
 	catch (gpibDeviceException e)
 	{
-		DEBUG_STREAM << "GetConfig command error on " << e.getDeviceName() << endl;
-		argout = 0;
+		GPIB_DEBUG_STREAM << "BCTestHS488 command error on " << e.getDeviceName() << endl;
+		// A failed standard handshake read leaves HS488 disabled.
+		try
+		{
+			if ( (gpibBoardHS488 != 0) && (get_board()->getHS488() == 0) )
+			{
+				gpibBoardHS488 = 0;
+				write_board_property("GpibBoardHS488", gpibBoardHS488);
+			}
+		}
+		catch (gpibDeviceException)
+		{
+		}
 		Tango::Except::throw_exception(
 		    (const char *) ("gpibDeviceException on " + e.getDeviceName() ).c_str(),
 		    (const char *) e.getiberrMessage().c_str(),
@@ -1859,45 +3989,63 @@ Tango::DevShort GpibDeviceServer::get_config(Tango::DevShort argin)
 		    Tango::ERR
 		);
 	}
+	gpibBoardHS488 = r.fallback ? 0 : argin->lvalue[2];
+	write_board_property("GpibBoardHS488", gpibBoardHS488);
+	
+	Tango::DevVarDoubleArray	*argout  = new Tango::DevVarDoubleArray();
+	argout->length(5);
+	(*argout)[0] = r.bytes;
+	(*argout)[1] = r.standard;
+	(*argout)[2] = r.hs488;
+	(*argout)[3] = r.fallback ? 0 : 1;
+	(*argout)[4] = r.iberr;
 	return argout;
-	
-	// if would work without exceptions, then instead of the last
-	// try/catch block above would have just the following 2 lines:
-	//argout = (Tango::DevShort)gpib_device->getconfig(argin);
-	//return argout;
 }
 
 
 //+------------------------------------------------------------------
 /**
-*	method:	GpibDeviceServer::listener_check
+*	method:	GpibDeviceServer::bctune_bus
 *
-*	description:	method to execute "ListenerCheck"
-*	This command returns the status of listener check on device and returns
-*	1, when device responds (= is alive) and 0, when not.
-*	Throws Tango::DevFailed exception on error.
+*	description:	method to execute "BCTuneBus"
+*	This command finds the fastest safe bus timing (IbcTIMING) and DMA
+*	(IbcDMA) setting of the board: each setting is tried with a short
+*	transfer benchmark on the devices, whose replies must be read without
+*	error and equal to the ones of the default setting. The fastest safe
+*	setting is applied and saved in the GpibBoardTiming and GpibBoardDMA
+*	class properties of the board, which are applied again at init.
+*	The query must get a fixed reply (e.g. *IDN?, not a measurement).
+*	The command fails, and the board keeps its setting, when no setting
+*	faster than the default one is safe.
 *
-* @return	Flag telling if selected GPIB device is alive
+* @param	argin	Addresses of the devices (pad, or pad + 256 * sad) (none = all listeners), query with a fixed reply (optional, default *IDN?)
+* @return	Chosen timing and DMA, then timing, DMA and us of all transfers (-1 = failed) of each setting tried
 *
 */
 //+------------------------------------------------------------------
-Tango::DevShort GpibDeviceServer::listener_check()
+Tango::DevVarLongArray *GpibDeviceServer::bctune_bus(const Tango::DevVarLongStringArray *argin)
 {
-	Tango::DevShort	argout ;
-	DEBUG_STREAM << "GpibDeviceServer::listener_check(): entering... !" << endl;
+	GPIB_DEBUG_STREAM << "GpibDeviceServer::bctune_bus(): entering... !" << endl;
 	
 	//	Add your own code to control device here
 	
-	throwExceptionIfDeviceIsClosed();
+	vector<int>            pads;
+	vector<gpibTuneResult> results;
+	string                 query = "*IDN?";
+	int                    best = 0;
 	
+	for (unsigned long i = 0; i < argin->lvalue.length(); i++)
+		pads.push_back(argin->lvalue[i]);
+	if ( (argin->svalue.length() > 0) && (strlen(argin->svalue[0].in()) > 0) )
+		query = argin->svalue[0].in();
 	try
 	{
-		argout = (Tango::DevShort)gpib_device->isAlive();
+		omni_mutex_lock bus(get_bus_mutex());
+		best = get_board()->tuneBus(pads, query, GPIB_TUNE_REPEAT, results);
 	}
 	catch (gpibDeviceException e)
 	{
-		DEBUG_STREAM << "ListenerCheck command error on " << e.getDeviceName() << endl;
-		argout = 0;
+		GPIB_DEBUG_STREAM << "BCTuneBus command error on " << e.getDeviceName() << endl;
 		Tango::Except::throw_exception(
 		    (const char *) ("gpibDeviceException on " + e.getDeviceName() ).c_str(),
 		    (const char *) e.getiberrMessage().c_str(),
@@ -1905,44 +4053,124 @@ Tango::DevShort GpibDeviceServer::listener_check()
 		    Tango::ERR
 		);
 	}
+	gpibBoardTiming = results[best].timing;
+	gpibBoardDMA = results[best].dma;
+	write_board_property("GpibBoardTiming", gpibBoardTiming);
+	write_board_property("GpibBoardDMA", gpibBoardDMA);
+	
+	Tango::DevVarLongArray	*argout  = new Tango::DevVarLongArray();
+	argout->length(2 + 3 * results.size());
+	(*argout)[0] = gpibBoardTiming;
+	(*argout)[1] = gpibBoardDMA;
+	for (unsigned long i = 0; i < results.size(); i++)
+	{
+		(*argout)[2 + 3 * i] = results[i].timing;
+		(*argout)[3 + 3 * i] = results[i].dma;
+		(*argout)[4 + 3 * i] = results[i].ok ? (Tango::DevLong) (results[i].ns / 1000) : -1;
+	}
 	return argout;
+}
+
+
+//+------------------------------------------------------------------
+/**
+*	method:	GpibDeviceServer::bcget_connected_device_list_sad
+*
+*	description:	method to execute "BCGetConnectedDeviceListSAD"
+*	This command returns the devices of the bus as BCGetConnectedDeviceList,
+*	the secondary addresses of every device answering on its primary
+*	address being scanned too: all the modules of a mainframe are listed
+*	(e.g. GPIBSIM,SWITCH,0,1.0 PAD=14 SAD=96). The address of a device for
+*	the group commands (BCWriteReadMany ...) is PAD + 256 * SAD.
+*
+* @return	list of connected device on the GPIB bus, with their secondary addresses
+*
+*/
+//+------------------------------------------------------------------
+Tango::DevVarStringArray *GpibDeviceServer::bcget_connected_device_list_sad()
+{
+	GPIB_DEBUG_STREAM << "GpibDeviceServer::bcget_connected_device_list_sad(): entering... !" << endl;
 	
-	// if would work without exceptions, then instead of the last
-	// try/catch block above would have just the following 2 lines:
-	//argout = (Tango::DevShort)gpib_device->isAlive();
-	//return argout;
+	//	Add your own code to control device here
+	
+	return connected_devices(true);
 }
 
 
 //+------------------------------------------------------------------
 /**
-*	method:	GpibDeviceServer::get_serial_poll
+*	method:	GpibDeviceServer::bcstart_monitor
 *
-*	description:	method to execute "GetSerialPoll"
-*	This command returns the serial poll byte of device.
-*	Throws Tango::DevFailed exception on error.
+*	description:	method to execute "BCStartMonitor"
+*	This command starts the passive bus monitor: a spare board on the bus
+*	cable is put in listen-only mode (not system controller) and records every byte of the bus
+*	traffic in background. The BusUtilization, TalkerBandwidth and
+*	ListenerBandwidth attributes then give the bus statistics, and
+*	BCDumpMonitor writes the capture. A running monitor is restarted. A
+*	board which runs the monitor of another device of the server is refused.
 *
-* @return	Serial poll status byte
+* @param	argin	Name of the spare board (e.g. gpib1) on the bus cable
 *
 */
 //+------------------------------------------------------------------
-Tango::DevShort GpibDeviceServer::get_serial_poll()
+void GpibDeviceServer::bcstart_monitor(Tango::DevString argin)
 {
-	Tango::DevShort	argout ;
-	DEBUG_STREAM << "GpibDeviceServer::get_serial_poll(): entering... !" << endl;
+	GPIB_DEBUG_STREAM << "GpibDeviceServer::bcstart_monitor(): entering... !" << endl;
 	
 	//	Add your own code to control device here
 	
-	throwExceptionIfDeviceIsClosed();
+	string name(argin);
+	if (name == gpibBoardName)
+	{
+		Tango::Except::throw_exception(
+		    (const char *) "GPIB_WRONG_ARGUMENT",
+		    (const char *) "The monitor needs a spare board, not the board of the device",
+		    (const char *) "GpibDeviceServer::bcstart_monitor",
+		    Tango::ERR
+		);
+	}
+	stop_bus_monitor();
 	
+	GpibDeviceServerClass	*ds_class =
+	    (static_cast<GpibDeviceServerClass *>(get_device_class()));
+	gpibBoard *board = NULL;
+	string     owner;
+	int        claimed = -1;
 	try
 	{
-		argout = (Tango::DevShort)gpib_device->getSerialPoll();
+		board = new gpibBoard(name);
+		if (ds_class->claim_monitor_board(board->getBoardInd(), device_name, owner) == false)
+		{
+			delete board;
+			Tango::Except::throw_exception(
+			    (const char *) "GPIB_MONITOR_BUSY",
+			    (const char *) ("A bus monitor already runs on " + name + " (device " + owner + ")").c_str(),
+			    (const char *) "GpibDeviceServer::bcstart_monitor",
+			    Tango::ERR
+			);
+		}
+		claimed = board->getBoardInd();
+		board->setTimeOut(GPIB_MONITOR_TMO);
+		board->setListenOnly(true);
+		bus_monitor = new GpibBusMonitor(board, ds_class->get_bus_mutex(claimed));
+		bus_monitor_board = claimed;
 	}
 	catch (gpibDeviceException e)
 	{
-		DEBUG_STREAM << "GetSerialPoll command error on " << e.getDeviceName() << endl;
-		argout = 0;
+		if (board != NULL)
+		{
+			try
+			{
+				board->setListenOnly(false);
+			}
+			catch (gpibDeviceException)
+			{
+			}
+			delete board;
+		}
+		if (claimed >= 0)
+			ds_class->release_monitor_board(claimed, device_name);
+		GPIB_DEBUG_STREAM << "BCStartMonitor command error on " << e.getDeviceName() << endl;
 		Tango::Except::throw_exception(
 		    (const char *) ("gpibDeviceException on " + e.getDeviceName() ).c_str(),
 		    (const char *) e.getiberrMessage().c_str(),
@@ -1950,69 +4178,72 @@ Tango::DevShort GpibDeviceServer::get_serial_poll()
 		    Tango::ERR
 		);
 	}
-	return argout;
-	
-	// if would work without exceptions, then instead of the last
-	// try/catch block above would have just the following 2 lines:
-	//argout = (Tango::DevShort)gpib_device->getSerialPoll();
-	//return argout;
 }
 
 
 //+------------------------------------------------------------------
 /**
-*	method:	GpibDeviceServer::get_device_pad
-*
-*	description:	method to execute "GetDevicePad"
-*	This command returns the primary address of device,
-*	which has possible values 0->30.
-*	Throws Tango::DevFailed exception on error.
+*	method:	GpibDeviceServer::bcstop_monitor
 *
-* @return	Device primary address
+*	description:	method to execute "BCStopMonitor"
+*	This command stops the passive bus monitor and puts its board back
+*	in normal mode.
 *
 */
 //+------------------------------------------------------------------
-Tango::DevShort GpibDeviceServer::get_device_pad()
+void GpibDeviceServer::bcstop_monitor()
 {
-	Tango::DevShort	argout ;
-	DEBUG_STREAM << "GpibDeviceServer::get_device_pad(): entering... !" << endl;
+	GPIB_DEBUG_STREAM << "GpibDeviceServer::bcstop_monitor(): entering... !" << endl;
 	
 	//	Add your own code to control device here
 	
-	throwExceptionIfDeviceIsClosed();
-	
-	argout = (Tango::DevShort)gpib_device->getDeviceAddr(); // This is soft
-	// command. No gpibDeviceException here.
-	
-	return argout;
+	stop_bus_monitor();
 }
 
 
 //+------------------------------------------------------------------
 /**
-*	method:	GpibDeviceServer::get_board_index
+*	method:	GpibDeviceServer::bcdump_monitor
 *
-*	description:	method to execute "GetBoardIndex"
-*	This command returns the board index.
-*	It is the number N at the end of the name /dev/gpibN.
-*	Throws Tango::DevFailed exception on error.
+*	description:	method to execute "BCDumpMonitor"
+*	This command writes the capture of the bus monitor (the last bytes
+*	seen on the bus, with their time, command or data, talker and
+*	listeners) in a text file, one byte per line.
 *
-* @return	Board Index (starts with 0)
+* @param	argin	File name
+* @return	Number of bus bytes written
 *
 */
 //+------------------------------------------------------------------
-Tango::DevShort GpibDeviceServer::get_board_index()
+Tango::DevLong GpibDeviceServer::bcdump_monitor(Tango::DevString argin)
 {
-	Tango::DevShort	argout ;
-	DEBUG_STREAM << "GpibDeviceServer::get_board_index(): entering... !" << endl;
+	GPIB_DEBUG_STREAM << "GpibDeviceServer::bcdump_monitor(): entering... !" << endl;
 	
 	//	Add your own code to control device here
-	throwExceptionIfDeviceIsClosed();
 	
-	argout = (Tango::DevShort)boardind;
-	return argout;
+	if (bus_monitor == NULL)
+	{
+		Tango::Except::throw_exception(
+		    (const char *) "GPIB_MONITOR_ERROR",
+		    (const char *) "The bus monitor is not running (BCStartMonitor)",
+		    (const char *) "GpibDeviceServer::bcdump_monitor",
+		    Tango::ERR
+		);
+	}
+	long n = bus_monitor->dump(string(argin));
+	if (n < 0)
+	{
+		Tango::Except::throw_exception(
+		    (const char *) "GPIB_MONITOR_ERROR",
+		    (const char *) ("Cannot write the capture file " + string(argin)).c_str(),
+		    (const char *) "GpibDeviceServer::bcdump_monitor",
+		    Tango::ERR
+		);
+	}
+	return (Tango::DevLong) n;
 }
 
+
 /**
  * This method test the dev_open flag, and throws an exception if its false.
  * The method is here to factorize code in several places where this test was
@@ -2020,9 +4251,22 @@ Tango::DevShort GpibDeviceServer::get_board_index()
  */
 void GpibDeviceServer::throwExceptionIfDeviceIsClosed()
 {
+	{
+		omni_mutex_lock lock(open_mutex);
+		if (open_pending == true)
+		{
+			Tango::Except::throw_exception(
+			    (const char *) "gpibDeviceException.",
+			    (const char *) "Gpib device is still being opened.",
+			    (const char *) "Wait for the device to leave the INIT state.",
+			    Tango::ERR
+			);
+		}
+	}
+	open_on_first_use();
 	if (dev_open == false) // Trying to access a non-open device generates an exception.
 	{
-		DEBUG_STREAM << "Error : operation on a not opened gpib device." << endl;
+		GPIB_DEBUG_STREAM << "Error : operation on a not opened gpib device." << endl;
 		Tango::Except::throw_exception(
 		    (const char *) "gpibDeviceException.",
 		    (const char *) "Attempt to operate on a not open device.",
@@ -2032,4 +4276,19 @@ void GpibDeviceServer::throwExceptionIfDeviceIsClosed()
 	}
 }
 
+/**
+ * With the LazyOpen property, init_device() does not open the device. This
+ * method opens it the first time a command needs it. When the open fails
+ * the device goes to FAULT and is not retried before the next Init.
+ */
+void GpibDeviceServer::open_on_first_use()
+{
+	if (lazy_pending == false)
+		return;
+	lazy_pending = false;
+	
+	open_device();
+	set_open_state();
+}
+
 }	//	namespace
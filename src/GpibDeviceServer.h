@@ -94,10 +94,93 @@
 //	Add your own constants definitions here.
 //-----------------------------------------------
 
+/**
+ * DEBUG_STREAM of the commands and attributes. Even when the logging level
+ * is lower, DEBUG_STREAM checks the logger on every call: it is compiled
+ * out unless the server is built with GPIB_TRACE=3 (see gpibTrace.h).
+ */
+#if GPIB_TRACE >= GPIB_LEVEL_DEBUG
+#define GPIB_DEBUG_STREAM	DEBUG_STREAM
+#else
+#define GPIB_DEBUG_STREAM	if (true) {} else DEBUG_STREAM
+#endif
+
+/**
+ * gpibDevice constructor used to open the device (see init_device).
+ * Values are saved in the GpibCachedOpenMethod property: do not renumber.
+ */
+enum GpibOpenMethod
+{
+    GPIB_OPEN_UNKNOWN = 0,
+    GPIB_OPEN_BY_NAME_ON_BOARD = 1,
+    GPIB_OPEN_BY_NAME = 2,
+    GPIB_OPEN_BY_ADDRESS_ON_BOARD = 3,
+    GPIB_OPEN_BY_ADDRESS = 4
+};
+
+/**
+ * Stages of a command, for the latency breakdown (see command_inout_4).
+ */
+enum GpibStage
+{
+    GPIB_STAGE_WAIT = 0,    // Tango request checks and serialization lock
+    GPIB_STAGE_PROBE = 1,   // always_executed_hook (isAlive)
+    GPIB_STAGE_IO = 2,      // gpib driver calls of the command
+    GPIB_STAGE_OTHER = 3,   // command code, argin/argout conversion
+    GPIB_STAGE_TOTAL = 4,   // whole command_inout_4
+    GPIB_NB_STAGE = 5
+};
+
+/**
+ * Transfers per device and setting of BCTuneBus.
+ */
+#define GPIB_TUNE_REPEAT	10
+
+/**
+ * Maximum number of commands in the latency breakdown.
+ */
+#define GPIB_MAX_BREAKDOWN	64
+
+/**
+ * Latency of each stage of one command.
+ */
+struct GpibBreakdown
+{
+	string        command;	// Command name as first received
+	gpibHistogram stage[GPIB_NB_STAGE];
+};
+
 
 namespace GpibDeviceServer_ns
 {
 
+class GpibFastPoll;
+class GpibBusMonitor;
+
+/**
+ * Device property values read from the database, checked before they are
+ * given to the device (see GpibDeviceServer for their description).
+ */
+struct GpibDeviceProperties
+{
+	string	gpibDeviceName;
+	Tango::DevShort	gpibDeviceAddress;
+	Tango::DevShort	gpibDeviceTimeOut;
+	Tango::DevShort	gpibDeviceSecondaryAddress;
+	string	gpibBoardName;
+	Tango::DevShort	gpibCachedOpenMethod;
+	Tango::DevShort	gpibCachedProbeMethod;
+	string	gpibCachedIdn;
+	Tango::DevBoolean	lazyOpen;
+	Tango::DevLong	gpibDeviceEOS;
+	Tango::DevShort	gpibDeviceEOT;
+	vector<double>	latencyAlarmP99;
+	Tango::DevShort	gpibBoardHS488;
+	Tango::DevShort	gpibBoardTiming;
+	Tango::DevShort	gpibBoardDMA;
+	Tango::DevBoolean	stickyAddressing;
+};
+
 /**
  * Class Description:
  * This server is a generic gpib interface.
@@ -121,6 +204,19 @@ public :
 	bool 	dev_open;	// Flag use to avoid r/w operation on a
 	// closed device.
 	int         boardind;       // board index
+	GpibOpenMethod open_method; // gpibDevice constructor which opened the device
+	bool        open_pending;   // Device queued in the class init pool
+	omni_mutex  open_mutex;     // Protects open_pending
+	bool        lazy_pending;   // LazyOpen: device not opened yet
+	gpibLatency latency;        // I/O latency histograms (kept over reopen)
+	gpibCounters counters;      // Transfer and error counters (kept over reopen)
+	map<string, GpibBreakdown> breakdown;	// Per command (lower case name)
+	vector<string> breakdown_order;	// Keys of breakdown, first call first
+	omni_mutex  breakdown_mutex;   // Recorded outside the device lock
+	GpibFastPoll *fast_poll;    // Background parallel poll, NULL if stopped
+	long long   ppoll_time;     // gpibClock() of the last BCParallelPoll, 0 if none
+	GpibBusMonitor *bus_monitor; // Passive bus monitor, NULL if stopped
+	int         bus_monitor_board;	// Spare board index of bus_monitor
 	
 	//	Here is the Start of the automatic code generation part
 	//-------------------------------------------------------------
@@ -129,6 +225,17 @@ public :
 	 *	Attributs member data.
 	 */
 	//@{
+		Tango::DevLong64	attr_LatencyHistogram_read[GPIB_NB_OP][GPIB_HIST_BUCKETS];
+		Tango::DevDouble	attr_LatencyBuckets_read[GPIB_HIST_BUCKETS];
+		Tango::DevLong64	attr_Counter_read[2][GPIB_NB_COUNTER];
+		Tango::DevLong64	attr_ErrorCounts_read[2][GPIB_NB_IBERR];
+		Tango::DevLong64	attr_BreakdownCount_read[GPIB_MAX_BREAKDOWN];
+		Tango::DevDouble	attr_BreakdownMean_read[GPIB_MAX_BREAKDOWN * GPIB_NB_STAGE];
+		Tango::DevDouble	attr_BreakdownP99_read[GPIB_MAX_BREAKDOWN * GPIB_NB_STAGE];
+		Tango::DevLong	attr_ServiceRequestMask_read;
+		Tango::DevLong	attr_ParallelPoll_read;
+		Tango::DevDouble	attr_BusUtilization_read;
+		Tango::DevDouble	attr_Bandwidth_read[2][GPIB_MONITOR_ADDRS];
 	//@}
 	
 	/**
@@ -168,7 +275,9 @@ public :
 	 */
 	Tango::DevShort	gpibDeviceTimeOut;
 	/**
-	 *	Second address of the gpib device.
+	 *	Second address of the gpib device, driver convention: 0 = none,
+	 *	else 0x60 to 0x7E (secondary address 0 to 30). Used when the
+	 *	device is opened by address.
 	 */
 	Tango::DevShort	gpibDeviceSecondaryAddress;
 	/**
@@ -176,6 +285,71 @@ public :
 	 *	e.g "gpib1
 	 */
 	string	gpibBoardName;
+	/**
+	 *	gpibDevice constructor which opened the device at the previous start
+	 *	(written by the server, 0 = unknown).
+	 */
+	Tango::DevShort	gpibCachedOpenMethod;
+	/**
+	 *	isAlive() probe method found at the previous start
+	 *	(written by the server, 0 = unknown).
+	 */
+	Tango::DevShort	gpibCachedProbeMethod;
+	/**
+	 *	Last known answer of the device to "*IDN?" (written by the server).
+	 */
+	string	gpibCachedIdn;
+	/**
+	 *	Do not open the device at init: it is opened by the first command
+	 *	which needs it. The device is in STANDBY until then.
+	 */
+	Tango::DevBoolean	lazyOpen;
+	/**
+	 *	End-of-string mode given to ibeos: EOS character in the low byte,
+	 *	plus REOS (0x400), XEOS (0x800) and BIN (0x1000).
+	 *	-1 keeps the driver (ibconf) setting.
+	 */
+	Tango::DevLong	gpibDeviceEOS;
+	/**
+	 *	Assert EOI with the last written byte (1) or not (0).
+	 *	-1 keeps the driver (ibconf) setting.
+	 */
+	Tango::DevShort	gpibDeviceEOT;
+	/**
+	 *	p99 latency alarm thresholds in us, for write, read, writeRead,
+	 *	binary and probe operations (a single value applies to all).
+	 *	The device goes to ALARM when a p99 is above its threshold.
+	 *	0 or no value = no alarm.
+	 */
+	vector<double>	latencyAlarmP99;
+	/**
+	 *	HS488 cable length of the board in meters (1 to 15), 0 = standard
+	 *	handshake. -1 keeps the driver (ibconf) setting. Default of the
+	 *	board: BCSetHS488 and BCTestHS488 save their setting in the
+	 *	GpibBoardHS488_<board> class property, used instead. A transfer
+	 *	error which restores the standard handshake saves 0 there.
+	 */
+	Tango::DevShort	gpibBoardHS488;
+	/**
+	 *	T1 delay of the board (IbcTIMING): 1 = 2 us, 2 = 500 ns,
+	 *	3 = 350 ns. -1 keeps the driver (ibconf) setting. Default of the
+	 *	board: BCTuneBus saves its setting in the
+	 *	GpibBoardTiming_<board> class property, used instead.
+	 */
+	Tango::DevShort	gpibBoardTiming;
+	/**
+	 *	DMA transfers of the board (IbcDMA): 1 = on, 0 = off. -1 keeps
+	 *	the driver (ibconf) setting. Default of the board: BCTuneBus
+	 *	saves its setting in the GpibBoardDMA_<board> class property,
+	 *	used instead.
+	 */
+	Tango::DevShort	gpibBoardDMA;
+	/**
+	 *	Keep the device addressed between its transfers (IbcUnAddr off).
+	 *	It is unaddressed when another device of the board makes a
+	 *	transfer.
+	 */
+	Tango::DevBoolean	stickyAddressing;
 	//@}
 	
 	/**@name Constructors
@@ -211,7 +385,7 @@ public :
 	/**
 	 * The object desctructor.
 	 */	
-	~GpibDeviceServer() {};
+	~GpibDeviceServer() {delete_device();};
 	/**
 	 *	will be called at device destruction or at init command.
 	 */
@@ -229,6 +403,103 @@ public :
 	 *	Always executed method befor execution command method.
 	 */
 	virtual void always_executed_hook();
+	/**
+	 *	Command request entry point, timed for the latency breakdown.
+	 */
+	virtual CORBA::Any *command_inout_4(const char *in_cmd, const CORBA::Any &in_data,
+	                                    Tango::DevSource source, const Tango::ClntIdent &cl_ident);
+	/**
+	 *	Hardware acquisition for attributes.
+	 */
+	virtual void read_attr_hardware(vector<long> &attr_list);
+	/**
+	 *	Extract real attribute values for <op>LatencyHistogram acquisition
+	 *	result (number of I/O per bucket of LatencyBuckets).
+	 */
+	virtual void read_LatencyHistogram(Tango::Attribute &attr, int op);
+	/**
+	 *	Extract real attribute values for LatencyBuckets acquisition result
+	 *	(highest latency of each histogram bucket, in us).
+	 */
+	virtual void read_LatencyBuckets(Tango::Attribute &attr);
+	/**
+	 *	Read/Write allowed for latency attributes.
+	 */
+	virtual bool is_Latency_allowed(Tango::AttReqType type);
+	/**
+	 *	Extract real attribute values for a counter attribute, of the
+	 *	device (e.g. BytesRead) or of its board (e.g. BoardBytesRead).
+	 */
+	virtual void read_Counter(Tango::Attribute &attr, int counter, bool board);
+	/**
+	 *	Extract real attribute values for ErrorCounts / BoardErrorCounts
+	 *	(number of errors by iberr code, EDVR to ETAB).
+	 */
+	virtual void read_ErrorCounts(Tango::Attribute &attr, bool board);
+	/**
+	 *	Read/Write allowed for counter attributes.
+	 */
+	virtual bool is_Counters_allowed(Tango::AttReqType type);
+	/**
+	 *	Extract real attribute values for BreakdownCommands acquisition
+	 *	result (commands of the latency breakdown, rows of the images).
+	 */
+	virtual void read_BreakdownCommands(Tango::Attribute &attr);
+	/**
+	 *	Extract real attribute values for BreakdownCount acquisition result.
+	 */
+	virtual void read_BreakdownCount(Tango::Attribute &attr);
+	/**
+	 *	Extract real attribute values for BreakdownMean acquisition result
+	 *	(one row per command, one column per GpibStage, us).
+	 */
+	virtual void read_BreakdownMean(Tango::Attribute &attr);
+	/**
+	 *	Extract real attribute values for BreakdownP99 acquisition result
+	 *	(one row per command, one column per GpibStage, us).
+	 */
+	virtual void read_BreakdownP99(Tango::Attribute &attr);
+	/**
+	 *	Read/Write allowed for latency breakdown attributes.
+	 */
+	virtual bool is_Breakdown_allowed(Tango::AttReqType type);
+	/**
+	 *	Extract real attribute values for ServiceRequestMask acquisition
+	 *	result (bit n set if the device at address n requested service).
+	 */
+	virtual void read_ServiceRequestMask(Tango::Attribute &attr);
+	/**
+	 *	Read/Write allowed for ServiceRequestMask attribute.
+	 */
+	virtual bool is_ServiceRequestMask_allowed(Tango::AttReqType type);
+	/**
+	 *	Extract real attribute values for ParallelPoll acquisition result
+	 *	(last parallel poll response byte).
+	 */
+	virtual void read_ParallelPoll(Tango::Attribute &attr);
+	/**
+	 *	Read/Write allowed for ParallelPoll attribute.
+	 */
+	virtual bool is_ParallelPoll_allowed(Tango::AttReqType type);
+	/**
+	 *	Extract real attribute values for BusUtilization acquisition result
+	 *	(busy time of the bus seen by the monitor, %).
+	 */
+	virtual void read_BusUtilization(Tango::Attribute &attr);
+	/**
+	 *	Extract real attribute values for TalkerBandwidth / ListenerBandwidth
+	 *	(bytes/s sent / received by each address, seen by the monitor).
+	 */
+	virtual void read_Bandwidth(Tango::Attribute &attr, bool listener);
+	/**
+	 *	Read/Write allowed for bus monitor attributes.
+	 */
+	virtual bool is_Monitor_allowed(Tango::AttReqType type);
+	/**
+	 *	Open the device queued by init_device() in the class init pool.
+	 *	Called from a GpibInitPool lane.
+	 */
+	void open_in_background();
 	
 	//@}
 	
@@ -365,6 +636,90 @@ public :
 	 *	Execution allowed for GetBoardIndex command.
 	 */
 	virtual bool is_GetBoardIndex_allowed(const CORBA::Any &any);
+	/**
+	 *	Execution allowed for ReloadProperties command.
+	 */
+	virtual bool is_ReloadProperties_allowed(const CORBA::Any &any);
+	/**
+	 *	Execution allowed for GetLatencyStats command.
+	 */
+	virtual bool is_GetLatencyStats_allowed(const CORBA::Any &any);
+	/**
+	 *	Execution allowed for ResetLatencyStats command.
+	 */
+	virtual bool is_ResetLatencyStats_allowed(const CORBA::Any &any);
+	/**
+	 *	Execution allowed for DumpTrace command.
+	 */
+	virtual bool is_DumpTrace_allowed(const CORBA::Any &any);
+	/**
+	 *	Execution allowed for BCTriggerList command.
+	 */
+	virtual bool is_BCTriggerList_allowed(const CORBA::Any &any);
+	/**
+	 *	Execution allowed for BCSnapshotGroup command.
+	 */
+	virtual bool is_BCSnapshotGroup_allowed(const CORBA::Any &any);
+	/**
+	 *	Execution allowed for BCWriteMany command.
+	 */
+	virtual bool is_BCWriteMany_allowed(const CORBA::Any &any);
+	/**
+	 *	Execution allowed for BCSerialPollAll command.
+	 */
+	virtual bool is_BCSerialPollAll_allowed(const CORBA::Any &any);
+	/**
+	 *	Execution allowed for PPollConfig command.
+	 */
+	virtual bool is_PPollConfig_allowed(const CORBA::Any &any);
+	/**
+	 *	Execution allowed for PPollUnconfig command.
+	 */
+	virtual bool is_PPollUnconfig_allowed(const CORBA::Any &any);
+	/**
+	 *	Execution allowed for BCParallelPoll command.
+	 */
+	virtual bool is_BCParallelPoll_allowed(const CORBA::Any &any);
+	/**
+	 *	Execution allowed for BCStartFastPoll command.
+	 */
+	virtual bool is_BCStartFastPoll_allowed(const CORBA::Any &any);
+	/**
+	 *	Execution allowed for BCStopFastPoll command.
+	 */
+	virtual bool is_BCStopFastPoll_allowed(const CORBA::Any &any);
+	/**
+	 *	Execution allowed for BCWriteReadMany command.
+	 */
+	virtual bool is_BCWriteReadMany_allowed(const CORBA::Any &any);
+	/**
+	 *	Execution allowed for BCSetHS488 command.
+	 */
+	virtual bool is_BCSetHS488_allowed(const CORBA::Any &any);
+	/**
+	 *	Execution allowed for BCTestHS488 command.
+	 */
+	virtual bool is_BCTestHS488_allowed(const CORBA::Any &any);
+	/**
+	 *	Execution allowed for BCTuneBus command.
+	 */
+	virtual bool is_BCTuneBus_allowed(const CORBA::Any &any);
+	/**
+	 *	Execution allowed for BCGetConnectedDeviceListSAD command.
+	 */
+	virtual bool is_BCGetConnectedDeviceListSAD_allowed(const CORBA::Any &any);
+	/**
+	 *	Execution allowed for BCStartMonitor command.
+	 */
+	virtual bool is_BCStartMonitor_allowed(const CORBA::Any &any);
+	/**
+	 *	Execution allowed for BCStopMonitor command.
+	 */
+	virtual bool is_BCStopMonitor_allowed(const CORBA::Any &any);
+	/**
+	 *	Execution allowed for BCDumpMonitor command.
+	 */
+	virtual bool is_BCDumpMonitor_allowed(const CORBA::Any &any);
 	/**
 	 * This command send a string to the device. Throws devFailed on error.
 	 *	@param	argin	String to send to the device
@@ -601,6 +956,195 @@ public :
 	 *	@exception DevFailed
 	 */
 	Tango::DevShort	get_board_index();
+	/**
+	 * Read the device properties again and apply the changed ones on the
+	 * open device (time out, EOS, EOT), without the Init command.
+	 * The device is opened again only when its name, address or board changed.
+	 * The device is not changed when GpibDeviceName and GpibDeviceAddress
+	 * are both missing: the command fails.
+	 *	@return	Changed properties
+	 *	@exception DevFailed
+	 */
+	Tango::DevVarStringArray	*reload_properties();
+	/**
+	 * This command returns the latency statistics of the gpib operations
+	 * (write, read, writeRead, binary, probe) since the server start or
+	 * the last ResetLatencyStats.
+	 *	@return	One line per operation: count, p50, p90, p99, p99.9 and max latency in us
+	 *	@exception DevFailed
+	 */
+	Tango::DevVarStringArray	*get_latency_stats();
+	/**
+	 * This command clears the latency histograms and the command latency
+	 * breakdown of the device.
+	 * It also clears a latency alarm (LatencyAlarmP99).
+	 *	@exception DevFailed
+	 */
+	void	reset_latency_stats();
+	/**
+	 * This command writes the flight recorder of the server (the last gpib
+	 * driver calls of all its devices: time, duration, wait, ibcnt, ibsta
+	 * and iberr) in a file, in Chrome trace-event JSON format.
+	 *	@param	argin	File name
+	 *	@return	Number of driver calls written
+	 *	@exception DevFailed
+	 */
+	Tango::DevLong	dump_trace(Tango::DevString);
+	/**
+	 * This command triggers a group of devices of the board with one Group
+	 * Execute Trigger: the devices are all addressed as listeners, then the
+	 * GET command is sent once on the bus.
+	 *	@param	argin	Addresses of the devices (pad, or pad + 256 * sad) to trigger
+	 *	@exception DevFailed
+	 */
+	void	bctrigger_list(const Tango::DevVarLongArray *);
+	/**
+	 * This command takes a synchronized snapshot of a group of devices of the
+	 * board: they are triggered with one Group Execute Trigger, then their
+	 * measurements are read back to back, after sending them the query if
+	 * given (e.g. "FETCH?"). Replies are returned in the order of the
+	 * addresses; for a failed read, the reply is empty and iberr is set.
+	 * Times are in seconds since the epoch.
+	 *	@param	argin	Addresses of the devices (pad, or pad + 256 * sad), query sent before each read (optional)
+	 *	@return	Replies, trigger time then time and iberr (-1 = ok) of each reply
+	 *	@exception DevFailed
+	 */
+	Tango::DevVarDoubleStringArray	*bcsnapshot_group(const Tango::DevVarLongStringArray *);
+	/**
+	 * This command writes the same string to a group of devices of the board
+	 * (e.g. *RST or a range setting): the devices are all addressed as
+	 * listeners, then the bytes are sent once on the bus.
+	 *	@param	argin	Addresses of the devices (pad, or pad + 256 * sad), string to write
+	 *	@return	Number of bytes written
+	 *	@exception DevFailed
+	 */
+	Tango::DevLong	bcwrite_many(const Tango::DevVarLongStringArray *);
+	/**
+	 * This command serial polls a group of devices of the board in one bus
+	 * operation (AllSpoll) and returns their status bytes, in the order of
+	 * the addresses. The devices requesting service are also set in the
+	 * ServiceRequestMask attribute.
+	 *	@param	argin	Addresses of the devices (pad, or pad + 256 * sad) to poll
+	 *	@return	Status byte of each device, -1 if it did not answer
+	 *	@exception DevFailed
+	 */
+	Tango::DevVarLongArray	*bcserial_poll_all(const Tango::DevVarLongArray *);
+	/**
+	 * This command configures the gpib device to answer parallel polls: it
+	 * drives the data line when its individual status (ist) equals sense.
+	 * The line is then read by BCParallelPoll and the ParallelPoll attribute.
+	 *	@param	argin	[data line (1 to 8), sense (0 or 1)]
+	 *	@exception DevFailed
+	 */
+	void	ppoll_config(const Tango::DevVarLongArray *);
+	/**
+	 * This command stops the gpib device answering parallel polls.
+	 *	@exception DevFailed
+	 */
+	void	ppoll_unconfig();
+	/**
+	 * This command parallel polls the board: one bus cycle returns the state
+	 * of up to 8 devices, bit n being set by the devices configured on data
+	 * line n+1 (see PPollConfig).
+	 *	@return	Parallel poll response byte
+	 *	@exception DevFailed
+	 */
+	Tango::DevLong	bcparallel_poll();
+	/**
+	 * This command starts parallel polling the board in background. The
+	 * ParallelPoll attribute then returns the last response byte without any
+	 * bus access. A running fast poll is restarted with the new period.
+	 *	@param	argin	Period of the polls, us (1000 to 1000000)
+	 *	@exception DevFailed
+	 */
+	void	bcstart_fast_poll(Tango::DevLong);
+	/**
+	 * This command stops the background parallel poll of the board.
+	 *	@exception DevFailed
+	 */
+	void	bcstop_fast_poll();
+	/**
+	 * This command sends the same query to a group of devices of the board
+	 * and reads their replies back to back, in one command. Replies are
+	 * returned in the order of the addresses; a device which fails does not
+	 * throw: its reply is empty and its iberr is set. The bus lock of the board
+	 * is held meanwhile: fast poll and bus monitor wait for the end.
+	 *	@param	argin	Addresses of the devices (pad, or pad + 256 * sad), query (e.g. :MEAS?)
+	 *	@return	iberr (-1 = ok) and reply of each device
+	 *	@exception DevFailed
+	 */
+	Tango::DevVarLongStringArray	*bcwrite_read_many(const Tango::DevVarLongStringArray *);
+	/**
+	 * This command enables the HS488 high speed handshake of the board for the
+	 * given total cable length, or disables it (0). The value is saved in the
+	 * GpibBoardHS488 class property of the board (e.g. GpibBoardHS488_gpib0).
+	 * BCTestHS488 checks a device first.
+	 *	@param	argin	Cable length in meters (1 to 15), 0 = standard handshake
+	 *	@exception DevFailed
+	 */
+	void	bcset_hs488(Tango::DevShort);
+	/**
+	 * This command checks HS488 on a device: the reply to the query is read
+	 * with the standard handshake, then with HS488 for the cable length. If
+	 * the device follows, HS488 stays enabled on the board; else the device is
+	 * cleared and the board goes back to the standard handshake. The result is
+	 * saved in the GpibBoardHS488 class property of the board.
+	 *	@param	argin	[address, size, cable length], query returning size bytes (e.g. a waveform)
+	 *	@return	[bytes, standard bytes/s, HS488 bytes/s (0 = failed), HS488 enabled (0/1), iberr (-1 = ok)]
+	 *	@exception DevFailed
+	 */
+	Tango::DevVarDoubleArray	*bctest_hs488(const Tango::DevVarLongStringArray *);
+	/**
+	 * This command finds the fastest safe bus timing (IbcTIMING) and DMA
+	 * (IbcDMA) setting of the board: each setting is tried with a short
+	 * transfer benchmark on the devices, whose replies must be read without
+	 * error and equal to the ones of the default setting. The fastest safe
+	 * setting is applied and saved in the GpibBoardTiming and GpibBoardDMA
+	 * class properties of the board, which are applied again at init.
+	 * The query must get a fixed reply (e.g. *IDN?, not a measurement).
+	 * The command fails, and the board keeps its setting, when no setting
+	 * faster than the default one is safe.
+	 *	@param	argin	Addresses of the devices (pad, or pad + 256 * sad) (none = all listeners), query with a fixed reply (optional, default *IDN?)
+	 *	@return	Chosen timing and DMA, then timing, DMA and us of all transfers (-1 = failed) of each setting tried
+	 *	@exception DevFailed
+	 */
+	Tango::DevVarLongArray	*bctune_bus(const Tango::DevVarLongStringArray *);
+	/**
+	 * This command returns the devices of the bus as BCGetConnectedDeviceList,
+	 * the secondary addresses of every device answering on its primary
+	 * address being scanned too: all the modules of a mainframe are listed
+	 * (e.g. GPIBSIM,SWITCH,0,1.0 PAD=14 SAD=96). The address of a device for
+	 * the group commands (BCWriteReadMany ...) is PAD + 256 * SAD.
+	 *	@return	list of connected device on the GPIB bus, with their secondary addresses
+	 *	@exception DevFailed
+	 */
+	Tango::DevVarStringArray	*bcget_connected_device_list_sad();
+	/**
+	 * This command starts the passive bus monitor: a spare board on the bus
+	 * cable is put in listen-only mode (not system controller) and records every byte of the bus
+	 * traffic in background. The BusUtilization, TalkerBandwidth and
+	 * ListenerBandwidth attributes then give the bus statistics, and
+	 * BCDumpMonitor writes the capture. A running monitor is restarted. A
+	 * board which runs the monitor of another device of the server is refused.
+	 *	@param	argin	Name of the spare board (e.g. gpib1) on the bus cable
+	 *	@exception DevFailed
+	 */
+	void	bcstart_monitor(Tango::DevString);
+	/**
+	 * This command stops the passive bus monitor and puts its board back
+	 * in normal mode.
+	 *	@exception DevFailed
+	 */
+	void	bcstop_monitor();
+	/**
+	 * This command writes the capture of the bus monitor (the last bytes
+	 * seen on the bus, with their time, command or data, talker and
+	 * listeners) in a text file, one byte per line.
+	 *	@param	argin	File name
+	 *	@return	Number of bus bytes written
+	 *	@exception DevFailed
+	 */
+	Tango::DevLong	bcdump_monitor(Tango::DevString);
 	
 	/**
 	 *	Read the device properties from database
@@ -618,6 +1162,31 @@ protected :
 	//-----------------------------------------
 	
 	void throwExceptionIfDeviceIsClosed();
+	bool read_device_property(GpibDeviceProperties &p);
+	void set_device_property(const GpibDeviceProperties &p);
+	void init_from_properties();
+	void open_device();
+	void set_open_state();
+	void open_on_first_use();
+	bool try_open(GpibOpenMethod method, GpibProbeMethod probe);
+	void apply_termination();
+	Tango::DevVarStringArray *connected_devices(bool secondaries);
+	string board_property_name(const char *name);
+	void read_board_properties();
+	void apply_board_config();
+	void write_board_property(const char *name, Tango::DevShort value);
+	void release_gpib_device();
+	bool check_latency_alarm(string &status);
+	gpibCounters *get_board_counters();
+	gpibBoard *get_board();
+	omni_mutex &get_bus_mutex();
+	double wall_time(long long t);
+	void stop_fast_poll();
+	void stop_bus_monitor();
+	void record_breakdown(const char *cmd, long long t0, long long io0);
+	void save_hs488_fallback();
+	void write_discovery_cache();
+	void write_idn_cache(const string &idn);
 };
 
 }	// namespace
@@ -86,6 +86,7 @@ static const char *RcsId = "$Header: /users/chaize/newsvn/cvsroot/Communication/
 
 
 #include <tango.h>
+#include <algorithm>
 
 #include <GpibDeviceServer.h>
 #include <GpibDeviceServerClass.h>
@@ -95,10 +96,10 @@ namespace GpibDeviceServer_ns
 {
 //+----------------------------------------------------------------------------
 //
-// method : 		GetBoardIndexCmd::execute()
-// 
+// method : 		BCDumpMonitorCmd::execute()
+//
 // description : 	method to trigger the execution of the command.
-//                PLEASE DO NOT MODIFY this method core without pogo   
+//                PLEASE DO NOT MODIFY this method core without pogo
 //
 // in : - device : The device on which the command must be executed
 //		- in_any : The command input data
@@ -106,20 +107,23 @@ namespace GpibDeviceServer_ns
 // returns : The command output data (packed in the Any object)
 //
 //-----------------------------------------------------------------------------
-CORBA::Any *GetBoardIndexCmd::execute(Tango::DeviceImpl *device,const CORBA::Any &in_any)
+CORBA::Any *BCDumpMonitorCmd::execute(Tango::DeviceImpl *device,const CORBA::Any &in_any)
 {
 
-	cout2 << "GetBoardIndexCmd::execute(): arrived" << endl;
+	cout2 << "BCDumpMonitorCmd::execute(): arrived" << endl;
 
-	return insert((static_cast<GpibDeviceServer *>(device))->get_board_index());
+	Tango::DevString	argin;
+	extract(in_any, argin);
+
+	return insert((static_cast<GpibDeviceServer *>(device))->bcdump_monitor(argin));
 }
 
 //+----------------------------------------------------------------------------
 //
-// method : 		GetDevicePadCmd::execute()
-// 
+// method : 		BCStopMonitorCmd::execute()
+//
 // description : 	method to trigger the execution of the command.
-//                PLEASE DO NOT MODIFY this method core without pogo   
+//                PLEASE DO NOT MODIFY this method core without pogo
 //
 // in : - device : The device on which the command must be executed
 //		- in_any : The command input data
@@ -127,20 +131,21 @@ CORBA::Any *GetBoardIndexCmd::execute(Tango::DeviceImpl *device,const CORBA::Any
 // returns : The command output data (packed in the Any object)
 //
 //-----------------------------------------------------------------------------
-CORBA::Any *GetDevicePadCmd::execute(Tango::DeviceImpl *device,const CORBA::Any &in_any)
+CORBA::Any *BCStopMonitorCmd::execute(Tango::DeviceImpl *device,const CORBA::Any &in_any)
 {
 
-	cout2 << "GetDevicePadCmd::execute(): arrived" << endl;
+	cout2 << "BCStopMonitorCmd::execute(): arrived" << endl;
 
-	return insert((static_cast<GpibDeviceServer *>(device))->get_device_pad());
+	((static_cast<GpibDeviceServer *>(device))->bcstop_monitor());
+	return new CORBA::Any();
 }
 
 //+----------------------------------------------------------------------------
 //
-// method : 		GetSerialPollCmd::execute()
-// 
+// method : 		BCStartMonitorCmd::execute()
+//
 // description : 	method to trigger the execution of the command.
-//                PLEASE DO NOT MODIFY this method core without pogo   
+//                PLEASE DO NOT MODIFY this method core without pogo
 //
 // in : - device : The device on which the command must be executed
 //		- in_any : The command input data
@@ -148,20 +153,24 @@ CORBA::Any *GetDevicePadCmd::execute(Tango::DeviceImpl *device,const CORBA::Any
 // returns : The command output data (packed in the Any object)
 //
 //-----------------------------------------------------------------------------
-CORBA::Any *GetSerialPollCmd::execute(Tango::DeviceImpl *device,const CORBA::Any &in_any)
+CORBA::Any *BCStartMonitorCmd::execute(Tango::DeviceImpl *device,const CORBA::Any &in_any)
 {
 
-	cout2 << "GetSerialPollCmd::execute(): arrived" << endl;
+	cout2 << "BCStartMonitorCmd::execute(): arrived" << endl;
 
-	return insert((static_cast<GpibDeviceServer *>(device))->get_serial_poll());
+	Tango::DevString	argin;
+	extract(in_any, argin);
+
+	((static_cast<GpibDeviceServer *>(device))->bcstart_monitor(argin));
+	return new CORBA::Any();
 }
 
 //+----------------------------------------------------------------------------
 //
-// method : 		ListenerCheckCmd::execute()
-// 
+// method : 		BCGetConnectedDeviceListSADCmd::execute()
+//
 // description : 	method to trigger the execution of the command.
-//                PLEASE DO NOT MODIFY this method core without pogo   
+//                PLEASE DO NOT MODIFY this method core without pogo
 //
 // in : - device : The device on which the command must be executed
 //		- in_any : The command input data
@@ -169,20 +178,20 @@ CORBA::Any *GetSerialPollCmd::execute(Tango::DeviceImpl *device,const CORBA::Any
 // returns : The command output data (packed in the Any object)
 //
 //-----------------------------------------------------------------------------
-CORBA::Any *ListenerCheckCmd::execute(Tango::DeviceImpl *device,const CORBA::Any &in_any)
+CORBA::Any *BCGetConnectedDeviceListSADCmd::execute(Tango::DeviceImpl *device,const CORBA::Any &in_any)
 {
 
-	cout2 << "ListenerCheckCmd::execute(): arrived" << endl;
+	cout2 << "BCGetConnectedDeviceListSADCmd::execute(): arrived" << endl;
 
-	return insert((static_cast<GpibDeviceServer *>(device))->listener_check());
+	return insert((static_cast<GpibDeviceServer *>(device))->bcget_connected_device_list_sad());
 }
 
 //+----------------------------------------------------------------------------
 //
-// method : 		GetConfigCmd::execute()
-// 
+// method : 		BCTuneBusCmd::execute()
+//
 // description : 	method to trigger the execution of the command.
-//                PLEASE DO NOT MODIFY this method core without pogo   
+//                PLEASE DO NOT MODIFY this method core without pogo
 //
 // in : - device : The device on which the command must be executed
 //		- in_any : The command input data
@@ -190,23 +199,23 @@ CORBA::Any *ListenerCheckCmd::execute(Tango::DeviceImpl *device,const CORBA::Any
 // returns : The command output data (packed in the Any object)
 //
 //-----------------------------------------------------------------------------
-CORBA::Any *GetConfigCmd::execute(Tango::DeviceImpl *device,const CORBA::Any &in_any)
+CORBA::Any *BCTuneBusCmd::execute(Tango::DeviceImpl *device,const CORBA::Any &in_any)
 {
 
-	cout2 << "GetConfigCmd::execute(): arrived" << endl;
+	cout2 << "BCTuneBusCmd::execute(): arrived" << endl;
 
-	Tango::DevShort	argin;
+	const Tango::DevVarLongStringArray	*	argin;
 	extract(in_any, argin);
 
-	return insert((static_cast<GpibDeviceServer *>(device))->get_config(argin));
+	return insert((static_cast<GpibDeviceServer *>(device))->bctune_bus(argin));
 }
 
 //+----------------------------------------------------------------------------
 //
-// method : 		BCGetConfigCmd::execute()
-// 
+// method : 		BCTestHS488Cmd::execute()
+//
 // description : 	method to trigger the execution of the command.
-//                PLEASE DO NOT MODIFY this method core without pogo   
+//                PLEASE DO NOT MODIFY this method core without pogo
 //
 // in : - device : The device on which the command must be executed
 //		- in_any : The command input data
@@ -214,504 +223,501 @@ CORBA::Any *GetConfigCmd::execute(Tango::DeviceImpl *device,const CORBA::Any &in
 // returns : The command output data (packed in the Any object)
 //
 //-----------------------------------------------------------------------------
-CORBA::Any *BCGetConfigCmd::execute(Tango::DeviceImpl *device,const CORBA::Any &in_any)
+CORBA::Any *BCTestHS488Cmd::execute(Tango::DeviceImpl *device,const CORBA::Any &in_any)
 {
 
-	cout2 << "BCGetConfigCmd::execute(): arrived" << endl;
+	cout2 << "BCTestHS488Cmd::execute(): arrived" << endl;
 
-	Tango::DevShort	argin;
+	const Tango::DevVarLongStringArray	*	argin;
 	extract(in_any, argin);
 
-	return insert((static_cast<GpibDeviceServer *>(device))->bcget_config(argin));
+	return insert((static_cast<GpibDeviceServer *>(device))->bctest_hs488(argin));
 }
 
 //+----------------------------------------------------------------------------
 //
-// method : 		ReceiveBinDataCmd::execute()
-// 
+// method : 		BCSetHS488Cmd::execute()
+//
 // description : 	method to trigger the execution of the command.
-//                PLEASE DO NOT MODIFY this method core without pogo   
+//                PLEASE DO NOT MODIFY this method core without pogo
 //
-// in : - device : The device on which the command must be excuted
+// in : - device : The device on which the command must be executed
 //		- in_any : The command input data
 //
 // returns : The command output data (packed in the Any object)
 //
 //-----------------------------------------------------------------------------
-CORBA::Any *ReceiveBinDataCmd::execute(Tango::DeviceImpl *device,const CORBA::Any &in_any)
+CORBA::Any *BCSetHS488Cmd::execute(Tango::DeviceImpl *device,const CORBA::Any &in_any)
 {
 
-	cout2 << "ReceiveBinDataCmd::execute(): arrived" << endl;
+	cout2 << "BCSetHS488Cmd::execute(): arrived" << endl;
 
-	Tango::DevLong	argin;
+	Tango::DevShort	argin;
 	extract(in_any, argin);
 
-	return insert((static_cast<GpibDeviceServer *>(device))->receive_bin_data(argin));
+	((static_cast<GpibDeviceServer *>(device))->bcset_hs488(argin));
+	return new CORBA::Any();
 }
 
 //+----------------------------------------------------------------------------
 //
-// method : 		SendBinDataCmd::execute()
-// 
+// method : 		BCWriteReadManyCmd::execute()
+//
 // description : 	method to trigger the execution of the command.
-//                PLEASE DO NOT MODIFY this method core without pogo   
+//                PLEASE DO NOT MODIFY this method core without pogo
 //
-// in : - device : The device on which the command must be excuted
+// in : - device : The device on which the command must be executed
 //		- in_any : The command input data
 //
 // returns : The command output data (packed in the Any object)
 //
 //-----------------------------------------------------------------------------
-CORBA::Any *SendBinDataCmd::execute(Tango::DeviceImpl *device,const CORBA::Any &in_any)
+CORBA::Any *BCWriteReadManyCmd::execute(Tango::DeviceImpl *device,const CORBA::Any &in_any)
 {
 
-	cout2 << "SendBinDataCmd::execute(): arrived" << endl;
+	cout2 << "BCWriteReadManyCmd::execute(): arrived" << endl;
 
-	const Tango::DevVarCharArray	*argin;
+	const Tango::DevVarLongStringArray	*	argin;
 	extract(in_any, argin);
 
-	((static_cast<GpibDeviceServer *>(device))->send_bin_data(argin));
-	return new CORBA::Any();
+	return insert((static_cast<GpibDeviceServer *>(device))->bcwrite_read_many(argin));
 }
 
 //+----------------------------------------------------------------------------
 //
-// method : 		BCConfigCmd::execute()
-// 
+// method : 		BCStopFastPollCmd::execute()
+//
 // description : 	method to trigger the execution of the command.
-//                PLEASE DO NOT MODIFY this method core without pogo   
+//                PLEASE DO NOT MODIFY this method core without pogo
 //
-// in : - device : The device on which the command must be excuted
+// in : - device : The device on which the command must be executed
 //		- in_any : The command input data
 //
 // returns : The command output data (packed in the Any object)
 //
 //-----------------------------------------------------------------------------
-CORBA::Any *BCConfigCmd::execute(Tango::DeviceImpl *device,const CORBA::Any &in_any)
+CORBA::Any *BCStopFastPollCmd::execute(Tango::DeviceImpl *device,const CORBA::Any &in_any)
 {
 
-	cout2 << "BCConfigCmd::execute(): arrived" << endl;
-
-	const Tango::DevVarLongArray	*argin;
-	extract(in_any, argin);
+	cout2 << "BCStopFastPollCmd::execute(): arrived" << endl;
 
-	((static_cast<GpibDeviceServer *>(device))->bcconfig(argin));
+	((static_cast<GpibDeviceServer *>(device))->bcstop_fast_poll());
 	return new CORBA::Any();
 }
 
-
 //+----------------------------------------------------------------------------
 //
-// method : 		ConfigCmd::execute()
-// 
+// method : 		BCStartFastPollCmd::execute()
+//
 // description : 	method to trigger the execution of the command.
-//                PLEASE DO NOT MODIFY this method core without pogo   
+//                PLEASE DO NOT MODIFY this method core without pogo
 //
-// in : - device : The device on which the command must be excuted
+// in : - device : The device on which the command must be executed
 //		- in_any : The command input data
 //
 // returns : The command output data (packed in the Any object)
 //
 //-----------------------------------------------------------------------------
-CORBA::Any *ConfigCmd::execute(Tango::DeviceImpl *device,const CORBA::Any &in_any)
+CORBA::Any *BCStartFastPollCmd::execute(Tango::DeviceImpl *device,const CORBA::Any &in_any)
 {
 
-	cout2 << "ConfigCmd::execute(): arrived" << endl;
+	cout2 << "BCStartFastPollCmd::execute(): arrived" << endl;
 
-	const Tango::DevVarLongArray	*argin;
+	Tango::DevLong	argin;
 	extract(in_any, argin);
 
-	((static_cast<GpibDeviceServer *>(device))->config(argin));
+	((static_cast<GpibDeviceServer *>(device))->bcstart_fast_poll(argin));
 	return new CORBA::Any();
 }
 
 //+----------------------------------------------------------------------------
 //
-// method : 		WriteReadCmd::execute()
-// 
+// method : 		BCParallelPollCmd::execute()
+//
 // description : 	method to trigger the execution of the command.
-//                PLEASE DO NOT MODIFY this method core without pogo   
+//                PLEASE DO NOT MODIFY this method core without pogo
 //
-// in : - device : The device on which the command must be excuted
+// in : - device : The device on which the command must be executed
 //		- in_any : The command input data
 //
 // returns : The command output data (packed in the Any object)
 //
 //-----------------------------------------------------------------------------
-CORBA::Any *WriteReadCmd::execute(Tango::DeviceImpl *device,const CORBA::Any &in_any)
+CORBA::Any *BCParallelPollCmd::execute(Tango::DeviceImpl *device,const CORBA::Any &in_any)
 {
 
-	cout2 << "WriteReadCmd::execute(): arrived" << endl;
-
-	Tango::DevString	argin;
-	extract(in_any, argin);
+	cout2 << "BCParallelPollCmd::execute(): arrived" << endl;
 
-	return insert((static_cast<GpibDeviceServer *>(device))->write_read(argin));
+	return insert((static_cast<GpibDeviceServer *>(device))->bcparallel_poll());
 }
 
 //+----------------------------------------------------------------------------
 //
-// method : 		TriggerCmd::execute()
-// 
+// method : 		PPollUnconfigCmd::execute()
+//
 // description : 	method to trigger the execution of the command.
-//                PLEASE DO NOT MODIFY this method core without pogo   
+//                PLEASE DO NOT MODIFY this method core without pogo
 //
-// in : - device : The device on which the command must be excuted
+// in : - device : The device on which the command must be executed
 //		- in_any : The command input data
 //
 // returns : The command output data (packed in the Any object)
 //
 //-----------------------------------------------------------------------------
-CORBA::Any *TriggerCmd::execute(Tango::DeviceImpl *device,const CORBA::Any &in_any)
+CORBA::Any *PPollUnconfigCmd::execute(Tango::DeviceImpl *device,const CORBA::Any &in_any)
 {
 
-	cout2 << "TriggerCmd::execute(): arrived" << endl;
+	cout2 << "PPollUnconfigCmd::execute(): arrived" << endl;
 
-	((static_cast<GpibDeviceServer *>(device))->trigger());
+	((static_cast<GpibDeviceServer *>(device))->ppoll_unconfig());
 	return new CORBA::Any();
 }
 
 //+----------------------------------------------------------------------------
 //
-// method : 		BCGetConnectedDeviceListCmd::execute()
-// 
+// method : 		PPollConfigCmd::execute()
+//
 // description : 	method to trigger the execution of the command.
-//                PLEASE DO NOT MODIFY this method core without pogo   
+//                PLEASE DO NOT MODIFY this method core without pogo
 //
-// in : - device : The device on which the command must be excuted
+// in : - device : The device on which the command must be executed
 //		- in_any : The command input data
 //
 // returns : The command output data (packed in the Any object)
 //
 //-----------------------------------------------------------------------------
-CORBA::Any *BCGetConnectedDeviceListCmd::execute(Tango::DeviceImpl *device,const CORBA::Any &in_any)
+CORBA::Any *PPollConfigCmd::execute(Tango::DeviceImpl *device,const CORBA::Any &in_any)
 {
 
-	cout2 << "BCGetConnectedDeviceListCmd::execute(): arrived" << endl;
+	cout2 << "PPollConfigCmd::execute(): arrived" << endl;
 
-	return insert((static_cast<GpibDeviceServer *>(device))->bcget_connected_device_list());
-}
+	const Tango::DevVarLongArray	*	argin;
+	extract(in_any, argin);
 
+	((static_cast<GpibDeviceServer *>(device))->ppoll_config(argin));
+	return new CORBA::Any();
+}
 
 //+----------------------------------------------------------------------------
 //
-// method : 		OpenByNameCmd::execute()
-// 
+// method : 		BCSerialPollAllCmd::execute()
+//
 // description : 	method to trigger the execution of the command.
-//                PLEASE DO NOT MODIFY this method core without pogo   
+//                PLEASE DO NOT MODIFY this method core without pogo
 //
-// in : - device : The device on which the command must be excuted
+// in : - device : The device on which the command must be executed
 //		- in_any : The command input data
 //
 // returns : The command output data (packed in the Any object)
 //
 //-----------------------------------------------------------------------------
-CORBA::Any *OpenByNameCmd::execute(Tango::DeviceImpl *device,const CORBA::Any &in_any)
+CORBA::Any *BCSerialPollAllCmd::execute(Tango::DeviceImpl *device,const CORBA::Any &in_any)
 {
 
-	cout2 << "OpenByNameCmd::execute(): arrived" << endl;
+	cout2 << "BCSerialPollAllCmd::execute(): arrived" << endl;
 
-	((static_cast<GpibDeviceServer *>(device))->open_by_name());
-	return new CORBA::Any();
+	const Tango::DevVarLongArray	*	argin;
+	extract(in_any, argin);
+
+	return insert((static_cast<GpibDeviceServer *>(device))->bcserial_poll_all(argin));
 }
 
 //+----------------------------------------------------------------------------
 //
-// method : 		OpenCmd::execute()
-// 
+// method : 		BCWriteManyCmd::execute()
+//
 // description : 	method to trigger the execution of the command.
-//                PLEASE DO NOT MODIFY this method core without pogo   
+//                PLEASE DO NOT MODIFY this method core without pogo
 //
-// in : - device : The device on which the command must be excuted
+// in : - device : The device on which the command must be executed
 //		- in_any : The command input data
 //
 // returns : The command output data (packed in the Any object)
 //
 //-----------------------------------------------------------------------------
-CORBA::Any *OpenCmd::execute(Tango::DeviceImpl *device,const CORBA::Any &in_any)
+CORBA::Any *BCWriteManyCmd::execute(Tango::DeviceImpl *device,const CORBA::Any &in_any)
 {
 
-	cout2 << "OpenCmd::execute(): arrived" << endl;
+	cout2 << "BCWriteManyCmd::execute(): arrived" << endl;
 
-	((static_cast<GpibDeviceServer *>(device))->open());
-	return new CORBA::Any();
+	const Tango::DevVarLongStringArray	*	argin;
+	extract(in_any, argin);
+
+	return insert((static_cast<GpibDeviceServer *>(device))->bcwrite_many(argin));
 }
 
 //+----------------------------------------------------------------------------
 //
-// method : 		BCcmdCmd::execute()
-// 
+// method : 		BCSnapshotGroupCmd::execute()
+//
 // description : 	method to trigger the execution of the command.
-//                PLEASE DO NOT MODIFY this method core without pogo   
+//                PLEASE DO NOT MODIFY this method core without pogo
 //
-// in : - device : The device on which the command must be excuted
+// in : - device : The device on which the command must be executed
 //		- in_any : The command input data
 //
 // returns : The command output data (packed in the Any object)
 //
 //-----------------------------------------------------------------------------
-CORBA::Any *BCcmdCmd::execute(Tango::DeviceImpl *device,const CORBA::Any &in_any)
+CORBA::Any *BCSnapshotGroupCmd::execute(Tango::DeviceImpl *device,const CORBA::Any &in_any)
 {
 
-	cout2 << "BCcmdCmd::execute(): arrived" << endl;
+	cout2 << "BCSnapshotGroupCmd::execute(): arrived" << endl;
 
-	Tango::DevString	argin;
+	const Tango::DevVarLongStringArray	*	argin;
 	extract(in_any, argin);
 
-	((static_cast<GpibDeviceServer *>(device))->bccmd(argin));
-	return new CORBA::Any();
+	return insert((static_cast<GpibDeviceServer *>(device))->bcsnapshot_group(argin));
 }
 
 //+----------------------------------------------------------------------------
 //
-// method : 		BClloCmd::execute()
-// 
+// method : 		BCTriggerListCmd::execute()
+//
 // description : 	method to trigger the execution of the command.
-//                PLEASE DO NOT MODIFY this method core without pogo   
+//                PLEASE DO NOT MODIFY this method core without pogo
 //
-// in : - device : The device on which the command must be excuted
+// in : - device : The device on which the command must be executed
 //		- in_any : The command input data
 //
 // returns : The command output data (packed in the Any object)
 //
 //-----------------------------------------------------------------------------
-CORBA::Any *BClloCmd::execute(Tango::DeviceImpl *device,const CORBA::Any &in_any)
+CORBA::Any *BCTriggerListCmd::execute(Tango::DeviceImpl *device,const CORBA::Any &in_any)
 {
 
-	cout2 << "BClloCmd::execute(): arrived" << endl;
+	cout2 << "BCTriggerListCmd::execute(): arrived" << endl;
 
-	Tango::DevLong	argin;
+	const Tango::DevVarLongArray	*	argin;
 	extract(in_any, argin);
 
-	((static_cast<GpibDeviceServer *>(device))->bcllo(argin));
+	((static_cast<GpibDeviceServer *>(device))->bctrigger_list(argin));
 	return new CORBA::Any();
 }
 
 //+----------------------------------------------------------------------------
 //
-// method : 		GetDeviceIDCmd::execute()
-// 
+// method : 		DumpTraceCmd::execute()
+//
 // description : 	method to trigger the execution of the command.
-//                PLEASE DO NOT MODIFY this method core without pogo   
+//                PLEASE DO NOT MODIFY this method core without pogo
 //
-// in : - device : The device on which the command must be excuted
+// in : - device : The device on which the command must be executed
 //		- in_any : The command input data
 //
 // returns : The command output data (packed in the Any object)
 //
 //-----------------------------------------------------------------------------
-CORBA::Any *GetDeviceIDCmd::execute(Tango::DeviceImpl *device,const CORBA::Any &in_any)
+CORBA::Any *DumpTraceCmd::execute(Tango::DeviceImpl *device,const CORBA::Any &in_any)
 {
 
-	cout2 << "GetDeviceIDCmd::execute(): arrived" << endl;
+	cout2 << "DumpTraceCmd::execute(): arrived" << endl;
 
-	return insert((static_cast<GpibDeviceServer *>(device))->get_device_id());
+	Tango::DevString	argin;
+	extract(in_any, argin);
+
+	return insert((static_cast<GpibDeviceServer *>(device))->dump_trace(argin));
 }
 
 //+----------------------------------------------------------------------------
 //
-// method : 		BCclrCmd::execute()
-// 
+// method : 		ResetLatencyStatsCmd::execute()
+//
 // description : 	method to trigger the execution of the command.
-//                PLEASE DO NOT MODIFY this method core without pogo   
+//                PLEASE DO NOT MODIFY this method core without pogo
 //
-// in : - device : The device on which the command must be excuted
+// in : - device : The device on which the command must be executed
 //		- in_any : The command input data
 //
 // returns : The command output data (packed in the Any object)
 //
 //-----------------------------------------------------------------------------
-CORBA::Any *BCclrCmd::execute(Tango::DeviceImpl *device,const CORBA::Any &in_any)
+CORBA::Any *ResetLatencyStatsCmd::execute(Tango::DeviceImpl *device,const CORBA::Any &in_any)
 {
 
-	cout2 << "BCclrCmd::execute(): arrived" << endl;
-
-	Tango::DevLong	argin;
-	extract(in_any, argin);
+	cout2 << "ResetLatencyStatsCmd::execute(): arrived" << endl;
 
-	((static_cast<GpibDeviceServer *>(device))->bcclr(argin));
+	((static_cast<GpibDeviceServer *>(device))->reset_latency_stats());
 	return new CORBA::Any();
 }
 
 //+----------------------------------------------------------------------------
 //
-// method : 		BCsendIFCCmd::execute()
-// 
+// method : 		GetLatencyStatsCmd::execute()
+//
 // description : 	method to trigger the execution of the command.
-//                PLEASE DO NOT MODIFY this method core without pogo   
+//                PLEASE DO NOT MODIFY this method core without pogo
 //
-// in : - device : The device on which the command must be excuted
+// in : - device : The device on which the command must be executed
 //		- in_any : The command input data
 //
 // returns : The command output data (packed in the Any object)
 //
 //-----------------------------------------------------------------------------
-CORBA::Any *BCsendIFCCmd::execute(Tango::DeviceImpl *device,const CORBA::Any &in_any)
+CORBA::Any *GetLatencyStatsCmd::execute(Tango::DeviceImpl *device,const CORBA::Any &in_any)
 {
 
-	cout2 << "BCsendIFCCmd::execute(): arrived" << endl;
+	cout2 << "GetLatencyStatsCmd::execute(): arrived" << endl;
 
-	((static_cast<GpibDeviceServer *>(device))->bcsend_ifc());
-	return new CORBA::Any();
+	return insert((static_cast<GpibDeviceServer *>(device))->get_latency_stats());
 }
 
 //+----------------------------------------------------------------------------
 //
-// method : 		SetTimeOutCmd::execute()
-// 
+// method : 		ReloadPropertiesCmd::execute()
+//
 // description : 	method to trigger the execution of the command.
-//                PLEASE DO NOT MODIFY this method core without pogo   
+//                PLEASE DO NOT MODIFY this method core without pogo
 //
-// in : - device : The device on which the command must be excuted
+// in : - device : The device on which the command must be executed
 //		- in_any : The command input data
 //
 // returns : The command output data (packed in the Any object)
 //
 //-----------------------------------------------------------------------------
-CORBA::Any *SetTimeOutCmd::execute(Tango::DeviceImpl *device,const CORBA::Any &in_any)
+CORBA::Any *ReloadPropertiesCmd::execute(Tango::DeviceImpl *device,const CORBA::Any &in_any)
 {
 
-	cout2 << "SetTimeOutCmd::execute(): arrived" << endl;
-
-	Tango::DevShort	argin;
-	extract(in_any, argin);
+	cout2 << "ReloadPropertiesCmd::execute(): arrived" << endl;
 
-	((static_cast<GpibDeviceServer *>(device))->set_time_out(argin));
-	return new CORBA::Any();
+	return insert((static_cast<GpibDeviceServer *>(device))->reload_properties());
 }
 
 //+----------------------------------------------------------------------------
 //
-// method : 		ClearCmd::execute()
+// method : 		GetBoardIndexCmd::execute()
 // 
 // description : 	method to trigger the execution of the command.
 //                PLEASE DO NOT MODIFY this method core without pogo   
 //
-// in : - device : The device on which the command must be excuted
+// in : - device : The device on which the command must be executed
 //		- in_any : The command input data
 //
 // returns : The command output data (packed in the Any object)
 //
 //-----------------------------------------------------------------------------
-CORBA::Any *ClearCmd::execute(Tango::DeviceImpl *device,const CORBA::Any &in_any)
+CORBA::Any *GetBoardIndexCmd::execute(Tango::DeviceImpl *device,const CORBA::Any &in_any)
 {
 
-	cout2 << "ClearCmd::execute(): arrived" << endl;
+	cout2 << "GetBoardIndexCmd::execute(): arrived" << endl;
 
-	((static_cast<GpibDeviceServer *>(device))->clear());
-	return new CORBA::Any();
+	return insert((static_cast<GpibDeviceServer *>(device))->get_board_index());
 }
 
 //+----------------------------------------------------------------------------
 //
-// method : 		GetibcntCmd::execute()
+// method : 		GetDevicePadCmd::execute()
 // 
 // description : 	method to trigger the execution of the command.
 //                PLEASE DO NOT MODIFY this method core without pogo   
 //
-// in : - device : The device on which the command must be excuted
+// in : - device : The device on which the command must be executed
 //		- in_any : The command input data
 //
 // returns : The command output data (packed in the Any object)
 //
 //-----------------------------------------------------------------------------
-CORBA::Any *GetibcntCmd::execute(Tango::DeviceImpl *device,const CORBA::Any &in_any)
+CORBA::Any *GetDevicePadCmd::execute(Tango::DeviceImpl *device,const CORBA::Any &in_any)
 {
 
-	cout2 << "GetibcntCmd::execute(): arrived" << endl;
+	cout2 << "GetDevicePadCmd::execute(): arrived" << endl;
 
-	return insert((static_cast<GpibDeviceServer *>(device))->getibcnt());
+	return insert((static_cast<GpibDeviceServer *>(device))->get_device_pad());
 }
 
 //+----------------------------------------------------------------------------
 //
-// method : 		GetibstaCmd::execute()
+// method : 		GetSerialPollCmd::execute()
 // 
 // description : 	method to trigger the execution of the command.
 //                PLEASE DO NOT MODIFY this method core without pogo   
 //
-// in : - device : The device on which the command must be excuted
+// in : - device : The device on which the command must be executed
 //		- in_any : The command input data
 //
 // returns : The command output data (packed in the Any object)
 //
 //-----------------------------------------------------------------------------
-CORBA::Any *GetibstaCmd::execute(Tango::DeviceImpl *device,const CORBA::Any &in_any)
+CORBA::Any *GetSerialPollCmd::execute(Tango::DeviceImpl *device,const CORBA::Any &in_any)
 {
 
-	cout2 << "GetibstaCmd::execute(): arrived" << endl;
+	cout2 << "GetSerialPollCmd::execute(): arrived" << endl;
 
-	return insert((static_cast<GpibDeviceServer *>(device))->getibsta());
+	return insert((static_cast<GpibDeviceServer *>(device))->get_serial_poll());
 }
 
 //+----------------------------------------------------------------------------
 //
-// method : 		GetiberrCmd::execute()
+// method : 		ListenerCheckCmd::execute()
 // 
 // description : 	method to trigger the execution of the command.
 //                PLEASE DO NOT MODIFY this method core without pogo   
 //
-// in : - device : The device on which the command must be excuted
+// in : - device : The device on which the command must be executed
 //		- in_any : The command input data
 //
 // returns : The command output data (packed in the Any object)
 //
 //-----------------------------------------------------------------------------
-CORBA::Any *GetiberrCmd::execute(Tango::DeviceImpl *device,const CORBA::Any &in_any)
+CORBA::Any *ListenerCheckCmd::execute(Tango::DeviceImpl *device,const CORBA::Any &in_any)
 {
 
-	cout2 << "GetiberrCmd::execute(): arrived" << endl;
+	cout2 << "ListenerCheckCmd::execute(): arrived" << endl;
 
-	return insert((static_cast<GpibDeviceServer *>(device))->getiberr());
+	return insert((static_cast<GpibDeviceServer *>(device))->listener_check());
 }
 
 //+----------------------------------------------------------------------------
 //
-// method : 		RemoteCmd::execute()
+// method : 		GetConfigCmd::execute()
 // 
 // description : 	method to trigger the execution of the command.
 //                PLEASE DO NOT MODIFY this method core without pogo   
 //
-// in : - device : The device on which the command must be excuted
+// in : - device : The device on which the command must be executed
 //		- in_any : The command input data
 //
 // returns : The command output data (packed in the Any object)
 //
 //-----------------------------------------------------------------------------
-CORBA::Any *RemoteCmd::execute(Tango::DeviceImpl *device,const CORBA::Any &in_any)
+CORBA::Any *GetConfigCmd::execute(Tango::DeviceImpl *device,const CORBA::Any &in_any)
 {
 
-	cout2 << "RemoteCmd::execute(): arrived" << endl;
+	cout2 << "GetConfigCmd::execute(): arrived" << endl;
 
-	((static_cast<GpibDeviceServer *>(device))->remote());
-	return new CORBA::Any();
+	Tango::DevShort	argin;
+	extract(in_any, argin);
+
+	return insert((static_cast<GpibDeviceServer *>(device))->get_config(argin));
 }
 
 //+----------------------------------------------------------------------------
 //
-// method : 		LocalCmd::execute()
+// method : 		BCGetConfigCmd::execute()
 // 
 // description : 	method to trigger the execution of the command.
 //                PLEASE DO NOT MODIFY this method core without pogo   
 //
-// in : - device : The device on which the command must be excuted
+// in : - device : The device on which the command must be executed
 //		- in_any : The command input data
 //
 // returns : The command output data (packed in the Any object)
 //
 //-----------------------------------------------------------------------------
-CORBA::Any *LocalCmd::execute(Tango::DeviceImpl *device,const CORBA::Any &in_any)
+CORBA::Any *BCGetConfigCmd::execute(Tango::DeviceImpl *device,const CORBA::Any &in_any)
 {
 
-	cout2 << "LocalCmd::execute(): arrived" << endl;
+	cout2 << "BCGetConfigCmd::execute(): arrived" << endl;
 
-	((static_cast<GpibDeviceServer *>(device))->local());
-	return new CORBA::Any();
+	Tango::DevShort	argin;
+	extract(in_any, argin);
+
+	return insert((static_cast<GpibDeviceServer *>(device))->bcget_config(argin));
 }
 
 //+----------------------------------------------------------------------------
 //
-// method : 		GetNameCmd::execute()
+// method : 		ReceiveBinDataCmd::execute()
 // 
 // description : 	method to trigger the execution of the command.
 //                PLEASE DO NOT MODIFY this method core without pogo   
@@ -722,17 +728,20 @@ CORBA::Any *LocalCmd::execute(Tango::DeviceImpl *device,const CORBA::Any &in_any
 // returns : The command output data (packed in the Any object)
 //
 //-----------------------------------------------------------------------------
-CORBA::Any *GetNameCmd::execute(Tango::DeviceImpl *device,const CORBA::Any &in_any)
+CORBA::Any *ReceiveBinDataCmd::execute(Tango::DeviceImpl *device,const CORBA::Any &in_any)
 {
 
-	cout2 << "GetNameCmd::execute(): arrived" << endl;
+	cout2 << "ReceiveBinDataCmd::execute(): arrived" << endl;
 
-	return insert((static_cast<GpibDeviceServer *>(device))->get_name());
+	Tango::DevLong	argin;
+	extract(in_any, argin);
+
+	return insert((static_cast<GpibDeviceServer *>(device))->receive_bin_data(argin));
 }
 
 //+----------------------------------------------------------------------------
 //
-// method : 		ReadLongStringCmd::execute()
+// method : 		SendBinDataCmd::execute()
 // 
 // description : 	method to trigger the execution of the command.
 //                PLEASE DO NOT MODIFY this method core without pogo   
@@ -743,20 +752,21 @@ CORBA::Any *GetNameCmd::execute(Tango::DeviceImpl *device,const CORBA::Any &in_a
 // returns : The command output data (packed in the Any object)
 //
 //-----------------------------------------------------------------------------
-CORBA::Any *ReadLongStringCmd::execute(Tango::DeviceImpl *device,const CORBA::Any &in_any)
+CORBA::Any *SendBinDataCmd::execute(Tango::DeviceImpl *device,const CORBA::Any &in_any)
 {
 
-	cout2 << "ReadLongStringCmd::execute(): arrived" << endl;
+	cout2 << "SendBinDataCmd::execute(): arrived" << endl;
 
-	Tango::DevLong	argin;
+	const Tango::DevVarCharArray	*argin;
 	extract(in_any, argin);
 
-	return insert((static_cast<GpibDeviceServer *>(device))->read_long_string(argin));
+	((static_cast<GpibDeviceServer *>(device))->send_bin_data(argin));
+	return new CORBA::Any();
 }
 
 //+----------------------------------------------------------------------------
 //
-// method : 		CloseCmd::execute()
+// method : 		BCConfigCmd::execute()
 // 
 // description : 	method to trigger the execution of the command.
 //                PLEASE DO NOT MODIFY this method core without pogo   
@@ -767,19 +777,22 @@ CORBA::Any *ReadLongStringCmd::execute(Tango::DeviceImpl *device,const CORBA::An
 // returns : The command output data (packed in the Any object)
 //
 //-----------------------------------------------------------------------------
-CORBA::Any *CloseCmd::execute(Tango::DeviceImpl *device,const CORBA::Any &in_any)
+CORBA::Any *BCConfigCmd::execute(Tango::DeviceImpl *device,const CORBA::Any &in_any)
 {
 
-	cout2 << "CloseCmd::execute(): arrived" << endl;
+	cout2 << "BCConfigCmd::execute(): arrived" << endl;
 
-	((static_cast<GpibDeviceServer *>(device))->close());
+	const Tango::DevVarLongArray	*argin;
+	extract(in_any, argin);
+
+	((static_cast<GpibDeviceServer *>(device))->bcconfig(argin));
 	return new CORBA::Any();
 }
 
 
 //+----------------------------------------------------------------------------
 //
-// method : 		ReadCmd::execute()
+// method : 		ConfigCmd::execute()
 // 
 // description : 	method to trigger the execution of the command.
 //                PLEASE DO NOT MODIFY this method core without pogo   
@@ -790,17 +803,21 @@ CORBA::Any *CloseCmd::execute(Tango::DeviceImpl *device,const CORBA::Any &in_any
 // returns : The command output data (packed in the Any object)
 //
 //-----------------------------------------------------------------------------
-CORBA::Any *ReadCmd::execute(Tango::DeviceImpl *device,const CORBA::Any &in_any)
+CORBA::Any *ConfigCmd::execute(Tango::DeviceImpl *device,const CORBA::Any &in_any)
 {
 
-	cout2 << "ReadCmd::execute(): arrived" << endl;
+	cout2 << "ConfigCmd::execute(): arrived" << endl;
 
-	return insert((static_cast<GpibDeviceServer *>(device))->read());
+	const Tango::DevVarLongArray	*argin;
+	extract(in_any, argin);
+
+	((static_cast<GpibDeviceServer *>(device))->config(argin));
+	return new CORBA::Any();
 }
 
 //+----------------------------------------------------------------------------
 //
-// method : 		WriteCmd::execute()
+// method : 		WriteReadCmd::execute()
 // 
 // description : 	method to trigger the execution of the command.
 //                PLEASE DO NOT MODIFY this method core without pogo   
@@ -811,109 +828,590 @@ CORBA::Any *ReadCmd::execute(Tango::DeviceImpl *device,const CORBA::Any &in_any)
 // returns : The command output data (packed in the Any object)
 //
 //-----------------------------------------------------------------------------
-CORBA::Any *WriteCmd::execute(Tango::DeviceImpl *device,const CORBA::Any &in_any)
+CORBA::Any *WriteReadCmd::execute(Tango::DeviceImpl *device,const CORBA::Any &in_any)
 {
 
-	cout2 << "WriteCmd::execute(): arrived" << endl;
+	cout2 << "WriteReadCmd::execute(): arrived" << endl;
 
 	Tango::DevString	argin;
 	extract(in_any, argin);
 
-	((static_cast<GpibDeviceServer *>(device))->write(argin));
+	return insert((static_cast<GpibDeviceServer *>(device))->write_read(argin));
+}
+
+//+----------------------------------------------------------------------------
+//
+// method : 		TriggerCmd::execute()
+// 
+// description : 	method to trigger the execution of the command.
+//                PLEASE DO NOT MODIFY this method core without pogo   
+//
+// in : - device : The device on which the command must be excuted
+//		- in_any : The command input data
+//
+// returns : The command output data (packed in the Any object)
+//
+//-----------------------------------------------------------------------------
+CORBA::Any *TriggerCmd::execute(Tango::DeviceImpl *device,const CORBA::Any &in_any)
+{
+
+	cout2 << "TriggerCmd::execute(): arrived" << endl;
+
+	((static_cast<GpibDeviceServer *>(device))->trigger());
 	return new CORBA::Any();
 }
 
+//+----------------------------------------------------------------------------
 //
-//----------------------------------------------------------------
-//	Initialize pointer for singleton pattern
-//----------------------------------------------------------------
+// method : 		BCGetConnectedDeviceListCmd::execute()
+// 
+// description : 	method to trigger the execution of the command.
+//                PLEASE DO NOT MODIFY this method core without pogo   
 //
-GpibDeviceServerClass *GpibDeviceServerClass::_instance = NULL;
+// in : - device : The device on which the command must be excuted
+//		- in_any : The command input data
+//
+// returns : The command output data (packed in the Any object)
+//
+//-----------------------------------------------------------------------------
+CORBA::Any *BCGetConnectedDeviceListCmd::execute(Tango::DeviceImpl *device,const CORBA::Any &in_any)
+{
+
+	cout2 << "BCGetConnectedDeviceListCmd::execute(): arrived" << endl;
+
+	return insert((static_cast<GpibDeviceServer *>(device))->bcget_connected_device_list());
+}
+
 
 //+----------------------------------------------------------------------------
 //
-// method : 		GpibDeviceServerClass::GpibDeviceServerClass(string &s)
+// method : 		OpenByNameCmd::execute()
 // 
-// description : 	constructor for the GpibDeviceServerClass
+// description : 	method to trigger the execution of the command.
+//                PLEASE DO NOT MODIFY this method core without pogo   
 //
-// in : - s : The class name
+// in : - device : The device on which the command must be excuted
+//		- in_any : The command input data
+//
+// returns : The command output data (packed in the Any object)
 //
 //-----------------------------------------------------------------------------
-GpibDeviceServerClass::GpibDeviceServerClass(string &s):DeviceClass(s)
+CORBA::Any *OpenByNameCmd::execute(Tango::DeviceImpl *device,const CORBA::Any &in_any)
 {
 
-	cout2 << "Entering GpibDeviceServerClass constructor" << endl;
-	get_class_property();
-	set_default_property();
-	write_class_property();
-	
-	cout2 << "Leaving GpibDeviceServerClass constructor" << endl;
+	cout2 << "OpenByNameCmd::execute(): arrived" << endl;
 
+	((static_cast<GpibDeviceServer *>(device))->open_by_name());
+	return new CORBA::Any();
 }
+
 //+----------------------------------------------------------------------------
 //
-// method : 		GpibDeviceServerClass::~GpibDeviceServerClass()
+// method : 		OpenCmd::execute()
 // 
-// description : 	destructor for the GpibDeviceServerClass
+// description : 	method to trigger the execution of the command.
+//                PLEASE DO NOT MODIFY this method core without pogo   
+//
+// in : - device : The device on which the command must be excuted
+//		- in_any : The command input data
+//
+// returns : The command output data (packed in the Any object)
 //
 //-----------------------------------------------------------------------------
-GpibDeviceServerClass::~GpibDeviceServerClass()
+CORBA::Any *OpenCmd::execute(Tango::DeviceImpl *device,const CORBA::Any &in_any)
 {
-	_instance = NULL;
+
+	cout2 << "OpenCmd::execute(): arrived" << endl;
+
+	((static_cast<GpibDeviceServer *>(device))->open());
+	return new CORBA::Any();
 }
 
 //+----------------------------------------------------------------------------
 //
-// method : 		GpibDeviceServerClass::instance
+// method : 		BCcmdCmd::execute()
 // 
-// description : 	Create the object if not already done. Otherwise, just
-//			return a pointer to the object
+// description : 	method to trigger the execution of the command.
+//                PLEASE DO NOT MODIFY this method core without pogo   
 //
-// in : - name : The class name
+// in : - device : The device on which the command must be excuted
+//		- in_any : The command input data
+//
+// returns : The command output data (packed in the Any object)
 //
 //-----------------------------------------------------------------------------
-GpibDeviceServerClass *GpibDeviceServerClass::init(const char *name)
+CORBA::Any *BCcmdCmd::execute(Tango::DeviceImpl *device,const CORBA::Any &in_any)
 {
-	if (_instance == NULL)
-	{
-		try
-		{
-			string s(name);
-			_instance = new GpibDeviceServerClass(s);
-		}
-		catch (bad_alloc)
-		{
-			throw;
-		}		
-	}		
-	return _instance;
+
+	cout2 << "BCcmdCmd::execute(): arrived" << endl;
+
+	Tango::DevString	argin;
+	extract(in_any, argin);
+
+	((static_cast<GpibDeviceServer *>(device))->bccmd(argin));
+	return new CORBA::Any();
 }
 
-GpibDeviceServerClass *GpibDeviceServerClass::instance()
+//+----------------------------------------------------------------------------
+//
+// method : 		BClloCmd::execute()
+// 
+// description : 	method to trigger the execution of the command.
+//                PLEASE DO NOT MODIFY this method core without pogo   
+//
+// in : - device : The device on which the command must be excuted
+//		- in_any : The command input data
+//
+// returns : The command output data (packed in the Any object)
+//
+//-----------------------------------------------------------------------------
+CORBA::Any *BClloCmd::execute(Tango::DeviceImpl *device,const CORBA::Any &in_any)
 {
-	if (_instance == NULL)
-	{
-		cerr << "Class is not initialised !!" << endl;
-		exit(-1);
-	}
-	return _instance;
+
+	cout2 << "BClloCmd::execute(): arrived" << endl;
+
+	Tango::DevLong	argin;
+	extract(in_any, argin);
+
+	((static_cast<GpibDeviceServer *>(device))->bcllo(argin));
+	return new CORBA::Any();
 }
 
 //+----------------------------------------------------------------------------
 //
-// method : 		GpibDeviceServerClass::command_factory
+// method : 		GetDeviceIDCmd::execute()
 // 
-// description : 	Create the command object(s) and store them in the 
-//			command list
+// description : 	method to trigger the execution of the command.
+//                PLEASE DO NOT MODIFY this method core without pogo   
+//
+// in : - device : The device on which the command must be excuted
+//		- in_any : The command input data
+//
+// returns : The command output data (packed in the Any object)
 //
 //-----------------------------------------------------------------------------
-void GpibDeviceServerClass::command_factory()
+CORBA::Any *GetDeviceIDCmd::execute(Tango::DeviceImpl *device,const CORBA::Any &in_any)
 {
-	command_list.push_back(new WriteCmd("Write",
-		Tango::DEV_STRING, Tango::DEV_VOID,
-		"String to send to the device",
-		"",
-		Tango::OPERATOR));
+
+	cout2 << "GetDeviceIDCmd::execute(): arrived" << endl;
+
+	return insert((static_cast<GpibDeviceServer *>(device))->get_device_id());
+}
+
+//+----------------------------------------------------------------------------
+//
+// method : 		BCclrCmd::execute()
+// 
+// description : 	method to trigger the execution of the command.
+//                PLEASE DO NOT MODIFY this method core without pogo   
+//
+// in : - device : The device on which the command must be excuted
+//		- in_any : The command input data
+//
+// returns : The command output data (packed in the Any object)
+//
+//-----------------------------------------------------------------------------
+CORBA::Any *BCclrCmd::execute(Tango::DeviceImpl *device,const CORBA::Any &in_any)
+{
+
+	cout2 << "BCclrCmd::execute(): arrived" << endl;
+
+	Tango::DevLong	argin;
+	extract(in_any, argin);
+
+	((static_cast<GpibDeviceServer *>(device))->bcclr(argin));
+	return new CORBA::Any();
+}
+
+//+----------------------------------------------------------------------------
+//
+// method : 		BCsendIFCCmd::execute()
+// 
+// description : 	method to trigger the execution of the command.
+//                PLEASE DO NOT MODIFY this method core without pogo   
+//
+// in : - device : The device on which the command must be excuted
+//		- in_any : The command input data
+//
+// returns : The command output data (packed in the Any object)
+//
+//-----------------------------------------------------------------------------
+CORBA::Any *BCsendIFCCmd::execute(Tango::DeviceImpl *device,const CORBA::Any &in_any)
+{
+
+	cout2 << "BCsendIFCCmd::execute(): arrived" << endl;
+
+	((static_cast<GpibDeviceServer *>(device))->bcsend_ifc());
+	return new CORBA::Any();
+}
+
+//+----------------------------------------------------------------------------
+//
+// method : 		SetTimeOutCmd::execute()
+// 
+// description : 	method to trigger the execution of the command.
+//                PLEASE DO NOT MODIFY this method core without pogo   
+//
+// in : - device : The device on which the command must be excuted
+//		- in_any : The command input data
+//
+// returns : The command output data (packed in the Any object)
+//
+//-----------------------------------------------------------------------------
+CORBA::Any *SetTimeOutCmd::execute(Tango::DeviceImpl *device,const CORBA::Any &in_any)
+{
+
+	cout2 << "SetTimeOutCmd::execute(): arrived" << endl;
+
+	Tango::DevShort	argin;
+	extract(in_any, argin);
+
+	((static_cast<GpibDeviceServer *>(device))->set_time_out(argin));
+	return new CORBA::Any();
+}
+
+//+----------------------------------------------------------------------------
+//
+// method : 		ClearCmd::execute()
+// 
+// description : 	method to trigger the execution of the command.
+//                PLEASE DO NOT MODIFY this method core without pogo   
+//
+// in : - device : The device on which the command must be excuted
+//		- in_any : The command input data
+//
+// returns : The command output data (packed in the Any object)
+//
+//-----------------------------------------------------------------------------
+CORBA::Any *ClearCmd::execute(Tango::DeviceImpl *device,const CORBA::Any &in_any)
+{
+
+	cout2 << "ClearCmd::execute(): arrived" << endl;
+
+	((static_cast<GpibDeviceServer *>(device))->clear());
+	return new CORBA::Any();
+}
+
+//+----------------------------------------------------------------------------
+//
+// method : 		GetibcntCmd::execute()
+// 
+// description : 	method to trigger the execution of the command.
+//                PLEASE DO NOT MODIFY this method core without pogo   
+//
+// in : - device : The device on which the command must be excuted
+//		- in_any : The command input data
+//
+// returns : The command output data (packed in the Any object)
+//
+//-----------------------------------------------------------------------------
+CORBA::Any *GetibcntCmd::execute(Tango::DeviceImpl *device,const CORBA::Any &in_any)
+{
+
+	cout2 << "GetibcntCmd::execute(): arrived" << endl;
+
+	return insert((static_cast<GpibDeviceServer *>(device))->getibcnt());
+}
+
+//+----------------------------------------------------------------------------
+//
+// method : 		GetibstaCmd::execute()
+// 
+// description : 	method to trigger the execution of the command.
+//                PLEASE DO NOT MODIFY this method core without pogo   
+//
+// in : - device : The device on which the command must be excuted
+//		- in_any : The command input data
+//
+// returns : The command output data (packed in the Any object)
+//
+//-----------------------------------------------------------------------------
+CORBA::Any *GetibstaCmd::execute(Tango::DeviceImpl *device,const CORBA::Any &in_any)
+{
+
+	cout2 << "GetibstaCmd::execute(): arrived" << endl;
+
+	return insert((static_cast<GpibDeviceServer *>(device))->getibsta());
+}
+
+//+----------------------------------------------------------------------------
+//
+// method : 		GetiberrCmd::execute()
+// 
+// description : 	method to trigger the execution of the command.
+//                PLEASE DO NOT MODIFY this method core without pogo   
+//
+// in : - device : The device on which the command must be excuted
+//		- in_any : The command input data
+//
+// returns : The command output data (packed in the Any object)
+//
+//-----------------------------------------------------------------------------
+CORBA::Any *GetiberrCmd::execute(Tango::DeviceImpl *device,const CORBA::Any &in_any)
+{
+
+	cout2 << "GetiberrCmd::execute(): arrived" << endl;
+
+	return insert((static_cast<GpibDeviceServer *>(device))->getiberr());
+}
+
+//+----------------------------------------------------------------------------
+//
+// method : 		RemoteCmd::execute()
+// 
+// description : 	method to trigger the execution of the command.
+//                PLEASE DO NOT MODIFY this method core without pogo   
+//
+// in : - device : The device on which the command must be excuted
+//		- in_any : The command input data
+//
+// returns : The command output data (packed in the Any object)
+//
+//-----------------------------------------------------------------------------
+CORBA::Any *RemoteCmd::execute(Tango::DeviceImpl *device,const CORBA::Any &in_any)
+{
+
+	cout2 << "RemoteCmd::execute(): arrived" << endl;
+
+	((static_cast<GpibDeviceServer *>(device))->remote());
+	return new CORBA::Any();
+}
+
+//+----------------------------------------------------------------------------
+//
+// method : 		LocalCmd::execute()
+// 
+// description : 	method to trigger the execution of the command.
+//                PLEASE DO NOT MODIFY this method core without pogo   
+//
+// in : - device : The device on which the command must be excuted
+//		- in_any : The command input data
+//
+// returns : The command output data (packed in the Any object)
+//
+//-----------------------------------------------------------------------------
+CORBA::Any *LocalCmd::execute(Tango::DeviceImpl *device,const CORBA::Any &in_any)
+{
+
+	cout2 << "LocalCmd::execute(): arrived" << endl;
+
+	((static_cast<GpibDeviceServer *>(device))->local());
+	return new CORBA::Any();
+}
+
+//+----------------------------------------------------------------------------
+//
+// method : 		GetNameCmd::execute()
+// 
+// description : 	method to trigger the execution of the command.
+//                PLEASE DO NOT MODIFY this method core without pogo   
+//
+// in : - device : The device on which the command must be excuted
+//		- in_any : The command input data
+//
+// returns : The command output data (packed in the Any object)
+//
+//-----------------------------------------------------------------------------
+CORBA::Any *GetNameCmd::execute(Tango::DeviceImpl *device,const CORBA::Any &in_any)
+{
+
+	cout2 << "GetNameCmd::execute(): arrived" << endl;
+
+	return insert((static_cast<GpibDeviceServer *>(device))->get_name());
+}
+
+//+----------------------------------------------------------------------------
+//
+// method : 		ReadLongStringCmd::execute()
+// 
+// description : 	method to trigger the execution of the command.
+//                PLEASE DO NOT MODIFY this method core without pogo   
+//
+// in : - device : The device on which the command must be excuted
+//		- in_any : The command input data
+//
+// returns : The command output data (packed in the Any object)
+//
+//-----------------------------------------------------------------------------
+CORBA::Any *ReadLongStringCmd::execute(Tango::DeviceImpl *device,const CORBA::Any &in_any)
+{
+
+	cout2 << "ReadLongStringCmd::execute(): arrived" << endl;
+
+	Tango::DevLong	argin;
+	extract(in_any, argin);
+
+	return insert((static_cast<GpibDeviceServer *>(device))->read_long_string(argin));
+}
+
+//+----------------------------------------------------------------------------
+//
+// method : 		CloseCmd::execute()
+// 
+// description : 	method to trigger the execution of the command.
+//                PLEASE DO NOT MODIFY this method core without pogo   
+//
+// in : - device : The device on which the command must be excuted
+//		- in_any : The command input data
+//
+// returns : The command output data (packed in the Any object)
+//
+//-----------------------------------------------------------------------------
+CORBA::Any *CloseCmd::execute(Tango::DeviceImpl *device,const CORBA::Any &in_any)
+{
+
+	cout2 << "CloseCmd::execute(): arrived" << endl;
+
+	((static_cast<GpibDeviceServer *>(device))->close());
+	return new CORBA::Any();
+}
+
+
+//+----------------------------------------------------------------------------
+//
+// method : 		ReadCmd::execute()
+// 
+// description : 	method to trigger the execution of the command.
+//                PLEASE DO NOT MODIFY this method core without pogo   
+//
+// in : - device : The device on which the command must be excuted
+//		- in_any : The command input data
+//
+// returns : The command output data (packed in the Any object)
+//
+//-----------------------------------------------------------------------------
+CORBA::Any *ReadCmd::execute(Tango::DeviceImpl *device,const CORBA::Any &in_any)
+{
+
+	cout2 << "ReadCmd::execute(): arrived" << endl;
+
+	return insert((static_cast<GpibDeviceServer *>(device))->read());
+}
+
+//+----------------------------------------------------------------------------
+//
+// method : 		WriteCmd::execute()
+// 
+// description : 	method to trigger the execution of the command.
+//                PLEASE DO NOT MODIFY this method core without pogo   
+//
+// in : - device : The device on which the command must be excuted
+//		- in_any : The command input data
+//
+// returns : The command output data (packed in the Any object)
+//
+//-----------------------------------------------------------------------------
+CORBA::Any *WriteCmd::execute(Tango::DeviceImpl *device,const CORBA::Any &in_any)
+{
+
+	cout2 << "WriteCmd::execute(): arrived" << endl;
+
+	Tango::DevString	argin;
+	extract(in_any, argin);
+
+	((static_cast<GpibDeviceServer *>(device))->write(argin));
+	return new CORBA::Any();
+}
+
+//
+//----------------------------------------------------------------
+//	Initialize pointer for singleton pattern
+//----------------------------------------------------------------
+//
+GpibDeviceServerClass *GpibDeviceServerClass::_instance = NULL;
+
+//+----------------------------------------------------------------------------
+//
+// method : 		GpibDeviceServerClass::GpibDeviceServerClass(string &s)
+// 
+// description : 	constructor for the GpibDeviceServerClass
+//
+// in : - s : The class name
+//
+//-----------------------------------------------------------------------------
+GpibDeviceServerClass::GpibDeviceServerClass(string &s):DeviceClass(s)
+{
+
+	cout2 << "Entering GpibDeviceServerClass constructor" << endl;
+	init_pool = NULL;
+	async_init = false;
+	metrics = NULL;
+	get_class_property();
+	set_default_property();
+	write_class_property();
+	
+	cout2 << "Leaving GpibDeviceServerClass constructor" << endl;
+
+}
+//+----------------------------------------------------------------------------
+//
+// method : 		GpibDeviceServerClass::~GpibDeviceServerClass()
+// 
+// description : 	destructor for the GpibDeviceServerClass
+//
+//-----------------------------------------------------------------------------
+GpibDeviceServerClass::~GpibDeviceServerClass()
+{
+	delete init_pool;
+	init_pool = NULL;
+	if (metrics != NULL)
+		metrics->stop();
+	metrics = NULL;
+	_instance = NULL;
+}
+
+//+----------------------------------------------------------------------------
+//
+// method : 		GpibDeviceServerClass::instance
+// 
+// description : 	Create the object if not already done. Otherwise, just
+//			return a pointer to the object
+//
+// in : - name : The class name
+//
+//-----------------------------------------------------------------------------
+GpibDeviceServerClass *GpibDeviceServerClass::init(const char *name)
+{
+	if (_instance == NULL)
+	{
+		try
+		{
+			string s(name);
+			_instance = new GpibDeviceServerClass(s);
+		}
+		catch (bad_alloc)
+		{
+			throw;
+		}		
+	}		
+	return _instance;
+}
+
+GpibDeviceServerClass *GpibDeviceServerClass::instance()
+{
+	if (_instance == NULL)
+	{
+		cerr << "Class is not initialised !!" << endl;
+		exit(-1);
+	}
+	return _instance;
+}
+
+//+----------------------------------------------------------------------------
+//
+// method : 		GpibDeviceServerClass::command_factory
+// 
+// description : 	Create the command object(s) and store them in the 
+//			command list
+//
+//-----------------------------------------------------------------------------
+void GpibDeviceServerClass::command_factory()
+{
+	command_list.push_back(new WriteCmd("Write",
+		Tango::DEV_STRING, Tango::DEV_VOID,
+		"String to send to the device",
+		"",
+		Tango::OPERATOR));
 	command_list.push_back(new ReadCmd("Read",
 		Tango::DEV_VOID, Tango::DEV_STRING,
 		"",
@@ -1069,6 +1567,111 @@ void GpibDeviceServerClass::command_factory()
 		"",
 		"Board Index (starts with 0)",
 		Tango::OPERATOR));
+	command_list.push_back(new ReloadPropertiesCmd("ReloadProperties",
+		Tango::DEV_VOID, Tango::DEVVAR_STRINGARRAY,
+		"no argin",
+		"Changed properties",
+		Tango::EXPERT));
+	command_list.push_back(new GetLatencyStatsCmd("GetLatencyStats",
+		Tango::DEV_VOID, Tango::DEVVAR_STRINGARRAY,
+		"no argin",
+		"One line per operation: count, p50, p90, p99, p99.9 and max latency in us",
+		Tango::OPERATOR));
+	command_list.push_back(new ResetLatencyStatsCmd("ResetLatencyStats",
+		Tango::DEV_VOID, Tango::DEV_VOID,
+		"no argin",
+		"no argout",
+		Tango::OPERATOR));
+	command_list.push_back(new DumpTraceCmd("DumpTrace",
+		Tango::DEV_STRING, Tango::DEV_LONG,
+		"File name",
+		"Number of driver calls written",
+		Tango::EXPERT));
+	command_list.push_back(new BCTriggerListCmd("BCTriggerList",
+		Tango::DEVVAR_LONGARRAY, Tango::DEV_VOID,
+		"Addresses of the devices (pad, or pad + 256 * sad) to trigger",
+		"no argout",
+		Tango::OPERATOR));
+	command_list.push_back(new BCSnapshotGroupCmd("BCSnapshotGroup",
+		Tango::DEVVAR_LONGSTRINGARRAY, Tango::DEVVAR_DOUBLESTRINGARRAY,
+		"Addresses of the devices (pad, or pad + 256 * sad), query sent before each read (optional)",
+		"Replies, trigger time then time and iberr (-1 = ok) of each reply",
+		Tango::OPERATOR));
+	command_list.push_back(new BCWriteManyCmd("BCWriteMany",
+		Tango::DEVVAR_LONGSTRINGARRAY, Tango::DEV_LONG,
+		"Addresses of the devices (pad, or pad + 256 * sad), string to write",
+		"Number of bytes written",
+		Tango::OPERATOR));
+	command_list.push_back(new BCSerialPollAllCmd("BCSerialPollAll",
+		Tango::DEVVAR_LONGARRAY, Tango::DEVVAR_LONGARRAY,
+		"Addresses of the devices (pad, or pad + 256 * sad) to poll",
+		"Status byte of each device, -1 if it did not answer",
+		Tango::OPERATOR));
+	command_list.push_back(new PPollConfigCmd("PPollConfig",
+		Tango::DEVVAR_LONGARRAY, Tango::DEV_VOID,
+		"[data line (1 to 8), sense (0 or 1)]",
+		"no argout",
+		Tango::OPERATOR));
+	command_list.push_back(new PPollUnconfigCmd("PPollUnconfig",
+		Tango::DEV_VOID, Tango::DEV_VOID,
+		"no argin",
+		"no argout",
+		Tango::OPERATOR));
+	command_list.push_back(new BCParallelPollCmd("BCParallelPoll",
+		Tango::DEV_VOID, Tango::DEV_LONG,
+		"no argin",
+		"Parallel poll response byte",
+		Tango::OPERATOR));
+	command_list.push_back(new BCStartFastPollCmd("BCStartFastPoll",
+		Tango::DEV_LONG, Tango::DEV_VOID,
+		"Period of the polls, us (1000 to 1000000)",
+		"no argout",
+		Tango::EXPERT));
+	command_list.push_back(new BCStopFastPollCmd("BCStopFastPoll",
+		Tango::DEV_VOID, Tango::DEV_VOID,
+		"no argin",
+		"no argout",
+		Tango::EXPERT));
+	command_list.push_back(new BCWriteReadManyCmd("BCWriteReadMany",
+		Tango::DEVVAR_LONGSTRINGARRAY, Tango::DEVVAR_LONGSTRINGARRAY,
+		"Addresses of the devices (pad, or pad + 256 * sad), query (e.g. :MEAS?)",
+		"iberr (-1 = ok) and reply of each device",
+		Tango::OPERATOR));
+	command_list.push_back(new BCSetHS488Cmd("BCSetHS488",
+		Tango::DEV_SHORT, Tango::DEV_VOID,
+		"Cable length in meters (1 to 15), 0 = standard handshake",
+		"no argout",
+		Tango::EXPERT));
+	command_list.push_back(new BCTestHS488Cmd("BCTestHS488",
+		Tango::DEVVAR_LONGSTRINGARRAY, Tango::DEVVAR_DOUBLEARRAY,
+		"[address, size, cable length], query returning size bytes (e.g. a waveform)",
+		"[bytes, standard bytes/s, HS488 bytes/s (0 = failed), HS488 enabled (0/1), iberr (-1 = ok)]",
+		Tango::EXPERT));
+	command_list.push_back(new BCTuneBusCmd("BCTuneBus",
+		Tango::DEVVAR_LONGSTRINGARRAY, Tango::DEVVAR_LONGARRAY,
+		"Addresses of the devices (pad, or pad + 256 * sad) (none = all listeners), query with a fixed reply (optional, default *IDN?)",
+		"Chosen timing and DMA, then timing, DMA and us of all transfers (-1 = failed) of each setting tried",
+		Tango::EXPERT));
+	command_list.push_back(new BCGetConnectedDeviceListSADCmd("BCGetConnectedDeviceListSAD",
+		Tango::DEV_VOID, Tango::DEVVAR_STRINGARRAY,
+		"no argin",
+		"list of connected device on the GPIB bus, with their secondary addresses",
+		Tango::OPERATOR));
+	command_list.push_back(new BCStartMonitorCmd("BCStartMonitor",
+		Tango::DEV_STRING, Tango::DEV_VOID,
+		"Name of the spare board (e.g. gpib1) on the bus cable",
+		"no argout",
+		Tango::EXPERT));
+	command_list.push_back(new BCStopMonitorCmd("BCStopMonitor",
+		Tango::DEV_VOID, Tango::DEV_VOID,
+		"no argin",
+		"no argout",
+		Tango::EXPERT));
+	command_list.push_back(new BCDumpMonitorCmd("BCDumpMonitor",
+		Tango::DEV_STRING, Tango::DEV_LONG,
+		"File name",
+		"Number of bus bytes written",
+		Tango::EXPERT));
 
 	//	add polling if any
 	for (unsigned int i=0 ; i<command_list.size(); i++)
@@ -1078,89 +1681,442 @@ void GpibDeviceServerClass::command_factory()
 
 //+----------------------------------------------------------------------------
 //
-// method : 		GpibDeviceServerClass::get_class_property
+// method : 		GpibDeviceServerClass::attribute_factory
+// 
+// description : 	Create the attribute object(s) and store them in the 
+//			attribute list
+//
+// in :		vector<Tango::Attr *> &att_list : The device attribute list
+//
+//-----------------------------------------------------------------------------
+void GpibDeviceServerClass::attribute_factory(vector<Tango::Attr *> &att_list)
+{
+	//	One latency histogram per operation type, e.g. WriteLatencyHistogram
+	for (int op=0 ; op<GPIB_NB_OP ; op++)
+	{
+		string	name(gpibOpName(op));
+		name[0] = toupper(name[0]);
+		name += "LatencyHistogram";
+		LatencyHistogramAttrib	*histo = new LatencyHistogramAttrib(name.c_str(), op);
+		Tango::UserDefaultAttrProp	histo_prop;
+		histo_prop.set_unit("count");
+		histo_prop.set_description(("Number of " + string(gpibOpName(op)) +
+			" calls per latency bucket (bucket limits in LatencyBuckets).\n" +
+			"Trimmed after the last non empty bucket.").c_str());
+		histo->set_default_properties(histo_prop);
+		att_list.push_back(histo);
+	}
+
+	//	Attribute : LatencyBuckets
+	LatencyBucketsAttrib	*buckets = new LatencyBucketsAttrib();
+	Tango::UserDefaultAttrProp	buckets_prop;
+	buckets_prop.set_unit("us");
+	buckets_prop.set_description("Highest latency of each bucket of the latency histograms.");
+	buckets->set_default_properties(buckets_prop);
+	att_list.push_back(buckets);
+
+	//	Counters of the device (e.g. BytesRead) and of its board
+	//	(e.g. BoardBytesRead)
+	static const char *counter_attr[GPIB_NB_COUNTER][2] = {
+		{"Transactions", "driver calls"},
+		{"BytesWritten", "bytes written on the bus"},
+		{"BytesRead",    "bytes read from the bus"},
+		{"Timeouts",     "driver calls ended by a timeout"},
+		{"Errors",       "driver calls ended with an error"},
+		{"Probes",       "presence checks (isAlive)"}};
+	for (int b=0 ; b<2 ; b++)
+	{
+		string	prefix = (b == 1) ? "Board" : "";
+		string	owner = (b == 1) ? "the board of the device" : "the device";
+		for (int c=0 ; c<GPIB_NB_COUNTER ; c++)
+		{
+			string	name = prefix + counter_attr[c][0];
+			CounterAttrib	*counter = new CounterAttrib(name.c_str(), c, (b == 1));
+			Tango::UserDefaultAttrProp	counter_prop;
+			counter_prop.set_description(("Number of " + string(counter_attr[c][1]) +
+				" of " + owner + " since the server start.").c_str());
+			counter->set_default_properties(counter_prop);
+			att_list.push_back(counter);
+		}
+
+		string	name = prefix + "ErrorCounts";
+		ErrorCountsAttrib	*errors = new ErrorCountsAttrib(name.c_str(), (b == 1));
+		Tango::UserDefaultAttrProp	errors_prop;
+		errors_prop.set_description(("Number of errors of " + owner +
+			" by iberr code (index 0 = EDVR ... 6 = EABO ... 20 = ETAB).").c_str());
+		errors->set_default_properties(errors_prop);
+		att_list.push_back(errors);
+	}
+
+	//	Latency breakdown of the commands: one row per command (see
+	//	BreakdownCommands), columns wait, probe, io, other and total
+	const char	*stages = "Columns: wait (request checks and serialization lock), "
+		"probe (always_executed_hook), io (gpib driver calls), other (command code, "
+		"argin/argout), total.";
+
+	BreakdownCommandsAttrib	*commands = new BreakdownCommandsAttrib();
+	Tango::UserDefaultAttrProp	commands_prop;
+	commands_prop.set_description("Commands of the latency breakdown, in the row order of BreakdownMean and BreakdownP99.");
+	commands->set_default_properties(commands_prop);
+	att_list.push_back(commands);
+
+	BreakdownCountAttrib	*count = new BreakdownCountAttrib();
+	Tango::UserDefaultAttrProp	count_prop;
+	count_prop.set_description("Number of calls of each command of BreakdownCommands.");
+	count->set_default_properties(count_prop);
+	att_list.push_back(count);
+
+	BreakdownMeanAttrib	*mean = new BreakdownMeanAttrib();
+	Tango::UserDefaultAttrProp	mean_prop;
+	mean_prop.set_unit("us");
+	mean_prop.set_description((string("Average time of each command stage.\n") + stages).c_str());
+	mean->set_default_properties(mean_prop);
+	att_list.push_back(mean);
+
+	BreakdownP99Attrib	*p99 = new BreakdownP99Attrib();
+	Tango::UserDefaultAttrProp	p99_prop;
+	p99_prop.set_unit("us");
+	p99_prop.set_description((string("p99 of each command stage.\n") + stages).c_str());
+	p99->set_default_properties(p99_prop);
+	att_list.push_back(p99);
+
+	//	Aggregate status of the last BCSerialPollAll
+	ServiceRequestMaskAttrib	*rqs = new ServiceRequestMaskAttrib();
+	Tango::UserDefaultAttrProp	rqs_prop;
+	rqs_prop.set_format("0x%08x");
+	rqs_prop.set_description("Devices requesting service (RQS bit of the status byte) at the last BCSerialPollAll: bit n is set for the primary address n (also for a device on one of its secondary addresses).");
+	rqs->set_default_properties(rqs_prop);
+	att_list.push_back(rqs);
+
+	//	Last parallel poll response
+	ParallelPollAttrib	*ppoll = new ParallelPollAttrib();
+	Tango::UserDefaultAttrProp	ppoll_prop;
+	ppoll_prop.set_format("0x%02x");
+	ppoll_prop.set_description("Last parallel poll response byte, of the fast poll while it runs (BCStartFastPoll), else of BCParallelPoll: bit n is set by the devices configured on data line n+1 (PPollConfig). Invalid before the first poll or on error.");
+	ppoll->set_default_properties(ppoll_prop);
+	att_list.push_back(ppoll);
+
+	//	Bus statistics of the passive monitor (BCStartMonitor)
+	BusUtilizationAttrib	*utilization = new BusUtilizationAttrib();
+	Tango::UserDefaultAttrProp	utilization_prop;
+	utilization_prop.set_unit("%");
+	utilization_prop.set_format("%5.1f");
+	utilization_prop.set_description("Busy time of the bus during the last second, seen by the bus monitor (BCStartMonitor). Invalid if the monitor is not running or cannot read the bus.");
+	utilization->set_default_properties(utilization_prop);
+	att_list.push_back(utilization);
+
+	for (int l=0 ; l<2 ; l++)
+	{
+		BandwidthAttrib	*bandwidth = new BandwidthAttrib((l == 1) ? "ListenerBandwidth" : "TalkerBandwidth", (l == 1));
+		Tango::UserDefaultAttrProp	bandwidth_prop;
+		bandwidth_prop.set_unit("bytes/s");
+		string	who = (l == 1) ? "listeners are" : "talker is";
+		bandwidth_prop.set_description((string((l == 1) ? "Data bytes received" : "Data bytes sent") +
+			" by each primary address during the last second, seen by the bus monitor (BCStartMonitor). "
+			"The last index counts the bytes whose " + who +
+			" unknown: all of them on a real board, whose driver does not return the addressing commands.").c_str());
+		bandwidth->set_default_properties(bandwidth_prop);
+		att_list.push_back(bandwidth);
+	}
+}
+
+//+----------------------------------------------------------------------------
+//
+// method : 		GpibDeviceServerClass::get_class_property
+// 
+// description : 	Get the class property for specified name.
+//
+// in :		string	name : The property name
+//
+//+----------------------------------------------------------------------------
+Tango::DbDatum GpibDeviceServerClass::get_class_property(string &prop_name)
+{
+	for (unsigned int i=0 ; i<cl_prop.size() ; i++)
+		if (cl_prop[i].name == prop_name)
+			return cl_prop[i];
+	//	if not found, return  an empty DbDatum
+	return Tango::DbDatum(prop_name);
+}
+//+----------------------------------------------------------------------------
+//
+// method : 		GpibDeviceServerClass::get_default_device_property()
+// 
+// description : 	Return the default value for device property.
+//
+//-----------------------------------------------------------------------------
+Tango::DbDatum GpibDeviceServerClass::get_default_device_property(string &prop_name)
+{
+	for (unsigned int i=0 ; i<dev_def_prop.size() ; i++)
+		if (dev_def_prop[i].name == prop_name)
+			return dev_def_prop[i];
+	//	if not found, return  an empty DbDatum
+	return Tango::DbDatum(prop_name);
+}
+
+//+----------------------------------------------------------------------------
+//
+// method : 		GpibDeviceServerClass::get_default_class_property()
+// 
+// description : 	Return the default value for class property.
+//
+//-----------------------------------------------------------------------------
+Tango::DbDatum GpibDeviceServerClass::get_default_class_property(string &prop_name)
+{
+	for (unsigned int i=0 ; i<cl_def_prop.size() ; i++)
+		if (cl_def_prop[i].name == prop_name)
+			return cl_def_prop[i];
+	//	if not found, return  an empty DbDatum
+	return Tango::DbDatum(prop_name);
+}
+//+----------------------------------------------------------------------------
+//
+// method : 		GpibDeviceServerClass::device_factory
+// 
+// description : 	Create the device object(s) and store them in the 
+//			device list
+//
+// in :		Tango::DevVarStringArray *devlist_ptr : The device name list
+//
+//-----------------------------------------------------------------------------
+void GpibDeviceServerClass::device_factory(const Tango::DevVarStringArray *devlist_ptr)
+{
+	//	Devices are opened in background by the init pool: a device which
+	//	is off must not delay the server startup.
+	if ( (initPoolSize > 0) && (init_pool == NULL) )
+		init_pool = new GpibInitPool(initPoolSize);
+	async_init = (init_pool != NULL);
+	
+	//	Devices register their counters at init_device().
+	if ( (metricsFile.length() > 0) && (metrics == NULL) )
+		metrics = new GpibMetrics(metricsFile, metricsPeriod);
+	
+	//	Read the properties of all devices with one database call.
+	prefetch_device_properties(devlist_ptr);
+
+	//	Create all devices.(Automatic code generation)
+	//-------------------------------------------------------------
+	for (unsigned long i=0 ; i < devlist_ptr->length() ; i++)
+	{
+		cout4 << "Device name : " << (*devlist_ptr)[i].in() << endl;
+						
+		// Create devices and add it into the device list
+		//----------------------------------------------------
+		device_list.push_back(new GpibDeviceServer(this, (*devlist_ptr)[i]));							 
+
+		// Export device to the outside world
+		// Check before if database used.
+		//---------------------------------------------
+		if ((Tango::Util::_UseDb == true) && (Tango::Util::_FileDb == false))
+			export_device(device_list.back());
+		else
+			export_device(device_list.back(), (*devlist_ptr)[i]);
+	}
+	//	End of Automatic code generation
+	//-------------------------------------------------------------
+
+	async_init = false;
+	prefetched_props.clear();
+}
+
+
+//+----------------------------------------------------------------------------
+//
+// function : 		sql_string
+// 
+// description : 	Quote a string for a DbMySqlSelect query: quotes and
+//			backslashes are escaped, so that a device name cannot
+//			change the query.
+//
+//-----------------------------------------------------------------------------
+static string sql_string(const string &s)
+{
+	string	quoted = "'";
+	for (unsigned long i=0 ; i < s.length() ; i++)
+	{
+		if ( (s[i] == '\'') || (s[i] == '\\') )
+			quoted += '\\';
+		quoted += s[i];
+	}
+	return quoted + "'";
+}
+
+
+//+----------------------------------------------------------------------------
+//
+// method : 		GpibDeviceServerClass::prefetch_device_properties
+// 
+// description : 	Read the properties of all the devices to be created
+//			with a single DbMySqlSelect call on the database, in
+//			place of one get_property call per device. The values
+//			are kept in prefetched_props until each device reads
+//			them in get_device_property(). On error nothing is
+//			prefetched and devices read their properties one by one.
+//
+// in :		Tango::DevVarStringArray *devlist_ptr : The device name list
+//
+//-----------------------------------------------------------------------------
+void GpibDeviceServerClass::prefetch_device_properties(const Tango::DevVarStringArray *devlist_ptr)
+{
+	prefetched_props.clear();
+	if ( (Tango::Util::_UseDb == false) || (Tango::Util::_FileDb == true) )
+		return;
+	if (devlist_ptr->length() == 0)
+		return;
+		
+	string	query = "select device,name,value from property_device where device in (";
+	for (unsigned long i=0 ; i < devlist_ptr->length() ; i++)
+	{
+		string	name((*devlist_ptr)[i].in());
+		transform(name.begin(), name.end(), name.begin(), ::tolower);
+		prefetched_props[name];		// Devices without properties too
+		if (i > 0)
+			query += ",";
+		query += sql_string(name);
+	}
+	query += ") order by device,name,count";
+	
+	try
+	{
+		Tango::DeviceData	din, dout;
+		const Tango::DevVarLongStringArray	*res;
+		din << query;
+		dout = Tango::Util::instance()->get_database()->command_inout("DbMySqlSelect", din);
+		dout >> res;
+		
+		//	lvalue ends with the number of rows and of fields
+		unsigned long	nb = res->lvalue.length();
+		if (nb < 2)
+			throw string("bad DbMySqlSelect reply");
+		long	nb_rows = res->lvalue[nb-2];
+		long	nb_fields = res->lvalue[nb-1];
+		if ( (nb_fields != 3) || ((long) res->svalue.length() < nb_rows * nb_fields) )
+			throw string("bad DbMySqlSelect reply");
+			
+		for (long r=0 ; r < nb_rows ; r++)
+		{
+			string	dev(res->svalue[r*3].in());
+			string	prop(res->svalue[r*3+1].in());
+			transform(dev.begin(), dev.end(), dev.begin(), ::tolower);
+			transform(prop.begin(), prop.end(), prop.begin(), ::tolower);
+			prefetched_props[dev][prop].push_back(res->svalue[r*3+2].in());
+		}
+		cout4 << "Prefetched properties of " << devlist_ptr->length() << " devices" << endl;
+	}
+	catch (Tango::DevFailed &e)
+	{
+		cout4 << "Cannot prefetch device properties, read them one by one" << endl;
+		prefetched_props.clear();
+	}
+	catch (string &)
+	{
+		cout4 << "Cannot prefetch device properties, read them one by one" << endl;
+		prefetched_props.clear();
+	}
+}
+
+
+//+----------------------------------------------------------------------------
+//
+// method : 		GpibDeviceServerClass::get_prefetched_property
 // 
-// description : 	Get the class property for specified name.
+// description : 	Fill a device property list with the values read by
+//			prefetch_device_properties(). The device entry is
+//			removed: an Init command reads the database again.
 //
-// in :		string	name : The property name
+// in :		string dev_name : The device name
+//		Tango::DbData props : The properties to fill
 //
-//+----------------------------------------------------------------------------
-Tango::DbDatum GpibDeviceServerClass::get_class_property(string &prop_name)
+// returns :	false when the device properties were not prefetched.
+//
+//-----------------------------------------------------------------------------
+bool GpibDeviceServerClass::get_prefetched_property(const string &dev_name, Tango::DbData &props)
 {
-	for (unsigned int i=0 ; i<cl_prop.size() ; i++)
-		if (cl_prop[i].name == prop_name)
-			return cl_prop[i];
-	//	if not found, return  an empty DbDatum
-	return Tango::DbDatum(prop_name);
+	string	name(dev_name);
+	transform(name.begin(), name.end(), name.begin(), ::tolower);
+	
+	map<string, map<string, vector<string> > >::iterator	dev = prefetched_props.find(name);
+	if (dev == prefetched_props.end())
+		return false;
+		
+	for (unsigned int i=0 ; i<props.size() ; i++)
+	{
+		string	prop(props[i].name);
+		transform(prop.begin(), prop.end(), prop.begin(), ::tolower);
+		map<string, vector<string> >::iterator	val = dev->second.find(prop);
+		if (val != dev->second.end())
+			props[i].value_string = val->second;
+	}
+	prefetched_props.erase(dev);
+	return true;
 }
+
+
 //+----------------------------------------------------------------------------
 //
-// method : 		GpibDeviceServerClass::get_default_device_property()
-// 
-// description : 	Return the default value for device property.
+// method : 		GpibDeviceServerClass::get_bus_mutex
+//
+// description : 	Lock of the bus of a board. The board commands
+//			and the background threads of all the devices of the
+//			server (fast poll, bus monitor) take it, so that they
+//			do not address the bus in the middle of each other.
+//
+// in : - board : Board index.
 //
 //-----------------------------------------------------------------------------
-Tango::DbDatum GpibDeviceServerClass::get_default_device_property(string &prop_name)
+omni_mutex &GpibDeviceServerClass::get_bus_mutex(int board)
 {
-	for (unsigned int i=0 ; i<dev_def_prop.size() ; i++)
-		if (dev_def_prop[i].name == prop_name)
-			return dev_def_prop[i];
-	//	if not found, return  an empty DbDatum
-	return Tango::DbDatum(prop_name);
+	if ( (board < 0) || (board >= GPIB_NB_COUNTED_BOARDS) )
+		board = GPIB_NB_COUNTED_BOARDS;
+	return bus_mutex[board];
 }
 
 //+----------------------------------------------------------------------------
 //
-// method : 		GpibDeviceServerClass::get_default_class_property()
-// 
-// description : 	Return the default value for class property.
+// method : 		GpibDeviceServerClass::claim_monitor_board
+//
+// description : 	Reserve a spare board for the bus monitor of a
+//			device: a board runs one monitor at most in the
+//			server, so that a device cannot put it back in
+//			normal mode under the monitor of another one.
+//
+// in : - board : Board index.
+//      - dev : Device starting the monitor.
+//      - owner : Device running the monitor of the board, if any.
+//
+// returns :	false when another device runs a monitor on the board.
 //
 //-----------------------------------------------------------------------------
-Tango::DbDatum GpibDeviceServerClass::get_default_class_property(string &prop_name)
+bool GpibDeviceServerClass::claim_monitor_board(int board, const string &dev, string &owner)
 {
-	for (unsigned int i=0 ; i<cl_def_prop.size() ; i++)
-		if (cl_def_prop[i].name == prop_name)
-			return cl_def_prop[i];
-	//	if not found, return  an empty DbDatum
-	return Tango::DbDatum(prop_name);
+	omni_mutex_lock lock(monitor_mutex);
+	map<int, string>::iterator	m = monitor_boards.find(board);
+	if ( (m != monitor_boards.end()) && (m->second != dev) )
+	{
+		owner = m->second;
+		return false;
+	}
+	monitor_boards[board] = dev;
+	return true;
 }
+
 //+----------------------------------------------------------------------------
 //
-// method : 		GpibDeviceServerClass::device_factory
-// 
-// description : 	Create the device object(s) and store them in the 
-//			device list
+// method : 		GpibDeviceServerClass::release_monitor_board
 //
-// in :		Tango::DevVarStringArray *devlist_ptr : The device name list
+// description : 	Free the spare board of a stopped bus monitor.
+//
+// in : - board : Board index.
+//      - dev : Device which ran the monitor.
 //
 //-----------------------------------------------------------------------------
-void GpibDeviceServerClass::device_factory(const Tango::DevVarStringArray *devlist_ptr)
+void GpibDeviceServerClass::release_monitor_board(int board, const string &dev)
 {
-
-	//	Create all devices.(Automatic code generation)
-	//-------------------------------------------------------------
-	for (unsigned long i=0 ; i < devlist_ptr->length() ; i++)
-	{
-		cout4 << "Device name : " << (*devlist_ptr)[i].in() << endl;
-						
-		// Create devices and add it into the device list
-		//----------------------------------------------------
-		device_list.push_back(new GpibDeviceServer(this, (*devlist_ptr)[i]));							 
-
-		// Export device to the outside world
-		// Check before if database used.
-		//---------------------------------------------
-		if ((Tango::Util::_UseDb == true) && (Tango::Util::_FileDb == false))
-			export_device(device_list.back());
-		else
-			export_device(device_list.back(), (*devlist_ptr)[i]);
-	}
-	//	End of Automatic code generation
-	//-------------------------------------------------------------
-
+	omni_mutex_lock lock(monitor_mutex);
+	map<int, string>::iterator	m = monitor_boards.find(board);
+	if ( (m != monitor_boards.end()) && (m->second == dev) )
+		monitor_boards.erase(m);
 }
 
-
 //+----------------------------------------------------------------------------
 //
 // method : 		GpibDeviceServerClass::get_class_property()
@@ -1172,9 +2128,19 @@ void GpibDeviceServerClass::get_class_property()
 {
 	//	Initialize your default values here (if not done with  POGO).
 	//------------------------------------------------------------------
+#ifdef GPIB_THREAD_STATUS
+	initPoolSize = 4;
+#else
+	initPoolSize = 0;	/* Driver status is global: no parallel open */
+#endif
+	metricsFile = "";
+	metricsPeriod = 10;
 
 	//	Read class properties from database.(Automatic code generation)
 	//------------------------------------------------------------------
+	cl_prop.push_back(Tango::DbDatum("InitPoolSize"));
+	cl_prop.push_back(Tango::DbDatum("MetricsFile"));
+	cl_prop.push_back(Tango::DbDatum("MetricsPeriod"));
 
 	//	Call database and extract values
 	//--------------------------------------------
@@ -1183,6 +2149,45 @@ void GpibDeviceServerClass::get_class_property()
 	Tango::DbDatum	def_prop;
 	int	i = -1;
 
+	//	Try to extract InitPoolSize value
+	if (cl_prop[++i].is_empty()==false)	cl_prop[i]  >>  initPoolSize;
+	else
+	{
+		//	Check default value for InitPoolSize
+		def_prop = get_default_class_property(cl_prop[i].name);
+		if (def_prop.is_empty()==false)
+		{
+			def_prop    >>  initPoolSize;
+			cl_prop[i]  <<  initPoolSize;
+		}
+	}
+
+	//	Try to extract MetricsFile value
+	if (cl_prop[++i].is_empty()==false)	cl_prop[i]  >>  metricsFile;
+	else
+	{
+		//	Check default value for MetricsFile
+		def_prop = get_default_class_property(cl_prop[i].name);
+		if (def_prop.is_empty()==false)
+		{
+			def_prop    >>  metricsFile;
+			cl_prop[i]  <<  metricsFile;
+		}
+	}
+
+	//	Try to extract MetricsPeriod value
+	if (cl_prop[++i].is_empty()==false)	cl_prop[i]  >>  metricsPeriod;
+	else
+	{
+		//	Check default value for MetricsPeriod
+		def_prop = get_default_class_property(cl_prop[i].name);
+		if (def_prop.is_empty()==false)
+		{
+			def_prop    >>  metricsPeriod;
+			cl_prop[i]  <<  metricsPeriod;
+		}
+	}
+
 
 	//	End of Automatic code generation
 	//------------------------------------------------------------------
@@ -1207,6 +2212,49 @@ void GpibDeviceServerClass::set_default_property()
 
 	vector<string>	vect_data;
 	//	Set Default Class Properties
+	prop_name = "InitPoolSize";
+	prop_desc = "Maximum number of gpib boards on which devices are opened at the same time\nat server startup. Devices stay in INIT until they are opened.\n0 = devices are opened one by one before the server starts.";
+	prop_def  = "";
+	vect_data.clear();
+	if (prop_def.length()>0)
+	{
+		Tango::DbDatum	data(prop_name);
+		data << vect_data ;
+		cl_def_prop.push_back(data);
+		add_wiz_class_prop(prop_name, prop_desc,  prop_def);
+	}
+	else
+		add_wiz_class_prop(prop_name, prop_desc);
+
+	prop_name = "MetricsFile";
+	prop_desc = "File where the transfer and error counters of the devices and boards are\nwritten in OpenMetrics text format, e.g. for the node_exporter textfile\ncollector. Empty = not written.";
+	prop_def  = "";
+	vect_data.clear();
+	if (prop_def.length()>0)
+	{
+		Tango::DbDatum	data(prop_name);
+		data << vect_data ;
+		cl_def_prop.push_back(data);
+		add_wiz_class_prop(prop_name, prop_desc,  prop_def);
+	}
+	else
+		add_wiz_class_prop(prop_name, prop_desc);
+
+	prop_name = "MetricsPeriod";
+	prop_desc = "Seconds between two writes of MetricsFile.";
+	prop_def  = "10";
+	vect_data.clear();
+	vect_data.push_back("10");
+	if (prop_def.length()>0)
+	{
+		Tango::DbDatum	data(prop_name);
+		data << vect_data ;
+		cl_def_prop.push_back(data);
+		add_wiz_class_prop(prop_name, prop_desc,  prop_def);
+	}
+	else
+		add_wiz_class_prop(prop_name, prop_desc);
+
 	//	Set Default Device Properties
 	prop_name = "GpibDeviceName";
 	prop_desc = "This property is used to connect gpib device by name.";
@@ -1251,7 +2299,7 @@ void GpibDeviceServerClass::set_default_property()
 		add_wiz_dev_prop(prop_name, prop_desc);
 
 	prop_name = "GpibDeviceSecondaryAddress";
-	prop_desc = "Second address of the gpib device.";
+	prop_desc = "Second address of the gpib device, driver convention: 0 = none,\nelse 0x60 to 0x7E (secondary address 0 to 30). Used when the\ndevice is opened by address.";
 	prop_def  = "";
 	vect_data.clear();
 	if (prop_def.length()>0)
@@ -1278,6 +2326,165 @@ void GpibDeviceServerClass::set_default_property()
 	else
 		add_wiz_dev_prop(prop_name, prop_desc);
 
+	prop_name = "GpibCachedOpenMethod";
+	prop_desc = "gpibDevice constructor which opened the device at the previous start.\nWritten by the server (0 = unknown, full search at next start).";
+	prop_def  = "";
+	vect_data.clear();
+	if (prop_def.length()>0)
+	{
+		Tango::DbDatum	data(prop_name);
+		data << vect_data ;
+		dev_def_prop.push_back(data);
+		add_wiz_dev_prop(prop_name, prop_desc,  prop_def);
+	}
+	else
+		add_wiz_dev_prop(prop_name, prop_desc);
+
+	prop_name = "GpibCachedProbeMethod";
+	prop_desc = "isAlive() probe method found at the previous start.\nWritten by the server (0 = unknown, 1 = device, 2 = board).";
+	prop_def  = "";
+	vect_data.clear();
+	if (prop_def.length()>0)
+	{
+		Tango::DbDatum	data(prop_name);
+		data << vect_data ;
+		dev_def_prop.push_back(data);
+		add_wiz_dev_prop(prop_name, prop_desc,  prop_def);
+	}
+	else
+		add_wiz_dev_prop(prop_name, prop_desc);
+
+	prop_name = "GpibCachedIdn";
+	prop_desc = "Last known answer of the device to *IDN?.\nWritten by the server.";
+	prop_def  = "";
+	vect_data.clear();
+	if (prop_def.length()>0)
+	{
+		Tango::DbDatum	data(prop_name);
+		data << vect_data ;
+		dev_def_prop.push_back(data);
+		add_wiz_dev_prop(prop_name, prop_desc,  prop_def);
+	}
+	else
+		add_wiz_dev_prop(prop_name, prop_desc);
+
+	prop_name = "LazyOpen";
+	prop_desc = "When true, the device is not opened at init (state STANDBY).\nIt is opened by the first command which needs it.";
+	prop_def  = "false";
+	vect_data.clear();
+	vect_data.push_back("false");
+	if (prop_def.length()>0)
+	{
+		Tango::DbDatum	data(prop_name);
+		data << vect_data ;
+		dev_def_prop.push_back(data);
+		add_wiz_dev_prop(prop_name, prop_desc,  prop_def);
+	}
+	else
+		add_wiz_dev_prop(prop_name, prop_desc);
+
+	prop_name = "GpibDeviceEOS";
+	prop_desc = "End-of-string mode given to ibeos: EOS character in the low byte,\nplus REOS (0x400), XEOS (0x800) and BIN (0x1000).\n-1 keeps the driver (ibconf) setting.";
+	prop_def  = "";
+	vect_data.clear();
+	if (prop_def.length()>0)
+	{
+		Tango::DbDatum	data(prop_name);
+		data << vect_data ;
+		dev_def_prop.push_back(data);
+		add_wiz_dev_prop(prop_name, prop_desc,  prop_def);
+	}
+	else
+		add_wiz_dev_prop(prop_name, prop_desc);
+
+	prop_name = "GpibDeviceEOT";
+	prop_desc = "Assert EOI with the last written byte (1) or not (0).\n-1 keeps the driver (ibconf) setting.";
+	prop_def  = "";
+	vect_data.clear();
+	if (prop_def.length()>0)
+	{
+		Tango::DbDatum	data(prop_name);
+		data << vect_data ;
+		dev_def_prop.push_back(data);
+		add_wiz_dev_prop(prop_name, prop_desc,  prop_def);
+	}
+	else
+		add_wiz_dev_prop(prop_name, prop_desc);
+
+	prop_name = "LatencyAlarmP99";
+	prop_desc = "p99 latency alarm thresholds in us, for write, read, writeRead,\nbinary and probe operations (a single value applies to all).\nThe device goes to ALARM when a p99 is above its threshold.\n0 or no value = no alarm.";
+	prop_def  = "";
+	vect_data.clear();
+	if (prop_def.length()>0)
+	{
+		Tango::DbDatum	data(prop_name);
+		data << vect_data ;
+		dev_def_prop.push_back(data);
+		add_wiz_dev_prop(prop_name, prop_desc,  prop_def);
+	}
+	else
+		add_wiz_dev_prop(prop_name, prop_desc);
+
+	prop_name = "GpibBoardHS488";
+	prop_desc = "HS488 cable length of the board in meters (1 to 15), 0 = standard\nhandshake. -1 keeps the driver (ibconf) setting. Default of the\nboard: BCSetHS488 and BCTestHS488 save their setting in the\nGpibBoardHS488_<board> class property, used instead. A transfer\nerror which restores the standard handshake saves 0 there.";
+	prop_def  = "-1";
+	vect_data.clear();
+	vect_data.push_back("-1");
+	if (prop_def.length()>0)
+	{
+		Tango::DbDatum	data(prop_name);
+		data << vect_data ;
+		dev_def_prop.push_back(data);
+		add_wiz_dev_prop(prop_name, prop_desc,  prop_def);
+	}
+	else
+		add_wiz_dev_prop(prop_name, prop_desc);
+
+	prop_name = "GpibBoardTiming";
+	prop_desc = "T1 delay of the board (IbcTIMING): 1 = 2 us, 2 = 500 ns,\n3 = 350 ns. -1 keeps the driver (ibconf) setting. Default of the\nboard: BCTuneBus saves its setting in the\nGpibBoardTiming_<board> class property, used instead.";
+	prop_def  = "-1";
+	vect_data.clear();
+	vect_data.push_back("-1");
+	if (prop_def.length()>0)
+	{
+		Tango::DbDatum	data(prop_name);
+		data << vect_data ;
+		dev_def_prop.push_back(data);
+		add_wiz_dev_prop(prop_name, prop_desc,  prop_def);
+	}
+	else
+		add_wiz_dev_prop(prop_name, prop_desc);
+
+	prop_name = "GpibBoardDMA";
+	prop_desc = "DMA transfers of the board (IbcDMA): 1 = on, 0 = off. -1 keeps\nthe driver (ibconf) setting. Default of the board: BCTuneBus\nsaves its setting in the GpibBoardDMA_<board> class property,\nused instead.";
+	prop_def  = "-1";
+	vect_data.clear();
+	vect_data.push_back("-1");
+	if (prop_def.length()>0)
+	{
+		Tango::DbDatum	data(prop_name);
+		data << vect_data ;
+		dev_def_prop.push_back(data);
+		add_wiz_dev_prop(prop_name, prop_desc,  prop_def);
+	}
+	else
+		add_wiz_dev_prop(prop_name, prop_desc);
+
+	prop_name = "StickyAddressing";
+	prop_desc = "Keep the device addressed between its transfers (IbcUnAddr off).\nIt is unaddressed when another device of the board makes a\ntransfer.";
+	prop_def  = "false";
+	vect_data.clear();
+	vect_data.push_back("false");
+	if (prop_def.length()>0)
+	{
+		Tango::DbDatum	data(prop_name);
+		data << vect_data ;
+		dev_def_prop.push_back(data);
+		add_wiz_dev_prop(prop_name, prop_desc,  prop_def);
+	}
+	else
+		add_wiz_dev_prop(prop_name, prop_desc);
+
 }
 //+----------------------------------------------------------------------------
 //
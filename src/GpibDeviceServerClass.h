@@ -74,6 +74,10 @@
 
 #include <tango.h>
 #include <GpibDeviceServer.h>
+#include <GpibInitPool.h>
+#include <GpibMetrics.h>
+#include <GpibFastPoll.h>
+#include <GpibBusMonitor.h>
 
 
 namespace GpibDeviceServer_ns
@@ -81,9 +85,678 @@ namespace GpibDeviceServer_ns
 //=====================================
 //	Define classes for attributes
 //=====================================
+class LatencyHistogramAttrib: public Tango::SpectrumAttr
+{
+public:
+	LatencyHistogramAttrib(const char *name, int o):SpectrumAttr(name,
+	                  Tango::DEV_LONG64, Tango::READ, GPIB_HIST_BUCKETS), op(o) {};
+	~LatencyHistogramAttrib() {};
+	
+	virtual void read(Tango::DeviceImpl *dev,Tango::Attribute &att)
+	{(static_cast<GpibDeviceServer *>(dev))->read_LatencyHistogram(att, op);}
+	virtual bool is_allowed(Tango::DeviceImpl *dev,Tango::AttReqType ty)
+	{return (static_cast<GpibDeviceServer *>(dev))->is_Latency_allowed(ty);}
+
+	int	op;	// GpibOp of the histogram
+};
+
+class LatencyBucketsAttrib: public Tango::SpectrumAttr
+{
+public:
+	LatencyBucketsAttrib():SpectrumAttr("LatencyBuckets",
+	                  Tango::DEV_DOUBLE, Tango::READ, GPIB_HIST_BUCKETS) {};
+	~LatencyBucketsAttrib() {};
+	
+	virtual void read(Tango::DeviceImpl *dev,Tango::Attribute &att)
+	{(static_cast<GpibDeviceServer *>(dev))->read_LatencyBuckets(att);}
+	virtual bool is_allowed(Tango::DeviceImpl *dev,Tango::AttReqType ty)
+	{return (static_cast<GpibDeviceServer *>(dev))->is_Latency_allowed(ty);}
+};
+
+class CounterAttrib: public Tango::Attr
+{
+public:
+	CounterAttrib(const char *name, int c, bool b):Attr(name,
+	                  Tango::DEV_LONG64, Tango::READ), counter(c), board(b) {};
+	~CounterAttrib() {};
+	
+	virtual void read(Tango::DeviceImpl *dev,Tango::Attribute &att)
+	{(static_cast<GpibDeviceServer *>(dev))->read_Counter(att, counter, board);}
+	virtual bool is_allowed(Tango::DeviceImpl *dev,Tango::AttReqType ty)
+	{return (static_cast<GpibDeviceServer *>(dev))->is_Counters_allowed(ty);}
+
+	int	counter;	// GpibCounter
+	bool	board;		// Counter of the board, not of the device
+};
+
+class ErrorCountsAttrib: public Tango::SpectrumAttr
+{
+public:
+	ErrorCountsAttrib(const char *name, bool b):SpectrumAttr(name,
+	                  Tango::DEV_LONG64, Tango::READ, GPIB_NB_IBERR), board(b) {};
+	~ErrorCountsAttrib() {};
+	
+	virtual void read(Tango::DeviceImpl *dev,Tango::Attribute &att)
+	{(static_cast<GpibDeviceServer *>(dev))->read_ErrorCounts(att, board);}
+	virtual bool is_allowed(Tango::DeviceImpl *dev,Tango::AttReqType ty)
+	{return (static_cast<GpibDeviceServer *>(dev))->is_Counters_allowed(ty);}
+
+	bool	board;		// Counters of the board, not of the device
+};
+
+class BreakdownCommandsAttrib: public Tango::SpectrumAttr
+{
+public:
+	BreakdownCommandsAttrib():SpectrumAttr("BreakdownCommands",
+	                  Tango::DEV_STRING, Tango::READ, GPIB_MAX_BREAKDOWN) {};
+	~BreakdownCommandsAttrib() {};
+	
+	virtual void read(Tango::DeviceImpl *dev,Tango::Attribute &att)
+	{(static_cast<GpibDeviceServer *>(dev))->read_BreakdownCommands(att);}
+	virtual bool is_allowed(Tango::DeviceImpl *dev,Tango::AttReqType ty)
+	{return (static_cast<GpibDeviceServer *>(dev))->is_Breakdown_allowed(ty);}
+};
+
+class BreakdownCountAttrib: public Tango::SpectrumAttr
+{
+public:
+	BreakdownCountAttrib():SpectrumAttr("BreakdownCount",
+	                  Tango::DEV_LONG64, Tango::READ, GPIB_MAX_BREAKDOWN) {};
+	~BreakdownCountAttrib() {};
+	
+	virtual void read(Tango::DeviceImpl *dev,Tango::Attribute &att)
+	{(static_cast<GpibDeviceServer *>(dev))->read_BreakdownCount(att);}
+	virtual bool is_allowed(Tango::DeviceImpl *dev,Tango::AttReqType ty)
+	{return (static_cast<GpibDeviceServer *>(dev))->is_Breakdown_allowed(ty);}
+};
+
+class BreakdownMeanAttrib: public Tango::ImageAttr
+{
+public:
+	BreakdownMeanAttrib():ImageAttr("BreakdownMean",
+	                  Tango::DEV_DOUBLE, Tango::READ, GPIB_NB_STAGE, GPIB_MAX_BREAKDOWN) {};
+	~BreakdownMeanAttrib() {};
+	
+	virtual void read(Tango::DeviceImpl *dev,Tango::Attribute &att)
+	{(static_cast<GpibDeviceServer *>(dev))->read_BreakdownMean(att);}
+	virtual bool is_allowed(Tango::DeviceImpl *dev,Tango::AttReqType ty)
+	{return (static_cast<GpibDeviceServer *>(dev))->is_Breakdown_allowed(ty);}
+};
+
+class BreakdownP99Attrib: public Tango::ImageAttr
+{
+public:
+	BreakdownP99Attrib():ImageAttr("BreakdownP99",
+	                  Tango::DEV_DOUBLE, Tango::READ, GPIB_NB_STAGE, GPIB_MAX_BREAKDOWN) {};
+	~BreakdownP99Attrib() {};
+	
+	virtual void read(Tango::DeviceImpl *dev,Tango::Attribute &att)
+	{(static_cast<GpibDeviceServer *>(dev))->read_BreakdownP99(att);}
+	virtual bool is_allowed(Tango::DeviceImpl *dev,Tango::AttReqType ty)
+	{return (static_cast<GpibDeviceServer *>(dev))->is_Breakdown_allowed(ty);}
+};
+
+class ServiceRequestMaskAttrib: public Tango::Attr
+{
+public:
+	ServiceRequestMaskAttrib():Attr("ServiceRequestMask",
+	                  Tango::DEV_LONG, Tango::READ) {};
+	~ServiceRequestMaskAttrib() {};
+	
+	virtual void read(Tango::DeviceImpl *dev,Tango::Attribute &att)
+	{(static_cast<GpibDeviceServer *>(dev))->read_ServiceRequestMask(att);}
+	virtual bool is_allowed(Tango::DeviceImpl *dev,Tango::AttReqType ty)
+	{return (static_cast<GpibDeviceServer *>(dev))->is_ServiceRequestMask_allowed(ty);}
+};
+
+class BusUtilizationAttrib: public Tango::Attr
+{
+public:
+	BusUtilizationAttrib():Attr("BusUtilization",
+	                  Tango::DEV_DOUBLE, Tango::READ) {};
+	~BusUtilizationAttrib() {};
+	
+	virtual void read(Tango::DeviceImpl *dev,Tango::Attribute &att)
+	{(static_cast<GpibDeviceServer *>(dev))->read_BusUtilization(att);}
+	virtual bool is_allowed(Tango::DeviceImpl *dev,Tango::AttReqType ty)
+	{return (static_cast<GpibDeviceServer *>(dev))->is_Monitor_allowed(ty);}
+};
+
+class BandwidthAttrib: public Tango::SpectrumAttr
+{
+public:
+	BandwidthAttrib(const char *name, bool l):SpectrumAttr(name,
+	                  Tango::DEV_DOUBLE, Tango::READ, GPIB_MONITOR_ADDRS), listener(l) {};
+	~BandwidthAttrib() {};
+	
+	virtual void read(Tango::DeviceImpl *dev,Tango::Attribute &att)
+	{(static_cast<GpibDeviceServer *>(dev))->read_Bandwidth(att, listener);}
+	virtual bool is_allowed(Tango::DeviceImpl *dev,Tango::AttReqType ty)
+	{return (static_cast<GpibDeviceServer *>(dev))->is_Monitor_allowed(ty);}
+
+	bool	listener;	// Bytes received, not sent
+};
+
+class ParallelPollAttrib: public Tango::Attr
+{
+public:
+	ParallelPollAttrib():Attr("ParallelPoll",
+	                  Tango::DEV_LONG, Tango::READ) {};
+	~ParallelPollAttrib() {};
+	
+	virtual void read(Tango::DeviceImpl *dev,Tango::Attribute &att)
+	{(static_cast<GpibDeviceServer *>(dev))->read_ParallelPoll(att);}
+	virtual bool is_allowed(Tango::DeviceImpl *dev,Tango::AttReqType ty)
+	{return (static_cast<GpibDeviceServer *>(dev))->is_ParallelPoll_allowed(ty);}
+};
+
 //=========================================
 //	Define classes for commands
 //=========================================
+class BCDumpMonitorCmd : public Tango::Command
+{
+public:
+	BCDumpMonitorCmd(const char   *name,
+	               Tango::CmdArgType in,
+				   Tango::CmdArgType out,
+				   const char        *in_desc,
+				   const char        *out_desc,
+				   Tango::DispLevel  level)
+	:Command(name,in,out,in_desc,out_desc, level)	{};
+
+	BCDumpMonitorCmd(const char   *name,
+	               Tango::CmdArgType in,
+				   Tango::CmdArgType out)
+	:Command(name,in,out)	{};
+	~BCDumpMonitorCmd() {};
+
+	virtual CORBA::Any *execute (Tango::DeviceImpl *dev, const CORBA::Any &any);
+	virtual bool is_allowed (Tango::DeviceImpl *dev, const CORBA::Any &any)
+	{return (static_cast<GpibDeviceServer *>(dev))->is_BCDumpMonitor_allowed(any);}
+};
+
+
+
+class BCStopMonitorCmd : public Tango::Command
+{
+public:
+	BCStopMonitorCmd(const char   *name,
+	               Tango::CmdArgType in,
+				   Tango::CmdArgType out,
+				   const char        *in_desc,
+				   const char        *out_desc,
+				   Tango::DispLevel  level)
+	:Command(name,in,out,in_desc,out_desc, level)	{};
+
+	BCStopMonitorCmd(const char   *name,
+	               Tango::CmdArgType in,
+				   Tango::CmdArgType out)
+	:Command(name,in,out)	{};
+	~BCStopMonitorCmd() {};
+
+	virtual CORBA::Any *execute (Tango::DeviceImpl *dev, const CORBA::Any &any);
+	virtual bool is_allowed (Tango::DeviceImpl *dev, const CORBA::Any &any)
+	{return (static_cast<GpibDeviceServer *>(dev))->is_BCStopMonitor_allowed(any);}
+};
+
+
+
+class BCStartMonitorCmd : public Tango::Command
+{
+public:
+	BCStartMonitorCmd(const char   *name,
+	               Tango::CmdArgType in,
+				   Tango::CmdArgType out,
+				   const char        *in_desc,
+				   const char        *out_desc,
+				   Tango::DispLevel  level)
+	:Command(name,in,out,in_desc,out_desc, level)	{};
+
+	BCStartMonitorCmd(const char   *name,
+	               Tango::CmdArgType in,
+				   Tango::CmdArgType out)
+	:Command(name,in,out)	{};
+	~BCStartMonitorCmd() {};
+
+	virtual CORBA::Any *execute (Tango::DeviceImpl *dev, const CORBA::Any &any);
+	virtual bool is_allowed (Tango::DeviceImpl *dev, const CORBA::Any &any)
+	{return (static_cast<GpibDeviceServer *>(dev))->is_BCStartMonitor_allowed(any);}
+};
+
+
+
+class BCGetConnectedDeviceListSADCmd : public Tango::Command
+{
+public:
+	BCGetConnectedDeviceListSADCmd(const char   *name,
+	               Tango::CmdArgType in,
+				   Tango::CmdArgType out,
+				   const char        *in_desc,
+				   const char        *out_desc,
+				   Tango::DispLevel  level)
+	:Command(name,in,out,in_desc,out_desc, level)	{};
+
+	BCGetConnectedDeviceListSADCmd(const char   *name,
+	               Tango::CmdArgType in,
+				   Tango::CmdArgType out)
+	:Command(name,in,out)	{};
+	~BCGetConnectedDeviceListSADCmd() {};
+
+	virtual CORBA::Any *execute (Tango::DeviceImpl *dev, const CORBA::Any &any);
+	virtual bool is_allowed (Tango::DeviceImpl *dev, const CORBA::Any &any)
+	{return (static_cast<GpibDeviceServer *>(dev))->is_BCGetConnectedDeviceListSAD_allowed(any);}
+};
+
+
+
+class BCTuneBusCmd : public Tango::Command
+{
+public:
+	BCTuneBusCmd(const char   *name,
+	               Tango::CmdArgType in,
+				   Tango::CmdArgType out,
+				   const char        *in_desc,
+				   const char        *out_desc,
+				   Tango::DispLevel  level)
+	:Command(name,in,out,in_desc,out_desc, level)	{};
+
+	BCTuneBusCmd(const char   *name,
+	               Tango::CmdArgType in,
+				   Tango::CmdArgType out)
+	:Command(name,in,out)	{};
+	~BCTuneBusCmd() {};
+
+	virtual CORBA::Any *execute (Tango::DeviceImpl *dev, const CORBA::Any &any);
+	virtual bool is_allowed (Tango::DeviceImpl *dev, const CORBA::Any &any)
+	{return (static_cast<GpibDeviceServer *>(dev))->is_BCTuneBus_allowed(any);}
+};
+
+
+
+class BCTestHS488Cmd : public Tango::Command
+{
+public:
+	BCTestHS488Cmd(const char   *name,
+	               Tango::CmdArgType in,
+				   Tango::CmdArgType out,
+				   const char        *in_desc,
+				   const char        *out_desc,
+				   Tango::DispLevel  level)
+	:Command(name,in,out,in_desc,out_desc, level)	{};
+
+	BCTestHS488Cmd(const char   *name,
+	               Tango::CmdArgType in,
+				   Tango::CmdArgType out)
+	:Command(name,in,out)	{};
+	~BCTestHS488Cmd() {};
+
+	virtual CORBA::Any *execute (Tango::DeviceImpl *dev, const CORBA::Any &any);
+	virtual bool is_allowed (Tango::DeviceImpl *dev, const CORBA::Any &any)
+	{return (static_cast<GpibDeviceServer *>(dev))->is_BCTestHS488_allowed(any);}
+};
+
+
+
+class BCSetHS488Cmd : public Tango::Command
+{
+public:
+	BCSetHS488Cmd(const char   *name,
+	               Tango::CmdArgType in,
+				   Tango::CmdArgType out,
+				   const char        *in_desc,
+				   const char        *out_desc,
+				   Tango::DispLevel  level)
+	:Command(name,in,out,in_desc,out_desc, level)	{};
+
+	BCSetHS488Cmd(const char   *name,
+	               Tango::CmdArgType in,
+				   Tango::CmdArgType out)
+	:Command(name,in,out)	{};
+	~BCSetHS488Cmd() {};
+
+	virtual CORBA::Any *execute (Tango::DeviceImpl *dev, const CORBA::Any &any);
+	virtual bool is_allowed (Tango::DeviceImpl *dev, const CORBA::Any &any)
+	{return (static_cast<GpibDeviceServer *>(dev))->is_BCSetHS488_allowed(any);}
+};
+
+
+
+class BCWriteReadManyCmd : public Tango::Command
+{
+public:
+	BCWriteReadManyCmd(const char   *name,
+	               Tango::CmdArgType in,
+				   Tango::CmdArgType out,
+				   const char        *in_desc,
+				   const char        *out_desc,
+				   Tango::DispLevel  level)
+	:Command(name,in,out,in_desc,out_desc, level)	{};
+
+	BCWriteReadManyCmd(const char   *name,
+	               Tango::CmdArgType in,
+				   Tango::CmdArgType out)
+	:Command(name,in,out)	{};
+	~BCWriteReadManyCmd() {};
+
+	virtual CORBA::Any *execute (Tango::DeviceImpl *dev, const CORBA::Any &any);
+	virtual bool is_allowed (Tango::DeviceImpl *dev, const CORBA::Any &any)
+	{return (static_cast<GpibDeviceServer *>(dev))->is_BCWriteReadMany_allowed(any);}
+};
+
+
+
+class BCStopFastPollCmd : public Tango::Command
+{
+public:
+	BCStopFastPollCmd(const char   *name,
+	               Tango::CmdArgType in,
+				   Tango::CmdArgType out,
+				   const char        *in_desc,
+				   const char        *out_desc,
+				   Tango::DispLevel  level)
+	:Command(name,in,out,in_desc,out_desc, level)	{};
+
+	BCStopFastPollCmd(const char   *name,
+	               Tango::CmdArgType in,
+				   Tango::CmdArgType out)
+	:Command(name,in,out)	{};
+	~BCStopFastPollCmd() {};
+
+	virtual CORBA::Any *execute (Tango::DeviceImpl *dev, const CORBA::Any &any);
+	virtual bool is_allowed (Tango::DeviceImpl *dev, const CORBA::Any &any)
+	{return (static_cast<GpibDeviceServer *>(dev))->is_BCStopFastPoll_allowed(any);}
+};
+
+
+
+class BCStartFastPollCmd : public Tango::Command
+{
+public:
+	BCStartFastPollCmd(const char   *name,
+	               Tango::CmdArgType in,
+				   Tango::CmdArgType out,
+				   const char        *in_desc,
+				   const char        *out_desc,
+				   Tango::DispLevel  level)
+	:Command(name,in,out,in_desc,out_desc, level)	{};
+
+	BCStartFastPollCmd(const char   *name,
+	               Tango::CmdArgType in,
+				   Tango::CmdArgType out)
+	:Command(name,in,out)	{};
+	~BCStartFastPollCmd() {};
+
+	virtual CORBA::Any *execute (Tango::DeviceImpl *dev, const CORBA::Any &any);
+	virtual bool is_allowed (Tango::DeviceImpl *dev, const CORBA::Any &any)
+	{return (static_cast<GpibDeviceServer *>(dev))->is_BCStartFastPoll_allowed(any);}
+};
+
+
+
+class BCParallelPollCmd : public Tango::Command
+{
+public:
+	BCParallelPollCmd(const char   *name,
+	               Tango::CmdArgType in,
+				   Tango::CmdArgType out,
+				   const char        *in_desc,
+				   const char        *out_desc,
+				   Tango::DispLevel  level)
+	:Command(name,in,out,in_desc,out_desc, level)	{};
+
+	BCParallelPollCmd(const char   *name,
+	               Tango::CmdArgType in,
+				   Tango::CmdArgType out)
+	:Command(name,in,out)	{};
+	~BCParallelPollCmd() {};
+
+	virtual CORBA::Any *execute (Tango::DeviceImpl *dev, const CORBA::Any &any);
+	virtual bool is_allowed (Tango::DeviceImpl *dev, const CORBA::Any &any)
+	{return (static_cast<GpibDeviceServer *>(dev))->is_BCParallelPoll_allowed(any);}
+};
+
+
+
+class PPollUnconfigCmd : public Tango::Command
+{
+public:
+	PPollUnconfigCmd(const char   *name,
+	               Tango::CmdArgType in,
+				   Tango::CmdArgType out,
+				   const char        *in_desc,
+				   const char        *out_desc,
+				   Tango::DispLevel  level)
+	:Command(name,in,out,in_desc,out_desc, level)	{};
+
+	PPollUnconfigCmd(const char   *name,
+	               Tango::CmdArgType in,
+				   Tango::CmdArgType out)
+	:Command(name,in,out)	{};
+	~PPollUnconfigCmd() {};
+
+	virtual CORBA::Any *execute (Tango::DeviceImpl *dev, const CORBA::Any &any);
+	virtual bool is_allowed (Tango::DeviceImpl *dev, const CORBA::Any &any)
+	{return (static_cast<GpibDeviceServer *>(dev))->is_PPollUnconfig_allowed(any);}
+};
+
+
+
+class PPollConfigCmd : public Tango::Command
+{
+public:
+	PPollConfigCmd(const char   *name,
+	               Tango::CmdArgType in,
+				   Tango::CmdArgType out,
+				   const char        *in_desc,
+				   const char        *out_desc,
+				   Tango::DispLevel  level)
+	:Command(name,in,out,in_desc,out_desc, level)	{};
+
+	PPollConfigCmd(const char   *name,
+	               Tango::CmdArgType in,
+				   Tango::CmdArgType out)
+	:Command(name,in,out)	{};
+	~PPollConfigCmd() {};
+
+	virtual CORBA::Any *execute (Tango::DeviceImpl *dev, const CORBA::Any &any);
+	virtual bool is_allowed (Tango::DeviceImpl *dev, const CORBA::Any &any)
+	{return (static_cast<GpibDeviceServer *>(dev))->is_PPollConfig_allowed(any);}
+};
+
+
+
+class BCSerialPollAllCmd : public Tango::Command
+{
+public:
+	BCSerialPollAllCmd(const char   *name,
+	               Tango::CmdArgType in,
+				   Tango::CmdArgType out,
+				   const char        *in_desc,
+				   const char        *out_desc,
+				   Tango::DispLevel  level)
+	:Command(name,in,out,in_desc,out_desc, level)	{};
+
+	BCSerialPollAllCmd(const char   *name,
+	               Tango::CmdArgType in,
+				   Tango::CmdArgType out)
+	:Command(name,in,out)	{};
+	~BCSerialPollAllCmd() {};
+
+	virtual CORBA::Any *execute (Tango::DeviceImpl *dev, const CORBA::Any &any);
+	virtual bool is_allowed (Tango::DeviceImpl *dev, const CORBA::Any &any)
+	{return (static_cast<GpibDeviceServer *>(dev))->is_BCSerialPollAll_allowed(any);}
+};
+
+
+
+class BCWriteManyCmd : public Tango::Command
+{
+public:
+	BCWriteManyCmd(const char   *name,
+	               Tango::CmdArgType in,
+				   Tango::CmdArgType out,
+				   const char        *in_desc,
+				   const char        *out_desc,
+				   Tango::DispLevel  level)
+	:Command(name,in,out,in_desc,out_desc, level)	{};
+
+	BCWriteManyCmd(const char   *name,
+	               Tango::CmdArgType in,
+				   Tango::CmdArgType out)
+	:Command(name,in,out)	{};
+	~BCWriteManyCmd() {};
+
+	virtual CORBA::Any *execute (Tango::DeviceImpl *dev, const CORBA::Any &any);
+	virtual bool is_allowed (Tango::DeviceImpl *dev, const CORBA::Any &any)
+	{return (static_cast<GpibDeviceServer *>(dev))->is_BCWriteMany_allowed(any);}
+};
+
+
+
+class BCSnapshotGroupCmd : public Tango::Command
+{
+public:
+	BCSnapshotGroupCmd(const char   *name,
+	               Tango::CmdArgType in,
+				   Tango::CmdArgType out,
+				   const char        *in_desc,
+				   const char        *out_desc,
+				   Tango::DispLevel  level)
+	:Command(name,in,out,in_desc,out_desc, level)	{};
+
+	BCSnapshotGroupCmd(const char   *name,
+	               Tango::CmdArgType in,
+				   Tango::CmdArgType out)
+	:Command(name,in,out)	{};
+	~BCSnapshotGroupCmd() {};
+
+	virtual CORBA::Any *execute (Tango::DeviceImpl *dev, const CORBA::Any &any);
+	virtual bool is_allowed (Tango::DeviceImpl *dev, const CORBA::Any &any)
+	{return (static_cast<GpibDeviceServer *>(dev))->is_BCSnapshotGroup_allowed(any);}
+};
+
+
+
+class BCTriggerListCmd : public Tango::Command
+{
+public:
+	BCTriggerListCmd(const char   *name,
+	               Tango::CmdArgType in,
+				   Tango::CmdArgType out,
+				   const char        *in_desc,
+				   const char        *out_desc,
+				   Tango::DispLevel  level)
+	:Command(name,in,out,in_desc,out_desc, level)	{};
+
+	BCTriggerListCmd(const char   *name,
+	               Tango::CmdArgType in,
+				   Tango::CmdArgType out)
+	:Command(name,in,out)	{};
+	~BCTriggerListCmd() {};
+
+	virtual CORBA::Any *execute (Tango::DeviceImpl *dev, const CORBA::Any &any);
+	virtual bool is_allowed (Tango::DeviceImpl *dev, const CORBA::Any &any)
+	{return (static_cast<GpibDeviceServer *>(dev))->is_BCTriggerList_allowed(any);}
+};
+
+
+
+class DumpTraceCmd : public Tango::Command
+{
+public:
+	DumpTraceCmd(const char   *name,
+	               Tango::CmdArgType in,
+				   Tango::CmdArgType out,
+				   const char        *in_desc,
+				   const char        *out_desc,
+				   Tango::DispLevel  level)
+	:Command(name,in,out,in_desc,out_desc, level)	{};
+
+	DumpTraceCmd(const char   *name,
+	               Tango::CmdArgType in,
+				   Tango::CmdArgType out)
+	:Command(name,in,out)	{};
+	~DumpTraceCmd() {};
+
+	virtual CORBA::Any *execute (Tango::DeviceImpl *dev, const CORBA::Any &any);
+	virtual bool is_allowed (Tango::DeviceImpl *dev, const CORBA::Any &any)
+	{return (static_cast<GpibDeviceServer *>(dev))->is_DumpTrace_allowed(any);}
+};
+
+
+
+class ResetLatencyStatsCmd : public Tango::Command
+{
+public:
+	ResetLatencyStatsCmd(const char   *name,
+	               Tango::CmdArgType in,
+				   Tango::CmdArgType out,
+				   const char        *in_desc,
+				   const char        *out_desc,
+				   Tango::DispLevel  level)
+	:Command(name,in,out,in_desc,out_desc, level)	{};
+
+	ResetLatencyStatsCmd(const char   *name,
+	               Tango::CmdArgType in,
+				   Tango::CmdArgType out)
+	:Command(name,in,out)	{};
+	~ResetLatencyStatsCmd() {};
+
+	virtual CORBA::Any *execute (Tango::DeviceImpl *dev, const CORBA::Any &any);
+	virtual bool is_allowed (Tango::DeviceImpl *dev, const CORBA::Any &any)
+	{return (static_cast<GpibDeviceServer *>(dev))->is_ResetLatencyStats_allowed(any);}
+};
+
+
+
+class GetLatencyStatsCmd : public Tango::Command
+{
+public:
+	GetLatencyStatsCmd(const char   *name,
+	               Tango::CmdArgType in,
+				   Tango::CmdArgType out,
+				   const char        *in_desc,
+				   const char        *out_desc,
+				   Tango::DispLevel  level)
+	:Command(name,in,out,in_desc,out_desc, level)	{};
+
+	GetLatencyStatsCmd(const char   *name,
+	               Tango::CmdArgType in,
+				   Tango::CmdArgType out)
+	:Command(name,in,out)	{};
+	~GetLatencyStatsCmd() {};
+
+	virtual CORBA::Any *execute (Tango::DeviceImpl *dev, const CORBA::Any &any);
+	virtual bool is_allowed (Tango::DeviceImpl *dev, const CORBA::Any &any)
+	{return (static_cast<GpibDeviceServer *>(dev))->is_GetLatencyStats_allowed(any);}
+};
+
+
+
+class ReloadPropertiesCmd : public Tango::Command
+{
+public:
+	ReloadPropertiesCmd(const char   *name,
+	               Tango::CmdArgType in,
+				   Tango::CmdArgType out,
+				   const char        *in_desc,
+				   const char        *out_desc,
+				   Tango::DispLevel  level)
+	:Command(name,in,out,in_desc,out_desc, level)	{};
+
+	ReloadPropertiesCmd(const char   *name,
+	               Tango::CmdArgType in,
+				   Tango::CmdArgType out)
+	:Command(name,in,out)	{};
+	~ReloadPropertiesCmd() {};
+
+	virtual CORBA::Any *execute (Tango::DeviceImpl *dev, const CORBA::Any &any);
+	virtual bool is_allowed (Tango::DeviceImpl *dev, const CORBA::Any &any)
+	{return (static_cast<GpibDeviceServer *>(dev))->is_ReloadProperties_allowed(any);}
+};
+
+
+
 class GetBoardIndexCmd : public Tango::Command
 {
 public:
@@ -864,9 +1537,35 @@ class
 {
 public:
 //	properties member data
+	/**
+	 *	Maximum number of gpib boards on which devices are opened at the
+	 *	same time at server startup (0 = open devices one by one in
+	 *	device_factory).
+	 */
+	Tango::DevShort	initPoolSize;
+	/**
+	 *	File where the device and board counters are written in
+	 *	OpenMetrics text format (empty = not written).
+	 */
+	string	metricsFile;
+	/**
+	 *	Seconds between two writes of MetricsFile.
+	 */
+	Tango::DevLong	metricsPeriod;
 
 //	add your own data members here
 //------------------------------------
+	GpibInitPool	*init_pool;	// Opens devices in background at startup
+	bool		async_init;	// True while device_factory creates devices
+	GpibMetrics	*metrics;	// Writes MetricsFile (NULL if not set)
+	map<string, map<string, vector<string> > >	prefetched_props;
+					// Device properties read by device_factory
+	omni_mutex	bus_mutex[GPIB_NB_COUNTED_BOARDS + 1];
+					// Bus of each board, last one shared by
+					// the boards which are not counted
+	map<int, string>	monitor_boards;	// Spare board of each bus
+					// monitor, and its device
+	omni_mutex	monitor_mutex;	// Protects monitor_boards
 
 public:
 	Tango::DbData	cl_prop;
@@ -880,11 +1579,16 @@ public:
 	Tango::DbDatum	get_class_property(string &);
 	Tango::DbDatum	get_default_device_property(string &);
 	Tango::DbDatum	get_default_class_property(string &);
+	bool	get_prefetched_property(const string &, Tango::DbData &);
+	omni_mutex	&get_bus_mutex(int board);
+	bool	claim_monitor_board(int board, const string &dev, string &owner);
+	void	release_monitor_board(int board, const string &dev);
 	
 protected:
 	GpibDeviceServerClass(string &);
 	static GpibDeviceServerClass *_instance;
 	void command_factory();
+	void attribute_factory(vector<Tango::Attr *> &);
 	void get_class_property();
 	void write_class_property();
 	void set_default_property();
@@ -893,6 +1597,7 @@ protected:
 
 private:
 	void device_factory(const Tango::DevVarStringArray *);
+	void prefetch_device_properties(const Tango::DevVarStringArray *);
 };
 
 
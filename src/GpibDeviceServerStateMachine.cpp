@@ -51,6 +51,97 @@ namespace GpibDeviceServer_ns
 //		Attributes Allowed Methods
 //=================================================
 
+//+----------------------------------------------------------------------------
+//
+// method : 		GpibDeviceServer::is_Latency_allowed
+// 
+// description : 	Read/Write allowed for latency attributes.
+//
+//-----------------------------------------------------------------------------
+bool GpibDeviceServer::is_Latency_allowed(Tango::AttReqType type)
+{
+		//	End of Generated Code
+
+		//	Re-Start of Generated Code
+	return true;
+}
+
+//+----------------------------------------------------------------------------
+//
+// method : 		GpibDeviceServer::is_Counters_allowed
+// 
+// description : 	Read/Write allowed for counter attributes.
+//
+//-----------------------------------------------------------------------------
+bool GpibDeviceServer::is_Counters_allowed(Tango::AttReqType type)
+{
+		//	End of Generated Code
+
+		//	Re-Start of Generated Code
+	return true;
+}
+
+//+----------------------------------------------------------------------------
+//
+// method : 		GpibDeviceServer::is_Breakdown_allowed
+// 
+// description : 	Read/Write allowed for latency breakdown attributes.
+//
+//-----------------------------------------------------------------------------
+bool GpibDeviceServer::is_Breakdown_allowed(Tango::AttReqType type)
+{
+		//	End of Generated Code
+
+		//	Re-Start of Generated Code
+	return true;
+}
+
+//+----------------------------------------------------------------------------
+//
+// method : 		GpibDeviceServer::is_ServiceRequestMask_allowed
+// 
+// description : 	Read/Write allowed for ServiceRequestMask attribute.
+//
+//-----------------------------------------------------------------------------
+bool GpibDeviceServer::is_ServiceRequestMask_allowed(Tango::AttReqType type)
+{
+		//	End of Generated Code
+
+		//	Re-Start of Generated Code
+	return true;
+}
+
+//+----------------------------------------------------------------------------
+//
+// method : 		GpibDeviceServer::is_ParallelPoll_allowed
+// 
+// description : 	Read/Write allowed for ParallelPoll attribute.
+//
+//-----------------------------------------------------------------------------
+bool GpibDeviceServer::is_ParallelPoll_allowed(Tango::AttReqType type)
+{
+		//	End of Generated Code
+
+		//	Re-Start of Generated Code
+	return true;
+}
+
+
+//+----------------------------------------------------------------------------
+//
+// method : 		GpibDeviceServer::is_Monitor_allowed
+// 
+// description : 	Read/Write allowed for bus monitor attributes.
+//
+//-----------------------------------------------------------------------------
+bool GpibDeviceServer::is_Monitor_allowed(Tango::AttReqType type)
+{
+		//	End of Generated Code
+
+		//	Re-Start of Generated Code
+	return true;
+}
+
 
 //=================================================
 //		Commands Allowed Methods
@@ -357,7 +448,8 @@ bool GpibDeviceServer::is_BCcmd_allowed(const CORBA::Any &any)
 //-----------------------------------------------------------------------------
 bool GpibDeviceServer::is_Open_allowed(const CORBA::Any &any)
 {
-	if (get_state() == Tango::MOVING)
+	if (get_state() == Tango::MOVING	||
+		get_state() == Tango::INIT)
 	{
 		//	End of Generated Code
 
@@ -375,7 +467,8 @@ bool GpibDeviceServer::is_Open_allowed(const CORBA::Any &any)
 //-----------------------------------------------------------------------------
 bool GpibDeviceServer::is_OpenByName_allowed(const CORBA::Any &any)
 {
-	if (get_state() == Tango::MOVING)
+	if (get_state() == Tango::MOVING	||
+		get_state() == Tango::INIT)
 	{
 		//	End of Generated Code
 
@@ -601,4 +694,334 @@ bool GpibDeviceServer::is_GetBoardIndex_allowed(const CORBA::Any &any)
 	return true;
 }
 
+//+----------------------------------------------------------------------------
+//
+// method : 		GpibDeviceServer::is_ReloadProperties_allowed
+//
+// description : 	Execution allowed for ReloadProperties command.
+//
+//-----------------------------------------------------------------------------
+bool GpibDeviceServer::is_ReloadProperties_allowed(const CORBA::Any &any)
+{
+	if (get_state() == Tango::MOVING	||
+		get_state() == Tango::INIT)
+	{
+		//	End of Generated Code
+
+		//	Re-Start of Generated Code
+		return false;
+	}
+	return true;
+}
+
+//+----------------------------------------------------------------------------
+//
+// method : 		GpibDeviceServer::is_GetLatencyStats_allowed
+//
+// description : 	Execution allowed for GetLatencyStats command.
+//
+//-----------------------------------------------------------------------------
+bool GpibDeviceServer::is_GetLatencyStats_allowed(const CORBA::Any &any)
+{
+		//	End of Generated Code
+
+		//	Re-Start of Generated Code
+	return true;
+}
+
+//+----------------------------------------------------------------------------
+//
+// method : 		GpibDeviceServer::is_ResetLatencyStats_allowed
+//
+// description : 	Execution allowed for ResetLatencyStats command.
+//
+//-----------------------------------------------------------------------------
+bool GpibDeviceServer::is_ResetLatencyStats_allowed(const CORBA::Any &any)
+{
+		//	End of Generated Code
+
+		//	Re-Start of Generated Code
+	return true;
+}
+
+//+----------------------------------------------------------------------------
+//
+// method : 		GpibDeviceServer::is_DumpTrace_allowed
+//
+// description : 	Execution allowed for DumpTrace command.
+//
+//-----------------------------------------------------------------------------
+bool GpibDeviceServer::is_DumpTrace_allowed(const CORBA::Any &any)
+{
+		//	End of Generated Code
+
+		//	Re-Start of Generated Code
+	return true;
+}
+
+//+----------------------------------------------------------------------------
+//
+// method : 		GpibDeviceServer::is_BCTriggerList_allowed
+//
+// description : 	Execution allowed for BCTriggerList command.
+//
+//-----------------------------------------------------------------------------
+bool GpibDeviceServer::is_BCTriggerList_allowed(const CORBA::Any &any)
+{
+		//	End of Generated Code
+
+		//	Re-Start of Generated Code
+	return true;
+}
+
+//+----------------------------------------------------------------------------
+//
+// method : 		GpibDeviceServer::is_BCSnapshotGroup_allowed
+//
+// description : 	Execution allowed for BCSnapshotGroup command.
+//
+//-----------------------------------------------------------------------------
+bool GpibDeviceServer::is_BCSnapshotGroup_allowed(const CORBA::Any &any)
+{
+		//	End of Generated Code
+
+		//	Re-Start of Generated Code
+	return true;
+}
+
+//+----------------------------------------------------------------------------
+//
+// method : 		GpibDeviceServer::is_BCWriteMany_allowed
+//
+// description : 	Execution allowed for BCWriteMany command.
+//
+//-----------------------------------------------------------------------------
+bool GpibDeviceServer::is_BCWriteMany_allowed(const CORBA::Any &any)
+{
+		//	End of Generated Code
+
+		//	Re-Start of Generated Code
+	return true;
+}
+
+//+----------------------------------------------------------------------------
+//
+// method : 		GpibDeviceServer::is_BCSerialPollAll_allowed
+//
+// description : 	Execution allowed for BCSerialPollAll command.
+//
+//-----------------------------------------------------------------------------
+bool GpibDeviceServer::is_BCSerialPollAll_allowed(const CORBA::Any &any)
+{
+		//	End of Generated Code
+
+		//	Re-Start of Generated Code
+	return true;
+}
+
+//+----------------------------------------------------------------------------
+//
+// method : 		GpibDeviceServer::is_PPollConfig_allowed
+//
+// description : 	Execution allowed for PPollConfig command.
+//
+//-----------------------------------------------------------------------------
+bool GpibDeviceServer::is_PPollConfig_allowed(const CORBA::Any &any)
+{
+	if (get_state() == Tango::MOVING	||
+		get_state() == Tango::FAULT)
+	{
+		//	End of Generated Code
+
+		//	Re-Start of Generated Code
+		return false;
+	}
+	return true;
+}
+
+//+----------------------------------------------------------------------------
+//
+// method : 		GpibDeviceServer::is_PPollUnconfig_allowed
+//
+// description : 	Execution allowed for PPollUnconfig command.
+//
+//-----------------------------------------------------------------------------
+bool GpibDeviceServer::is_PPollUnconfig_allowed(const CORBA::Any &any)
+{
+	if (get_state() == Tango::MOVING	||
+		get_state() == Tango::FAULT)
+	{
+		//	End of Generated Code
+
+		//	Re-Start of Generated Code
+		return false;
+	}
+	return true;
+}
+
+//+----------------------------------------------------------------------------
+//
+// method : 		GpibDeviceServer::is_BCParallelPoll_allowed
+//
+// description : 	Execution allowed for BCParallelPoll command.
+//
+//-----------------------------------------------------------------------------
+bool GpibDeviceServer::is_BCParallelPoll_allowed(const CORBA::Any &any)
+{
+		//	End of Generated Code
+
+		//	Re-Start of Generated Code
+	return true;
+}
+
+//+----------------------------------------------------------------------------
+//
+// method : 		GpibDeviceServer::is_BCStartFastPoll_allowed
+//
+// description : 	Execution allowed for BCStartFastPoll command.
+//
+//-----------------------------------------------------------------------------
+bool GpibDeviceServer::is_BCStartFastPoll_allowed(const CORBA::Any &any)
+{
+		//	End of Generated Code
+
+		//	Re-Start of Generated Code
+	return true;
+}
+
+//+----------------------------------------------------------------------------
+//
+// method : 		GpibDeviceServer::is_BCStopFastPoll_allowed
+//
+// description : 	Execution allowed for BCStopFastPoll command.
+//
+//-----------------------------------------------------------------------------
+bool GpibDeviceServer::is_BCStopFastPoll_allowed(const CORBA::Any &any)
+{
+		//	End of Generated Code
+
+		//	Re-Start of Generated Code
+	return true;
+}
+
+//+----------------------------------------------------------------------------
+//
+// method : 		GpibDeviceServer::is_BCWriteReadMany_allowed
+//
+// description : 	Execution allowed for BCWriteReadMany command.
+//
+//-----------------------------------------------------------------------------
+bool GpibDeviceServer::is_BCWriteReadMany_allowed(const CORBA::Any &any)
+{
+		//	End of Generated Code
+
+		//	Re-Start of Generated Code
+	return true;
+}
+
+//+----------------------------------------------------------------------------
+//
+// method : 		GpibDeviceServer::is_BCSetHS488_allowed
+//
+// description : 	Execution allowed for BCSetHS488 command.
+//
+//-----------------------------------------------------------------------------
+bool GpibDeviceServer::is_BCSetHS488_allowed(const CORBA::Any &any)
+{
+		//	End of Generated Code
+
+		//	Re-Start of Generated Code
+	return true;
+}
+
+//+----------------------------------------------------------------------------
+//
+// method : 		GpibDeviceServer::is_BCTestHS488_allowed
+//
+// description : 	Execution allowed for BCTestHS488 command.
+//
+//-----------------------------------------------------------------------------
+bool GpibDeviceServer::is_BCTestHS488_allowed(const CORBA::Any &any)
+{
+		//	End of Generated Code
+
+		//	Re-Start of Generated Code
+	return true;
+}
+
+//+----------------------------------------------------------------------------
+//
+// method : 		GpibDeviceServer::is_BCTuneBus_allowed
+//
+// description : 	Execution allowed for BCTuneBus command.
+//
+//-----------------------------------------------------------------------------
+bool GpibDeviceServer::is_BCTuneBus_allowed(const CORBA::Any &any)
+{
+		//	End of Generated Code
+
+		//	Re-Start of Generated Code
+	return true;
+}
+
+//+----------------------------------------------------------------------------
+//
+// method : 		GpibDeviceServer::is_BCGetConnectedDeviceListSAD_allowed
+//
+// description : 	Execution allowed for BCGetConnectedDeviceListSAD command.
+//
+//-----------------------------------------------------------------------------
+bool GpibDeviceServer::is_BCGetConnectedDeviceListSAD_allowed(const CORBA::Any &any)
+{
+		//	End of Generated Code
+
+		//	Re-Start of Generated Code
+	return true;
+}
+
+//+----------------------------------------------------------------------------
+//
+// method : 		GpibDeviceServer::is_BCStartMonitor_allowed
+//
+// description : 	Execution allowed for BCStartMonitor command.
+//
+//-----------------------------------------------------------------------------
+bool GpibDeviceServer::is_BCStartMonitor_allowed(const CORBA::Any &any)
+{
+		//	End of Generated Code
+
+		//	Re-Start of Generated Code
+	return true;
+}
+
+//+----------------------------------------------------------------------------
+//
+// method : 		GpibDeviceServer::is_BCStopMonitor_allowed
+//
+// description : 	Execution allowed for BCStopMonitor command.
+//
+//-----------------------------------------------------------------------------
+bool GpibDeviceServer::is_BCStopMonitor_allowed(const CORBA::Any &any)
+{
+		//	End of Generated Code
+
+		//	Re-Start of Generated Code
+	return true;
+}
+
+//+----------------------------------------------------------------------------
+//
+// method : 		GpibDeviceServer::is_BCDumpMonitor_allowed
+//
+// description : 	Execution allowed for BCDumpMonitor command.
+//
+//-----------------------------------------------------------------------------
+bool GpibDeviceServer::is_BCDumpMonitor_allowed(const CORBA::Any &any)
+{
+		//	End of Generated Code
+
+		//	Re-Start of Generated Code
+	return true;
+}
+
 }	// namespace GpibDeviceServer_ns
@@ -0,0 +1,121 @@
+//+=============================================================================
+//
+// file :         GpibFastPoll.cpp
+//
+// description :  C++ source for the GpibFastPoll class. A board is parallel
+//                polled in background (BCStartFastPoll command) and the
+//                last response byte is read by the ParallelPoll attribute.
+//
+// project :      TANGO Device Server
+//
+// copyleft :     European Synchrotron Radiation Facility
+//                BP 220, Grenoble 38043
+//                FRANCE
+//
+//-=============================================================================
+
+#include <tango.h>
+#include <GpibFastPoll.h>
+
+namespace GpibDeviceServer_ns
+{
+
+/**
+ * Period of the polls while the board is in error, us.
+ */
+#define FAST_POLL_ERROR_PERIOD	100000
+
+//+----------------------------------------------------------------------------
+//
+// method : 		GpibFastPoll::GpibFastPoll()
+//
+// description : 	Constructor, starts the thread.
+//
+// in : - b : Board to poll, deleted with the thread.
+//      - p : us between two polls.
+//      - l : Bus lock of the board.
+//
+//-----------------------------------------------------------------------------
+GpibFastPoll::GpibFastPoll(gpibBoard *b, long p, omni_mutex &l)
+	:omni_thread(), board(b), period(p), bus(l), stopping(false),
+	 result(-1), time(0), polls(0), error("Not polled yet")
+{
+	if (period < GPIB_FAST_POLL_MIN_PERIOD)
+		period = GPIB_FAST_POLL_MIN_PERIOD;
+	if (period > GPIB_FAST_POLL_MAX_PERIOD)
+		period = GPIB_FAST_POLL_MAX_PERIOD;
+	start_undetached();
+}
+
+//+----------------------------------------------------------------------------
+//
+// method : 		GpibFastPoll::get()
+//
+// description : 	Last poll result.
+//
+//-----------------------------------------------------------------------------
+unsigned long long GpibFastPoll::get(int &r, long long &t, string &e)
+{
+	omni_mutex_lock lock(mutex);
+	r = result;
+	t = time;
+	e = error;
+	return polls;
+}
+
+//+----------------------------------------------------------------------------
+//
+// method : 		GpibFastPoll::stop()
+//
+// description : 	Stop the thread, after its current poll. The object is
+//			deleted by join().
+//
+//-----------------------------------------------------------------------------
+void GpibFastPoll::stop()
+{
+	stopping = true;
+	join(NULL);
+}
+
+//+----------------------------------------------------------------------------
+//
+// method : 		GpibFastPoll::run_undetached()
+//
+// description : 	Poll the board until stopped. A board in error is
+//			polled again every FAST_POLL_ERROR_PERIOD us at most.
+//
+//-----------------------------------------------------------------------------
+void *GpibFastPoll::run_undetached(void *)
+{
+	while (stopping == false)
+	{
+		long   wait = period;
+		int    r = -1;
+		string e;
+		try
+		{
+			omni_mutex_lock lock(bus);
+			r = board->parallelPoll();
+		}
+		catch (gpibDeviceException ex)
+		{
+			e = ex.getiberrMessage();
+			if (wait < FAST_POLL_ERROR_PERIOD)
+				wait = FAST_POLL_ERROR_PERIOD;
+		}
+		{
+			omni_mutex_lock lock(mutex);
+			if ( (r < 0) && (result >= 0) )
+				GPIB_LOG_ERROR("fast parallel poll failed: %s", e.c_str(), 0, 0);
+			result = r;
+			error = e;
+			time = gpibClock();
+			polls++;
+		}
+		omni_thread::sleep(wait / 1000000, (wait % 1000000) * 1000);
+	}
+	delete board;
+	return NULL;
+}
+
+}	// namespace
@@ -0,0 +1,67 @@
+//=============================================================================
+//
+// file :        GpibFastPoll.h
+//
+// description : Include for the GpibFastPoll class, which parallel polls a
+//               gpib board in background.
+//
+// project :     gpidDeviceServer
+//
+// copyleft :    European Synchrotron Radiation Facility
+//               BP 220, Grenoble 38043
+//               FRANCE
+//
+//=============================================================================
+#ifndef _GPIBFASTPOLL_H
+#define _GPIBFASTPOLL_H
+
+#include <tango.h>
+#include "gpibDevice.h"
+
+namespace GpibDeviceServer_ns
+{
+
+/**
+ * Period of the fast poll, us. The minimum leaves the bus to the device
+ * commands between two polls.
+ */
+#define GPIB_FAST_POLL_MIN_PERIOD	1000
+#define GPIB_FAST_POLL_MAX_PERIOD	1000000
+
+/**
+ * This thread parallel polls a board every period us
+ * and keeps the last response byte, so that the ready/busy state of up to
+ * 8 devices is read without any bus access. It uses its own gpibBoard
+ * object: the ibsta/iberr of the device commands are not changed. Each
+ * poll takes the bus lock, so that it does not fall in the middle of a
+ * board group command.
+ */
+class GpibFastPoll : public omni_thread
+{
+public:
+	// Owns board, polls under the bus lock of the board.
+	GpibFastPoll(gpibBoard *board, long period, omni_mutex &bus);
+
+	// Last response byte, -1 on error (error gets the reason), and its
+	// gpibClock() time. Return the number of polls done.
+	unsigned long long get(int &result, long long &time, string &error);
+	void stop();	// Stop the polls and delete the thread.
+
+protected:
+	void *run_undetached(void *);
+
+private:
+	gpibBoard          *board;
+	long                period;
+	omni_mutex         &bus;
+	volatile bool       stopping;
+	omni_mutex          mutex;
+	int                 result;
+	long long           time;
+	unsigned long long  polls;
+	string              error;
+};
+
+}	// namespace
+
+#endif	// _GPIBFASTPOLL_H
@@ -0,0 +1,210 @@
+//+=============================================================================
+//
+// file :         GpibInitPool.cpp
+//
+// description :  C++ source for the GpibInitPool class. Devices created at
+//                server startup are queued here, one queue per gpib board,
+//                and opened in background threads. The server startup
+//                does not wait for the isAlive() timeouts of devices which
+//                are off.
+//
+// project :      TANGO Device Server
+//
+// copyleft :     European Synchrotron Radiation Facility
+//                BP 220, Grenoble 38043
+//                FRANCE
+//
+//-=============================================================================
+
+#include <tango.h>
+#include <GpibDeviceServer.h>
+#include <GpibInitPool.h>
+
+namespace GpibDeviceServer_ns
+{
+
+//+----------------------------------------------------------------------------
+//
+// method : 		GpibInitLane::GpibInitLane()
+//
+// description : 	Lane constructor. The thread is started by the pool.
+//
+//-----------------------------------------------------------------------------
+GpibInitLane::GpibInitLane(GpibInitPool *p, const string &b)
+	:omni_thread(), pool(p), board(b)
+{
+}
+
+//+----------------------------------------------------------------------------
+//
+// method : 		GpibInitLane::run()
+//
+// description : 	Open the devices of the lane board until its queue is
+//			empty. The thread is detached: omni_thread deletes the
+//			lane when run() returns.
+//
+//-----------------------------------------------------------------------------
+void GpibInitLane::run(void *)
+{
+	GpibDeviceServer *dev;
+	
+	while ( (dev = pool->next(board)) != NULL )
+	{
+		dev->open_in_background();
+		pool->done(dev);
+	}
+}
+
+
+//+----------------------------------------------------------------------------
+//
+// method : 		GpibInitPool::GpibInitPool()
+//
+// description : 	Pool constructor.
+//
+// in : - max_lanes : Maximum number of boards opened at the same time.
+//
+//-----------------------------------------------------------------------------
+GpibInitPool::GpibInitPool(int lanes)
+	:max_lanes(lanes), cond(&mutex)
+{
+	if (max_lanes < 1)
+		max_lanes = 1;
+}
+
+//+----------------------------------------------------------------------------
+//
+// method : 		GpibInitPool::~GpibInitPool()
+//
+// description : 	Drop queued devices and wait for running lanes.
+//
+//-----------------------------------------------------------------------------
+GpibInitPool::~GpibInitPool()
+{
+	omni_mutex_lock lock(mutex);
+	
+	queues.clear();
+	while (running.empty() == false)
+		cond.wait();
+}
+
+//+----------------------------------------------------------------------------
+//
+// method : 		GpibInitPool::submit()
+//
+// description : 	Queue a device on the lane of its board.
+//
+//-----------------------------------------------------------------------------
+void GpibInitPool::submit(GpibDeviceServer *dev)
+{
+	string board = dev->gpibBoardName;
+	
+	// Devices opened without board name are on board 0.
+	if (board.length() == 0)
+		board = "gpib0";
+		
+	omni_mutex_lock lock(mutex);
+	queues[board].push_back(dev);
+	start_lanes();
+}
+
+//+----------------------------------------------------------------------------
+//
+// method : 		GpibInitPool::cancel()
+//
+// description : 	Remove a device from its queue. If the device is being
+//			opened, wait until its lane is done with it.
+//
+//-----------------------------------------------------------------------------
+void GpibInitPool::cancel(GpibDeviceServer *dev)
+{
+	omni_mutex_lock lock(mutex);
+	map<string, deque<GpibDeviceServer *> >::iterator q;
+	
+	for (q = queues.begin(); q != queues.end(); ++q)
+	{
+		deque<GpibDeviceServer *>::iterator d;
+		for (d = q->second.begin(); d != q->second.end(); )
+		{
+			if (*d == dev)
+				d = q->second.erase(d);
+			else
+				++d;
+		}
+	}
+	
+	while (busy.count(dev) != 0)
+		cond.wait();
+}
+
+//+----------------------------------------------------------------------------
+//
+// method : 		GpibInitPool::next()
+//
+// description : 	Called by a lane to get its next device. When the board
+//			queue is empty the lane retires and its slot is given
+//			to a waiting board.
+//
+// returns : The device to open, NULL when the lane must stop.
+//
+//-----------------------------------------------------------------------------
+GpibDeviceServer *GpibInitPool::next(const string &board)
+{
+	omni_mutex_lock lock(mutex);
+	map<string, deque<GpibDeviceServer *> >::iterator q = queues.find(board);
+	
+	if ( (q != queues.end()) && (q->second.empty() == false) )
+	{
+		GpibDeviceServer *dev = q->second.front();
+		q->second.pop_front();
+		busy.insert(dev);
+		return dev;
+	}
+	
+	if (q != queues.end())
+		queues.erase(q);
+	running.erase(board);
+	start_lanes();
+	cond.broadcast();
+	return NULL;
+}
+
+//+----------------------------------------------------------------------------
+//
+// method : 		GpibInitPool::done()
+//
+// description : 	Called by a lane when a device open is finished.
+//
+//-----------------------------------------------------------------------------
+void GpibInitPool::done(GpibDeviceServer *dev)
+{
+	omni_mutex_lock lock(mutex);
+	busy.erase(dev);
+	cond.broadcast();
+}
+
+//+----------------------------------------------------------------------------
+//
+// method : 		GpibInitPool::start_lanes()
+//
+// description : 	Start a lane for each waiting board, up to max_lanes
+//			running lanes. Must be called with mutex locked.
+//
+//-----------------------------------------------------------------------------
+void GpibInitPool::start_lanes()
+{
+	map<string, deque<GpibDeviceServer *> >::iterator q;
+	
+	for (q = queues.begin(); q != queues.end(); ++q)
+	{
+		if ((int) running.size() >= max_lanes)
+			break;
+		if ( (running.count(q->first) != 0) || (q->second.empty() == true) )
+			continue;
+		running.insert(q->first);
+		GpibInitLane *lane = new GpibInitLane(this, q->first);
+		lane->start();
+	}
+}
+
+}	// namespace
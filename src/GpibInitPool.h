@@ -0,0 +1,79 @@
+//=============================================================================
+//
+// file :        GpibInitPool.h
+//
+// description : Include for the GpibInitPool class, which opens the gpib
+//               devices of the server in background threads at startup.
+//
+// project :     gpidDeviceServer
+//
+// copyleft :    European Synchrotron Radiation Facility
+//               BP 220, Grenoble 38043
+//               FRANCE
+//
+//=============================================================================
+#ifndef _GPIBINITPOOL_H
+#define _GPIBINITPOOL_H
+
+#include <tango.h>
+#include <deque>
+#include <map>
+#include <set>
+
+namespace GpibDeviceServer_ns
+{
+
+class GpibDeviceServer;
+class GpibInitPool;
+
+/**
+ * A lane opens, one after the other, the devices queued for one gpib board.
+ * Devices sharing a board are never opened concurrently.
+ */
+class GpibInitLane : public omni_thread
+{
+public:
+	GpibInitLane(GpibInitPool *pool, const string &board);
+	
+protected:
+	void run(void *);
+	
+private:
+	GpibInitPool *pool;
+	string        board;
+};
+
+
+/**
+ * This class runs the device open sequence (GpibDeviceServer::open_device)
+ * outside of the server startup. It keeps one queue per gpib board and runs
+ * at most max_lanes boards at the same time. A device which is off can then
+ * only delay the devices on its own board.
+ */
+class GpibInitPool
+{
+public:
+	GpibInitPool(int max_lanes);
+	~GpibInitPool();
+	
+	void submit(GpibDeviceServer *dev);	// Queue device on its board lane.
+	void cancel(GpibDeviceServer *dev);	// Unqueue device or wait its open.
+	
+private:
+	friend class GpibInitLane;
+	
+	GpibDeviceServer *next(const string &board);
+	void done(GpibDeviceServer *dev);
+	void start_lanes();
+	
+	int                                         max_lanes;
+	omni_mutex                                  mutex;
+	omni_condition                              cond;
+	map<string, deque<GpibDeviceServer *> >    queues;
+	set<string>                                 running;
+	set<GpibDeviceServer *>                     busy;
+};
+
+}	// namespace
+
+#endif	// _GPIBINITPOOL_H
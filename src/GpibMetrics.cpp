@@ -0,0 +1,207 @@
+//+=============================================================================
+//
+// file :         GpibMetrics.cpp
+//
+// description :  C++ source for the GpibMetrics class. The transfer and
+//                error counters of the devices and boards of the server are
+//                written periodically in a local file, in OpenMetrics text
+//                format (MetricsFile and MetricsPeriod class properties).
+//
+// project :      TANGO Device Server
+//
+// copyleft :     European Synchrotron Radiation Facility
+//                BP 220, Grenoble 38043
+//                FRANCE
+//
+//-=============================================================================
+
+#include <tango.h>
+#include <fstream>
+#include <set>
+#include <stdio.h>
+#include <GpibMetrics.h>
+
+namespace GpibDeviceServer_ns
+{
+
+/**
+ * Help text of the counters, indexed by GpibCounter.
+ */
+static const char *counter_help[GPIB_NB_COUNTER] = {
+                                                       "GPIB driver calls.",
+                                                       "Bytes written on the GPIB bus.",
+                                                       "Bytes read from the GPIB bus.",
+                                                       "GPIB driver calls ended by a timeout.",
+                                                       "GPIB driver calls ended with an error, by iberr code.",
+                                                       "Device presence checks (ibln)."
+                                                   };
+
+//+----------------------------------------------------------------------------
+//
+// method : 		GpibMetrics::GpibMetrics()
+//
+// description : 	Constructor, starts the thread.
+//
+// in : - file : Path of the OpenMetrics file.
+//      - period : Seconds between two writes of the file.
+//
+//-----------------------------------------------------------------------------
+GpibMetrics::GpibMetrics(const string &f, long p)
+	:omni_thread(), file(f), period(p), stopping(false), cond(&mutex)
+{
+	if (period < 1)
+		period = 1;
+	start_undetached();
+}
+
+//+----------------------------------------------------------------------------
+//
+// method : 		GpibMetrics::add()
+//
+// description : 	Register the counters of a device. A device registered
+//			again (Init command) replaces the previous entry.
+//
+//-----------------------------------------------------------------------------
+void GpibMetrics::add(const string &device, gpibCounters *c, int board)
+{
+	omni_mutex_lock lock(mutex);
+	Entry e;
+	e.counters = c;
+	e.board = board;
+	devices[device] = e;
+}
+
+//+----------------------------------------------------------------------------
+//
+// method : 		GpibMetrics::remove()
+//
+// description : 	Unregister a device, before its counters are deleted.
+//
+//-----------------------------------------------------------------------------
+void GpibMetrics::remove(const string &device)
+{
+	omni_mutex_lock lock(mutex);
+	devices.erase(device);
+}
+
+//+----------------------------------------------------------------------------
+//
+// method : 		GpibMetrics::stop()
+//
+// description : 	Stop the thread. The object is deleted by join().
+//
+//-----------------------------------------------------------------------------
+void GpibMetrics::stop()
+{
+	{
+		omni_mutex_lock lock(mutex);
+		stopping = true;
+		cond.signal();
+	}
+	join(NULL);
+}
+
+//+----------------------------------------------------------------------------
+//
+// method : 		GpibMetrics::run_undetached()
+//
+// description : 	Write the file every period seconds, and when stopped.
+//
+//-----------------------------------------------------------------------------
+void *GpibMetrics::run_undetached(void *)
+{
+	omni_mutex_lock lock(mutex);
+
+	while (stopping == false)
+	{
+		unsigned long sec, nsec;
+		omni_thread::get_time(&sec, &nsec, period, 0);
+		cond.timedwait(sec, nsec);
+		dump();
+	}
+	return NULL;
+}
+
+//+----------------------------------------------------------------------------
+//
+// method : 		GpibMetrics::dump()
+//
+// description : 	Write the counters of the registered devices and of
+//			their boards. Must be called with mutex locked.
+//
+//-----------------------------------------------------------------------------
+void GpibMetrics::dump()
+{
+	string   tmp = file + ".tmp";
+	ofstream out(tmp.c_str());
+	string   server = Tango::Util::instance()->get_ds_name();
+	set<int> boards;
+	map<string, Entry>::iterator d;
+
+	if (!out)
+	{
+		cerr << "GpibMetrics: cannot write " << tmp << endl;
+		return;
+	}
+
+	for (d = devices.begin(); d != devices.end(); ++d)
+		boards.insert(d->second.board);
+
+	for (int c = 0; c < GPIB_NB_COUNTER; c++)
+	{
+		string name = string("gpib_device_") + gpibCounterName(c);
+		out << "# TYPE " << name << " counter" << endl;
+		out << "# HELP " << name << " " << counter_help[c] << endl;
+		for (d = devices.begin(); d != devices.end(); ++d)
+		{
+			string labels = "server=\"" + server + "\",device=\"" + d->first + "\"";
+			if (c != GPIB_CNT_ERRORS)
+			{
+				out << name << "_total{" << labels << "} " << d->second.counters->get(c) << endl;
+				continue;
+			}
+			for (int e = 0; e < GPIB_NB_IBERR; e++)
+			{
+				if (d->second.counters->getError(e) != 0)
+					out << name << "_total{" << labels << ",code=\"" << gpibErrorName(e) << "\"} "
+					    << d->second.counters->getError(e) << endl;
+			}
+		}
+	}
+
+	for (int c = 0; c < GPIB_NB_COUNTER; c++)
+	{
+		string name = string("gpib_board_") + gpibCounterName(c);
+		out << "# TYPE " << name << " counter" << endl;
+		out << "# HELP " << name << " " << counter_help[c] << endl;
+		for (set<int>::iterator b = boards.begin(); b != boards.end(); ++b)
+		{
+			gpibCounters *bc = gpibBoardCounters(*b);
+			if (bc == NULL)
+				continue;
+			ostringstream labels;
+			labels << "server=\"" << server << "\",board=\"gpib" << *b << "\"";
+			if (c != GPIB_CNT_ERRORS)
+			{
+				out << name << "_total{" << labels.str() << "} " << bc->get(c) << endl;
+				continue;
+			}
+			for (int e = 0; e < GPIB_NB_IBERR; e++)
+			{
+				if (bc->getError(e) != 0)
+					out << name << "_total{" << labels.str() << ",code=\"" << gpibErrorName(e) << "\"} "
+					    << bc->getError(e) << endl;
+			}
+		}
+	}
+	out << "# EOF" << endl;
+	out.close();
+
+#ifdef WIN32
+	::remove(file.c_str());	// rename() does not replace a file
+#endif
+	if (rename(tmp.c_str(), file.c_str()) != 0)
+		cerr << "GpibMetrics: cannot rename " << tmp << " to " << file << endl;
+}
+
+}	// namespace
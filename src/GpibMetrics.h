@@ -0,0 +1,63 @@
+//=============================================================================
+//
+// file :        GpibMetrics.h
+//
+// description : Include for the GpibMetrics class, which writes the device
+//               and board counters of the server in a file, in OpenMetrics
+//               text format.
+//
+// project :     gpidDeviceServer
+//
+// copyleft :    European Synchrotron Radiation Facility
+//               BP 220, Grenoble 38043
+//               FRANCE
+//
+//=============================================================================
+#ifndef _GPIBMETRICS_H
+#define _GPIBMETRICS_H
+
+#include <tango.h>
+#include <map>
+#include "gpibStats.h"
+
+namespace GpibDeviceServer_ns
+{
+
+/**
+ * This thread writes the counters of the registered devices, and of their
+ * boards, every period seconds. The file is written next to its final name
+ * and renamed, so a reader (e.g. the textfile collector of node_exporter)
+ * never sees a partial file.
+ */
+class GpibMetrics : public omni_thread
+{
+public:
+	GpibMetrics(const string &file, long period);
+
+	void add(const string &device, gpibCounters *c, int board);	// Register a device.
+	void remove(const string &device);	// Unregister a device.
+	void stop();	// Write the file a last time and delete the thread.
+
+protected:
+	void *run_undetached(void *);
+
+private:
+	struct Entry
+	{
+		gpibCounters *counters;
+		int           board;
+	};
+
+	void dump();
+
+	string                  file;
+	long                    period;
+	bool                    stopping;
+	omni_mutex              mutex;
+	omni_condition          cond;
+	map<string, Entry>      devices;
+};
+
+}	// namespace
+
+#endif	// _GPIBMETRICS_H
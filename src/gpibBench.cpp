@@ -0,0 +1,312 @@
+/*
+ * Micro-benchmark of the gpibDevice I/O layer.
+ *
+ * Drives gpibDevice::write, read, writeRead, read(size), sendData and
+ * receiveData against the simulated driver (gpibSim.cpp) with all bus
+ * latencies set to zero, so that only the cost of the wrapper and of the
+ * driver calls is measured. The raw driver calls (ibwrt, ibrd, Send,
+ * Receive) are measured the same way: the wrapper overhead of an operation
+ * is the difference with the matching driver row.
+ *
+ * Build: make linux=1 SIM=1 bench
+ * Usage: gpibBench [-t <ms per measure>] [-s <max size>] [<op> ...]
+ *
+ * For each operation and payload size (8 B to 1 MB) it prints the time
+ * per operation, the number of heap allocations (operator new) per
+ * operation and the payload throughput. The stand-in instrument copies
+ * the written bytes in, as a listener would. read() and writeRead() read
+ * into the RD_BUFFER_SIZE device buffer and are only run up to that size
+ * (a line says so in the output).
+ */
+
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <new>
+#include <string.h>
+#include <stdlib.h>
+#include <time.h>
+#include "gpibDevice.h"
+#include "gpibSim.h"
+
+using namespace std;
+
+#define BENCH_BOARD     0
+#define BENCH_PAD       1
+
+/*
+ * Payload sizes, in bytes.
+ */
+static const unsigned long bench_sizes[] = {8, 64, 512, 4096, 65536, 1048576};
+
+/*
+ * Heap allocation counter, for the whole process.
+ */
+static unsigned long bench_allocs = 0;
+
+void *operator new(size_t n)
+{
+	bench_allocs++;
+	void *p = malloc(n ? n : 1);
+	if (p == NULL)
+		throw bad_alloc();
+	return p;
+}
+
+void *operator new[](size_t n)
+{
+	bench_allocs++;
+	void *p = malloc(n ? n : 1);
+	if (p == NULL)
+		throw bad_alloc();
+	return p;
+}
+
+void operator delete(void *p) throw()
+{
+	free(p);
+}
+
+void operator delete[](void *p) throw()
+{
+	free(p);
+}
+
+void operator delete(void *p, size_t) throw()
+{
+	free(p);
+}
+
+void operator delete[](void *p, size_t) throw()
+{
+	free(p);
+}
+
+static double bench_now_ns(void)
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+/*
+ * One benchmarked operation. run() does one call of the payload size.
+ */
+class BenchOp
+{
+public:
+	BenchOp(const char *n, unsigned long max) : name(n), max_size(max) {}
+	virtual ~BenchOp() {}
+	virtual void run(gpibDevice *dev, int handle, const string &payload) = 0;
+
+	const char    *name;
+	unsigned long  max_size;
+};
+
+class DrvWrite : public BenchOp
+{
+public:
+	DrvWrite() : BenchOp("ibwrt", 0) {}
+	void run(gpibDevice *, int handle, const string &p)
+	{ ibwrt(handle, (char *) p.data(), p.length()); }
+};
+
+class DrvRead : public BenchOp
+{
+public:
+	DrvRead() : BenchOp("ibrd", 0) {}
+	void run(gpibDevice *, int handle, const string &p)
+	{ ibrd(handle, buffer, p.length()); }
+	static char *buffer;
+};
+char *DrvRead::buffer = NULL;
+
+class DrvSend : public BenchOp
+{
+public:
+	DrvSend() : BenchOp("Send", 0) {}
+	void run(gpibDevice *, int, const string &p)
+	{ Send(BENCH_BOARD, MakeAddr(BENCH_PAD, 0), (char *) p.data(), p.length(), NLend); }
+};
+
+class DrvReceive : public BenchOp
+{
+public:
+	DrvReceive() : BenchOp("Receive", 0) {}
+	void run(gpibDevice *, int, const string &p)
+	{ Receive(BENCH_BOARD, MakeAddr(BENCH_PAD, 0), DrvRead::buffer, p.length(), STOPend); }
+};
+
+class DevWrite : public BenchOp
+{
+public:
+	DevWrite() : BenchOp("write", 0) {}
+	void run(gpibDevice *dev, int, const string &p)
+	{ dev->write(p); }
+};
+
+class DevRead : public BenchOp
+{
+public:
+	DevRead() : BenchOp("read", RD_BUFFER_SIZE) {}
+	void run(gpibDevice *dev, int, const string &)
+	{ dev->read(); }
+};
+
+class DevWriteRead : public BenchOp
+{
+public:
+	DevWriteRead() : BenchOp("writeRead", RD_BUFFER_SIZE) {}
+	void run(gpibDevice *dev, int, const string &p)
+	{ dev->writeRead(p); }
+};
+
+class DevReadSize : public BenchOp
+{
+public:
+	DevReadSize() : BenchOp("read(size)", 0) {}
+	void run(gpibDevice *dev, int, const string &p)
+	{ dev->read(p.length()); }
+};
+
+class DevSendData : public BenchOp
+{
+public:
+	DevSendData() : BenchOp("sendData", 0) {}
+	void run(gpibDevice *dev, int, const string &p)
+	{ dev->sendData(p.data(), p.length()); }
+};
+
+class DevReceiveData : public BenchOp
+{
+public:
+	DevReceiveData() : BenchOp("receiveData", 0) {}
+	void run(gpibDevice *dev, int, const string &p)
+	{ delete [] dev->receiveData(p.length()); }
+};
+
+static void usage(const char *prog)
+{
+	cerr << "usage: " << prog << " [-t <ms per measure>] [-s <max size>] [<op> ...]" << endl;
+	cerr << "read and writeRead stop at " << RD_BUFFER_SIZE << " B (RD_BUFFER_SIZE)." << endl;
+	exit(1);
+}
+
+int main(int argc, char *argv[])
+{
+	double         min_ns = 200e6;
+	unsigned long  max_payload = 1024 * 1024;
+	vector<string> selected;
+
+	for (int i = 1; i < argc; i++)
+	{
+		if ( (strcmp(argv[i], "-t") == 0) && (i + 1 < argc) )
+			min_ns = atof(argv[++i]) * 1e6;
+		else if ( (strcmp(argv[i], "-s") == 0) && (i + 1 < argc) )
+			max_payload = strtoul(argv[++i], NULL, 0);
+		else if (argv[i][0] == '-')
+			usage(argv[0]);
+		else
+			selected.push_back(argv[i]);
+	}
+
+	// Stand-in bus: one instrument answering every read with the
+	// requested number of bytes, no bus latency.
+	gpibSimReset();
+	gpibSimSetLatency(0, 0, 0.0);
+	gpibSimAddInstrument(BENCH_BOARD, BENCH_PAD, 0, "bench", NULL, GPIBSIM_FILL);
+
+	vector<BenchOp *> ops;
+	ops.push_back(new DrvWrite());
+	ops.push_back(new DrvRead());
+	ops.push_back(new DrvSend());
+	ops.push_back(new DrvReceive());
+	ops.push_back(new DevWrite());
+	ops.push_back(new DevRead());
+	ops.push_back(new DevWriteRead());
+	ops.push_back(new DevReadSize());
+	ops.push_back(new DevSendData());
+	ops.push_back(new DevReceiveData());
+
+	DrvRead::buffer = new char[max_payload + 1];
+	gpibDevice *dev;
+	try
+	{
+		dev = new gpibDevice(BENCH_PAD, "gpib0");
+	}
+	catch (gpibDeviceException &e)
+	{
+		cerr << "Cannot open bench device: " << e.getMessage() << " (" << e.getiberrMessage() << ")" << endl;
+		return 1;
+	}
+	int handle = dev->getDeviceID();
+
+	cout << left << setw(14) << "op" << right << setw(10) << "size"
+	     << setw(14) << "ns/op" << setw(12) << "allocs/op" << setw(14) << "MB/s" << endl;
+
+	for (unsigned int k = 0; k < ops.size(); k++)
+	{
+		BenchOp *op = ops[k];
+		bool     run = selected.empty();
+		for (unsigned int i = 0; i < selected.size(); i++)
+			run = run || (selected[i] == op->name);
+		if (!run)
+			continue;
+
+		for (unsigned int s = 0; s < sizeof(bench_sizes) / sizeof(bench_sizes[0]); s++)
+		{
+			unsigned long size = bench_sizes[s];
+			if (size > max_payload)
+				break;
+			if ( (op->max_size != 0) && (size > op->max_size) )
+			{
+				cout << left << setw(14) << op->name << right << setw(10) << size
+				     << "  not run, capped at " << op->max_size << " B" << endl;
+				break;
+			}
+
+			string payload(size, 'x');
+			gpibSimSetFillSize(BENCH_BOARD, BENCH_PAD, 0, size);
+
+			// Warm up, then double the batch until it lasts long enough.
+			unsigned long batch = 1;
+			double        elapsed = 0;
+			unsigned long allocs = 0;
+			try
+			{
+				op->run(dev, handle, payload);
+				while (true)
+				{
+					unsigned long a0 = bench_allocs;
+					double t0 = bench_now_ns();
+					for (unsigned long n = 0; n < batch; n++)
+						op->run(dev, handle, payload);
+					elapsed = bench_now_ns() - t0;
+					allocs = bench_allocs - a0;
+					if (elapsed >= min_ns)
+						break;
+					batch *= 2;
+				}
+			}
+			catch (gpibDeviceException &e)
+			{
+				cerr << op->name << " failed: " << e.getMessage() << " (" << e.getiberrMessage() << ")" << endl;
+				break;
+			}
+
+			double ns_op = elapsed / batch;
+			cout << left << setw(14) << op->name << right << setw(10) << size
+			     << fixed << setprecision(1) << setw(14) << ns_op
+			     << setprecision(2) << setw(12) << (double) allocs / batch
+			     << setprecision(1) << setw(14) << (size * 1e3 / ns_op) << endl;
+		}
+	}
+
+	dev->setOffLine();
+	delete dev;
+	delete [] DrvRead::buffer;
+	for (unsigned int k = 0; k < ops.size(); k++)
+		delete ops[k];
+	return 0;
+}
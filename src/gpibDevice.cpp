@@ -1,7 +1,16 @@
 #include <iostream>
 #include <sstream>
 #include <string>
+#include <string.h>
+#include <stdlib.h>
+#include <algorithm>
 #include "gpibDevice.h"
+#include "gpibRecorder.h"
+
+/* Simulated driver (make SIM=1), replaces the platform library. */
+#ifdef GPIB_SIM
+#include "gpibSim.h"
+#else
 
 /* Include for Linux and Solaris. */
 #ifdef _solaris
@@ -22,8 +31,10 @@
 #include "ni488.h"	
 #endif
 
+#endif /* GPIB_SIM */
 
-#ifdef BCU
+
+#if defined(BCU) && !defined(GPIB_SIM)
 extern "C" {
 	void errno()
 	{
@@ -33,6 +44,17 @@ extern "C" {
 
 using namespace std;
 
+/**
+ * Board whose HS488 was disabled by the calling thread (gpibHS488Fallback).
+ */
+#ifdef WIN32
+static __declspec(thread) int thread_hs488_fallback = -1;
+#else
+static __thread int thread_hs488_fallback = -1;
+#endif
+
+static void board_addr_list(const vector<int> &pads, vector<Addr4882_t> &addrs);
+
 /**
  * Standard GPIB errors strings.
  */
@@ -76,14 +98,25 @@ const string error_array[] = {
 gpibDevice::gpibDevice(string dev_name, string boardname)
 {
 	int pad;
+	int sad;
 	string ss;
 	probe_method = GPIB_PROBE_UNKNOWN;
+	probe_confirmed = false;
+	latency = NULL;
+	counters = NULL;
+	board_counters = NULL;
+	bus_board = GPIB_DEFAULT_BOARD;
+	request_mark = 0;
+	sticky = false;
+	unaddr_saved = 1;
+	devSad = 0;
+	devAddr = -1;
 	
 	resetState();
 	// Get Device by name.
 	devID = ibfind((char *) dev_name.c_str() );
 	
-	saveState();
+	saveState("ibfind", -1, dev_name.c_str(), dev_name.length());
 	device_name = dev_name;
 	if ( (devID & ERR) || (dev_ibsta & ERR) )
 	{
@@ -92,13 +125,22 @@ gpibDevice::gpibDevice(string dev_name, string boardname)
 	
 	resetState();
 	ibask(devID,0x01,&pad);	// Get PAD;
-	saveState();
+	saveState("ibask", -1, &pad, sizeof(pad));
 	if ( (devID & ERR) || (dev_ibsta & ERR) )
 	{
 		throw gpibDeviceException( device_name, "Error occurs while getting device Addr ", iberrToString(), ibstaToString(), getiberr(),getibsta());
 	}
 	devAddr = pad;
 	
+	resetState();
+	ibask(devID, IbaSAD, &sad);	// Get SAD (0 = none);
+	saveState("ibask", -1, &sad, sizeof(sad));
+	if (dev_ibsta & ERR)
+	{
+		throw gpibDeviceException( device_name, "Error occurs while getting device secondary Addr ", iberrToString(), ibstaToString(), getiberr(),getibsta());
+	}
+	devSad = sad;
+	
 	// Save board id.
 	ss = boardname.substr(4);
 	gpib_board = atoi( ss.c_str() );
@@ -107,6 +149,11 @@ gpibDevice::gpibDevice(string dev_name, string boardname)
 	{
 		throw gpibDeviceException( device_name, "Error occurs while getting device Addr ", "Board index is out of range.", "Value must be between 0 and 7", getiberr(),getibsta());
 	}
+	bus_board = gpib_board;
+	board_counters = gpibBoardCounters(gpib_board);
+	// Let a replay of the traffic open the device by name.
+	gpibRecordCall(GPIB_RECORD_NAME, gpibClock(), 0, bus_board, GPIB_ADDR(devAddr, devSad), 0, 0, 0,
+	               dev_name.c_str(), dev_name.length());
 };
 
 
@@ -122,13 +169,24 @@ gpibDevice::gpibDevice(string dev_name, string boardname)
 gpibDevice::gpibDevice(string dev_name)
 {
 	int pad;
+	int sad;
 	probe_method = GPIB_PROBE_UNKNOWN;
+	probe_confirmed = false;
+	latency = NULL;
+	counters = NULL;
+	board_counters = gpibBoardCounters(GPIB_DEFAULT_BOARD);
+	bus_board = GPIB_DEFAULT_BOARD;
+	request_mark = 0;
+	sticky = false;
+	unaddr_saved = 1;
+	devSad = 0;
+	devAddr = -1;
 	resetState();
 	
 	// Get Device by name.
 	devID = ibfind((char *) dev_name.c_str() );
 	
-	saveState();
+	saveState("ibfind", -1, dev_name.c_str(), dev_name.length());
 	device_name = dev_name;
 	if ( (devID & ERR) || (dev_ibsta & ERR) )
 	{
@@ -137,32 +195,53 @@ gpibDevice::gpibDevice(string dev_name)
 	
 	resetState();
 	ibask(devID,0x01,&pad);	// Get PAD;
-	saveState();
+	saveState("ibask", -1, &pad, sizeof(pad));
 	if ( (devID & ERR) || (dev_ibsta & ERR) )
 	{
 		throw gpibDeviceException( device_name, "Error occurs while getting device Addr ", iberrToString(), ibstaToString(), getiberr(),getibsta());
 	}
 	devAddr = pad;
+	
+	resetState();
+	ibask(devID, IbaSAD, &sad);	// Get SAD (0 = none);
+	saveState("ibask", -1, &sad, sizeof(sad));
+	if (dev_ibsta & ERR)
+	{
+		throw gpibDeviceException( device_name, "Error occurs while getting device secondary Addr ", iberrToString(), ibstaToString(), getiberr(),getibsta());
+	}
+	devSad = sad;
 	gpib_board = GPIB_DEFAULT_BOARD;
+	gpibRecordCall(GPIB_RECORD_NAME, gpibClock(), 0, bus_board, GPIB_ADDR(devAddr, devSad), 0, 0, 0,
+	               dev_name.c_str(), dev_name.length());
 };
 
 
 /**
  * This is the 3rd constructor for the gpibDevice class.
- * It opens a device by GPIB Board name and Primary address.
- * This constructor assumes your gpib device secondary address to be 0 !
- * (= the third argument to ibdev()).
+ * It opens a device by GPIB Board name, Primary address and Secondary
+ * address (= the third argument to ibdev(): 0 = none, else MIN_SAD to
+ * MAX_SAD).
  *
  * See the default parameters for ibdev !
  *
  */
-gpibDevice::gpibDevice(int primary_add, string boardname)
+gpibDevice::gpibDevice(int primary_add, string boardname, int secondary_add)
 {
 	ostringstream os;
 	os << primary_add;
 	int    pad;
 	string ss;
 	probe_method = GPIB_PROBE_UNKNOWN;
+	probe_confirmed = false;
+	latency = NULL;
+	counters = NULL;
+	board_counters = NULL;
+	bus_board = GPIB_DEFAULT_BOARD;
+	request_mark = 0;
+	sticky = false;
+	unaddr_saved = 1;
+	devSad = 0;
+	devAddr = primary_add;	// Checked with ibask below
 	resetState();
 	device_name = "Not used with this constructor.";
 	
@@ -174,9 +253,15 @@ gpibDevice::gpibDevice(int primary_add, string boardname)
 	{
 		throw gpibDeviceException( device_name, "Error occurs while getting device Addr ", "Board index is out of range.", "Value must be between 0 and 7", getiberr(),getibsta());
 	}
+	bus_board = gpib_board;
+	board_counters = gpibBoardCounters(gpib_board);
 	
-	devID = ibdev(gpib_board, primary_add, 0, 13, 1, 0);
-	saveState();
+	if ( (secondary_add != 0) && ((secondary_add < MIN_SAD) || (secondary_add > MAX_SAD)) )
+	{
+		throw gpibDeviceException( device_name, "Error occurs while connecting to GPIB ", "Bad secondary address.", "Value must be 0 (none) or between 0x60 and 0x7e", 0, 0);
+	}
+	devID = ibdev(gpib_board, primary_add, secondary_add, 13, 1, 0);
+	saveState("ibdev");
 	if ( (devID & ERR) || (dev_ibsta & ERR) )
 	{
 		throw gpibDeviceException( device_name, "Error occurs while connecting to GPIB ", iberrToString(), ibstaToString(), getiberr(),getibsta());
@@ -184,7 +269,7 @@ gpibDevice::gpibDevice(int primary_add, string boardname)
 	
 	resetState();
 	ibask(devID,0x01,&pad);     // Get PAD and check if it is the same as on ip
-	saveState();
+	saveState("ibask", -1, &pad, sizeof(pad));
 	if ( (devID & ERR) || (dev_ibsta & ERR) )
 	{
 		throw gpibDeviceException( device_name, "Error occurs while getting device Addr ", iberrToString(), ibstaToString(), getiberr(),getibsta());
@@ -195,6 +280,7 @@ gpibDevice::gpibDevice(int primary_add, string boardname)
 	}
 	
 	devAddr = pad;
+	devSad = secondary_add;
 };
 
 
@@ -203,22 +289,35 @@ gpibDevice::gpibDevice(int primary_add, string boardname)
  * It opens a device by its Primary address.
  * This constructor assumes your gpib device to be on board 0 !
  * (= the first argument to ibdev()).
- * This constructor assumes your gpib device secondary address to be 0 !
- * (= the third argument to ibdev()).
+ * The secondary address is the third argument to ibdev() (0 = none).
 
  * See the default parameters for ibdev !
  *
  */
-gpibDevice::gpibDevice(int primary_add)
+gpibDevice::gpibDevice(int primary_add, int secondary_add)
 {
 	ostringstream os;
 	os << primary_add;
 	int pad;
 	probe_method = GPIB_PROBE_UNKNOWN;
+	probe_confirmed = false;
+	latency = NULL;
+	counters = NULL;
+	board_counters = gpibBoardCounters(GPIB_DEFAULT_BOARD);
+	bus_board = GPIB_DEFAULT_BOARD;
+	request_mark = 0;
+	sticky = false;
+	unaddr_saved = 1;
+	devSad = 0;
+	devAddr = primary_add;	// Checked with ibask below
 	resetState();
 	
-	devID = ibdev(0, primary_add, 0, 13, 1, 0);
-	saveState();
+	if ( (secondary_add != 0) && ((secondary_add < MIN_SAD) || (secondary_add > MAX_SAD)) )
+	{
+		throw gpibDeviceException( device_name, "Error occurs while connecting to GPIB ", "Bad secondary address.", "Value must be 0 (none) or between 0x60 and 0x7e", 0, 0);
+	}
+	devID = ibdev(0, primary_add, secondary_add, 13, 1, 0);
+	saveState("ibdev");
 	if ( (devID & ERR) || (dev_ibsta & ERR) )
 	{
 		throw gpibDeviceException( device_name, "Error occurs while connecting to GPIB ", iberrToString(), ibstaToString(), getiberr(),getibsta());
@@ -226,7 +325,7 @@ gpibDevice::gpibDevice(int primary_add)
 	
 	resetState();
 	ibask(devID,0x01,&pad);     // Get PAD;
-	saveState();
+	saveState("ibask", -1, &pad, sizeof(pad));
 	if ( (devID & ERR) || (dev_ibsta & ERR) )
 	{
 		throw gpibDeviceException( device_name, "Error occurs while getting device Addr ", iberrToString(), ibstaToString(), getiberr(),getibsta());
@@ -236,6 +335,7 @@ gpibDevice::gpibDevice(int primary_add)
 		throw gpibDeviceException( device_name, "Error occured: primary address on the input of constructur not the same as obtained with ibask() ", iberrToString(), ibstaToString(), getiberr(),getibsta());
 	}
 	devAddr = pad;
+	devSad = secondary_add;
 	gpib_board = GPIB_DEFAULT_BOARD;
 };
 
@@ -341,16 +441,142 @@ int gpibDevice::getDeviceAddr()
 }
 
 
+/**
+ * This method returns device's secondary address, 0 if it has none.
+ */
+int gpibDevice::getDeviceSecondaryAddr()
+{
+	return devSad;
+}
+
+
 /**
  * This method is for internal class use. 
  * GPIB iberr, ibsta and ibcnt are global to all devices. The gpibDevice 
  * class will call this method after all NI488 / NI488.2 function call, 
  * to save a specific device state. This method is must not be used from
  * outside the gpibDevice class.
+ * It also updates the counters and adds the call (driver function name
+ * given by call) to the flight recorder (gpibTrace.cpp), and to the bus
+ * traffic log (gpibRecorder.cpp) with the data it wrote or returned: len
+ * bytes at data, ibcnt bytes if len < 0.
  */
-void gpibDevice::saveState()
+void gpibDevice::saveState(const char *call, int bytes, const void *data, long len)
 {
-#ifdef WIN32
+	readState();
+	count(counters, bytes);
+	count(board_counters, bytes);
+	
+	long long end = gpibClock();
+	long long wait = 0;
+	gpibThreadIoAdd(end - call_start);
+	if (request_mark != 0)
+	{
+		wait = (call_start > request_mark) ? call_start - request_mark : 0;
+		request_mark = end;
+	}
+	gpibTraceRecord(call, call_start, end - call_start, wait, bus_board, GPIB_ADDR(devAddr, devSad),
+	                dev_ibcnt, dev_ibsta, dev_iberr);
+	if ( (data != NULL) && (len < 0) )
+		len = dev_ibcnt;
+	gpibRecordCall(call, call_start, end - call_start, bus_board, GPIB_ADDR(devAddr, devSad),
+	               dev_ibcnt, dev_ibsta, dev_iberr, data, len);
+}
+
+
+/**
+ * This method is for internal class use.
+ * After a transfer cut by a handshake error on a board using HS488 (EBUS,
+ * or EABO after part of the data: EABO alone is the time out of a slow
+ * device), put the board back to the standard handshake: this is how a
+ * device which does not follow HS488 fails. The device, or the GPIB_ADDR
+ * addresses of pads, is then cleared. Return true if HS488 was disabled.
+ * The state of the failed transfer is kept in dev_ibsta/dev_iberr.
+ */
+bool gpibDevice::hs488Fallback(const vector<int> *pads)
+{
+	if ( !(dev_ibsta & ERR) ||
+	     ((dev_iberr != EBUS) && ((dev_iberr != EABO) || (dev_ibcnt == 0))) )
+		return false;
+		
+	int sta = dev_ibsta;
+	int err = dev_iberr;
+	unsigned int cnt = dev_ibcnt;
+	bool fallback = false;
+	try
+	{
+		if (getconfig(bus_board, IbaHSCableLength) != 0)
+		{
+			config(bus_board, IbcHSCableLength, 0);
+			fallback = true;
+			thread_hs488_fallback = bus_board;
+			GPIB_LOG_ERROR("%s: transfer error with HS488 on board %d, standard handshake restored",
+			               device_name.c_str(), bus_board, 0);
+			resetState();
+			if (pads == NULL)
+			{
+				ibclr(devID);
+				saveState("ibclr");
+			}
+			else
+			{
+				vector<Addr4882_t> addrs;
+				board_addr_list(*pads, addrs);
+				DevClearList(bus_board, &addrs[0]);
+				saveState("DevClearList");
+			}
+		}
+	}
+	catch (gpibDeviceException)
+	{
+	}
+	dev_ibsta = sta;
+	dev_iberr = err;
+	dev_ibcnt = cnt;
+	return fallback;
+}
+
+
+int gpibHS488Fallback()
+{
+	int board = thread_hs488_fallback;
+	thread_hs488_fallback = -1;
+	return board;
+}
+
+
+/**
+ * This method is for internal class use.
+ * Update counters after a driver call: one transaction, the bytes
+ * transferred when bytes is GPIB_CNT_BYTES_WRITTEN or GPIB_CNT_BYTES_READ,
+ * timeout and error.
+ */
+void gpibDevice::count(gpibCounters *c, int bytes)
+{
+	if (c == NULL)
+		return;
+	c->add(GPIB_CNT_TRANSACTIONS, 1);
+	if (bytes >= 0)
+		c->add(bytes, dev_ibcnt);
+	if (dev_ibsta & TIMO)
+		c->add(GPIB_CNT_TIMEOUTS, 1);
+	if (dev_ibsta & ERR)
+	{
+		c->add(GPIB_CNT_ERRORS, 1);
+		c->addError(dev_iberr);
+	}
+}
+
+
+/**
+ * This method is for internal class use.
+ * Save iberr, ibsta and ibcnt of the last driver call in dev_iberr,
+ * dev_ibsta and dev_ibcnt, without counting or recording the call
+ * (saveState does both).
+ */
+void gpibDevice::readState()
+{
+#ifdef GPIB_THREAD_STATUS
 	dev_iberr = ThreadIberr ();
 	dev_ibsta = ThreadIbsta ();
 	dev_ibcnt = ThreadIbcntl ();
@@ -374,6 +600,7 @@ void gpibDevice::resetState()
 	dev_iberr = 0;
 	dev_ibsta = 0;
 	dev_ibcnt = 0;
+	call_start = gpibClock();
 }
 
 
@@ -383,49 +610,51 @@ void gpibDevice::resetState()
 void gpibDevice::findIsAliveMethod()
 {
 	probe_method = GPIB_PROBE_UNKNOWN;
+	probe_confirmed = false;
 	
 	// With pci board, ibln goes to device.
-	ibln( devID , devAddr, 0, &alive);
+	resetState();
+	ibln( devID , devAddr, devSad, &alive);
+	saveState("ibln", -1, &alive, sizeof(alive));
 	if ( (!(dev_ibsta & ERR)) && (alive != 0))
 	{
 		probe_method = GPIB_PROBE_DEVICE;
+		probe_confirmed = true;
 		return;
 	}
 	
 	// With enet board, ibln goes enet.
-	ibln( gpib_board , devAddr, 0, &alive);
+	resetState();
+	ibln( gpib_board , devAddr, devSad, &alive);
+	saveState("ibln", -1, &alive, sizeof(alive));
 	if ( (!(dev_ibsta & ERR)) && (alive != 0))
 	{
 		probe_method = GPIB_PROBE_BOARD;
+		probe_confirmed = true;
 		return;
 	}
-	cout << "Unable to determine IsAlive method to use. is your hardware turned on ?." << endl;
+	GPIB_LOG_ERROR("%s: unable to determine IsAlive method to use, is the hardware turned on ? (pad %d)",
+	               device_name.c_str(), devAddr, 0);
 }
 
 
 /**
- * This method test if the device is alive on the bus.
- * If returns 0: nobody there, else ok.
+ * This method sends the ibln request matching the current probe method.
  */
-short gpibDevice::isAlive() {
-
+void gpibDevice::probe()
+{
 	resetState();
 	
-	if (probe_method == GPIB_PROBE_UNKNOWN)
-	{
-		findIsAliveMethod();
-	}
-	
 	switch(probe_method)
 	{
 		case GPIB_PROBE_DEVICE:
 			// With pci board, ibln goes to device.
-			ibln( devID , devAddr, 0, &alive);
+			ibln( devID , devAddr, devSad, &alive);
 			break;
 			
 		case GPIB_PROBE_BOARD:
 			// With enet board, ibln goes enet.
-			ibln( gpib_board , devAddr, 0, &alive);
+			ibln( gpib_board , devAddr, devSad, &alive);
 			break;
 			
 		case GPIB_PROBE_UNKNOWN:
@@ -435,8 +664,46 @@ short gpibDevice::isAlive() {
 			break;
 	}
 	
-	saveState();
+	saveState("ibln", -1, &alive, sizeof(alive));
+}
+
+
+/**
+ * This method test if the device is alive on the bus.
+ * If returns 0: nobody there, else ok.
+ */
+short gpibDevice::isAlive() {
+
+	long long t0 = gpibClock();
+	
+	if (probe_method == GPIB_PROBE_UNKNOWN)
+	{
+		findIsAliveMethod();
+	}
+	
+	probe();
+	
+	// A preset probe method (see setProbeMethod) may not match the hardware
+	// any more, e.g. PCI board replaced by an ENET box: redo the full search
+	// once before reporting the device as absent.
+	if ( (probe_confirmed == false) && (probe_method != GPIB_PROBE_UNKNOWN) )
+	{
+		if ( (dev_ibsta & ERR) || (alive == 0) )
+		{
+			findIsAliveMethod();
+			probe();
+		}
+		else
+		{
+			probe_confirmed = true;
+		}
+	}
 	
+	record(GPIB_OP_PROBE, t0);
+	if (counters != NULL)
+		counters->add(GPIB_CNT_PROBES, 1);
+	if (board_counters != NULL)
+		board_counters->add(GPIB_CNT_PROBES, 1);
 	if ((dev_ibsta & ERR) || (probe_method == GPIB_PROBE_UNKNOWN))
 	{
 		throw gpibDeviceException( device_name,"Device not answering to ibln (isAlive() method).", iberrToString(), ibstaToString(), getiberr(),getibsta() );
@@ -445,6 +712,152 @@ short gpibDevice::isAlive() {
 }
 
 
+/**
+ * This method returns the method used by isAlive() to probe the device.
+ * GPIB_PROBE_UNKNOWN is returned until the first successful isAlive().
+ */
+GpibProbeMethod gpibDevice::getProbeMethod()
+{
+	return probe_method;
+}
+
+
+/**
+ * This method presets the method used by isAlive() to probe the device,
+ * typically with a value saved at a previous server start. It saves up to
+ * two ibln requests at the first isAlive(). If the preset method does not
+ * work, isAlive() falls back to the full search.
+ */
+void gpibDevice::setProbeMethod(GpibProbeMethod m)
+{
+	probe_method = m;
+	probe_confirmed = false;
+}
+
+
+/**
+ * This method gives the latency histograms where the durations of the
+ * I/O operations are recorded. The histograms belong to the caller and
+ * survive the gpibDevice, NULL stops the recording.
+ */
+void gpibDevice::setLatency(gpibLatency *l)
+{
+	latency = l;
+}
+
+
+/**
+ * This method gives the counters of the device (transactions, bytes, errors,
+ * ...). They belong to the caller, NULL stops the counting. The board
+ * counters (gpibBoardCounters) are always updated.
+ */
+void gpibDevice::setCounters(gpibCounters *c)
+{
+	counters = c;
+}
+
+
+/**
+ * This method gives the start of the request which the next driver calls
+ * serve (gpibClock()), e.g. the arrival of a Tango command. The flight
+ * recorder then keeps the time spent off the bus before each call.
+ */
+void gpibDevice::setRequestStart(long long t)
+{
+	request_mark = t;
+}
+
+
+/**
+ * Device left addressed on each board by its last transfer (sticky
+ * addressing), as driver handle + 1, 0 = none. Boards from
+ * GPIB_NB_COUNTED_BOARDS on are not tracked. The entries are only changed
+ * with the gpibAtomic functions: the thread which takes an owner out of
+ * an entry unaddresses it.
+ */
+static volatile unsigned long long bus_owner[GPIB_NB_COUNTED_BOARDS];
+
+
+/**
+ * Enable or disable sticky addressing. The driver does not send UNT UNL
+ * after each transfer any more (IbcUnAddr 0): repeated transfers with the
+ * same device skip its addressing. The device is unaddressed when another
+ * device of the board makes a transfer, or when sticky addressing is
+ * disabled.
+ */
+void gpibDevice::setStickyAddressing(bool on)
+{
+	if (on == sticky)
+		return;
+	if (on)
+	{
+		unaddr_saved = getconfig(IbcUnAddr);
+		config(IbcUnAddr, 0);
+		sticky = true;
+		return;
+	}
+	
+	sticky = false;
+	config(IbcUnAddr, unaddr_saved);
+	unsigned long long self = devID + 1;
+	if ( (gpib_board >= 0) && (gpib_board < GPIB_NB_COUNTED_BOARDS) &&
+	     (gpibAtomicCompareExchange(&bus_owner[gpib_board], self, 0) == self) )
+		unaddressBus();
+}
+
+
+bool gpibDevice::getStickyAddressing()
+{
+	return sticky;
+}
+
+
+/**
+ * This method is for internal class use, called before the transfers.
+ * If another device was left addressed on the board, unaddress it first:
+ * it would still listen to (or talk in) this transfer. The device then
+ * owns the bus if it is in sticky addressing.
+ */
+void gpibDevice::claimBus()
+{
+	if ( (gpib_board < 0) || (gpib_board >= GPIB_NB_COUNTED_BOARDS) )
+		return;
+	unsigned long long self = devID + 1;
+	if (gpibAtomicAdd(&bus_owner[gpib_board], 0) == self)
+		return;
+	unsigned long long owner = gpibAtomicExchange(&bus_owner[gpib_board], sticky ? self : 0);
+	if ( (owner != 0) && (owner != self) )
+		unaddressBus();
+}
+
+
+/**
+ * Send Untalk and Unlisten on the board.
+ */
+void gpibDevice::unaddressBus()
+{
+	char unaddr[2] = {UNT, UNL};
+	
+	resetState();
+	ibcmd(gpib_board, unaddr, 2);
+	saveState("ibcmd", GPIB_CNT_BYTES_WRITTEN, unaddr, 2);
+	if (dev_ibsta & ERR)
+	{
+		throw gpibDeviceException(device_name, "Error occurs while unaddressing the bus ", iberrToString(), ibstaToString(), getiberr(),getibsta() );
+	}
+}
+
+
+/**
+ * Record the duration of an operation started at t0 (gpibClock()).
+ */
+void gpibDevice::record(int op, long long t0)
+{
+	if (latency != NULL)
+		latency->record(op, gpibClock() - t0);
+}
+
+
 /**
  * This method reads a string from the encapsulated device.
  * Read a string from the encapsulated device. Return the string read. 
@@ -460,13 +873,17 @@ string gpibDevice::read()
 {
 	string ret;
 	
+	claimBus();
 	resetState();
 	memset(rd_buffer,0, (RD_BUFFER_SIZE+1));
+	long long t0 = gpibClock();
 	ibrd(devID,rd_buffer,RD_BUFFER_SIZE);
+	saveState("ibrd", GPIB_CNT_BYTES_READ, rd_buffer);
+	record(GPIB_OP_READ, t0);
 	ret = rd_buffer;
-	saveState();
 	if (dev_ibsta & ERR)
 	{
+		hs488Fallback();
 		throw gpibDeviceException( device_name,"Error occurs while reading to GPIB ", iberrToString(), ibstaToString(), getiberr(),getibsta() );
 	}
 	return ret;
@@ -480,11 +897,15 @@ string gpibDevice::read()
 int gpibDevice::write(string m)
 {
 
+	claimBus();
 	resetState();
+	long long t0 = gpibClock();
 	ibwrt(devID,(char *) m.c_str(),m.length() );
-	saveState();
+	saveState("ibwrt", GPIB_CNT_BYTES_WRITTEN, m.c_str(), m.length());
+	record(GPIB_OP_WRITE, t0);
 	if (dev_ibsta & ERR)
 	{
+		hs488Fallback();
 		throw gpibDeviceException( device_name,"Error occurs while writing to GPIB ", iberrToString(), ibstaToString(), getiberr(),getibsta() );
 	}
 	return dev_ibcnt;	/* Return saved incnt value */
@@ -495,12 +916,16 @@ string gpibDevice::writeRead(string m)
 {
 	string ret;
 	
+	claimBus();
 	resetState();
 	// Make the first Operation: Write.
+	long long t0 = gpibClock();
 	ibwrt(devID,(char *) m.c_str(),m.length() );
-	saveState();
+	saveState("ibwrt", GPIB_CNT_BYTES_WRITTEN, m.c_str(), m.length());
 	if (dev_ibsta & ERR)
 	{
+		record(GPIB_OP_WRITE_READ, t0);
+		hs488Fallback();
 		throw gpibDeviceException( device_name,"Error occurs while writing to GPIB ", iberrToString(), ibstaToString(), getiberr(),getibsta() );
 	}
 	
@@ -508,13 +933,15 @@ string gpibDevice::writeRead(string m)
 	resetState();
 	memset(rd_buffer,0, (RD_BUFFER_SIZE+1));
 	ibrd(devID,rd_buffer,RD_BUFFER_SIZE);
-	saveState();
+	saveState("ibrd", GPIB_CNT_BYTES_READ, rd_buffer);
+	record(GPIB_OP_WRITE_READ, t0);
 	
 	// ibcnt contain string length.
 	ret = string(rd_buffer, dev_ibcnt);
 	
 	if (dev_ibsta & ERR)
 	{
+		hs488Fallback();
 		throw gpibDeviceException( device_name,"Error occurs while reading to GPIB ", iberrToString(), ibstaToString(), getiberr(),getibsta() );
 	}
 	return ret;
@@ -533,17 +960,21 @@ string gpibDevice::read(unsigned long size)
 	string ret;
 	char *tmp_buffer;
 	
+	claimBus();
 	resetState();
 	tmp_buffer = new char[size+1];
 	memset(tmp_buffer,0, (size+1));
+	long long t0 = gpibClock();
 	ibrd(devID, tmp_buffer, size);
-	saveState();
+	saveState("ibrd", GPIB_CNT_BYTES_READ, tmp_buffer);
+	record(GPIB_OP_READ, t0);
 	
 	ret = string(tmp_buffer, dev_ibcnt);
 	delete []tmp_buffer;
 	
 	if (dev_ibsta & ERR)
 	{
+		hs488Fallback();
 		throw gpibDeviceException( device_name,"Error occurs while reading to GPIB ", iberrToString(), ibstaToString(), getiberr(),getibsta() );
 	}
 	return ret;
@@ -558,11 +989,15 @@ string gpibDevice::read(unsigned long size)
 void gpibDevice::sendData(const char *argin, long count)
 {
 
+	claimBus();
 	resetState();
-	Send ( gpib_board , MakeAddr(devAddr, 0),(char *)argin, count, NLend);
-	saveState();
+	long long t0 = gpibClock();
+	Send ( gpib_board , MakeAddr(devAddr, devSad),(char *)argin, count, NLend);
+	saveState("Send", GPIB_CNT_BYTES_WRITTEN, argin, count);
+	record(GPIB_OP_BINARY, t0);
 	if (dev_ibsta & ERR)
 	{
+		hs488Fallback();
 		throw gpibDeviceException( device_name,
 		                           string("Error occurs while writing to GPIB binary data"),
 		                           iberrToString(),
@@ -591,15 +1026,19 @@ char *gpibDevice::receiveData(long count)
 		                           getibsta());
 	}
 	
+	claimBus();
 	resetState();
 	
-	Receive ( gpib_board, MakeAddr(devAddr, 0), buffer, count, STOPend);
+	long long t0 = gpibClock();
+	Receive ( gpib_board, MakeAddr(devAddr, devSad), buffer, count, STOPend);
 	// The actual number of bytes transferred is returned in the variable
 	// ibcntl. We use ThreadIbcntl for thread safety
-	saveState();
+	saveState("Receive", GPIB_CNT_BYTES_READ, buffer);
+	record(GPIB_OP_BINARY, t0);
 	
 	if (dev_ibsta & ERR)
 	{
+		hs488Fallback();
 		delete [] buffer;
 		throw gpibDeviceException(device_name,
 		                          "Error occurs while reading binary data from GPIB",
@@ -625,9 +1064,10 @@ char *gpibDevice::receiveData(long count)
  */
 void gpibDevice::clear()
 {
+	claimBus();
 	resetState();
 	ibclr(devID);
-	saveState();
+	saveState("ibclr");
 	if (dev_ibsta & ERR)
 	{
 		throw gpibDeviceException(device_name, "Error occurs while clearing to GPIB ", iberrToString(), ibstaToString(), getiberr(),getibsta() );
@@ -639,10 +1079,21 @@ void gpibDevice::clear()
  * This method sends a configuration request to the device.
  */
 void gpibDevice::config(int option, int value)
+{
+	config(devID, option, value);
+}
+
+
+/**
+ * This method is for internal class use: ibconfig on a driver handle, the
+ * device or its board.
+ */
+void gpibDevice::config(int ud, int option, int value)
 {
 	resetState();
-	ibconfig(devID, option, value);
-	saveState();
+	ibconfig(ud, option, value);
+	int arg[2] = {option, value};
+	saveState("ibconfig", -1, arg, sizeof(arg));
 	if (dev_ibsta & ERR)
 	{
 		throw gpibDeviceException(device_name, "Error occurs while clearing to GPIB ", iberrToString(), ibstaToString(), getiberr(),getibsta() );
@@ -655,16 +1106,24 @@ void gpibDevice::config(int option, int value)
  * device or board.
  */
 short gpibDevice::getconfig(short option)
+{
+	return getconfig(devID, option);
+}
+
+
+/**
+ * This method is for internal class use: ibask on a driver handle, the
+ * device or its board.
+ */
+short gpibDevice::getconfig(int ud, short option)
 {
 	int value;
 	
 	resetState();
-	ibask(devID, option, &value);
-	
-	// temporarily to see what get out with ibask
-	cout << "getconfig(): option = " << option << " value = " << value << endl;
+	ibask(ud, option, &value);
+	GPIB_LOG_DEBUG("%s: getconfig(): option = %x value = %d", device_name.c_str(), option, value);
 	
-	saveState();
+	saveState("ibask", -1, &value, sizeof(value));
 	if (dev_ibsta & ERR)
 	{
 		throw gpibDeviceException(device_name, "Error occurs while asking for one configuration field of GPIB board or device ", iberrToString(), ibstaToString(), getiberr(),getibsta() );
@@ -680,9 +1139,10 @@ short gpibDevice::getconfig(short option)
  */
 void gpibDevice::trigger()
 {
+	claimBus();
 	resetState();
 	ibtrg(devID);
-	saveState();
+	saveState("ibtrg");
 	if (dev_ibsta & ERR)
 	{
 		throw gpibDeviceException(device_name, "Error occurs while triggering device ", iberrToString(), ibstaToString(), getiberr(),getibsta() );
@@ -690,15 +1150,55 @@ void gpibDevice::trigger()
 }
 
 
+/**
+ * Configure the device to answer parallel polls on data line DIO<line>
+ * (1 to 8), when its individual status (ist) equals sense (0 or 1).
+ */
+void gpibDevice::ppollConfig(int line, int sense)
+{
+	if ( (line < 1) || (line > 8) )
+	{
+		throw gpibDeviceException(device_name, "Error in parallel poll configuration ", "Bad data line.", "Value must be between 1 and 8", 0, 0);
+	}
+	resetState();
+	PPollConfig(gpib_board, MakeAddr(devAddr, devSad), line, sense ? 1 : 0);
+	saveState("PPollConfig");
+	if (dev_ibsta & ERR)
+	{
+		throw gpibDeviceException(device_name, "Error occurs while configuring parallel poll ", iberrToString(), ibstaToString(), getiberr(),getibsta() );
+	}
+}
+
+
+/**
+ * The device does not answer parallel polls any more.
+ */
+void gpibDevice::ppollUnconfig()
+{
+	Addr4882_t addrs[2];
+	
+	addrs[0] = MakeAddr(devAddr, devSad);
+	addrs[1] = NOADDR;
+	resetState();
+	PPollUnconfig(gpib_board, addrs);
+	saveState("PPollUnconfig");
+	if (dev_ibsta & ERR)
+	{
+		throw gpibDeviceException(device_name, "Error occurs while unconfiguring parallel poll ", iberrToString(), ibstaToString(), getiberr(),getibsta() );
+	}
+}
+
+
 /**
  * This method makes a serial poll on the gpib device.
  */
 short gpibDevice::getSerialPoll()
 {
 	char serialpollbyte;
+	claimBus();
 	resetState();
 	ibrsp(devID,&serialpollbyte );
-	saveState();
+	saveState("ibrsp", -1, &serialpollbyte, 1);
 	if (dev_ibsta & ERR)
 	{
 		throw gpibDeviceException(device_name, "Error occurs while triggering device ", iberrToString(), ibstaToString(), getiberr(),getibsta() );
@@ -707,6 +1207,38 @@ short gpibDevice::getSerialPoll()
 }
 
 
+/**
+ * Set the device end-of-string mode with ibeos. The low byte of v is the
+ * EOS character, the upper bits are REOS, XEOS and BIN.
+ */
+void gpibDevice::setEOS(int v)
+{
+	resetState();
+	ibeos(devID, v);
+	saveState("ibeos");
+	if (dev_ibsta & ERR)
+	{
+		throw gpibDeviceException(device_name, "Error occurs while setting EOS mode on ", iberrToString(), ibstaToString(), getiberr(),getibsta() );
+	}
+}
+
+
+/**
+ * Enable (v != 0) or disable the assertion of EOI with the last byte
+ * written to the device.
+ */
+void gpibDevice::setEOT(int v)
+{
+	resetState();
+	ibconfig(devID, IbcEOT, (v != 0) ? 1 : 0);
+	saveState("ibconfig");
+	if (dev_ibsta & ERR)
+	{
+		throw gpibDeviceException(device_name, "Error occurs while setting EOT mode on ", iberrToString(), ibstaToString(), getiberr(),getibsta() );
+	}
+}
+
+
 /**
  * Set the device time out value. 
  * Warning: These values are predefined. With GPIB you can only choose
@@ -719,7 +1251,7 @@ void gpibDevice::setTimeOut(int v)
 	if ( (v >= 0) && (v <= 17) )
 	{
 		ibtmo(devID,v);
-		saveState();
+		saveState("ibtmo");
 		
 	} else {
 		throw gpibDeviceException(device_name, "Error occurs while setting time out on ", "Value out of range.", " [0-15] value expected.", getiberr(),getibsta() );
@@ -740,9 +1272,11 @@ void gpibDevice::setTimeOut(int v)
  */
 void gpibDevice::setOffLine()
 {
+	// A device left addressed would listen to the next transfer.
+	setStickyAddressing(false);
 	resetState();
 	ibonl(devID, 0);
-	saveState();
+	saveState("ibonl");
 	if (dev_ibsta & ERR)
 	{
 		throw gpibDeviceException( device_name,"Error occurs with setOffline method ", iberrToString(), ibstaToString(), getiberr(),getibsta() );
@@ -762,7 +1296,7 @@ void gpibDevice::goToLocalMode()
 {
 	resetState();
 	ibloc(devID);
-	saveState();
+	saveState("ibloc");
 	if (dev_ibsta & ERR)
 	{
 		throw gpibDeviceException( device_name,"Error occurs with ibloc() command", iberrToString(), ibstaToString(), getiberr(),getibsta() );
@@ -779,7 +1313,7 @@ void gpibDevice::goToRemoteMode()
 {
 	resetState();
 	ibsre( gpib_board , devID);
-	saveState();
+	saveState("ibsre");
 	if (dev_ibsta & ERR)
 	{
 		throw gpibDeviceException( device_name,"Error occurs with ibsre() command", iberrToString(), ibstaToString(), getiberr(),getibsta() );
@@ -800,6 +1334,7 @@ void gpibDevice::goToRemoteMode()
 gpibBoard::gpibBoard() :gpibDevice( "gpib0" )
 {
 	board_id = GPIB_DEFAULT_BOARD;
+	sc_saved = -1;
 }
 
 
@@ -812,37 +1347,75 @@ gpibBoard::gpibBoard(string boardname) :gpibDevice( boardname )
 	string ss;
 	ss = boardname.substr(4);
 	board_id = atoi( ss.c_str() );
+	sc_saved = -1;
+	bus_board = board_id;
+	board_counters = gpibBoardCounters(board_id);
 }
 
 
 /**
- * This method sends an Interface Clear on the bus. 
- * All devices are cleared and the device @0 becomes Controler In Charge.
+ * gpibBoard destructor. The board is not set offline, other gpibDevice
+ * objects may still use it.
  */
-void gpibBoard::sendIFC()
+gpibBoard::~gpibBoard()
 {
-	resetState();
+}
+
+
+/**
+ * Called before the bus operations of the board. A device left addressed
+ * by sticky addressing is unaddressed first and no longer owns the bus:
+ * the board addresses the devices itself, and the owner would not know
+ * that it must address itself again.
+ */
+void gpibBoard::claimBus()
+{
+	char unaddr[2] = {UNT, UNL};
 	
-	// Note: sendIFC() != SendIFC() / gpibDevice NI.488.2 func SendIFC ()
-	SendIFC( board_id );
-	saveState();
+	if ( (board_id < 0) || (board_id >= GPIB_NB_COUNTED_BOARDS) )
+		return;
+	if (gpibAtomicExchange(&bus_owner[board_id], 0) == 0)
+		return;
+	resetState();
+	ibcmd(board_id, unaddr, 2);
+	saveState("ibcmd", GPIB_CNT_BYTES_WRITTEN, unaddr, 2);
 	if (dev_ibsta & ERR)
 	{
-		throw gpibDeviceException( device_name,"Error occurs with sendIFC() command", iberrToString(), ibstaToString(), getiberr(),getibsta() );
+		throw gpibDeviceException(device_name, "Error occurs while unaddressing the bus ", iberrToString(), ibstaToString(), getiberr(),getibsta() );
 	}
 }
 
 
 /**
- * Send a GPIB command message. 
+ * This method sends an Interface Clear on the bus. 
+ * All devices are cleared and the device @0 becomes Controler In Charge.
+ */
+void gpibBoard::sendIFC()
+{
+	claimBus();
+	resetState();
+	
+	// Note: sendIFC() != SendIFC() / gpibDevice NI.488.2 func SendIFC ()
+	SendIFC( board_id );
+	saveState("SendIFC");
+	if (dev_ibsta & ERR)
+	{
+		throw gpibDeviceException( device_name,"Error occurs with sendIFC() command", iberrToString(), ibstaToString(), getiberr(),getibsta() );
+	}
+}
+
+
+/**
+ * Send a GPIB command message. 
  * This method is not used to transmit programming instruction to devices,
  * This kind of instructions are transmitted with the read / write methods.
  */
 int gpibBoard::cmd(string cmd)
 {
+	claimBus();
 	resetState();
 	ibcmd( board_id ,(char *) cmd.c_str(),cmd.length() );
-	saveState();
+	saveState("ibcmd", GPIB_CNT_BYTES_WRITTEN);
 	if (dev_ibsta & ERR)
 	{
 		throw gpibDeviceException(device_name, "Error occurs with cmd on GPIB ",
@@ -859,6 +1432,8 @@ int gpibBoard::cmd(string cmd)
  */
 void gpibBoard::llo(int dev)
 {
+	(void) dev;	// Only used where the driver has ibllo().
+	claimBus();
 	resetState();
 	// TODO : find ibllo for WIN32
 #ifdef _solaris
@@ -877,7 +1452,7 @@ void gpibBoard::llo(int dev)
 	ibllo( dev );
 #endif
 	
-	saveState();
+	saveState("ibllo");
 	if (dev_ibsta & ERR)
 	{
 		throw gpibDeviceException(device_name, "Error occurs with ibllo on GPIB ", iberrToString(), ibstaToString(), getiberr(),getibsta() );
@@ -891,9 +1466,10 @@ void gpibBoard::llo(int dev)
  */
 void gpibBoard::clr(int dev)
 {
+	claimBus();
 	resetState();
 	ibclr( dev );
-	saveState();
+	saveState("ibclr");
 	if (dev_ibsta & ERR)
 	{
 		throw gpibDeviceException(device_name, "Error occurs with ibclr on GPIB ", iberrToString(), ibstaToString(), getiberr(),getibsta() );
@@ -910,54 +1486,743 @@ int gpibBoard::getBoardInd(void)
 }
 
 
+/**
+ * Check a list of addresses (GPIB_ADDR) for a group operation: 1 to
+ * MAX_GROUP_SIZE addresses, without the board one.
+ */
+void gpibBoard::checkPads(const vector<int> &pads)
+{
+	if ( (pads.size() == 0) || (pads.size() > MAX_GROUP_SIZE) )
+	{
+		throw gpibDeviceException(device_name, "Error in group operation ", "Bad number of devices.", "Give 1 to 960 addresses", 0, 0);
+	}
+	for (unsigned int i = 0; i < pads.size(); i++)
+	{
+		int pad = GPIB_ADDR_PAD(pads[i]);
+		int sad = GPIB_ADDR_SAD(pads[i]);
+		
+		if ( (pads[i] < 0) || (pads[i] != GPIB_ADDR(pad, sad)) || (pad > MAX_PAD) ||
+		     ((sad != 0) && ((sad < MIN_SAD) || (sad > MAX_SAD))) ||
+		     ((pad == devAddr) && (sad == 0)) )
+		{
+			throw gpibDeviceException(device_name, "Error in group operation ", "Bad address.", "Primary address 0 to 30 (not the board one), plus 256 * secondary address (0x60 to 0x7e) if any", 0, 0);
+		}
+	}
+}
+
+
+/**
+ * Driver address of a GPIB_ADDR address.
+ */
+static Addr4882_t board_addr(int addr)
+{
+	return MakeAddr(GPIB_ADDR_PAD(addr), GPIB_ADDR_SAD(addr));
+}
+
+
+/**
+ * Driver address list of a group operation, NOADDR terminated.
+ */
+static void board_addr_list(const vector<int> &pads, vector<Addr4882_t> &addrs)
+{
+	addrs.resize(pads.size() + 1);
+	for (unsigned int i = 0; i < pads.size(); i++)
+		addrs[i] = board_addr(pads[i]);
+	addrs[pads.size()] = NOADDR;
+}
+
+
+/**
+ * Send a Group Execute Trigger to a list of devices: they are all addressed
+ * as listeners, then triggered by one GET command on the bus.
+ */
+void gpibBoard::triggerList(const vector<int> &pads)
+{
+	vector<Addr4882_t> addrs;
+	
+	checkPads(pads);
+	board_addr_list(pads, addrs);
+	
+	claimBus();
+	resetState();
+	TriggerList(board_id, &addrs[0]);
+	saveState("TriggerList", -1, &addrs[0], pads.size() * sizeof(Addr4882_t));
+	if (dev_ibsta & ERR)
+	{
+		throw gpibDeviceException(device_name, "Error occurs with TriggerList on GPIB ", iberrToString(), ibstaToString(), getiberr(),getibsta() );
+	}
+}
+
+
+/**
+ * Write the same data to a list of devices: they are all addressed as
+ * listeners, then the bytes are sent once on the bus (SendList). Return the
+ * number of bytes written.
+ */
+int gpibBoard::writeMany(const vector<int> &pads, const string &data)
+{
+	vector<Addr4882_t> addrs;
+	
+	checkPads(pads);
+	board_addr_list(pads, addrs);
+	
+	claimBus();
+	resetState();
+	SendList(board_id, &addrs[0], (char *) data.c_str(), data.length(), NLend);
+	saveState("SendList", GPIB_CNT_BYTES_WRITTEN, data.c_str(), data.length());
+	if (dev_ibsta & ERR)
+	{
+		hs488Fallback(&pads);
+		throw gpibDeviceException(device_name, "Error occurs with SendList on GPIB ", iberrToString(), ibstaToString(), getiberr(),getibsta() );
+	}
+	return dev_ibcnt;
+}
+
+
+/**
+ * Serial poll a list of devices with AllSpoll: the board is addressed once
+ * as listener and the devices are polled in a row. status gets the status
+ * byte of each device, -1 for a device which did not answer: AllSpoll
+ * stops on it (EABO, ibcnt = its index), the next ones are polled again.
+ */
+void gpibBoard::serialPollAll(const vector<int> &pads, vector<int> &status)
+{
+	vector<Addr4882_t> addrs(pads.size() + 1);
+	vector<Addr4882_t> results(pads.size() + 1);
+	unsigned int       first = 0;
+	
+	checkPads(pads);
+	status.assign(pads.size(), -1);
+	claimBus();
+	while (first < pads.size())
+	{
+		unsigned int n = pads.size() - first;
+		for (unsigned int i = 0; i < n; i++)
+			addrs[i] = board_addr(pads[first + i]);
+		addrs[n] = NOADDR;
+		
+		results.assign(results.size(), 0);
+		resetState();
+		AllSpoll(board_id, &addrs[0], &results[0]);
+		saveState("AllSpoll", -1, &results[0], n * sizeof(Addr4882_t));
+		unsigned int polled = (dev_ibsta & ERR) ? dev_ibcnt : n;
+		if (polled > n)
+			polled = n;
+		
+		for (unsigned int i = 0; i < polled; i++)
+			status[first + i] = results[i] & 0xff;
+		if (!(dev_ibsta & ERR))
+			break;
+		if (dev_iberr != EABO)
+		{
+			throw gpibDeviceException(device_name, "Error occurs with AllSpoll on GPIB ", iberrToString(), ibstaToString(), getiberr(),getibsta() );
+		}
+		first += polled + 1;
+	}
+}
+
+
+/**
+ * Parallel poll the bus: bit n of the result is set by the devices
+ * configured on data line DIO<n+1> (see gpibDevice::ppollConfig). One bus
+ * cycle, a few us, for up to 8 devices.
+ */
+int gpibBoard::parallelPoll()
+{
+	short result = 0;
+	
+	claimBus();
+	resetState();
+	PPoll(board_id, &result);
+	saveState("PPoll", -1, &result, sizeof(result));
+	if (dev_ibsta & ERR)
+	{
+		throw gpibDeviceException(device_name, "Error occurs with PPoll on GPIB ", iberrToString(), ibstaToString(), getiberr(),getibsta() );
+	}
+	return result & 0xff;
+}
+
+
+/**
+ * Enable the HS488 high speed handshake of the board for a bus of
+ * cable_length meters of cable (1 to MAX_HS488_CABLE), or disable it (0).
+ * Devices which do not support HS488 still use the standard handshake.
+ * A transfer which then fails with a handshake error disables HS488 again
+ * and clears the device (hs488Fallback).
+ */
+void gpibBoard::setHS488(int cable_length)
+{
+	if ( (cable_length < 0) || (cable_length > MAX_HS488_CABLE) )
+	{
+		throw gpibDeviceException(device_name, "Error in HS488 configuration ", "Bad cable length.", "Value must be between 0 (disabled) and 15 meters", 0, 0);
+	}
+	config(IbcHSCableLength, cable_length);
+}
+
+
+/**
+ * Return the HS488 cable length of the board, 0 if HS488 is disabled.
+ */
+int gpibBoard::getHS488()
+{
+	return getconfig(IbcHSCableLength);
+}
+
+
+/**
+ * Send query to a device, then read size bytes of its reply (less if it
+ * ends before). ns gets the duration of the whole transfer. Return the
+ * number of bytes read, -1 on error (see dev_iberr).
+ */
+long gpibBoard::timedRead(int pad, const string &query, char *buffer, long size,
+                          long long &ns)
+{
+	claimBus();
+	long long t0 = gpibClock();
+	
+	resetState();
+	Send(board_id, board_addr(pad), (char *) query.c_str(), query.length(), NLend);
+	saveState("Send", GPIB_CNT_BYTES_WRITTEN, query.c_str(), query.length());
+	if (dev_ibsta & ERR)
+		return -1;
+	
+	resetState();
+	Receive(board_id, board_addr(pad), buffer, size, STOPend);
+	saveState("Receive", GPIB_CNT_BYTES_READ, buffer);
+	ns = gpibClock() - t0;
+	if (dev_ibsta & ERR)
+		return -1;
+	return dev_ibcnt;
+}
+
+
+/**
+ * Check that a device follows the HS488 handshake: its reply to query
+ * (e.g. a waveform transfer of size bytes) is read with the standard
+ * handshake, then with HS488 for cable_length meters. HS488 stays enabled
+ * if the second read succeeds with the same number of bytes; else the
+ * device is cleared and the board goes back to the standard handshake.
+ * The rates of both reads are given in result. Throw if the standard
+ * read fails.
+ */
+void gpibBoard::testHS488(int pad, const string &query, long size, int cable_length,
+                          gpibSpeedTest &result)
+{
+	vector<char> buffer;
+	long long    ns = 0;
+	
+	if (query.length() == 0)
+	{
+		throw gpibDeviceException(device_name, "Error in HS488 test ", "Empty query.", "Give a device address and a query", 0, 0);
+	}
+	checkPads(vector<int>(1, pad));
+	if ( (size < 1) || (size > MAX_SPEED_TEST) || (cable_length < 1) )
+	{
+		throw gpibDeviceException(device_name, "Error in HS488 test ", "Bad size or cable length.", "Size must be between 1 and 16 MB, cable length at least 1 meter", 0, 0);
+	}
+	buffer.resize(size);
+	result.bytes = 0;
+	result.standard = 0;
+	result.hs488 = 0;
+	result.fallback = false;
+	result.iberr = -1;
+	
+	setHS488(0);
+	long n = timedRead(pad, query, &buffer[0], size, ns);
+	if (n < 0)
+	{
+		throw gpibDeviceException(device_name, "Error occurs with the standard handshake read ", iberrToString(), ibstaToString(), getiberr(),getibsta() );
+	}
+	result.bytes = n;
+	result.standard = (ns > 0) ? n * 1e9 / ns : 0;
+	
+	setHS488(cable_length);
+	long hs = timedRead(pad, query, &buffer[0], size, ns);
+	if (hs == n)
+	{
+		result.hs488 = (ns > 0) ? hs * 1e9 / ns : 0;
+		return;
+	}
+	
+	// The device did not follow: back to the standard handshake.
+	result.fallback = true;
+	if (hs < 0)
+		result.iberr = dev_iberr;
+	GPIB_LOG_ERROR("%s: HS488 test failed on pad %d, standard handshake restored",
+	               device_name.c_str(), pad, 0);
+	setHS488(0);
+	clearPad(pad);
+}
+
+
+/**
+ * Clear a device left in an unknown state by a failed transfer. Errors
+ * are ignored.
+ */
+void gpibBoard::clearPad(int pad)
+{
+	claimBus();
+	resetState();
+	DevClear(board_id, board_addr(pad));
+	saveState("DevClear");
+}
+
+
+/**
+ * Set the T1 delay of the board as talker: GPIB_T1_2000NS, GPIB_T1_500NS
+ * or GPIB_T1_350NS.
+ */
+void gpibBoard::setTiming(int timing)
+{
+	if ( (timing < GPIB_T1_2000NS) || (timing > GPIB_T1_350NS) )
+	{
+		throw gpibDeviceException(device_name, "Error in bus timing configuration ", "Bad timing.", "Value must be between 1 (2 us) and 3 (350 ns)", 0, 0);
+	}
+	config(IbcTIMING, timing);
+}
+
+
+/**
+ * Use DMA (1) or programmed I/O (0) for the transfers of the board.
+ */
+void gpibBoard::setDMA(int on)
+{
+	config(IbcDMA, on ? 1 : 0);
+}
+
+
+/**
+ * Put the board in listen-only mode, or back to normal. In listen-only
+ * mode the board takes part in the handshake of every data byte on the
+ * bus without being addressed: it must read back to back (monitorRead)
+ * so as not to slow down the transfers. The board is not system
+ * controller while it listens (IbcSC 0): the bus already has one. Its
+ * IbcSC setting is given back in normal mode.
+ */
+void gpibBoard::setListenOnly(bool on)
+{
+	if (on)
+	{
+		if (sc_saved < 0)
+			sc_saved = getconfig(IbcSC);
+		config(IbcSC, 0);
+		config(IbcLON, 1);
+		return;
+	}
+	config(IbcLON, 0);
+	if (sc_saved > 0)
+		config(IbcSC, sc_saved);
+	sc_saved = -1;
+}
+
+
+/**
+ * Read the bytes seen on the bus by the listen-only board, up to max.
+ * Return 0 if the bus stayed idle during the board time out.
+ *
+ * The driver only returns the data bytes, with EOI on the last one: their
+ * talker and listeners are unknown. The bytes get the end time of the
+ * read, less GPIB_MONITOR_BYTE_NS per following byte. The simulated
+ * driver gives the command bytes too (gpibSimMonitorRead).
+ */
+long gpibBoard::monitorRead(gpibBusCycle *cycles, long max)
+{
+#ifdef GPIB_SIM
+	long long     times[GPIB_MONITOR_READ];
+	unsigned char bytes[GPIB_MONITOR_READ];
+	unsigned char flags[GPIB_MONITOR_READ];
+	if (max > GPIB_MONITOR_READ)
+		max = GPIB_MONITOR_READ;
+	
+	long n = gpibSimMonitorRead(board_id, times, bytes, flags, max, GPIB_MONITOR_WAIT_US);
+	if (n < 0)
+	{
+		throw gpibDeviceException(device_name, "Error occurs while monitoring GPIB ", "Board not in listen-only mode.", "Use setListenOnly first", 0, 0);
+	}
+	for (long i = 0; i < n; i++)
+	{
+		cycles[i].time = times[i];
+		cycles[i].byte = bytes[i];
+		cycles[i].flags = ((flags[i] & GPIBSIM_ATN) ? GPIB_MONITOR_ATN : 0) |
+		                  ((flags[i] & GPIBSIM_EOI) ? GPIB_MONITOR_EOI : 0);
+		cycles[i].talker = -1;
+		cycles[i].listeners = 0;
+	}
+	return n;
+#else
+	char buffer[GPIB_MONITOR_READ];
+	if (max > GPIB_MONITOR_READ)
+		max = GPIB_MONITOR_READ;
+	
+	// Not counted, traced nor recorded: the idle time outs would hide
+	// the bus transfers.
+	resetState();
+	long long t0 = gpibClock();
+	ibrd(devID, buffer, max);
+	readState();
+	long long t1 = gpibClock();
+	if ( (dev_ibsta & ERR) && (dev_iberr == EABO) && (dev_ibcnt == 0) )
+		return 0;	// Time out: idle bus.
+	if (dev_ibsta & ERR)
+	{
+		throw gpibDeviceException(device_name, "Error occurs while monitoring GPIB ", iberrToString(), ibstaToString(), getiberr(),getibsta() );
+	}
+	
+	long n = dev_ibcnt;
+	long long step = GPIB_MONITOR_BYTE_NS;
+	if ( (n > 0) && ((t1 - t0) / n < step) )
+		step = (t1 - t0) / n;
+	for (long i = 0; i < n; i++)
+	{
+		cycles[i].time = t1 - (n - 1 - i) * step;
+		cycles[i].byte = (unsigned char) buffer[i];
+		cycles[i].flags = ( (i == n - 1) && (dev_ibsta & END) ) ? GPIB_MONITOR_EOI : 0;
+		cycles[i].talker = -1;
+		cycles[i].listeners = 0;
+	}
+	return n;
+#endif
+}
+
+
+/**
+ * Find the fastest safe IbcTIMING / IbcDMA setting of the board. The
+ * devices (all the listeners if pads is empty) are queried repeat times
+ * with each setting, the default one (2 us T1, no DMA) first: its replies
+ * are the reference, a device which does not answer it is left out. The
+ * query must get a fixed reply (e.g. *IDN?, not a measurement): a device
+ * whose two first replies differ fails the tuning. A setting is safe if
+ * all the replies are read without error and equal to the reference. The
+ * fastest safe setting is applied to the board. The tuning fails when no
+ * setting but the default one is safe. On failure, the board gets back
+ * its timing and DMA setting.
+ * results gets every setting tried; return the index of the chosen one.
+ */
+int gpibBoard::tuneBus(const vector<int> &pads, const string &query, int repeat,
+                       vector<gpibTuneResult> &results)
+{
+	vector<int>    tested;
+	vector<string> reference;
+	long long      ns;
+	int            best = -1;
+	
+	if (pads.size() == 0)
+	{
+		vector<gpibDeviceInfo> &devices = getConnectedDeviceList();
+		for (unsigned int i = 0; i < devices.size(); i++)
+			tested.push_back(GPIB_ADDR(devices[i].dev_pad, devices[i].dev_sad));
+	}
+	else
+	{
+		checkPads(pads);
+		tested = pads;
+	}
+	if ( (query.length() == 0) || (repeat < 1) )
+	{
+		throw gpibDeviceException(device_name, "Error in bus tuning ", "Bad query or repeat count.", "Give a query and at least one transfer", 0, 0);
+	}
+	
+	int timing_saved = getconfig(IbcTIMING);
+	int dma_saved = getconfig(IbcDMA);
+	try
+	{
+		// Reference replies with the default setting.
+		setTiming(GPIB_T1_2000NS);
+		setDMA(0);
+		for (unsigned int i = 0; i < tested.size(); )
+		{
+			long n = timedRead(tested[i], query, rd_buffer, RD_BUFFER_SIZE, ns);
+			if (n < 0)
+			{
+				clearPad(tested[i]);
+				tested.erase(tested.begin() + i);
+				continue;
+			}
+			reference.push_back(string(rd_buffer, n));
+			n = timedRead(tested[i], query, rd_buffer, RD_BUFFER_SIZE, ns);
+			if ( (n >= 0) && (reference[i] != string(rd_buffer, n)) )
+			{
+				throw gpibDeviceException(device_name, "Error in bus tuning ", "The reply to the query changes.", "Give a query with a fixed reply (e.g. *IDN?)", 0, 0);
+			}
+			i++;
+		}
+		if (tested.size() == 0)
+		{
+			throw gpibDeviceException(device_name, "Error in bus tuning ", "No device answers the query.", "Check the addresses and the query", 0, 0);
+		}
+		
+		results.clear();
+		for (int timing = GPIB_T1_2000NS; timing <= GPIB_T1_350NS; timing++)
+		{
+			for (int dma = 0; dma <= 1; dma++)
+			{
+				gpibTuneResult r;
+				r.timing = timing;
+				r.dma = dma;
+				r.ns = 0;
+				r.ok = true;
+				try
+				{
+					setTiming(timing);
+					setDMA(dma);
+				}
+				catch (gpibDeviceException e)
+				{
+					r.ok = false;	// Not supported by the board.
+				}
+				for (unsigned int i = 0; r.ok && (i < tested.size()); i++)
+				{
+					for (int k = 0; k < repeat; k++)
+					{
+						long n = timedRead(tested[i], query, rd_buffer, RD_BUFFER_SIZE, ns);
+						if ( (n < 0) || (reference[i] != string(rd_buffer, n)) )
+						{
+							GPIB_LOG_INFO("%s: bus tuning, pad %d failed", device_name.c_str(), tested[i], 0);
+							// A reply read to its end leaves the device in a known state.
+							if (n < 0)
+								clearPad(tested[i]);
+							r.ok = false;
+							break;
+						}
+						r.ns += ns;
+					}
+				}
+				if ( r.ok && ( (best < 0) || (r.ns < results[best].ns) ) )
+					best = results.size();
+				results.push_back(r);
+			}
+		}
+		
+		bool verified = false;
+		for (unsigned int i = 1; i < results.size(); i++)
+			verified = verified || results[i].ok;
+		if (!verified)
+		{
+			throw gpibDeviceException(device_name, "Error in bus tuning ", "No setting faster than the default one is safe.", "Keep the board setting, or check the query has a fixed reply", 0, 0);
+		}
+		
+		setTiming(results[best].timing);
+		setDMA(results[best].dma);
+	}
+	catch (gpibDeviceException)
+	{
+		try
+		{
+			config(IbcTIMING, timing_saved);
+			config(IbcDMA, dma_saved);
+		}
+		catch (gpibDeviceException)
+		{
+		}
+		throw;
+	}
+	return best;
+}
+
+
+/**
+ * Send a query (if not empty) to a device and read its reply. Errors are
+ * returned in the reply, not thrown.
+ */
+void gpibBoard::readReply(int pad, const string &query, gpibReply &r)
+{
+	vector<int> one(1, pad);
+	
+	r.pad = GPIB_ADDR_PAD(pad);
+	r.sad = GPIB_ADDR_SAD(pad);
+	r.data = "";
+	r.iberr = -1;
+	r.ibsta = 0;
+	
+	if (query.length() != 0)
+	{
+		resetState();
+		Send(board_id, board_addr(pad), (char *) query.c_str(), query.length(), NLend);
+		saveState("Send", GPIB_CNT_BYTES_WRITTEN, query.c_str(), query.length());
+		if (dev_ibsta & ERR)
+		{
+			r.time = gpibClock();
+			r.ibsta = dev_ibsta;
+			r.iberr = dev_iberr;
+			hs488Fallback(&one);
+			return;
+		}
+	}
+	
+	resetState();
+	Receive(board_id, board_addr(pad), rd_buffer, RD_BUFFER_SIZE, STOPend);
+	saveState("Receive", GPIB_CNT_BYTES_READ, rd_buffer);
+	r.time = gpibClock();
+	r.ibsta = dev_ibsta;
+	if (dev_ibsta & ERR)
+	{
+		r.iberr = dev_iberr;
+		hs488Fallback(&one);
+	}
+	else
+		r.data = string(rd_buffer, dev_ibcnt);
+}
+
+
+/**
+ * Take a synchronized snapshot of a group of devices: trigger them all with
+ * one Group Execute Trigger, then read their measurements back to back,
+ * after sending them query if not empty (e.g. "FETCH?"). Return the time
+ * of the trigger (gpibClock(), ns), the replies are in the order of pads.
+ * Only the trigger failure is thrown, read errors are in the replies.
+ */
+long long gpibBoard::snapshotGroup(const vector<int> &pads, const string &query,
+                                   vector<gpibReply> &replies)
+{
+	triggerList(pads);
+	long long t = gpibClock();
+	
+	replies.resize(pads.size());
+	for (unsigned int i = 0; i < pads.size(); i++)
+		readReply(pads[i], query, replies[i]);
+	return t;
+}
+
+
+/**
+ * Send the same query to a list of devices and read their replies, device
+ * after device, with Send/Receive on the board: no device handle is
+ * needed. The replies are in the order of pads; errors are in the replies
+ * and do not stop the next devices.
+ */
+void gpibBoard::writeReadMany(const vector<int> &pads, const string &query,
+                              vector<gpibReply> &replies)
+{
+	checkPads(pads);
+	claimBus();
+	replies.resize(pads.size());
+	for (unsigned int i = 0; i < pads.size(); i++)
+		readReply(pads[i], query, replies[i]);
+}
+
+
+/**
+ * Find the listeners of a list of primary addresses with FindLstn. As with
+ * the driver, a primary address without listener has its secondary
+ * addresses tested.
+ */
+void gpibBoard::findListeners(const vector<int> &scan, vector<int> &found)
+{
+	vector<Addr4882_t> addrs;
+	vector<Addr4882_t> result(scan.size() * 32);
+	
+	board_addr_list(scan, addrs);
+	claimBus();
+	resetState();
+	FindLstn(board_id, &addrs[0], &result[0], result.size());
+	saveState("FindLstn", -1, &result[0], dev_ibcnt * sizeof(Addr4882_t));
+	if (dev_ibsta & ERR)
+	{
+		throw gpibDeviceException(device_name, "Error occurs with FindLstn on GPIB ", iberrToString(), ibstaToString(), getiberr(),getibsta() );
+	}
+	found.clear();
+	for (unsigned int i = 0; i < dev_ibcnt; i++)
+		found.push_back(GPIB_ADDR(GetPAD(result[i]), GetSAD(result[i])));
+}
+
+
+/**
+ * Find the secondary addresses of a primary address which listen, with one
+ * ibln per secondary address: FindLstn only takes primary addresses. A
+ * device without secondary addressing ignores the MSA and answers on all of
+ * them: none is then returned.
+ */
+void gpibBoard::findSecondaries(int pad, vector<int> &found)
+{
+	vector<int> listeners;
+	
+	claimBus();
+	for (int sad = MIN_SAD; sad <= MAX_SAD; sad++)
+	{
+		short listen = 0;
+		
+		resetState();
+		ibln(board_id, pad, sad, &listen);
+		saveState("ibln", -1, &listen, sizeof(listen));
+		if (dev_ibsta & ERR)
+		{
+			throw gpibDeviceException(device_name, "Error occurs with ibln on GPIB ", iberrToString(), ibstaToString(), getiberr(),getibsta() );
+		}
+		if (listen)
+			listeners.push_back(GPIB_ADDR(pad, sad));
+	}
+	if (listeners.size() < (unsigned int) (MAX_SAD - MIN_SAD + 1))
+		found.insert(found.end(), listeners.begin(), listeners.end());
+}
+
+
+static bool addr_before(int a, int b)
+{
+	if (GPIB_ADDR_PAD(a) != GPIB_ADDR_PAD(b))
+		return GPIB_ADDR_PAD(a) < GPIB_ADDR_PAD(b);
+	return GPIB_ADDR_SAD(a) < GPIB_ADDR_SAD(b);
+}
+
+
 /**
  * Get a list of devices connected on the bus.
  * This method returns a reference on vector of gpibDeviceInfo, containing 
  * information on all gpibDevice found on the gpib bus. The referenced variable
  * is  just below. Provided info are device *IDN string, primary address,
  * secondary address. See gpibDeviceInfo for more information on these fields.
+ * With secondaries, the secondary addresses of the devices answering on
+ * their primary address are probed too (mainframes with modules in
+ * slots), with ibln.
  * Board must be CIC to perform FindLstn !
  */
-vector<gpibDeviceInfo>& gpibBoard::getConnectedDeviceList()
+vector<gpibDeviceInfo>& gpibBoard::getConnectedDeviceList(bool secondaries)
 {
 	char idn_buffer[MAX_DEV_IDN_STR];
-	int loop, nb_listener;
-	Addr4882_t scanlist[MAX_DEV_ON_BOARD+1]; // +1 for terminal NOADDR
-	Addr4882_t result[MAX_DEV_ON_BOARD];
+	unsigned int loop;
+	vector<int> scanlist;
+	vector<int> result;
 	
 	inf.clear(); // Empty vector first.
-	// Build address list to scan, add NOADDR list terminator
-	for (loop = 0; loop < MAX_DEV_ON_BOARD; loop++)
-		scanlist[loop] = loop;
-	scanlist[MAX_DEV_ON_BOARD] = NOADDR;
-	
-	resetState();
-	
-	FindLstn(board_id, scanlist, result, MAX_DEV_ON_BOARD);
-	saveState();
+	// Build address list to scan.
+	for (int pad = 0; pad < MAX_DEV_ON_BOARD; pad++)
+		scanlist.push_back(pad);
+	findListeners(scanlist, result);
 	
-	if (dev_ibsta & ERR)
+	if ( secondaries && (result.size() > 1) )
 	{
-		throw gpibDeviceException(device_name, "Error occurs with FindLstn on GPIB ", iberrToString(), ibstaToString(), getiberr(),getibsta() );
+		vector<int> more;
+		
+		for (loop = 1; loop < result.size(); loop++)
+		{
+			if (GPIB_ADDR_SAD(result[loop]) == 0)
+				findSecondaries(GPIB_ADDR_PAD(result[loop]), more);
+		}
+		if (more.size() != 0)
+		{
+			result.insert(result.end(), more.begin(), more.end());
+			sort(result.begin() + 1, result.end(), addr_before);
+			result.erase(unique(result.begin() + 1, result.end()), result.end());
+		}
 	}
 	
-	nb_listener = dev_ibcnt -1;//-1; MODIF
 	// Start from 1 to avoid gpib board 0 who does not answer to "*IDN?"
-	for (loop = 1; loop <= nb_listener; loop++ )
+	for (loop = 1; loop < result.size(); loop++ )
 	{
-		gpibDeviceInfo *t = new gpibDeviceInfo();
+		gpibDeviceInfo t;
 		
-		t->dev_pad = GetPAD( result[loop] );
-		t->dev_sad = GetSAD( result[loop] );
-		t->dev_idn = "Device does not support *IDN? command.\n";
+		t.dev_pad = GPIB_ADDR_PAD( result[loop] );
+		t.dev_sad = GPIB_ADDR_SAD( result[loop] );
+		t.dev_idn = "Device does not support *IDN? command.\n";
 		
 		resetState();
-		Send(board_id, result[loop],(char *)"*IDN?", 5L, NLend);
-		saveState();
+		Send(board_id, board_addr(result[loop]),(char *)"*IDN?", 5L, NLend);
+		saveState("Send", GPIB_CNT_BYTES_WRITTEN, "*IDN?", 5);
 		if (! (dev_ibsta & ERR) )
 		{
 			memset(idn_buffer,0, MAX_DEV_IDN_STR);
-			Receive(board_id, result[loop], idn_buffer, MAX_DEV_IDN_STR, STOPend);
+			resetState();
+			Receive(board_id, board_addr(result[loop]), idn_buffer, MAX_DEV_IDN_STR - 1, STOPend);
+			saveState("Receive", GPIB_CNT_BYTES_READ, idn_buffer);
 			// Most of gpib device understand '*IDN?' command, and return
 			// a string of identification. Some old device does not implement
 			// this command, like Tektronik 2440 who implements his own ID
@@ -965,12 +2230,12 @@ vector<gpibDeviceInfo>& gpibBoard::getConnectedDeviceList()
 			// as bad command. Thats why if a device returns an ID string < 5
 			// bytes, or finish in Time Out error, we admit that it does not
 			// implement command.
-			if ( (!(dev_ibsta & ERR)) && (ibcnt > 5) ) // Ibcnt = nb of byte received.
+			if ( (!(dev_ibsta & ERR)) && (dev_ibcnt > 5) ) // Ibcnt = nb of byte received.
 			{
-				t->dev_idn = idn_buffer;
+				t.dev_idn = idn_buffer;
 			}
 		}
-		inf.push_back( *t );
+		inf.push_back( t );
 	}
 	return inf;
 }
@@ -4,6 +4,9 @@
 #include <string>
 #include <vector>
 #include "gpibDeviceException.h"
+#include "gpibStats.h"
+#include "gpibTrace.h"
+#include "gpibMonitor.h"
 
 /**
  * Device's default size buffer for read operations.
@@ -21,6 +24,50 @@
  */
 #define MAX_DEV_ON_BOARD 16
 
+/**
+ * Highest primary address of a device.
+ */
+#define MAX_PAD          30
+
+/**
+ * Secondary addresses, driver convention: 0 = none, else MIN_SAD to MAX_SAD
+ * (secondary address 0 to 30).
+ */
+#define MIN_SAD          0x60
+#define MAX_SAD          0x7e
+
+/**
+ * Device address of the group operations and of the bus scan: primary
+ * address in the low byte, secondary address (0 = none) in the next one,
+ * as a NI-488.2 Addr4882_t.
+ */
+#define GPIB_ADDR(pad, sad)  ((pad) | ((sad) << 8))
+#define GPIB_ADDR_PAD(addr)  ((addr) & 0xff)
+#define GPIB_ADDR_SAD(addr)  (((addr) >> 8) & 0xff)
+
+/**
+ * Maximum number of devices of a group operation (gpibBoard::triggerList
+ * ...): every primary address with all its secondary addresses.
+ */
+#define MAX_GROUP_SIZE   (MAX_PAD * 32)
+
+/**
+ * Longest bus cable of HS488 (gpibBoard::setHS488), meters.
+ */
+#define MAX_HS488_CABLE  15
+
+/**
+ * Largest transfer of the HS488 test (gpibBoard::testHS488), bytes.
+ */
+#define MAX_SPEED_TEST   (16 * 1024 * 1024)
+
+/**
+ * IbcTIMING values: T1 delay of the board as talker.
+ */
+#define GPIB_T1_2000NS   1
+#define GPIB_T1_500NS    2
+#define GPIB_T1_350NS    3
+
 /**
  * Maximum size of string received, when identifying devices connected on
  * the bus.( string return by device in answer to "*IDN?"
@@ -38,6 +85,15 @@
  */
 #define GPIB_NB_CONF_OPT          34
 
+/**
+ * Defined when the driver keeps iberr, ibsta and ibcntl per thread
+ * (ThreadIberr, ThreadIbsta, ThreadIbcntl). gpibDevice objects can then be
+ * used from several threads at the same time.
+ */
+#if defined(WIN32) || defined(GPIB_SIM) || (defined(linux) && !defined(BCU))
+#define GPIB_THREAD_STATUS
+#endif
+
 
 
 using namespace std;
@@ -50,6 +106,13 @@ enum GpibProbeMethod
 };
 
 
+/**
+ * Board whose HS488 was disabled after a transfer error of the calling
+ * thread (gpibDevice::hs488Fallback) since the previous call, -1 if none.
+ */
+int gpibHS488Fallback(void);
+
+
 /**
  * This class is designed to handle gpibDevices. It's point of
  * view is very device oriented: For example, setting device in remote mode, 
@@ -73,8 +136,8 @@ public:
 
 	gpibDevice(string dev_name ,string boardname);  // class constructor.
 	gpibDevice(string dev_name);                    // class constructor.
-	gpibDevice(int primary_add, string boardname);  // class constructor.
-	gpibDevice(int primary_add);                    // class constructor.
+	gpibDevice(int primary_add, string boardname, int secondary_add = 0); // class constructor.
+	gpibDevice(int primary_add, int secondary_add = 0);                   // class constructor.
 	
 	string ibstaToString(void); // Get string from ibsta string.
 	string iberrToString(void); // Get string from iberr string.
@@ -82,6 +145,7 @@ public:
 	int getibsta(void);  // Get device ibsta value.
 	int getDeviceID(void);  // Get internal device ID.
 	int getDeviceAddr(void); // Get device gpib address;
+	int getDeviceSecondaryAddr(void); // Get device secondary address (0 = none).
 	unsigned int getibcnt(void); // Get device ibsta value.
 	void clear(void);  // Clear the gpib device.
 	void config(int opt,int v); // Send a ibconfig request. (= set config)
@@ -97,15 +161,33 @@ public:
 	string getName(void);  // Return device name. Provided by constructor.
 	void goToLocalMode(void); // Device goes to local mode(opp to remote mode).
 	void setTimeOut(int tmo); // Set Device Time out.
+	void setEOS(int v);   // Set Device end-of-string mode (ibeos).
+	void setEOT(int v);   // Set Device EOI on last written byte (IbcEOT).
 	void goToRemoteMode(void); // Device goes to remote mode(opp to local mode).
 	short isAlive(void);  // Check the presence of the device on the bus.
+	GpibProbeMethod getProbeMethod(void); // Get the method used by isAlive().
+	void setProbeMethod(GpibProbeMethod); // Preset isAlive() method (e.g cached).
 	char* receiveData(long count); // Read binary data from a GPIB device
 	void sendData(const char *, long count); // Write binary data on a GPIB device
+	void ppollConfig(int line, int sense); // Answer parallel polls on a data line.
+	void ppollUnconfig(void); // Stop answering parallel polls.
+	void setLatency(gpibLatency *); // Record I/O durations in histograms.
+	void setCounters(gpibCounters *); // Count transfers and errors.
+	void setRequestStart(long long t); // Start of the request (trace wait).
+	void setStickyAddressing(bool on); // Stay addressed between transfers.
+	bool getStickyAddressing(void);
 	
 protected:
 
-	void saveState(void);  // save iberr/ibstat in dev_ibsta/dev_iberr.
+	// save iberr/ibstat in dev_ibsta/dev_iberr, record the call data (len -1: ibcnt).
+	void saveState(const char *call, int bytes = -1, const void *data = NULL, long len = -1);
 	void resetState(void);  // reset iberr/ibstat in dev_ibsta/dev_iberr.
+	void readState(void);   // save iberr/ibstat only, the call is not counted.
+	void record(int op, long long t0); // Record the duration of an operation.
+	void count(gpibCounters *c, int bytes); // Update counters after a call.
+	bool hs488Fallback(const vector<int> *pads = NULL); // Standard handshake after a transfer error.
+	void config(int ud, int opt, int v); // ibconfig on the device or board handle.
+	short getconfig(int ud, short opt);  // ibask on the device or board handle.
 	
 	/**
 	 * Internal gpib handler.
@@ -117,6 +199,11 @@ protected:
 	 */
 	int devAddr;
 	
+	/**
+	 * gpib SAD (0 = none, else MIN_SAD to MAX_SAD).
+	 */
+	int devSad;
+	
 	/**
 	 * Internal gpib ibsta copy.
 	 */
@@ -147,14 +234,65 @@ protected:
 	 */
 	short alive;
 	
+	/**
+	 * Latency histograms, owned by the caller (may be NULL).
+	 */
+	gpibLatency *latency;
+	
+	/**
+	 * Device counters, owned by the caller (may be NULL).
+	 */
+	gpibCounters *counters;
+	
+	/**
+	 * Counters of the board (gpibBoardCounters), NULL until it is known.
+	 */
+	gpibCounters *board_counters;
+	
+	/**
+	 * Board index of the counters and of the flight recorder events.
+	 */
+	int bus_board;
+	
+	/**
+	 * gpibClock() at resetState(), start of the driver call.
+	 */
+	long long call_start;
+	
+	/**
+	 * Start of the request or end of its previous driver call, 0 if
+	 * unknown (see setRequestStart).
+	 */
+	long long request_mark;
+	
 private:
 
 	void findIsAliveMethod(void);
+	void probe(void);
+	void claimBus(void);     // Unaddress the device left addressed by another one.
+	void unaddressBus(void); // Send UNT UNL.
 	/**
 	 * This is the gpib board, where our device is connected to.
 	 */
 	int             gpib_board;
 	GpibProbeMethod probe_method;
+	
+	/**
+	 * False while probe_method is a preset value which has not been
+	 * confirmed by a successful isAlive() on this hardware yet.
+	 */
+	bool            probe_confirmed;
+	
+	/**
+	 * Sticky addressing: IbcUnAddr is off, the device stays addressed
+	 * until another device of the board makes a transfer.
+	 */
+	bool            sticky;
+	
+	/**
+	 * IbcUnAddr setting before sticky addressing was enabled.
+	 */
+	int             unaddr_saved;
 };
 
 /**
@@ -183,6 +321,98 @@ public:
 };
 
 
+/**
+ * This class is the reply of a device to a board group operation
+ * (see gpibBoard::snapshotGroup). No methods are implemented.
+ */
+
+class gpibReply {
+
+public:
+	/**
+	* Primary address of the device.
+	*/
+	int pad;
+	
+	/**
+	* Secondary address of the device, 0 = none.
+	*/
+	int sad;
+	
+	/**
+	* Bytes read, empty on error.
+	*/
+	string data;
+	
+	/**
+	* gpibClock() when the reply has been read, ns.
+	*/
+	long long time;
+	
+	/**
+	* ibsta and iberr of the failed call, iberr = -1 on success.
+	*/
+	int ibsta;
+	int iberr;
+};
+
+
+/**
+ * This class is the result of the HS488 test (see gpibBoard::testHS488).
+ * No methods are implemented.
+ */
+
+class gpibSpeedTest {
+
+public:
+	/**
+	* Bytes read by each transfer.
+	*/
+	long bytes;
+	
+	/**
+	* Transfer rates with standard and HS488 handshake, bytes/s
+	* (hs488 = 0 when it failed).
+	*/
+	double standard;
+	double hs488;
+	
+	/**
+	* True if HS488 failed and has been disabled, iberr of the failed
+	* transfer (-1 if it only read a wrong number of bytes).
+	*/
+	bool fallback;
+	int  iberr;
+};
+
+
+/**
+ * This class is the result of one board configuration of the bus tuning
+ * (see gpibBoard::tuneBus). No methods are implemented.
+ */
+
+class gpibTuneResult {
+
+public:
+	/**
+	* IbcTIMING and IbcDMA values.
+	*/
+	int timing;
+	int dma;
+	
+	/**
+	* Time of all the transfers, ns.
+	*/
+	long long ns;
+	
+	/**
+	* False if the board refused the setting, or a transfer failed or
+	* returned another reply than with the default setting.
+	*/
+	bool ok;
+};
+
+
 /**
  * This class is designed to handle gpibBoards. gpidBoard can be
  * seen as gpibDevice with more feature that's why this class inherits from
@@ -198,7 +428,7 @@ public:
 	gpibBoard(string board); // Constructor for specified board.
 	~gpibBoard(void);  // Classs destructor.
 	
-	vector<gpibDeviceInfo>& getConnectedDeviceList();
+	vector<gpibDeviceInfo>& getConnectedDeviceList(bool secondaries = false);
 	// NI-488.2 methods call.
 	void sendIFC(void);  // Send GPIB Interface Clear  (Board command).
 	
@@ -208,9 +438,43 @@ public:
 	void clr(int dev);  // Clear specified device. (Board command).
 	int  getBoardInd(void);         // Get Board Index (0,1,2,...)
 	
+	// Group operations on a list of addresses (GPIB_ADDR).
+	void triggerList(const vector<int> &pads);  // Group Execute Trigger.
+	long long snapshotGroup(const vector<int> &pads, const string &query,
+	                        vector<gpibReply> &replies); // Trigger, then read all.
+	int writeMany(const vector<int> &pads, const string &data); // Write to all at once.
+	void writeReadMany(const vector<int> &pads, const string &query,
+	                   vector<gpibReply> &replies); // Same query to each device.
+	void serialPollAll(const vector<int> &pads, vector<int> &status); // Status bytes.
+	int parallelPoll(void); // Parallel poll response byte (Board command).
+	
+	// HS488 high speed handshake.
+	void setHS488(int cable_length); // 0 = standard handshake.
+	int getHS488(void);
+	void testHS488(int pad, const string &query, long size, int cable_length,
+	               gpibSpeedTest &result); // Enable HS488 if the device follows.
+	void setTiming(int timing); // T1 delay, GPIB_T1_xxx (IbcTIMING).
+	void setDMA(int on); // DMA transfers (IbcDMA).
+	int tuneBus(const vector<int> &pads, const string &query, int repeat,
+	            vector<gpibTuneResult> &results); // Fastest safe timing/DMA.
+	
+	// Passive bus monitor, on a spare board of the bus.
+	void setListenOnly(bool on); // Listen-only mode (IbcLON).
+	long monitorRead(gpibBusCycle *cycles, long max); // Bytes seen, 0 if idle.
+	
 private:
 
+	void checkPads(const vector<int> &pads);  // Throw if a list is not valid.
+	void findListeners(const vector<int> &scan, vector<int> &found); // FindLstn.
+	void findSecondaries(int pad, vector<int> &found); // ibln on each SAD.
+	void readReply(int pad, const string &query, gpibReply &r); // Query one device.
+	long timedRead(int pad, const string &query, char *buffer, long size,
+	               long long &ns); // Query, read size bytes, -1 on error.
+	void clearPad(int pad); // Device clear after a failed transfer.
+	void claimBus(void); // Unaddress the device left addressed, before a bus operation.
+
 	int board_id;          // Board number.
+	int sc_saved;          // IbcSC before listen-only mode, -1 = not changed.
 	vector<gpibDeviceInfo> inf;
 };
 
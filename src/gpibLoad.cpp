@@ -0,0 +1,310 @@
+/*
+ * End-to-end load generator for GpibDeviceServer.
+ *
+ * Starts N client threads, each with its own DeviceProxy, which call one
+ * command (WriteRead, Read or ReceiveBinData) in a loop for a fixed time.
+ * Client count and payload size are swept, and for each step the tool
+ * prints the throughput and the p50/p99/p999 latency of the calls.
+ * Clients are spread round-robin over the devices given on the command
+ * line: with devices of one server, the effect of the server serialization
+ * model (Tango::BY_CLASS, see main.cpp) shows in the numbers.
+ *
+ * Typical run against the simulated driver (make linux=1 SIM=1 all load),
+ * with devices opened on a fill mode instrument (see gpibSim.conf):
+ *
+ *   GPIBSIM_CONFIG=gpibSim.conf GpibDeviceServer sim &
+ *   gpibLoad -c 1,4,16,64 -s 8,64,512 -d 5 sim/gpib/load
+ *
+ * Before each step, "SIM:FILL <size>" is written to the devices, so that
+ * simulated instruments answer with <size> bytes (use -n with a real one).
+ */
+
+#include <tango.h>
+#include <iostream>
+#include <iomanip>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+using namespace std;
+
+static double load_now_ns(void)
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+/*
+ * Start line shared by the clients of a step: clients get ready (proxy
+ * built, first call done), then all start when the main thread says so.
+ */
+struct LoadStep
+{
+	LoadStep() : cond(&mutex), ready(0), started(false), deadline(0) {}
+
+	omni_mutex     mutex;
+	omni_condition cond;
+	int            ready;
+	bool           started;
+	double         deadline;
+};
+
+/*
+ * Results of one client. Kept out of the thread object, which is deleted
+ * by join().
+ */
+struct LoadResult
+{
+	LoadResult() : errors(0), bytes(0) {}
+
+	vector<double>  latencies;	// ns, one per successful call
+	long            errors;
+	double          bytes;
+	string          last_error;
+};
+
+class LoadClient : public omni_thread
+{
+public:
+	LoadClient(LoadStep *st, LoadResult *res, const string &dev, const string &cmd, long sz)
+		: step(st), result(res), device(dev), command(cmd), size(sz) {}
+
+	void *run_undetached(void *);
+	void call(Tango::DeviceProxy &proxy);
+
+	LoadStep       *step;
+	LoadResult     *result;
+	string          device;
+	string          command;
+	long            size;
+};
+
+void LoadClient::call(Tango::DeviceProxy &proxy)
+{
+	Tango::DeviceData din, dout;
+
+	if (command == "WriteRead")
+	{
+		string q(size, 'q'), a;
+		din << q;
+		dout = proxy.command_inout("WriteRead", din);
+		dout >> a;
+		result->bytes += q.length() + a.length();
+	}
+	else if (command == "Read")
+	{
+		string a;
+		dout = proxy.command_inout("Read");
+		dout >> a;
+		result->bytes += a.length();
+	}
+	else
+	{
+		const Tango::DevVarCharArray *a;
+		din << (Tango::DevLong) size;
+		dout = proxy.command_inout("ReceiveBinData", din);
+		dout >> a;
+		result->bytes += a->length();
+	}
+}
+
+void *LoadClient::run_undetached(void *)
+{
+	Tango::DeviceProxy *proxy = NULL;
+	try
+	{
+		proxy = new Tango::DeviceProxy(device);
+		call(*proxy);	// Warm up: connection and first call
+		result->bytes = 0;
+	}
+	catch (Tango::DevFailed &e)
+	{
+		result->errors++;
+		result->last_error = string(e.errors[0].desc.in());
+	}
+
+	{
+		omni_mutex_lock lock(step->mutex);
+		step->ready++;
+		step->cond.broadcast();
+		while (!step->started)
+			step->cond.wait();
+	}
+
+	while ( (proxy != NULL) && (load_now_ns() < step->deadline) )
+	{
+		double t0 = load_now_ns();
+		try
+		{
+			call(*proxy);
+			result->latencies.push_back(load_now_ns() - t0);
+		}
+		catch (Tango::DevFailed &e)
+		{
+			result->errors++;
+			result->last_error = string(e.errors[0].desc.in());
+		}
+	}
+	delete proxy;
+	return NULL;
+}
+
+static vector<long> load_list(const char *s)
+{
+	vector<long> v;
+	istringstream in(s);
+	string        tok;
+	while (getline(in, tok, ','))
+		v.push_back(atol(tok.c_str()));
+	return v;
+}
+
+static double load_percentile(const vector<double> &v, double p)
+{
+	if (v.empty())
+		return 0.0;
+	unsigned long i = (unsigned long) (p * (v.size() - 1) + 0.5);
+	return v[i];
+}
+
+static void usage(const char *prog)
+{
+	cerr << "usage: " << prog << " [-c <clients,...>] [-s <sizes,...>] [-d <seconds>]" << endl
+	     << "       [-x WriteRead|Read|ReceiveBinData] [-n] <device> [<device> ...]" << endl
+	     << "  -c  client counts (default 1,2,4,8,16,32,64)" << endl
+	     << "  -s  payload sizes in bytes (default 8,64,512)" << endl
+	     << "  -d  duration of each step (default 3 s)" << endl
+	     << "  -x  command to run, may be repeated (default all three)" << endl
+	     << "  -n  do not send SIM:FILL to the devices (real instruments)" << endl;
+	exit(1);
+}
+
+int main(int argc, char *argv[])
+{
+	vector<long>   clients = load_list("1,2,4,8,16,32,64");
+	vector<long>   sizes = load_list("8,64,512");
+	vector<string> commands;
+	vector<string> devices;
+	double         duration = 3.0;
+	bool           sim_fill = true;
+
+	for (int i = 1; i < argc; i++)
+	{
+		if ( (strcmp(argv[i], "-c") == 0) && (i + 1 < argc) )
+			clients = load_list(argv[++i]);
+		else if ( (strcmp(argv[i], "-s") == 0) && (i + 1 < argc) )
+			sizes = load_list(argv[++i]);
+		else if ( (strcmp(argv[i], "-d") == 0) && (i + 1 < argc) )
+			duration = atof(argv[++i]);
+		else if ( (strcmp(argv[i], "-x") == 0) && (i + 1 < argc) )
+			commands.push_back(argv[++i]);
+		else if (strcmp(argv[i], "-n") == 0)
+			sim_fill = false;
+		else if (argv[i][0] == '-')
+			usage(argv[0]);
+		else
+			devices.push_back(argv[i]);
+	}
+	if (devices.empty())
+		usage(argv[0]);
+	if (commands.empty())
+	{
+		commands.push_back("WriteRead");
+		commands.push_back("Read");
+		commands.push_back("ReceiveBinData");
+	}
+	for (unsigned int k = 0; k < commands.size(); k++)
+	{
+		if ( (commands[k] != "WriteRead") && (commands[k] != "Read") && (commands[k] != "ReceiveBinData") )
+			usage(argv[0]);
+	}
+
+	for (unsigned int k = 0; k < commands.size(); k++)
+	{
+		cout << endl << commands[k] << " on " << devices.size() << " device(s), "
+		     << duration << " s per step" << endl;
+		cout << setw(8) << "clients" << setw(9) << "size" << setw(11) << "calls/s"
+		     << setw(10) << "MB/s" << setw(11) << "p50 us" << setw(11) << "p99 us"
+		     << setw(11) << "p999 us" << setw(9) << "errors" << endl;
+
+		for (unsigned int si = 0; si < sizes.size(); si++)
+		{
+			if (sim_fill)
+			{
+				for (unsigned int d = 0; d < devices.size(); d++)
+				{
+					try
+					{
+						Tango::DeviceProxy proxy(devices[d]);
+						Tango::DeviceData  din;
+						ostringstream      os;
+						os << "SIM:FILL " << sizes[si];
+						din << os.str();
+						proxy.command_inout("Write", din);
+					}
+					catch (Tango::DevFailed &e)
+					{
+						Tango::Except::print_exception(e);
+						return 1;
+					}
+				}
+			}
+
+			for (unsigned int ci = 0; ci < clients.size(); ci++)
+			{
+				LoadStep             step;
+				vector<LoadResult>   results(clients[ci]);
+				vector<LoadClient *> threads;
+
+				for (long c = 0; c < clients[ci]; c++)
+				{
+					LoadClient *t = new LoadClient(&step, &results[c], devices[c % devices.size()],
+					                               commands[k], sizes[si]);
+					threads.push_back(t);
+					t->start_undetached();
+				}
+
+				{
+					omni_mutex_lock lock(step.mutex);
+					while (step.ready < clients[ci])
+						step.cond.wait();
+					step.deadline = load_now_ns() + duration * 1e9;
+					step.started = true;
+					step.cond.broadcast();
+				}
+
+				vector<double> all;
+				long           errors = 0;
+				double         bytes = 0;
+				string         last_error;
+				for (unsigned int t = 0; t < threads.size(); t++)
+				{
+					threads[t]->join(NULL);
+					LoadResult &r = results[t];
+					all.insert(all.end(), r.latencies.begin(), r.latencies.end());
+					errors += r.errors;
+					bytes += r.bytes;
+					if (r.last_error.length() > 0)
+						last_error = r.last_error;
+				}
+				sort(all.begin(), all.end());
+
+				cout << setw(8) << clients[ci] << setw(9) << sizes[si]
+				     << fixed << setprecision(0) << setw(11) << all.size() / duration
+				     << setprecision(2) << setw(10) << bytes / duration / 1e6
+				     << setprecision(0) << setw(11) << load_percentile(all, 0.50) / 1e3
+				     << setw(11) << load_percentile(all, 0.99) / 1e3
+				     << setw(11) << load_percentile(all, 0.999) / 1e3
+				     << setw(9) << errors << endl;
+				if (errors > 0)
+					cout << "         last error: " << last_error << endl;
+			}
+		}
+	}
+	return 0;
+}
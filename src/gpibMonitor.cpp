@@ -0,0 +1,242 @@
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <string.h>
+#include "gpibMonitor.h"
+
+/**
+ * Multiline commands (IEEE 488.1) and their address groups.
+ */
+#define CMD_GTL     0x01
+#define CMD_SDC     0x04
+#define CMD_PPC     0x05
+#define CMD_GET     0x08
+#define CMD_TCT     0x09
+#define CMD_LLO     0x11
+#define CMD_DCL     0x14
+#define CMD_PPU     0x15
+#define CMD_SPE     0x18
+#define CMD_SPD     0x19
+#define CMD_LAG     0x20    // Listen address group, 0x20-0x3e.
+#define CMD_UNL     0x3f
+#define CMD_TAG     0x40    // Talk address group, 0x40-0x5e.
+#define CMD_UNT     0x5f
+#define CMD_SCG     0x60    // Secondary command group, 0x60-0x7f.
+
+
+gpibMonitor::gpibMonitor()
+{
+	reset();
+}
+
+
+void gpibMonitor::reset()
+{
+	head = 0;
+	talker = -1;
+	listeners = 0;
+	last_cycle = 0;
+	start = 0;
+	data_bytes = 0;
+	command_bytes = 0;
+	period_start = 0;
+	busy = 0;
+	period_data = 0;
+	memset(talker_bytes, 0, sizeof(talker_bytes));
+	memset(listener_bytes, 0, sizeof(listener_bytes));
+	utilization = 0.0;
+	data_rate = 0.0;
+	for (int a = 0; a < GPIB_MONITOR_ADDRS; a++)
+	{
+		talker_rate[a] = 0.0;
+		listener_rate[a] = 0.0;
+	}
+}
+
+
+/**
+ * The rates of the period are divided by its actual length: a period
+ * without any call of add() is averaged with the next one.
+ */
+void gpibMonitor::closePeriod(long long now)
+{
+	double s = (double) (now - period_start) / 1e9;
+
+	utilization = (double) busy / (double) (now - period_start);
+	if (utilization > 1.0)
+		utilization = 1.0;
+	data_rate = (double) period_data / s;
+	for (int a = 0; a < GPIB_MONITOR_ADDRS; a++)
+	{
+		talker_rate[a] = (double) talker_bytes[a] / s;
+		listener_rate[a] = (double) listener_bytes[a] / s;
+	}
+
+	period_start = now;
+	busy = 0;
+	period_data = 0;
+	memset(talker_bytes, 0, sizeof(talker_bytes));
+	memset(listener_bytes, 0, sizeof(listener_bytes));
+}
+
+
+void gpibMonitor::add(gpibBusCycle *cycles, long n, long long now)
+{
+	if (start == 0)
+	{
+		start = now;
+		period_start = now;
+	}
+
+	for (long i = 0; i < n; i++)
+	{
+		gpibBusCycle &c = cycles[i];
+
+		if ( (last_cycle != 0) && (c.time > last_cycle) && (c.time - last_cycle < GPIB_MONITOR_IDLE_NS) )
+			busy += c.time - last_cycle;
+		last_cycle = c.time;
+
+		if (c.flags & GPIB_MONITOR_ATN)
+		{
+			command_bytes++;
+			unsigned char b = c.byte & 0x7f;	// DIO8 is not used by commands.
+			if (b == CMD_UNL)
+				listeners = 0;
+			else if ( (b >= CMD_LAG) && (b < CMD_UNL) )
+				listeners |= 1u << (b - CMD_LAG);
+			else if (b == CMD_UNT)
+				talker = -1;
+			else if ( (b >= CMD_TAG) && (b < CMD_UNT) )
+				talker = b - CMD_TAG;
+		}
+		else
+		{
+			data_bytes++;
+			period_data++;
+			talker_bytes[(talker < 0) ? GPIB_MONITOR_UNKNOWN : talker]++;
+			if (listeners == 0)
+				listener_bytes[GPIB_MONITOR_UNKNOWN]++;
+			for (int a = 0; a < GPIB_MONITOR_UNKNOWN; a++)
+				if (listeners & (1u << a))
+					listener_bytes[a]++;
+		}
+		c.talker = (signed char) talker;
+		c.listeners = listeners;
+		ring[head & (GPIB_MONITOR_CYCLES - 1)] = c;
+		head++;
+	}
+
+	if (now - period_start >= GPIB_MONITOR_PERIOD_NS)
+		closePeriod(now);
+}
+
+
+void gpibMonitor::getStats(gpibMonitorStats &stats)
+{
+	stats.start = start;
+	stats.cycles = head;
+	stats.data_bytes = data_bytes;
+	stats.command_bytes = command_bytes;
+	stats.utilization = utilization;
+	stats.data_rate = data_rate;
+	for (int a = 0; a < GPIB_MONITOR_ADDRS; a++)
+	{
+		stats.talker_rate[a] = talker_rate[a];
+		stats.listener_rate[a] = listener_rate[a];
+	}
+}
+
+
+void gpibMonitor::getCycles(vector<gpibBusCycle> &cycles)
+{
+	unsigned long long first = (head > GPIB_MONITOR_CYCLES) ? head - GPIB_MONITOR_CYCLES : 0;
+
+	cycles.clear();
+	cycles.reserve(head - first);
+	for (unsigned long long n = first; n < head; n++)
+		cycles.push_back(ring[n & (GPIB_MONITOR_CYCLES - 1)]);
+}
+
+
+string gpibCommandName(unsigned char byte)
+{
+	ostringstream out;
+	unsigned char b = byte & 0x7f;
+
+	switch (b)
+	{
+		case CMD_GTL:	return "GTL";
+		case CMD_SDC:	return "SDC";
+		case CMD_PPC:	return "PPC";
+		case CMD_GET:	return "GET";
+		case CMD_TCT:	return "TCT";
+		case CMD_LLO:	return "LLO";
+		case CMD_DCL:	return "DCL";
+		case CMD_PPU:	return "PPU";
+		case CMD_SPE:	return "SPE";
+		case CMD_SPD:	return "SPD";
+		case CMD_UNL:	return "UNL";
+		case CMD_UNT:	return "UNT";
+		default:
+			break;
+	}
+	if ( (b >= CMD_LAG) && (b < CMD_UNL) )
+		out << "MLA" << b - CMD_LAG;
+	else if ( (b >= CMD_TAG) && (b < CMD_UNT) )
+		out << "MTA" << b - CMD_TAG;
+	else if (b >= CMD_SCG)
+		out << "MSA" << b - CMD_SCG;
+	else
+		out << "?";
+	return out.str();
+}
+
+
+long gpibMonitorDump(const string &file, const vector<gpibBusCycle> &cycles)
+{
+	ofstream out(file.c_str());
+	if (!out)
+		return -1;
+
+	long long t0 = cycles.empty() ? 0 : cycles[0].time;
+
+	out << "# time_us type byte meaning talker listeners" << endl;
+	out << fixed << setprecision(3);
+	for (unsigned long i = 0; i < cycles.size(); i++)
+	{
+		const gpibBusCycle &c = cycles[i];
+
+		out << setw(14) << (double) (c.time - t0) / 1000.0
+		    << ((c.flags & GPIB_MONITOR_ATN) ? " CMD  " : " DATA ")
+		    << hex << setw(2) << setfill('0') << (int) c.byte << dec << setfill(' ') << " ";
+		if (c.flags & GPIB_MONITOR_ATN)
+		{
+			out << gpibCommandName(c.byte) << endl;
+			continue;
+		}
+
+		if ( (c.byte >= 0x20) && (c.byte < 0x7f) )
+			out << "'" << (char) c.byte << "'";
+		else
+			out << ".";
+		if (c.flags & GPIB_MONITOR_EOI)
+			out << " EOI";
+		out << " T";
+		if (c.talker < 0)
+			out << "?";
+		else
+			out << (int) c.talker;
+		out << " L";
+		if (c.listeners == 0)
+			out << "?";
+		for (int a = 0, sep = 0; a < GPIB_MONITOR_UNKNOWN; a++)
+			if (c.listeners & (1u << a))
+				out << (sep++ ? "," : "") << a;
+		out << endl;
+	}
+
+	out.close();
+	if (!out)
+		return -1;
+	return (long) cycles.size();
+}
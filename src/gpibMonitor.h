@@ -0,0 +1,140 @@
+#ifndef _GPIBMONITOR_H
+#define _GPIBMONITOR_H
+
+#include <string>
+#include <vector>
+
+using namespace std;
+
+/**
+ * Bus cycles kept by a monitor for the capture dump (power of 2).
+ */
+#define GPIB_MONITOR_CYCLES      65536
+
+/**
+ * Per address statistics: primary addresses 0 to 30, then one entry for
+ * the bytes whose talker or listener is not known (no addressing seen).
+ */
+#define GPIB_MONITOR_ADDRS       32
+#define GPIB_MONITOR_UNKNOWN     31
+
+/**
+ * Two bus cycles less than GPIB_MONITOR_IDLE_NS apart belong to the same
+ * transfer: the bus is counted busy between them.
+ */
+#define GPIB_MONITOR_IDLE_NS     100000
+
+/**
+ * Length of the statistics periods (the rates are those of the last
+ * complete period), ns.
+ */
+#define GPIB_MONITOR_PERIOD_NS   1000000000LL
+
+/**
+ * Bytes read at once by gpibBoard::monitorRead() on a real board, and the
+ * byte time assumed to date them (the driver does not time the bytes), ns.
+ */
+#define GPIB_MONITOR_READ        1024
+#define GPIB_MONITOR_BYTE_NS     1000
+
+/**
+ * Longest wait of gpibBoard::monitorRead() for bus traffic: time out of a
+ * monitor board (T100ms), and its equivalent on the simulated driver, us.
+ */
+#define GPIB_MONITOR_TMO         9
+#define GPIB_MONITOR_WAIT_US     100000
+
+/**
+ * Flags of a bus cycle.
+ */
+#define GPIB_MONITOR_ATN         0x01   // Command byte (ATN asserted).
+#define GPIB_MONITOR_EOI         0x02   // Last data byte (EOI asserted).
+
+/**
+ * One byte seen on the bus by a listen-only board. talker and listeners
+ * are filled by gpibMonitor::add() from the addressing commands seen
+ * before the byte.
+ */
+struct gpibBusCycle
+{
+	long long     time;       // gpibClock(), ns.
+	unsigned char byte;
+	unsigned char flags;      // GPIB_MONITOR_ATN, GPIB_MONITOR_EOI.
+	signed char   talker;     // Primary address, -1 if unknown.
+	unsigned int  listeners;  // Bit n set for the listener at address n.
+};
+
+/**
+ * Bus statistics of a monitor. The rates are those of the last complete
+ * period (GPIB_MONITOR_PERIOD_NS, longer if the monitor was not fed).
+ */
+struct gpibMonitorStats
+{
+	long long          start;         // gpibClock() of the monitor start.
+	unsigned long long cycles;        // Since the start.
+	unsigned long long data_bytes;
+	unsigned long long command_bytes;
+	double             utilization;   // Busy bus time / period, 0 to 1.
+	double             data_rate;     // Data bytes/s.
+	double             talker_rate[GPIB_MONITOR_ADDRS];   // Bytes/s sent.
+	double             listener_rate[GPIB_MONITOR_ADDRS]; // Bytes/s received.
+};
+
+/**
+ * Decodes the bus cycles read by a listen-only board: the addressing
+ * commands (MTA, MLA, UNT, UNL) give the talker and the listeners of the
+ * data bytes, which are counted per address. The last GPIB_MONITOR_CYCLES
+ * cycles are kept for gpibMonitorDump(). Not thread safe: the caller
+ * serializes the calls.
+ */
+class gpibMonitor
+{
+public:
+	gpibMonitor(void);
+
+	void reset(void);
+	// Decode n cycles; now (gpibClock()) closes the period when it is over,
+	// also when n is 0 (idle bus).
+	void add(gpibBusCycle *cycles, long n, long long now);
+	void getStats(gpibMonitorStats &stats);
+	void getCycles(vector<gpibBusCycle> &cycles);  // Oldest first.
+
+private:
+	void closePeriod(long long now);
+
+	gpibBusCycle       ring[GPIB_MONITOR_CYCLES];
+	unsigned long long head;         // Cycles ever added.
+	int                talker;       // Current addressing, -1 = none.
+	unsigned int       listeners;
+	long long          last_cycle;   // Time of the last cycle, 0 = none.
+
+	long long          start;
+	unsigned long long data_bytes;
+	unsigned long long command_bytes;
+
+	long long          period_start; // Period being counted.
+	long long          busy;
+	unsigned long long talker_bytes[GPIB_MONITOR_ADDRS];
+	unsigned long long listener_bytes[GPIB_MONITOR_ADDRS];
+	unsigned long long period_data;
+
+	double             utilization;  // Last complete period.
+	double             data_rate;
+	double             talker_rate[GPIB_MONITOR_ADDRS];
+	double             listener_rate[GPIB_MONITOR_ADDRS];
+};
+
+/**
+ * Multiline message meaning of a command byte, e.g. "MTA5" or "UNL".
+ */
+string gpibCommandName(unsigned char byte);
+
+/**
+ * Write bus cycles in a text file, one per line: time (us from the first
+ * cycle), CMD or DATA, byte, meaning or character, EOI, talker and
+ * listeners of the data bytes. Return the number of cycles written, -1 if
+ * the file cannot be written.
+ */
+long gpibMonitorDump(const string &file, const vector<gpibBusCycle> &cycles);
+
+#endif /* _GPIBMONITOR_H */
@@ -0,0 +1,183 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "gpibRecorder.h"
+
+/**
+ * Driver calls, indexed by their code in the log. New calls are added at
+ * the end, so that old logs can still be read.
+ */
+static const char *record_calls[] = {
+                                        GPIB_RECORD_NAME,
+                                        "ibfind", "ibdev", "ibask", "ibconfig", "ibonl",
+                                        "ibwrt", "ibrd", "ibln", "ibclr", "ibtrg",
+                                        "ibrsp", "ibeos", "ibtmo", "ibloc", "ibsre",
+                                        "ibllo", "ibcmd", "Send", "Receive", "SendIFC",
+                                        "FindLstn", "TriggerList", "SendList", "AllSpoll",
+                                        "PPollConfig", "PPollUnconfig", "PPoll", "DevClear"
+                                    };
+#define RECORD_NB_CALLS   (int) (sizeof(record_calls) / sizeof(record_calls[0]))
+#define RECORD_UNKNOWN    0xff
+
+/**
+ * The log being written, NULL when not recording.
+ */
+static FILE *volatile record_file = NULL;
+
+/**
+ * Open the log named by GPIB_RECORD at startup, close it at exit (stdio
+ * buffers are flushed by exit() too).
+ */
+class gpibRecordStartup
+{
+public:
+	gpibRecordStartup()
+	{
+		const char *file = getenv("GPIB_RECORD");
+		if ( (file != NULL) && (*file != 0) && (gpibRecordOpen(file) != 0) )
+			fprintf(stderr, "gpibRecorder: cannot create %s, not recording.\n", file);
+	}
+	~gpibRecordStartup()
+	{
+		gpibRecordClose();
+	}
+};
+static gpibRecordStartup record_startup;
+
+
+int gpibRecordOpen(const char *file)
+{
+	gpibRecordClose();
+
+	FILE *f = fopen(file, "wb");
+	if (f == NULL)
+		return -1;
+	setvbuf(f, NULL, _IOFBF, 65536);
+	if (fwrite(GPIB_RECORD_MAGIC, 8, 1, f) != 1)
+	{
+		fclose(f);
+		return -1;
+	}
+	record_file = f;
+	return 0;
+}
+
+
+void gpibRecordClose(void)
+{
+	FILE *f = record_file;
+
+	record_file = NULL;
+	if (f != NULL)
+		fclose(f);
+}
+
+
+const char *gpibRecordCallName(int code)
+{
+	if ( (code < 0) || (code >= RECORD_NB_CALLS) )
+		return NULL;
+	return record_calls[code];
+}
+
+
+static int record_code(const char *call)
+{
+	for (int i = 0; i < RECORD_NB_CALLS; i++)
+		if (strcmp(record_calls[i], call) == 0)
+			return i;
+	return RECORD_UNKNOWN;
+}
+
+
+static void put_le(unsigned char *p, unsigned long long v, int n)
+{
+	for (int i = 0; i < n; i++, v >>= 8)
+		p[i] = (unsigned char) (v & 0xff);
+}
+
+
+static unsigned long long get_le(const unsigned char *p, int n)
+{
+	unsigned long long v = 0;
+	for (int i = n - 1; i >= 0; i--)
+		v = (v << 8) | p[i];
+	return v;
+}
+
+
+void gpibRecordCall(const char *call, long long start, long long duration,
+                    int board, int addr, unsigned long count, int ibsta, int iberr,
+                    const void *data, long len)
+{
+	FILE *f = record_file;
+	if (f == NULL)
+		return;
+
+	if ( (data == NULL) || (len < 0) )
+		len = 0;
+
+	// Small records are built on the stack.
+	unsigned char  local[GPIB_RECORD_HEADER_SIZE + 256];
+	unsigned char *rec = local;
+	if (len > 256)
+		rec = new unsigned char[GPIB_RECORD_HEADER_SIZE + len];
+
+	rec[0] = (unsigned char) record_code(call);
+	rec[1] = (unsigned char) ((board < 0) ? 0xff : board);
+	rec[2] = (unsigned char) ((addr < 0) ? 0xff : (addr & 0xff));
+	rec[3] = (unsigned char) iberr;
+	put_le(rec + 4, (unsigned int) ibsta, 2);
+	put_le(rec + 6, (addr < 0) ? 0 : (addr >> 8) & 0xff, 2);
+	put_le(rec + 8, count, 4);
+	put_le(rec + 12, (unsigned long long) start, 8);
+	put_le(rec + 20, (duration > 0) ? duration / 1000 : 0, 4);
+	put_le(rec + 24, len, 4);
+	if (len > 0)
+		memcpy(rec + GPIB_RECORD_HEADER_SIZE, data, len);
+
+	fwrite(rec, GPIB_RECORD_HEADER_SIZE + len, 1, f);
+
+	if (rec != local)
+		delete [] rec;
+}
+
+
+long gpibRecordLoad(const char *file, vector<gpibRecordEntry> &records)
+{
+	FILE *f = fopen(file, "rb");
+	char  magic[8];
+
+	records.clear();
+	if (f == NULL)
+		return -1;
+	if ( (fread(magic, 8, 1, f) != 1) || (memcmp(magic, GPIB_RECORD_MAGIC, 8) != 0) )
+	{
+		fclose(f);
+		return -1;
+	}
+
+	unsigned char   h[GPIB_RECORD_HEADER_SIZE];
+	gpibRecordEntry e;
+	while (fread(h, GPIB_RECORD_HEADER_SIZE, 1, f) == 1)
+	{
+		const char   *name = gpibRecordCallName(h[0]);
+		unsigned long len = (unsigned long) get_le(h + 24, 4);
+
+		e.call = (name != NULL) ? name : "?";
+		e.board = (h[1] == 0xff) ? -1 : h[1];
+		e.pad = (h[2] == 0xff) ? -1 : h[2];
+		e.iberr = h[3];
+		e.ibsta = (int) get_le(h + 4, 2);
+		e.sad = (int) get_le(h + 6, 2);
+		e.count = (unsigned long) get_le(h + 8, 4);
+		e.start = (long long) get_le(h + 12, 8);
+		e.duration = (long long) get_le(h + 20, 4) * 1000;
+		e.data.resize(len);
+		if ( (len > 0) && (fread(&e.data[0], len, 1, f) != 1) )
+			break;
+		records.push_back(e);
+	}
+	fclose(f);
+	return (long) records.size();
+}
@@ -0,0 +1,89 @@
+#ifndef _GPIBRECORDER_H
+#define _GPIBRECORDER_H
+
+#include <string>
+#include <vector>
+
+using namespace std;
+
+/**
+ * Bus traffic recorder: every driver call made by a gpibDevice is appended
+ * to a binary log, with its data, ibsta, iberr, ibcnt and timing. The log
+ * is opened at startup when the GPIB_RECORD environment variable names a
+ * file, or with gpibRecordOpen(). The simulated driver replays it
+ * (GPIBSIM_REPLAY, see gpibSim.cpp).
+ *
+ * File format, integers little endian:
+ *
+ *   "GPIBREC1"
+ *   records:
+ *     u8  call       index in the call table (gpibRecordCallName)
+ *     u8  board      0xff if unknown
+ *     u8  pad        0xff if unknown
+ *     u8  iberr
+ *     u16 ibsta
+ *     u16 sad        secondary address, 0 = none
+ *     u32 ibcnt
+ *     u64 start      gpibClock() before the call, ns
+ *     u32 duration   us
+ *     u32 len        followed by len data bytes
+ *
+ * The data is what the call wrote (ibwrt, Send, ibconfig option and value)
+ * or returned (ibrd, Receive, ibln, ibrsp, ibask, FindLstn, AllSpoll,
+ * PPoll), as found in memory: a log is replayed on the same architecture.
+ */
+#define GPIB_RECORD_MAGIC        "GPIBREC1"
+#define GPIB_RECORD_HEADER_SIZE  28
+
+/**
+ * Pseudo call written when a device opened by name (ibfind) gets its
+ * address: its data is the name, so that the replay can open it again.
+ */
+#define GPIB_RECORD_NAME         "name"
+
+/**
+ * One record of a log, as read by gpibRecordLoad().
+ */
+struct gpibRecordEntry
+{
+	string        call;      // Driver function, e.g. "ibwrt".
+	int           board;     // -1 if unknown.
+	int           pad;       // -1 if unknown.
+	int           sad;       // 0 = none, else 0x60 to 0x7E.
+	int           ibsta;
+	int           iberr;
+	unsigned long count;     // ibcnt.
+	long long     start;     // ns, gpibClock() of the recording process.
+	long long     duration;  // ns (us resolution).
+	string        data;
+};
+
+/**
+ * Start recording in a file (replaced), or stop it. The recording must not
+ * be started or stopped while driver calls are running. Return -1 if the
+ * file cannot be created.
+ */
+int gpibRecordOpen(const char *file);
+void gpibRecordClose(void);
+
+/**
+ * Append a driver call to the log, if recording. addr is the device address,
+ * pad + 256 * sad (GPIB_ADDR), -1 if unknown. Records are written with a
+ * single fwrite, so calls of several threads are not mixed up.
+ */
+void gpibRecordCall(const char *call, long long start, long long duration,
+                    int board, int addr, unsigned long count, int ibsta, int iberr,
+                    const void *data, long len);
+
+/**
+ * Name of a call code, NULL if out of range.
+ */
+const char *gpibRecordCallName(int code);
+
+/**
+ * Read a log. Return the number of records, -1 if the file cannot be read
+ * or is not a log (a truncated last record is ignored).
+ */
+long gpibRecordLoad(const char *file, vector<gpibRecordEntry> &records);
+
+#endif /* _GPIBRECORDER_H */
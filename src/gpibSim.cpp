@@ -0,0 +1,2164 @@
+/*
+ * Simulated GPIB driver.
+ *
+ * This file implements the NI-488 / NI-488.2 functions declared in ugpib.h
+ * for a bus of virtual instruments. It replaces the National Instruments
+ * libraries when the server is built with SIM=1 (see Makefile).
+ *
+ * Model:
+ * - Boards are addressed by their index (ibfind("gpibN") returns N), like
+ *   the ENET driver. Device handles start at SIM_FIRST_DEV_HANDLE.
+ * - Every transfer costs a handshake time (addressing) plus a time per
+ *   byte. The byte time is divided by the board IbcTIMING setting and by
+ *   4 when HS488 is enabled (IbcHSCableLength != 0). Times are multiplied
+ *   by the "scale" factor (0 = no waiting at all).
+ * - Transfers on one board are serialized, like on a real bus.
+ * - Instruments answer "*IDN?", "*STB?", "*RST", "*CLS" and
+ *   "SIM:SIZE? <n>" (next read returns <n> bytes of a printable pattern),
+ *   "SIM:FILL <n>" (fill size of the instrument, see below) and
+ *   "SIM:STATS?" (open handles, heap in use and RSS of the process),
+ *   then scripted replies, then according to their mode (echo, script,
+ *   fill).
+ * - Faults: each I/O on an instrument can fail with a timeout (TIMO,
+ *   EABO after the time out period), an immediate abort (EABO) or a
+ *   missing listener (ENOL), with configured probabilities. A powered off
+ *   instrument does not listen and does not talk. An instrument without
+ *   HS488 fails with a bus error (EBUS) while its board has HS488 enabled
+ *   (IbcHSCableLength), and an instrument slower than the board T1 delay
+ *   (IbcTIMING above its timing=<n>) times out.
+ *
+ * Configuration file (GPIBSIM_CONFIG), one statement per line, '#' starts
+ * a comment, strings are double quoted with \n \r \" \\ escapes:
+ *
+ *   latency handshake_ns=<n> byte_ns=<n> scale=<x>
+ *   seed <n>
+ *   board <index> [tap=<board>]
+ *   instrument <board> <pad>[:<sad>] [name=<ibconf name>] [idn="<idn>"]
+ *              [mode=echo|script|fill] [stb=<n>] [power=on|off]
+ *              [delay_us=<n>] [fill=<n>] [timo=<p>] [enol=<p>] [eabo=<p>]
+ *              [hs488=on|off] [timing=1|2|3]
+ *   reply <board> <pad>[:<sad>] "<query>" "<answer>"
+ *
+ * Bus monitor: a board with a tap on the bus of another board (tap=, or
+ * gpibSimSetTap) sees, while in listen-only mode (IbcLON), the bytes of
+ * the transfers of that bus: the addressing commands (UNL, MTA, MLA, MSA)
+ * and the data bytes of ibwrt, ibrd, Send and Receive, the command bytes
+ * of ibcmd. gpibSimMonitorRead() returns them with their bus time, like a
+ * bus analyzer. The last SIM_CAPTURE_CYCLES bytes not read are kept.
+ *
+ * Replay: GPIBSIM_REPLAY names a bus traffic log written by gpibDevice
+ * (GPIB_RECORD, see gpibRecorder.h), or gpibSimReplay() loads one. The
+ * boards of the log are created and its devices can be opened by address
+ * or by name. Then ibwrt, ibrd, ibln, ibrsp, ibclr, ibtrg, ibloc, ibllo,
+ * Send and Receive on an address of the log return, call after call, the
+ * recorded data, ibsta, iberr and ibcnt of the same function on the same
+ * address, primary and secondary (the sequence starts again when it is
+ * exhausted), and hold the bus for the recorded duration divided by
+ * GPIBSIM_REPLAY_SPEED (1 = original timing, 10 = ten times faster, 0 = no
+ * waiting). Other calls and addresses are simulated as usual.
+ */
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <map>
+#include <deque>
+#include <string.h>
+#include <stdlib.h>
+#include <ctype.h>
+#include <time.h>
+#include <stdio.h>
+#include <unistd.h>
+#include <malloc.h>
+#include <pthread.h>
+#include "gpibSim.h"
+#include "gpibRecorder.h"
+
+using namespace std;
+
+#define SIM_MAX_BOARDS          8
+#define SIM_FIRST_DEV_HANDLE    32
+#define SIM_MAX_HANDLES         1024
+#define SIM_CAPTURE_CYCLES      65536
+
+/*
+ * Driver globals (ugpib.h). They hold the status of the last call made by
+ * any thread; the Thread* functions give the status of the calling thread.
+ */
+int           ibsta = 0;
+int           iberr = 0;
+unsigned int  ibcnt = 0;
+long          ibcntl = 0;
+
+static __thread int  t_ibsta = 0;
+static __thread int  t_iberr = 0;
+static __thread long t_ibcntl = 0;
+
+/*
+ * Time out values in ns, indexed by T10us ... T1000s.
+ */
+static const long long sim_tmo_ns[] = {
+	1000000000000LL,				/* TNONE: 1000 s     */
+	10000LL, 30000LL, 100000LL, 300000LL,
+	1000000LL, 3000000LL, 10000000LL, 30000000LL,
+	100000000LL, 300000000LL, 1000000000LL, 3000000000LL,
+	10000000000LL, 30000000000LL, 100000000000LL, 300000000000LL,
+	1000000000000LL
+};
+
+struct SimInstrument
+{
+	int                 pad;
+	int                 sad;
+	string              name;
+	string              idn;
+	int                 mode;
+	bool                powered;
+	int                 stb;
+	long                delay_us;
+	double              p_timo;
+	double              p_enol;
+	double              p_eabo;
+	map<string, string> replies;
+	string              output;     // Pending answer (talker buffer)
+	string              input;      // Last data received (listener buffer)
+	unsigned long       fill_pos;   // Position in the fill pattern
+	long                fill_size;  // Fill mode bytes per read, 0 = all
+	bool                remote;
+	bool                lockout;
+	int                 pp_line;    // Parallel poll line 1-8, 0 = none
+	int                 pp_sense;
+	bool                hs488;      // Follows the HS488 handshake
+	int                 timing;     // Highest IbcTIMING it follows
+};
+
+struct SimBoard
+{
+	bool                  present;
+	pthread_mutex_t       bus;        // Serializes transfers
+	map<int, int>         config;     // ibconfig values
+	int                   addressed;  // (pad * 256 + sad) * 2 + talker + 1 of
+	                                  // the device left addressed (IbcUnAddr 0),
+	                                  // 0 = none
+	int                   tap;        // Board whose bus it monitors, -1 = none
+	vector<SimInstrument> instruments;
+};
+
+/*
+ * A byte seen by a monitor board.
+ */
+struct SimCycle
+{
+	long long     time;
+	unsigned char byte;
+	unsigned char flags;        // GPIBSIM_ATN, GPIBSIM_EOI
+};
+
+struct SimHandle
+{
+	bool  used;
+	int   board;
+	int   pad;
+	int   sad;
+	int   tmo;
+	int   eot;
+	int   eos;
+	int   unaddr;   // IbcUnAddr: unaddress after each ibrd/ibwrt
+};
+
+static pthread_mutex_t sim_lock = PTHREAD_MUTEX_INITIALIZER;
+static bool            sim_loaded = false;
+static SimBoard        sim_boards[SIM_MAX_BOARDS];
+static SimHandle       sim_handles[SIM_MAX_HANDLES];
+static long            sim_handshake_ns = 20000;
+static long            sim_byte_ns = 1000;
+static double          sim_scale = 1.0;
+static unsigned int    sim_seed = 1;
+
+/*
+ * Bytes captured by the monitor boards, not read yet. They are written
+ * while the tapped bus is held: sim_tap_lock, not sim_lock.
+ */
+static pthread_mutex_t sim_tap_lock = PTHREAD_MUTEX_INITIALIZER;
+static deque<SimCycle> sim_captures[SIM_MAX_BOARDS];
+
+/*
+ * Replayed calls of one function on one address.
+ */
+struct SimReplayQueue
+{
+	vector<gpibRecordEntry> calls;
+	unsigned long           next;
+};
+
+static map<int, map<string, SimReplayQueue> > sim_replay;       // sim_replay_key()
+static map<string, pair<int, int> >           sim_replay_names; // ibfind name: board, pad + 256 * sad
+static double                                 sim_replay_speed = 1.0;
+
+
+/******************************************************************************
+ *
+ * Status and time helpers
+ *
+ *****************************************************************************/
+
+static int sim_status(int sta, int err, long cnt)
+{
+	t_ibsta = sta;
+	t_iberr = err;
+	t_ibcntl = cnt;
+	ibsta = sta;
+	iberr = err;
+	ibcnt = (unsigned int) cnt;
+	ibcntl = cnt;
+	return sta;
+}
+
+static int sim_error(int err)
+{
+	return sim_status(ERR, err, 0);
+}
+
+static void sim_wait_ns(long long ns)
+{
+	if ( (sim_scale <= 0.0) || (ns <= 0) )
+		return;
+	ns = (long long) (ns * sim_scale);
+	struct timespec ts;
+	ts.tv_sec = ns / 1000000000LL;
+	ts.tv_nsec = ns % 1000000000LL;
+	while (nanosleep(&ts, &ts) != 0)
+		;
+}
+
+/*
+ * Time to move n data bytes on a board, with its timing settings.
+ */
+static long long sim_transfer_ns(SimBoard &b, long n)
+{
+	double per_byte = sim_byte_ns;
+	int timing = b.config.count(IbcTIMING) ? b.config[IbcTIMING] : 1;
+
+	if (timing == 2)
+		per_byte /= 4.0;	/* 500 ns T1 */
+	else if (timing == 3)
+		per_byte /= 6.0;	/* 350 ns T1 */
+	if (b.config.count(IbcHSCableLength) && (b.config[IbcHSCableLength] != 0))
+		per_byte /= 4.0;
+	return sim_handshake_ns + (long long) (per_byte * n);
+}
+
+static long long sim_timeout_ns(int tmo)
+{
+	if ( (tmo < 0) || (tmo > T1000s) )
+		tmo = T10s;
+	return sim_tmo_ns[tmo];
+}
+
+static double sim_random(void)
+{
+	return (double) rand_r(&sim_seed) / ((double) RAND_MAX + 1.0);
+}
+
+
+/******************************************************************************
+ *
+ * Bus description
+ *
+ *****************************************************************************/
+
+static void sim_clear_bus(void)
+{
+	for (int i = 0; i < SIM_MAX_BOARDS; i++)
+	{
+		sim_boards[i].present = false;
+		sim_boards[i].config.clear();
+		sim_boards[i].addressed = 0;
+		sim_boards[i].tap = -1;
+		sim_boards[i].instruments.clear();
+	}
+	pthread_mutex_lock(&sim_tap_lock);
+	for (int i = 0; i < SIM_MAX_BOARDS; i++)
+		sim_captures[i].clear();
+	pthread_mutex_unlock(&sim_tap_lock);
+	sim_boards[0].present = true;
+	sim_handshake_ns = 20000;
+	sim_byte_ns = 1000;
+	sim_scale = 1.0;
+	sim_seed = 1;
+	sim_replay.clear();
+	sim_replay_names.clear();
+}
+
+static SimInstrument *sim_find(int board, int pad, int sad)
+{
+	if ( (board < 0) || (board >= SIM_MAX_BOARDS) || (!sim_boards[board].present) )
+		return NULL;
+	vector<SimInstrument> &v = sim_boards[board].instruments;
+	for (unsigned int i = 0; i < v.size(); i++)
+	{
+		if ( (v[i].pad == pad) && (v[i].sad == sad) )
+			return &v[i];
+	}
+	return NULL;
+}
+
+static bool sim_listening(int board, int pad, int sad)
+{
+	SimInstrument *ins = sim_find(board, pad, sad);
+	return (ins != NULL) && ins->powered;
+}
+
+/*
+ * Read a token: a double quoted string or a word. Returns false at end.
+ */
+static bool sim_token(istream &in, string &tok)
+{
+	char c;
+
+	tok = "";
+	while (in.get(c) && isspace((unsigned char) c))
+		;
+	if (!in)
+		return false;
+	if (c == '#')
+	{
+		in.setstate(ios::eofbit);
+		return false;
+	}
+	if (c != '"')
+	{
+		tok += c;
+		while (in.get(c) && !isspace((unsigned char) c))
+		{
+			if (c == '"')	/* key="quoted value" */
+			{
+				string q;
+				in.putback(c);
+				sim_token(in, q);
+				tok += q;
+				continue;
+			}
+			tok += c;
+		}
+		return true;
+	}
+	while (in.get(c) && (c != '"'))
+	{
+		if ( (c == '\\') && in.get(c) )
+		{
+			if (c == 'n') c = '\n';
+			else if (c == 'r') c = '\r';
+		}
+		tok += c;
+	}
+	return true;
+}
+
+static bool sim_address(const string &s, int &pad, int &sad)
+{
+	sad = 0;
+	if (sscanf(s.c_str(), "%d:%d", &pad, &sad) < 1)
+		return false;
+	return (pad >= 0) && (pad <= 30);
+}
+
+static int sim_add_instrument(int board, int pad, int sad, const char *name,
+                              const char *idn, int mode)
+{
+	if ( (board < 0) || (board >= SIM_MAX_BOARDS) )
+		return -1;
+	sim_boards[board].present = true;
+	if (sim_find(board, pad, sad) != NULL)
+		return -1;
+
+	SimInstrument ins;
+	ins.pad = pad;
+	ins.sad = sad;
+	ins.name = (name != NULL) ? name : "";
+	ins.idn = (idn != NULL) ? idn : "";
+	ins.mode = mode;
+	ins.powered = true;
+	ins.stb = 0;
+	ins.delay_us = 0;
+	ins.p_timo = ins.p_enol = ins.p_eabo = 0.0;
+	ins.fill_pos = 0;
+	ins.fill_size = 0;
+	ins.remote = false;
+	ins.lockout = false;
+	ins.pp_line = 0;
+	ins.pp_sense = 0;
+	ins.hs488 = true;
+	ins.timing = 3;
+	if (ins.idn.length() == 0)
+	{
+		ostringstream os;
+		os << "GPIBSIM,INSTRUMENT," << board << "-" << pad << ",1.0";
+		ins.idn = os.str();
+	}
+	sim_boards[board].instruments.push_back(ins);
+	return 0;
+}
+
+static int sim_parse(istream &in, const string &file)
+{
+	string line;
+	int    line_nb = 0;
+
+	while (getline(in, line))
+	{
+		istringstream ls(line);
+		string        kw, tok;
+		line_nb++;
+
+		if (!sim_token(ls, kw))
+			continue;
+
+		if (kw == "latency")
+		{
+			while (sim_token(ls, tok))
+			{
+				string::size_type eq = tok.find('=');
+				if (eq == string::npos)
+					continue;
+				string k = tok.substr(0, eq);
+				string v = tok.substr(eq + 1);
+				if (k == "handshake_ns") sim_handshake_ns = atol(v.c_str());
+				else if (k == "byte_ns") sim_byte_ns = atol(v.c_str());
+				else if (k == "scale") sim_scale = atof(v.c_str());
+			}
+		}
+		else if (kw == "seed")
+		{
+			if (sim_token(ls, tok))
+				sim_seed = (unsigned int) atol(tok.c_str());
+		}
+		else if (kw == "board")
+		{
+			if (sim_token(ls, tok))
+			{
+				int b = atoi(tok.c_str());
+				if ( (b < 0) || (b >= SIM_MAX_BOARDS) )
+					continue;
+				sim_boards[b].present = true;
+				while (sim_token(ls, tok))
+				{
+					if (tok.compare(0, 4, "tap=") != 0)
+						continue;
+					int t = atoi(tok.c_str() + 4);
+					if ( (t < 0) || (t >= SIM_MAX_BOARDS) || (t == b) )
+					{
+						cerr << file << ":" << line_nb << ": bad tap" << endl;
+						return -1;
+					}
+					sim_boards[b].tap = t;
+				}
+			}
+		}
+		else if ( (kw == "instrument") || (kw == "reply") )
+		{
+			string sb, sa;
+			int    board, pad, sad;
+			if ( !sim_token(ls, sb) || !sim_token(ls, sa) || !sim_address(sa, pad, sad) )
+			{
+				cerr << file << ":" << line_nb << ": bad address" << endl;
+				return -1;
+			}
+			board = atoi(sb.c_str());
+
+			if (kw == "reply")
+			{
+				string q, a;
+				if ( !sim_token(ls, q) || !sim_token(ls, a) || (sim_find(board, pad, sad) == NULL) )
+				{
+					cerr << file << ":" << line_nb << ": bad reply" << endl;
+					return -1;
+				}
+				sim_find(board, pad, sad)->replies[q] = a;
+				continue;
+			}
+
+			if (sim_add_instrument(board, pad, sad, NULL, NULL, GPIBSIM_ECHO) != 0)
+			{
+				cerr << file << ":" << line_nb << ": bad or duplicate instrument" << endl;
+				return -1;
+			}
+			SimInstrument *ins = sim_find(board, pad, sad);
+			while (sim_token(ls, tok))
+			{
+				string::size_type eq = tok.find('=');
+				if (eq == string::npos)
+					continue;
+				string k = tok.substr(0, eq);
+				string v = tok.substr(eq + 1);
+				if (k == "name") ins->name = v;
+				else if (k == "idn") ins->idn = v;
+				else if (k == "mode") ins->mode = (v == "script") ? GPIBSIM_SCRIPT : (v == "fill") ? GPIBSIM_FILL : GPIBSIM_ECHO;
+				else if (k == "stb") ins->stb = (int) strtol(v.c_str(), NULL, 0);
+				else if (k == "power") ins->powered = (v != "off");
+				else if (k == "delay_us") ins->delay_us = atol(v.c_str());
+				else if (k == "fill") ins->fill_size = atol(v.c_str());
+				else if (k == "timo") ins->p_timo = atof(v.c_str());
+				else if (k == "enol") ins->p_enol = atof(v.c_str());
+				else if (k == "eabo") ins->p_eabo = atof(v.c_str());
+				else if (k == "hs488") ins->hs488 = (v != "off");
+				else if (k == "timing") ins->timing = atoi(v.c_str());
+			}
+		}
+		else
+		{
+			cerr << file << ":" << line_nb << ": unknown statement " << kw << endl;
+			return -1;
+		}
+	}
+	return 0;
+}
+
+/*
+ * Load the configuration at the first driver call. Called with sim_lock.
+ */
+static int sim_replay_load(const char *file, double speed);
+
+static void sim_init(void)
+{
+	if (sim_loaded)
+		return;
+	sim_loaded = true;
+	for (int i = 0; i < SIM_MAX_BOARDS; i++)
+		pthread_mutex_init(&sim_boards[i].bus, NULL);
+	for (int h = 0; h < SIM_MAX_HANDLES; h++)
+		sim_handles[h].used = false;
+	sim_clear_bus();
+
+	const char *file = getenv("GPIBSIM_CONFIG");
+	if (file != NULL)
+	{
+		ifstream in(file);
+		if (!in || (sim_parse(in, file) != 0))
+		{
+			cerr << "gpibSim: cannot load " << file << ", empty bus used." << endl;
+			sim_clear_bus();
+		}
+	}
+
+	file = getenv("GPIBSIM_REPLAY");
+	if (file != NULL)
+	{
+		const char *speed = getenv("GPIBSIM_REPLAY_SPEED");
+		if (sim_replay_load(file, (speed != NULL) ? atof(speed) : 1.0) != 0)
+			cerr << "gpibSim: cannot load replay log " << file << "." << endl;
+	}
+}
+
+/*
+ * Lock the driver and check a handle. Returns NULL (and sets the status)
+ * for a bad handle. The caller must call sim_unlock.
+ */
+static SimHandle *sim_handle(int ud)
+{
+	pthread_mutex_lock(&sim_lock);
+	sim_init();
+
+	if ( (ud >= 0) && (ud < SIM_MAX_BOARDS) )
+	{
+		if (!sim_boards[ud].present)
+		{
+			sim_error(ENEB);
+			return NULL;
+		}
+		/* Board handles are not allocated: describe them on the fly. */
+		static __thread SimHandle board_handle;
+		board_handle.used = true;
+		board_handle.board = ud;
+		board_handle.pad = 0;
+		board_handle.sad = 0;
+		board_handle.tmo = sim_boards[ud].config.count(IbcTMO) ? sim_boards[ud].config[IbcTMO] : T3s;
+		board_handle.eot = 1;
+		board_handle.eos = 0;
+		board_handle.unaddr = 1;
+		/* Board calls address devices themselves. */
+		sim_boards[ud].addressed = 0;
+		return &board_handle;
+	}
+	if ( (ud < SIM_FIRST_DEV_HANDLE) || (ud >= SIM_MAX_HANDLES) || !sim_handles[ud].used )
+	{
+		sim_error(EDVR);
+		return NULL;
+	}
+	return &sim_handles[ud];
+}
+
+static bool sim_is_board(int ud)
+{
+	return (ud >= 0) && (ud < SIM_MAX_BOARDS);
+}
+
+static void sim_unlock(void)
+{
+	pthread_mutex_unlock(&sim_lock);
+}
+
+
+/******************************************************************************
+ *
+ * Instrument behaviour. Called with sim_lock held.
+ *
+ *****************************************************************************/
+
+/*
+ * Draw the fault injected on this transfer: 0 or ENOL / EABO / EBUS / -1
+ * (TIMO). An instrument without HS488 always breaks the handshake when the
+ * board uses it, an instrument slower than the board timing times out.
+ */
+static int sim_fault(SimBoard &b, SimInstrument *ins)
+{
+	if ( !ins->hs488 && b.config.count(IbcHSCableLength) && (b.config[IbcHSCableLength] != 0) )
+		return EBUS;
+	if ( b.config.count(IbcTIMING) && (b.config[IbcTIMING] > ins->timing) )
+		return -1;
+	double r = sim_random();
+	if (r < ins->p_timo)
+		return -1;
+	r -= ins->p_timo;
+	if (r < ins->p_enol)
+		return ENOL;
+	r -= ins->p_enol;
+	if (r < ins->p_eabo)
+		return EABO;
+	return 0;
+}
+
+static string sim_trim(const string &s)
+{
+	string::size_type e = s.find_last_not_of("\r\n ");
+	return (e == string::npos) ? string("") : s.substr(0, e + 1);
+}
+
+/*
+ * Process figures for soak tests: "handles=<n> heap=<bytes> rss=<kB>".
+ */
+static string sim_stats(void)
+{
+	int handles = 0;
+	for (int h = SIM_FIRST_DEV_HANDLE; h < SIM_MAX_HANDLES; h++)
+		if (sim_handles[h].used)
+			handles++;
+
+#if defined(__GLIBC__) && ((__GLIBC__ > 2) || (__GLIBC_MINOR__ >= 33))
+	struct mallinfo2 mi = mallinfo2();
+#else
+	struct mallinfo mi = mallinfo();
+#endif
+
+	long rss = 0, size = 0;
+	FILE *f = fopen("/proc/self/statm", "r");
+	if (f != NULL)
+	{
+		if (fscanf(f, "%ld %ld", &size, &rss) != 2)
+			rss = 0;
+		fclose(f);
+	}
+
+	ostringstream os;
+	os << "handles=" << handles << " heap=" << (unsigned long) mi.uordblks
+	   << " rss=" << rss * (sysconf(_SC_PAGESIZE) / 1024);
+	return os.str();
+}
+
+/*
+ * Next byte of the fill pattern: printable, so that it goes through the
+ * string commands of the server too.
+ */
+static char sim_fill_byte(SimInstrument *ins)
+{
+	return (char) ('!' + (ins->fill_pos++ % 94));
+}
+
+static void sim_instrument_write(SimInstrument *ins, const char *buf, long cnt)
+{
+	ins->remote = true;
+
+	/* Data to a fill instrument: only built-in commands are parsed. The
+	   data is still copied in, as a real listener takes every byte, into
+	   a buffer which is kept so that bulk transfers do not allocate. */
+	if ( (ins->mode == GPIBSIM_FILL) && ins->replies.empty() && (cnt > 0) &&
+	     (buf[0] != '*') && ((cnt < 4) || (strncasecmp(buf, "SIM:", 4) != 0)) )
+	{
+		ins->input.assign(buf, cnt);
+		return;
+	}
+
+	string data(buf, cnt);
+	string cmd = sim_trim(data);
+	string up = cmd;
+	for (unsigned int i = 0; i < up.length(); i++)
+		up[i] = toupper((unsigned char) up[i]);
+
+	if (up == "*IDN?")
+		ins->output = ins->idn + "\n";
+	else if (up == "*STB?")
+	{
+		ostringstream os;
+		os << ins->stb << "\n";
+		ins->output = os.str();
+	}
+	else if (up == "*RST")
+		ins->output = "";
+	else if (up == "*CLS")
+	{
+		ins->output = "";
+		ins->stb = 0;
+	}
+	else if (up.compare(0, 10, "SIM:SIZE? ") == 0)
+	{
+		long n = atol(cmd.c_str() + 10);
+		ins->output.resize(n > 0 ? n : 0);
+		for (long i = 0; i < n; i++)
+			ins->output[i] = sim_fill_byte(ins);
+	}
+	else if (up == "SIM:STATS?")
+		ins->output = sim_stats() + "\n";
+	else if (up.compare(0, 9, "SIM:FILL ") == 0)
+	{
+		ins->fill_size = atol(cmd.c_str() + 9);
+		ins->output = "";
+	}
+	else if (ins->replies.count(cmd))
+	{
+		ins->output = ins->replies[cmd];
+		if (ins->output.length() > 0)
+			ins->output += "\n";
+	}
+	else if (ins->mode == GPIBSIM_ECHO)
+		ins->output = data;
+	else
+		ins->output = "";
+}
+
+/*
+ * Read up to cnt bytes of the instrument answer. Returns the number of
+ * bytes, -1 when the instrument has nothing to say.
+ */
+static long sim_instrument_read(SimInstrument *ins, char *buf, long cnt, int eos, bool &end)
+{
+	long n = 0;
+
+	end = false;
+	if (ins->output.length() == 0)
+	{
+		if (ins->mode != GPIBSIM_FILL)
+			return -1;
+		if ( (ins->fill_size > 0) && (ins->fill_size < cnt) )
+			cnt = ins->fill_size;
+		for (n = 0; n < cnt; n++)
+			buf[n] = sim_fill_byte(ins);
+		end = true;
+		return n;
+	}
+
+	while ( (n < cnt) && (n < (long) ins->output.length()) )
+	{
+		buf[n] = ins->output[n];
+		n++;
+		if ( (eos & REOS) && ((unsigned char) buf[n-1] == (eos & 0xff)) )
+		{
+			end = true;
+			break;
+		}
+	}
+	ins->output.erase(0, n);
+	if (ins->output.length() == 0)
+		end = true;
+	return n;
+}
+
+
+/*
+ * Bus monitor. sim_monitor (with sim_lock) finds the board in listen-only
+ * mode with a tap on a bus, sim_tap (with the bus held) appends the bytes
+ * of a transfer to its capture: cmd command bytes, handshake_ns apart,
+ * then n data bytes byte_ns apart, EOI on the last one if end.
+ */
+static int sim_monitor(int board)
+{
+	for (int m = 0; m < SIM_MAX_BOARDS; m++)
+	{
+		SimBoard &b = sim_boards[m];
+		if ( b.present && (b.tap == board) && b.config.count(IbcLON) && (b.config[IbcLON] != 0) )
+			return m;
+	}
+	return -1;
+}
+
+static void sim_tap(int monitor, const unsigned char *cmd, int ncmd,
+                    const char *data, long n, bool end, long long byte_ns)
+{
+	if (monitor < 0)
+		return;
+
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	long long t = (long long) ts.tv_sec * 1000000000LL + ts.tv_nsec;
+	long long cmd_ns = (ncmd > 0) ? (long long) (sim_handshake_ns * sim_scale) / ncmd : 0;
+	byte_ns = (long long) (byte_ns * sim_scale);
+
+	pthread_mutex_lock(&sim_tap_lock);
+	deque<SimCycle> &capture = sim_captures[monitor];
+	SimCycle         c;
+	for (int i = 0; i < ncmd; i++, t += cmd_ns)
+	{
+		c.time = t;
+		c.byte = cmd[i];
+		c.flags = GPIBSIM_ATN;
+		capture.push_back(c);
+	}
+	for (long i = 0; i < n; i++, t += byte_ns)
+	{
+		c.time = t;
+		c.byte = (unsigned char) data[i];
+		c.flags = ( end && (i == n - 1) ) ? GPIBSIM_EOI : 0;
+		capture.push_back(c);
+	}
+	while (capture.size() > SIM_CAPTURE_CYCLES)
+		capture.pop_front();
+	pthread_mutex_unlock(&sim_tap_lock);
+}
+
+/*
+ * Addressing commands of a transfer between the board (controller, at
+ * its IbcPAD) and an instrument. Return the number of bytes.
+ */
+static int sim_addressing(unsigned char *cmd, SimBoard &b, int pad, int sad, bool talker)
+{
+	int n = 0;
+	int own = b.config.count(IbcPAD) ? b.config[IbcPAD] : 0;
+
+	cmd[n++] = UNL;
+	cmd[n++] = (unsigned char) ((talker ? 0x20 : 0x40) | own);	/* MLA / MTA */
+	cmd[n++] = (unsigned char) ((talker ? 0x40 : 0x20) | pad);
+	if (sad != 0)
+		cmd[n++] = (unsigned char) sad;				/* MSA */
+	return n;
+}
+
+/*
+ * Device level transfers (ibwrt, ibrd): return true if the device is still
+ * addressed as listener (ibwrt) or talker (ibrd) by its previous transfer
+ * (IbcUnAddr 0, no other device or board call since), so that its
+ * addressing handshake is skipped.
+ */
+static bool sim_addressed(SimHandle *h, int talker)
+{
+	SimBoard &b = sim_boards[h->board];
+	int       key = (h->pad * 256 + h->sad) * 2 + talker + 1;
+	bool      addressed = (b.addressed == key);
+
+	b.addressed = h->unaddr ? 0 : key;
+	return addressed;
+}
+
+/*
+ * Data transfers to or from an instrument. The bus of the board is held
+ * for the transfer duration, the driver lock is released meanwhile.
+ * addressed: no addressing handshake (see sim_addressed). end: EOI is
+ * sent with the last byte (Send with NULLend does not).
+ */
+static int sim_send(int board, int pad, int sad, const char *buf, long cnt, int tmo,
+                    bool addressed = false, bool end = true)
+{
+	SimInstrument *ins = sim_find(board, pad, sad);
+	if ( (ins == NULL) || !ins->powered )
+	{
+		sim_unlock();
+		return sim_error(ENOL);
+	}
+	SimBoard &b = sim_boards[board];
+	int fault = sim_fault(b, ins);
+	if (fault == 0)
+		sim_instrument_write(ins, buf, cnt);
+	long long t = sim_transfer_ns(b, cnt) - (addressed ? sim_handshake_ns : 0);
+	int monitor = sim_monitor(board);
+	unsigned char cmd[4];
+	int ncmd = addressed ? 0 : sim_addressing(cmd, b, pad, sad, false);
+	long long byte_ns = (sim_transfer_ns(b, cnt) - sim_handshake_ns) / ((cnt > 0) ? cnt : 1);
+	sim_unlock();
+
+	pthread_mutex_lock(&b.bus);
+	if (fault == -1)
+		sim_wait_ns(sim_timeout_ns(tmo));
+	else if (fault == 0)
+	{
+		sim_tap(monitor, cmd, ncmd, buf, cnt, end, byte_ns);
+		sim_wait_ns(t);
+	}
+	pthread_mutex_unlock(&b.bus);
+
+	if (fault == -1)
+		return sim_status(ERR | TIMO | CMPL, EABO, 0);
+	if (fault != 0)
+		return sim_error(fault);
+	return sim_status(CMPL, 0, cnt);
+}
+
+static int sim_receive(int board, int pad, int sad, char *buf, long cnt, int eos, int tmo,
+                       bool addressed = false)
+{
+	SimInstrument *ins = sim_find(board, pad, sad);
+	SimBoard      &b = sim_boards[board];
+	bool           end = false;
+	long           n = -1;
+	long long      t, byte_ns = 0;
+	int            fault = 0;
+	int            monitor = -1;
+	unsigned char  cmd[4];
+	int            ncmd = 0;
+
+	if ( (ins != NULL) && ins->powered )
+	{
+		fault = sim_fault(b, ins);
+		if (fault == 0)
+			n = sim_instrument_read(ins, buf, cnt, eos, end);
+		t = sim_transfer_ns(b, n) - (addressed ? sim_handshake_ns : 0) + ins->delay_us * 1000LL;
+		if (n > 0)
+			byte_ns = (sim_transfer_ns(b, n) - sim_handshake_ns) / n;
+		monitor = sim_monitor(board);
+		if (!addressed)
+			ncmd = sim_addressing(cmd, b, pad, sad, true);
+	}
+	sim_unlock();
+
+	pthread_mutex_lock(&b.bus);
+	if ( (n < 0) && (fault != EABO) && (fault != ENOL) && (fault != EBUS) )
+		sim_wait_ns(sim_timeout_ns(tmo));
+	else if (n >= 0)
+	{
+		sim_tap(monitor, cmd, ncmd, buf, n, end, byte_ns);
+		sim_wait_ns(t);
+	}
+	pthread_mutex_unlock(&b.bus);
+
+	if ( (fault == EABO) || (fault == ENOL) || (fault == EBUS) )
+		return sim_error(fault);
+	if (n < 0)
+		return sim_status(ERR | TIMO | CMPL, EABO, 0);
+	return sim_status(CMPL | (end ? END : 0), 0, n);
+}
+
+
+/******************************************************************************
+ *
+ * Replay of a bus traffic log. Called with sim_lock held.
+ *
+ *****************************************************************************/
+
+/*
+ * Replay queues of an address: the modules of a mainframe (secondary
+ * addresses of one pad) get their own replies.
+ */
+static int sim_replay_key(int board, int pad, int sad)
+{
+	return (board << 16) | (((sad > 0) ? sad : 0) << 8) | pad;
+}
+
+static int sim_replay_load(const char *file, double speed)
+{
+	vector<gpibRecordEntry> records;
+
+	if (gpibRecordLoad(file, records) < 0)
+		return -1;
+
+	sim_replay.clear();
+	sim_replay_names.clear();
+	sim_replay_speed = speed;
+	for (unsigned long i = 0; i < records.size(); i++)
+	{
+		gpibRecordEntry &r = records[i];
+		if ( (r.board < 0) || (r.board >= SIM_MAX_BOARDS) || (r.pad < 0) )
+			continue;
+		sim_boards[r.board].present = true;
+		if (r.call == GPIB_RECORD_NAME)
+		{
+			sim_replay_names[r.data] = make_pair(r.board, r.pad | (r.sad << 8));
+			continue;
+		}
+		SimReplayQueue &q = sim_replay[sim_replay_key(r.board, r.pad, r.sad)][r.call];
+		q.calls.push_back(r);
+		q.next = 0;
+	}
+	return 0;
+}
+
+/*
+ * Serve the next recorded call of a function on an address. Data returned
+ * by the call (reads, ibln, ibrsp) are copied in out, up to cnt bytes.
+ * Return -1 with sim_lock still held if the log has no such call, else
+ * release the lock and return ibsta.
+ */
+static int sim_replay_call(const char *call, int board, int pad, int sad, void *out, long cnt)
+{
+	map<int, map<string, SimReplayQueue> >::iterator a = sim_replay.find(sim_replay_key(board, pad, sad));
+	if (a == sim_replay.end())
+		return -1;
+	map<string, SimReplayQueue>::iterator c = a->second.find(call);
+	if (c == a->second.end())
+		return -1;
+
+	SimReplayQueue  &q = c->second;
+	gpibRecordEntry &r = q.calls[q.next];
+	q.next = (q.next + 1) % q.calls.size();
+
+	if ( (out != NULL) && (cnt > 0) )
+	{
+		long n = ((long) r.data.size() < cnt) ? (long) r.data.size() : cnt;
+		if (n > 0)
+			memcpy(out, r.data.data(), n);
+	}
+	int           sta = r.ibsta;
+	int           err = r.iberr;
+	long          count = (long) r.count;
+	long long     t = (sim_replay_speed > 0.0) ? (long long) (r.duration / sim_replay_speed) : 0;
+	SimBoard     &b = sim_boards[board];
+	sim_unlock();
+
+	pthread_mutex_lock(&b.bus);
+	if (t > 0)
+	{
+		struct timespec ts;
+		ts.tv_sec = t / 1000000000LL;
+		ts.tv_nsec = t % 1000000000LL;
+		while (nanosleep(&ts, &ts) != 0)
+			;
+	}
+	pthread_mutex_unlock(&b.bus);
+	return sim_status(sta, err, count);
+}
+
+
+/******************************************************************************
+ *
+ * NI-488 functions
+ *
+ *****************************************************************************/
+
+extern "C" {
+
+int ibfind(char *name)
+{
+	pthread_mutex_lock(&sim_lock);
+	sim_init();
+
+	int board;
+	if ( (strncmp(name, "gpib", 4) == 0) && isdigit((unsigned char) name[4]) )
+	{
+		board = atoi(name + 4);
+		if ( (board < 0) || (board >= SIM_MAX_BOARDS) || !sim_boards[board].present )
+		{
+			sim_unlock();
+			sim_error(ENEB);
+			return -1;
+		}
+		sim_unlock();
+		sim_status(CMPL, 0, 0);
+		return board;
+	}
+
+	for (board = 0; board < SIM_MAX_BOARDS; board++)
+	{
+		vector<SimInstrument> &v = sim_boards[board].instruments;
+		for (unsigned int i = 0; i < v.size(); i++)
+		{
+			if (v[i].name != name)
+				continue;
+			for (int h = SIM_FIRST_DEV_HANDLE; h < SIM_MAX_HANDLES; h++)
+			{
+				if (sim_handles[h].used)
+					continue;
+				sim_handles[h].used = true;
+				sim_handles[h].board = board;
+				sim_handles[h].pad = v[i].pad;
+				sim_handles[h].sad = v[i].sad;
+				sim_handles[h].tmo = T10s;
+				sim_handles[h].eot = 1;
+				sim_handles[h].eos = 0;
+				sim_handles[h].unaddr = 1;
+				sim_unlock();
+				sim_status(CMPL, 0, 0);
+				return h;
+			}
+			sim_unlock();
+			sim_error(ETAB);
+			return -1;
+		}
+	}
+
+	map<string, pair<int, int> >::iterator r = sim_replay_names.find(name);
+	if (r != sim_replay_names.end())
+	{
+		sim_unlock();
+		return ibdev(r->second.first, r->second.second & 0xff, r->second.second >> 8, T10s, 1, 0);
+	}
+	sim_unlock();
+	sim_error(EDVR);
+	return -1;
+}
+
+int ibdev(int board, int pad, int sad, int tmo, int eot, int eos)
+{
+	pthread_mutex_lock(&sim_lock);
+	sim_init();
+
+	if ( (board < 0) || (board >= SIM_MAX_BOARDS) || !sim_boards[board].present )
+	{
+		sim_unlock();
+		sim_error(ENEB);
+		return -1;
+	}
+	if ( (pad < 0) || (pad > 30) || ((sad != 0) && ((sad < 0x60) || (sad > 0x7e))) )
+	{
+		sim_unlock();
+		sim_error(EARG);
+		return -1;
+	}
+	for (int h = SIM_FIRST_DEV_HANDLE; h < SIM_MAX_HANDLES; h++)
+	{
+		if (sim_handles[h].used)
+			continue;
+		sim_handles[h].used = true;
+		sim_handles[h].board = board;
+		sim_handles[h].pad = pad;
+		sim_handles[h].sad = sad;
+		sim_handles[h].tmo = tmo;
+		sim_handles[h].eot = eot;
+		sim_handles[h].eos = eos;
+		sim_handles[h].unaddr = 1;
+		sim_unlock();
+		sim_status(CMPL, 0, 0);
+		return h;
+	}
+	sim_unlock();
+	sim_error(EDVR);
+	return -1;
+}
+
+int ibonl(int ud, int v)
+{
+	SimHandle *h = sim_handle(ud);
+	if (h == NULL)
+	{
+		sim_unlock();
+		return ibsta;
+	}
+	if ( (v == 0) && !sim_is_board(ud) )
+		h->used = false;
+	sim_unlock();
+	return sim_status(CMPL, 0, 0);
+}
+
+int ibwrt(int ud, char *buf, int cnt)
+{
+	SimHandle *h = sim_handle(ud);
+	if (h == NULL)
+	{
+		sim_unlock();
+		return ibsta;
+	}
+	if (sim_is_board(ud))
+	{
+		/* Board writes need listeners addressed with ibcmd. */
+		sim_unlock();
+		return sim_error(EADR);
+	}
+	int sta = sim_replay_call("ibwrt", h->board, h->pad, h->sad, NULL, 0);
+	if (sta != -1)
+		return sta;
+	return sim_send(h->board, h->pad, h->sad, buf, cnt, h->tmo, sim_addressed(h, 0));
+}
+
+int ibrd(int ud, char *buf, int cnt)
+{
+	SimHandle *h = sim_handle(ud);
+	if (h == NULL)
+	{
+		sim_unlock();
+		return ibsta;
+	}
+	if (sim_is_board(ud))
+	{
+		sim_unlock();
+		return sim_error(EADR);
+	}
+	int sta = sim_replay_call("ibrd", h->board, h->pad, h->sad, buf, cnt);
+	if (sta != -1)
+		return sta;
+	return sim_receive(h->board, h->pad, h->sad, buf, cnt, h->eos, h->tmo, sim_addressed(h, 1));
+}
+
+int ibln(int ud, int pad, int sad, short *listen)
+{
+	SimHandle *h = sim_handle(ud);
+	if (h == NULL)
+	{
+		sim_unlock();
+		return ibsta;
+	}
+
+	int sta = sim_replay_call("ibln", h->board, pad, sad, listen, sizeof(short));
+	if (sta != -1)
+		return sta;
+
+	*listen = 0;
+	if (sad == (int) ALL_SAD)
+	{
+		vector<SimInstrument> &v = sim_boards[h->board].instruments;
+		for (unsigned int i = 0; i < v.size(); i++)
+			if ( (v[i].pad == pad) && v[i].powered )
+				*listen = 1;
+	}
+	else if (sim_listening(h->board, pad, sad))
+		*listen = 1;
+
+	SimBoard &b = sim_boards[h->board];
+	sim_unlock();
+
+	pthread_mutex_lock(&b.bus);
+	sim_wait_ns(sim_handshake_ns);
+	pthread_mutex_unlock(&b.bus);
+	return sim_status(CMPL, 0, 0);
+}
+
+int ibask(int ud, int opt, int *val)
+{
+	SimHandle *h = sim_handle(ud);
+	if (h == NULL)
+	{
+		sim_unlock();
+		return ibsta;
+	}
+
+	map<int, int> &cfg = sim_boards[h->board].config;
+	switch (opt)
+	{
+		case IbaPAD:	*val = h->pad; break;
+		case IbaSAD:	*val = h->sad; break;
+		case IbaTMO:	*val = h->tmo; break;
+		case IbaEOT:	*val = h->eot; break;
+		case IbaEOSchar: *val = h->eos & 0xff; break;
+		case IbaEOSrd:	*val = (h->eos & REOS) ? 1 : 0; break;
+		case IbaEOSwrt:	*val = (h->eos & XEOS) ? 1 : 0; break;
+		case IbaEOScmp:	*val = (h->eos & BIN) ? 1 : 0; break;
+		case IbaUnAddr:	*val = h->unaddr; break;
+		case IbaBNA:	*val = h->board; break;
+		case IbaSC:	*val = cfg.count(IbcSC) ? cfg[IbcSC] : 1; break;
+		default:
+			*val = cfg.count(opt) ? cfg[opt] : 0;
+			break;
+	}
+	sim_unlock();
+	return sim_status(CMPL, 0, 0);
+}
+
+int ibconfig(int ud, int opt, int val)
+{
+	SimHandle *h = sim_handle(ud);
+	if (h == NULL)
+	{
+		sim_unlock();
+		return ibsta;
+	}
+
+	switch (opt)
+	{
+		case IbcPAD:	h->pad = val; break;
+		case IbcSAD:	h->sad = val; break;
+		case IbcTMO:	h->tmo = val; break;
+		case IbcEOT:	h->eot = val; break;
+		case IbcEOSchar: h->eos = (h->eos & ~0xff) | (val & 0xff); break;
+		case IbcEOSrd:	h->eos = val ? (h->eos | REOS) : (h->eos & ~REOS); break;
+		case IbcEOSwrt:	h->eos = val ? (h->eos | XEOS) : (h->eos & ~XEOS); break;
+		case IbcEOScmp:	h->eos = val ? (h->eos | BIN) : (h->eos & ~BIN); break;
+		case IbcUnAddr:	h->unaddr = val; break;
+		default:
+			break;
+	}
+	if (sim_is_board(ud))
+		sim_boards[ud].config[opt] = val;
+	sim_unlock();
+	return sim_status(CMPL, 0, 0);
+}
+
+int ibtmo(int ud, int v)
+{
+	if ( (v < TNONE) || (v > T1000s) )
+		return sim_error(EARG);
+	return ibconfig(ud, IbcTMO, v);
+}
+
+int ibeos(int ud, int v)
+{
+	SimHandle *h = sim_handle(ud);
+	if (h == NULL)
+	{
+		sim_unlock();
+		return ibsta;
+	}
+	h->eos = v;
+	sim_unlock();
+	return sim_status(CMPL, 0, 0);
+}
+
+int ibeot(int ud, int v)
+{
+	return ibconfig(ud, IbcEOT, v);
+}
+
+int ibpad(int ud, int v)
+{
+	return ibconfig(ud, IbcPAD, v);
+}
+
+int ibsad(int ud, int v)
+{
+	return ibconfig(ud, IbcSAD, v);
+}
+
+/*
+ * Device operations which only change the instrument state.
+ */
+static int sim_device_op(int ud, int op)
+{
+	SimHandle *h = sim_handle(ud);
+	if (h == NULL)
+	{
+		sim_unlock();
+		return ibsta;
+	}
+
+	if (sim_is_board(ud))
+	{
+		SimBoard &b = sim_boards[ud];
+		for (unsigned int i = 0; i < b.instruments.size(); i++)
+		{
+			if (op == 'l')
+				b.instruments[i].remote = b.instruments[i].lockout = false;
+			if (op == 'o')
+				b.instruments[i].lockout = true;
+		}
+		sim_unlock();
+		return sim_status(CMPL, 0, 0);
+	}
+
+	static const char *calls[] = {"ibclr", "ibloc", "ibllo", "ibtrg"};
+	const char *call = calls[(op == 'c') ? 0 : (op == 'l') ? 1 : (op == 'o') ? 2 : 3];
+	int sta = sim_replay_call(call, h->board, h->pad, h->sad, NULL, 0);
+	if (sta != -1)
+		return sta;
+
+	SimInstrument *ins = sim_find(h->board, h->pad, h->sad);
+	if ( (ins == NULL) || !ins->powered )
+	{
+		sim_unlock();
+		return sim_error(ENOL);
+	}
+	switch (op)
+	{
+		case 'c':	ins->output = ""; break;		/* ibclr */
+		case 'l':	ins->remote = false; break;		/* ibloc */
+		case 'o':	ins->lockout = true; break;		/* ibllo */
+		default:	break;					/* ibtrg */
+	}
+	SimBoard &b = sim_boards[h->board];
+	b.addressed = 0;		/* Addressed commands end unaddressed */
+	sim_unlock();
+
+	pthread_mutex_lock(&b.bus);
+	sim_wait_ns(sim_handshake_ns);
+	pthread_mutex_unlock(&b.bus);
+	return sim_status(CMPL, 0, 0);
+}
+
+int ibclr(int ud)
+{
+	return sim_device_op(ud, 'c');
+}
+
+int ibloc(int ud)
+{
+	return sim_device_op(ud, 'l');
+}
+
+int ibllo(int ud)
+{
+	return sim_device_op(ud, 'o');
+}
+
+int ibtrg(int ud)
+{
+	return sim_device_op(ud, 't');
+}
+
+int ibrsp(int ud, char *spr)
+{
+	SimHandle *h = sim_handle(ud);
+	if (h == NULL)
+	{
+		sim_unlock();
+		return ibsta;
+	}
+	int sta = sim_replay_call("ibrsp", h->board, h->pad, h->sad, spr, 1);
+	if (sta != -1)
+		return sta;
+	SimInstrument *ins = sim_find(h->board, h->pad, h->sad);
+	if ( (ins == NULL) || !ins->powered )
+	{
+		SimBoard &b = sim_boards[h->board];
+		int tmo = h->tmo;
+		sim_unlock();
+		pthread_mutex_lock(&b.bus);
+		sim_wait_ns(sim_timeout_ns(tmo));
+		pthread_mutex_unlock(&b.bus);
+		return sim_status(ERR | TIMO, EABO, 0);
+	}
+	*spr = (char) ins->stb;
+	ins->stb &= ~0x40;		/* RQS cleared by the serial poll */
+	SimBoard &b = sim_boards[h->board];
+	b.addressed = 0;
+	sim_unlock();
+
+	pthread_mutex_lock(&b.bus);
+	sim_wait_ns(sim_transfer_ns(b, 1));
+	pthread_mutex_unlock(&b.bus);
+	return sim_status(CMPL, 0, 1);
+}
+
+int ibcmd(int ud, char *buf, int cnt)
+{
+	SimHandle *h = sim_handle(ud);
+	if (h == NULL)
+	{
+		sim_unlock();
+		return ibsta;
+	}
+	if (!sim_is_board(ud))
+	{
+		sim_unlock();
+		return sim_error(ECIC);
+	}
+
+	SimBoard &b = sim_boards[ud];
+	for (int i = 0; i < cnt; i++)
+	{
+		if ((unsigned char) buf[i] == DCL)
+			for (unsigned int k = 0; k < b.instruments.size(); k++)
+				b.instruments[k].output = "";
+	}
+	long long t = sim_transfer_ns(b, cnt);
+	int monitor = sim_monitor(ud);
+	sim_unlock();
+
+	pthread_mutex_lock(&b.bus);
+	sim_tap(monitor, (const unsigned char *) buf, cnt, NULL, 0, false, 0);
+	sim_wait_ns(t);
+	pthread_mutex_unlock(&b.bus);
+	return sim_status(CMPL, 0, cnt);
+}
+
+int ibsre(int ud, int v)
+{
+	return sim_device_op(ud, (v != 0) ? 'r' : 'l');
+}
+
+int ibsic(int ud)
+{
+	SimHandle *h = sim_handle(ud);
+	sim_unlock();
+	if (h == NULL)
+		return ibsta;
+	if (!sim_is_board(ud))
+		return sim_error(EARG);
+	return sim_status(CMPL, 0, 0);
+}
+
+int ibwait(int ud, int mask)
+{
+	(void) mask;	/* Does not wait: returns the current SRQI / RQS status */
+	SimHandle *h = sim_handle(ud);
+	if (h == NULL)
+	{
+		sim_unlock();
+		return ibsta;
+	}
+	int sta = CMPL;
+	vector<SimInstrument> &v = sim_boards[h->board].instruments;
+	for (unsigned int i = 0; i < v.size(); i++)
+	{
+		if (!v[i].powered || !(v[i].stb & 0x40))
+			continue;
+		if (sim_is_board(ud))
+			sta |= SRQI;
+		else if ( (v[i].pad == h->pad) && (v[i].sad == h->sad) )
+			sta |= RQS;
+	}
+	sim_unlock();
+	return sim_status(sta, 0, 0);
+}
+
+int iblines(int ud, short *lines)
+{
+	SimHandle *h = sim_handle(ud);
+	sim_unlock();
+	if (h == NULL)
+		return ibsta;
+	*lines = 0;
+	return sim_status(CMPL, 0, 0);
+}
+
+
+/******************************************************************************
+ *
+ * NI-488.2 functions
+ *
+ *****************************************************************************/
+
+void Send(int board, Addr4882_t addr, char *buf, int cnt, int eotmode)
+{
+	if (sim_handle(board) == NULL)
+	{
+		sim_unlock();
+		return;
+	}
+	if (sim_replay_call("Send", board, GetPAD(addr), GetSAD(addr), NULL, 0) != -1)
+		return;
+	int tmo = sim_boards[board].config.count(IbcTMO) ? sim_boards[board].config[IbcTMO] : T3s;
+	sim_send(board, GetPAD(addr), GetSAD(addr), buf, cnt, tmo, false, eotmode != NULLend);
+}
+
+void SendList(int board, Addr4882_t addrs[], char *buf, int cnt, int eotmode)
+{
+	SimHandle *h = sim_handle(board);
+	if (h == NULL)
+	{
+		sim_unlock();
+		return;
+	}
+	if (sim_replay_call("SendList", board, h->pad, h->sad, NULL, 0) != -1)
+		return;
+
+	/* All the listeners must be there before the transfer starts. */
+	vector<SimInstrument *> listeners;
+	for (int i = 0; addrs[i] != NOADDR; i++)
+	{
+		SimInstrument *ins = sim_find(board, GetPAD(addrs[i]), GetSAD(addrs[i]));
+		if ( (ins == NULL) || !ins->powered )
+		{
+			sim_unlock();
+			sim_error(ENOL);
+			return;
+		}
+		listeners.push_back(ins);
+	}
+
+	/* One transfer, every listener gets the data. The handshake is shared:
+	   a listener which fails makes the whole transfer fail. */
+	SimBoard &b = sim_boards[board];
+	int fault = 0;
+	for (unsigned int i = 0; (i < listeners.size()) && (fault == 0); i++)
+		fault = sim_fault(b, listeners[i]);
+	if (fault == 0)
+		for (unsigned int i = 0; i < listeners.size(); i++)
+			sim_instrument_write(listeners[i], buf, cnt);
+
+	vector<unsigned char> cmd;
+	int own = b.config.count(IbcPAD) ? b.config[IbcPAD] : 0;
+	cmd.push_back(UNL);
+	cmd.push_back((unsigned char) (0x40 | own));				/* MTA */
+	for (int i = 0; addrs[i] != NOADDR; i++)
+	{
+		cmd.push_back((unsigned char) (0x20 | GetPAD(addrs[i])));	/* MLA */
+		if (GetSAD(addrs[i]) != 0)
+			cmd.push_back((unsigned char) GetSAD(addrs[i]));	/* MSA */
+	}
+	int monitor = sim_monitor(board);
+	long long byte_ns = (sim_transfer_ns(b, cnt) - sim_handshake_ns) / ((cnt > 0) ? cnt : 1);
+	long long t = sim_transfer_ns(b, cnt) + listeners.size() * sim_handshake_ns / 4;
+	int tmo = b.config.count(IbcTMO) ? b.config[IbcTMO] : T3s;
+	sim_unlock();
+
+	pthread_mutex_lock(&b.bus);
+	if (fault == -1)
+		sim_wait_ns(sim_timeout_ns(tmo));
+	else if (fault == 0)
+	{
+		sim_tap(monitor, &cmd[0], (int) cmd.size(), buf, cnt, eotmode != NULLend, byte_ns);
+		sim_wait_ns(t);
+	}
+	pthread_mutex_unlock(&b.bus);
+
+	if (fault == -1)
+		sim_status(ERR | TIMO | CMPL, EABO, 0);
+	else if (fault != 0)
+		sim_error(fault);
+	else
+		sim_status(CMPL, 0, cnt);
+}
+
+void Receive(int board, Addr4882_t addr, char *buf, int cnt, int termination)
+{
+	if (sim_handle(board) == NULL)
+	{
+		sim_unlock();
+		return;
+	}
+	if (sim_replay_call("Receive", board, GetPAD(addr), GetSAD(addr), buf, cnt) != -1)
+		return;
+	int eos = (termination == STOPend) ? 0 : (REOS | (termination & 0xff));
+	int tmo = sim_boards[board].config.count(IbcTMO) ? sim_boards[board].config[IbcTMO] : T3s;
+	sim_receive(board, GetPAD(addr), GetSAD(addr), buf, cnt, eos, tmo);
+}
+
+void SendIFC(int board)
+{
+	if (sim_handle(board) == NULL)
+	{
+		sim_unlock();
+		return;
+	}
+	SimBoard &b = sim_boards[board];
+	for (unsigned int i = 0; i < b.instruments.size(); i++)
+		b.instruments[i].output = "";
+	sim_unlock();
+	sim_status(CMPL | CIC, 0, 0);
+}
+
+void SendLLO(int board)
+{
+	sim_device_op(board, 'o');
+}
+
+void DevClear(int board, Addr4882_t addr)
+{
+	if (sim_handle(board) == NULL)
+	{
+		sim_unlock();
+		return;
+	}
+	SimInstrument *ins = sim_find(board, GetPAD(addr), GetSAD(addr));
+	if ( (ins == NULL) || !ins->powered )
+	{
+		sim_unlock();
+		sim_error(ENOL);
+		return;
+	}
+	ins->output = "";
+	sim_unlock();
+	sim_status(CMPL, 0, 0);
+}
+
+void DevClearList(int board, Addr4882_t addrs[])
+{
+	for (int i = 0; addrs[i] != NOADDR; i++)
+	{
+		DevClear(board, addrs[i]);
+		if (t_ibsta & ERR)
+			return;
+	}
+}
+
+static void sim_list_op(int board, Addr4882_t addrs[], bool remote)
+{
+	if (sim_handle(board) == NULL)
+	{
+		sim_unlock();
+		return;
+	}
+	for (int i = 0; (addrs != NULL) && (addrs[i] != NOADDR); i++)
+	{
+		SimInstrument *ins = sim_find(board, GetPAD(addrs[i]), GetSAD(addrs[i]));
+		if (ins != NULL)
+			ins->remote = remote;
+	}
+	sim_unlock();
+	sim_status(CMPL, 0, 0);
+}
+
+void EnableLocal(int board, Addr4882_t addrs[])
+{
+	sim_list_op(board, addrs, false);
+}
+
+void EnableRemote(int board, Addr4882_t addrs[])
+{
+	sim_list_op(board, addrs, true);
+}
+
+void Trigger(int board, Addr4882_t addr)
+{
+	Addr4882_t list[2];
+	list[0] = addr;
+	list[1] = NOADDR;
+	TriggerList(board, list);
+}
+
+void TriggerList(int board, Addr4882_t addrs[])
+{
+	if (sim_handle(board) == NULL)
+	{
+		sim_unlock();
+		return;
+	}
+	int nb = 0;
+	for (int i = 0; (addrs != NULL) && (addrs[i] != NOADDR); i++)
+	{
+		if (!sim_listening(board, GetPAD(addrs[i]), GetSAD(addrs[i])))
+		{
+			sim_unlock();
+			sim_error(ENOL);
+			return;
+		}
+		nb++;
+	}
+	/* Listeners are addressed, then one GET command byte. */
+	SimBoard &b = sim_boards[board];
+	long long t = sim_transfer_ns(b, nb + 1);
+	sim_unlock();
+
+	pthread_mutex_lock(&b.bus);
+	sim_wait_ns(t);
+	pthread_mutex_unlock(&b.bus);
+	sim_status(CMPL, 0, 0);
+}
+
+void ReadStatusByte(int board, Addr4882_t addr, short *result)
+{
+	if (sim_handle(board) == NULL)
+	{
+		sim_unlock();
+		return;
+	}
+	SimInstrument *ins = sim_find(board, GetPAD(addr), GetSAD(addr));
+	if ( (ins == NULL) || !ins->powered )
+	{
+		sim_unlock();
+		sim_status(ERR | TIMO, EABO, 0);
+		return;
+	}
+	*result = ins->stb;
+	ins->stb &= ~0x40;
+	SimBoard &b = sim_boards[board];
+	sim_unlock();
+
+	pthread_mutex_lock(&b.bus);
+	sim_wait_ns(sim_transfer_ns(b, 1));
+	pthread_mutex_unlock(&b.bus);
+	sim_status(CMPL, 0, 1);
+}
+
+void FindLstn(int board, Addr4882_t pads[], Addr4882_t results[], int limit)
+{
+	if (sim_handle(board) == NULL)
+	{
+		sim_unlock();
+		return;
+	}
+
+	int n = 0;
+	int board_pad = sim_boards[board].config.count(IbcPAD) ? sim_boards[board].config[IbcPAD] : 0;
+	vector<SimInstrument> &v = sim_boards[board].instruments;
+	for (int i = 0; (pads[i] != NOADDR) && (n < limit); i++)
+	{
+		/* The board listens too, as with the NI driver. */
+		if (GetPAD(pads[i]) == board_pad)
+			results[n++] = MakeAddr(board_pad, 0);
+		for (unsigned int k = 0; (k < v.size()) && (n < limit); k++)
+		{
+			if ( (v[k].pad == GetPAD(pads[i])) && v[k].powered )
+				results[n++] = MakeAddr(v[k].pad, v[k].sad);
+		}
+	}
+	if (n < limit)
+		results[n] = NOADDR;
+	SimBoard &b = sim_boards[board];
+	sim_unlock();
+
+	pthread_mutex_lock(&b.bus);
+	for (int i = 0; pads[i] != NOADDR; i++)
+		sim_wait_ns(sim_handshake_ns);
+	pthread_mutex_unlock(&b.bus);
+	sim_status(CMPL, 0, n);
+}
+
+void AllSpoll(int board, Addr4882_t addrs[], Addr4882_t results[])
+{
+	if (sim_handle(board) == NULL)
+	{
+		sim_unlock();
+		return;
+	}
+	int n = 0;
+	for (int i = 0; addrs[i] != NOADDR; i++, n++)
+	{
+		SimInstrument *ins = sim_find(board, GetPAD(addrs[i]), GetSAD(addrs[i]));
+		if ( (ins == NULL) || !ins->powered )
+		{
+			sim_unlock();
+			sim_status(ERR | TIMO, EABO, n);
+			return;
+		}
+		results[i] = (Addr4882_t) (ins->stb & 0xff);
+		ins->stb &= ~0x40;
+	}
+	SimBoard &b = sim_boards[board];
+	long long t = sim_handshake_ns + n * sim_transfer_ns(b, 1) / 2;
+	sim_unlock();
+
+	pthread_mutex_lock(&b.bus);
+	sim_wait_ns(t);
+	pthread_mutex_unlock(&b.bus);
+	sim_status(CMPL, 0, n);
+}
+
+void FindRQS(int board, Addr4882_t addrs[], short *status)
+{
+	if (sim_handle(board) == NULL)
+	{
+		sim_unlock();
+		return;
+	}
+	for (int i = 0; addrs[i] != NOADDR; i++)
+	{
+		SimInstrument *ins = sim_find(board, GetPAD(addrs[i]), GetSAD(addrs[i]));
+		if ( (ins != NULL) && ins->powered && (ins->stb & 0x40) )
+		{
+			*status = ins->stb;
+			ins->stb &= ~0x40;
+			sim_unlock();
+			sim_status(CMPL, 0, i);
+			return;
+		}
+	}
+	sim_unlock();
+	sim_status(ERR, ETAB, 0);
+}
+
+void TestSRQ(int board, short *result)
+{
+	sim_handle(board);
+	*result = 0;
+	if (sim_is_board(board) && sim_boards[board].present)
+	{
+		vector<SimInstrument> &v = sim_boards[board].instruments;
+		for (unsigned int i = 0; i < v.size(); i++)
+			if (v[i].powered && (v[i].stb & 0x40))
+				*result = 1;
+	}
+	sim_unlock();
+	sim_status(CMPL, 0, 0);
+}
+
+void WaitSRQ(int board, short *result)
+{
+	TestSRQ(board, result);
+}
+
+void PPollConfig(int board, Addr4882_t addr, int line, int sense)
+{
+	if (sim_handle(board) == NULL)
+	{
+		sim_unlock();
+		return;
+	}
+	SimInstrument *ins = sim_find(board, GetPAD(addr), GetSAD(addr));
+	if ( (ins == NULL) || !ins->powered || (line < 1) || (line > 8) )
+	{
+		sim_unlock();
+		sim_error((ins == NULL) ? ENOL : EARG);
+		return;
+	}
+	ins->pp_line = line;
+	ins->pp_sense = sense ? 1 : 0;
+	sim_unlock();
+	sim_status(CMPL, 0, 0);
+}
+
+void PPollUnconfig(int board, Addr4882_t addrs[])
+{
+	if (sim_handle(board) == NULL)
+	{
+		sim_unlock();
+		return;
+	}
+	vector<SimInstrument> &v = sim_boards[board].instruments;
+	for (unsigned int i = 0; i < v.size(); i++)
+	{
+		bool match = (addrs == NULL);
+		for (int k = 0; !match && (addrs[k] != NOADDR); k++)
+			match = (v[i].pad == GetPAD(addrs[k])) && (v[i].sad == GetSAD(addrs[k]));
+		if (match)
+			v[i].pp_line = 0;
+	}
+	sim_unlock();
+	sim_status(CMPL, 0, 0);
+}
+
+/*
+ * The individual status (ist) of an instrument is its RQS bit.
+ */
+void PPoll(int board, short *result)
+{
+	if (sim_handle(board) == NULL)
+	{
+		sim_unlock();
+		return;
+	}
+	*result = 0;
+	vector<SimInstrument> &v = sim_boards[board].instruments;
+	for (unsigned int i = 0; i < v.size(); i++)
+	{
+		int ist = (v[i].stb & 0x40) ? 1 : 0;
+		if (v[i].powered && v[i].pp_line && (ist == v[i].pp_sense))
+			*result |= 1 << (v[i].pp_line - 1);
+	}
+	SimBoard &b = sim_boards[board];
+	sim_unlock();
+
+	pthread_mutex_lock(&b.bus);
+	sim_wait_ns(2000);	/* Parallel poll lasts about 2 us */
+	pthread_mutex_unlock(&b.bus);
+	sim_status(CMPL, 0, 0);
+}
+
+void ResetSys(int board, Addr4882_t addrs[])
+{
+	(void) addrs;	/* IFC resets every device of the bus */
+	SendIFC(board);
+}
+
+
+/******************************************************************************
+ *
+ * Thread status and simulator API (gpibSim.h)
+ *
+ *****************************************************************************/
+
+int ThreadIbsta(void)
+{
+	return t_ibsta;
+}
+
+int ThreadIberr(void)
+{
+	return t_iberr;
+}
+
+int ThreadIbcnt(void)
+{
+	return (int) t_ibcntl;
+}
+
+long ThreadIbcntl(void)
+{
+	return t_ibcntl;
+}
+
+int gpibSimLoad(const char *file)
+{
+	pthread_mutex_lock(&sim_lock);
+	sim_init();
+	sim_clear_bus();
+
+	ifstream in(file);
+	int ret = (in) ? sim_parse(in, file) : -1;
+	if (ret != 0)
+		sim_clear_bus();
+	sim_unlock();
+	return ret;
+}
+
+void gpibSimReset(void)
+{
+	pthread_mutex_lock(&sim_lock);
+	sim_init();
+	sim_clear_bus();
+	sim_unlock();
+}
+
+int gpibSimAddBoard(int board)
+{
+	if ( (board < 0) || (board >= SIM_MAX_BOARDS) )
+		return -1;
+	pthread_mutex_lock(&sim_lock);
+	sim_init();
+	sim_boards[board].present = true;
+	sim_unlock();
+	return 0;
+}
+
+int gpibSimAddInstrument(int board, int pad, int sad, const char *name,
+                         const char *idn, int mode)
+{
+	pthread_mutex_lock(&sim_lock);
+	sim_init();
+	int ret = sim_add_instrument(board, pad, sad, name, idn, mode);
+	sim_unlock();
+	return ret;
+}
+
+int gpibSimSetReply(int board, int pad, int sad, const char *query, const char *reply)
+{
+	pthread_mutex_lock(&sim_lock);
+	sim_init();
+	SimInstrument *ins = sim_find(board, pad, sad);
+	if (ins != NULL)
+		ins->replies[query] = reply;
+	sim_unlock();
+	return (ins != NULL) ? 0 : -1;
+}
+
+int gpibSimSetPower(int board, int pad, int sad, int on)
+{
+	pthread_mutex_lock(&sim_lock);
+	sim_init();
+	SimInstrument *ins = sim_find(board, pad, sad);
+	if (ins != NULL)
+		ins->powered = (on != 0);
+	sim_unlock();
+	return (ins != NULL) ? 0 : -1;
+}
+
+int gpibSimSetStatusByte(int board, int pad, int sad, int stb)
+{
+	pthread_mutex_lock(&sim_lock);
+	sim_init();
+	SimInstrument *ins = sim_find(board, pad, sad);
+	if (ins != NULL)
+		ins->stb = stb & 0xff;
+	sim_unlock();
+	return (ins != NULL) ? 0 : -1;
+}
+
+int gpibSimSetFaults(int board, int pad, int sad, double timo, double enol, double eabo)
+{
+	pthread_mutex_lock(&sim_lock);
+	sim_init();
+	SimInstrument *ins = sim_find(board, pad, sad);
+	if (ins != NULL)
+	{
+		ins->p_timo = timo;
+		ins->p_enol = enol;
+		ins->p_eabo = eabo;
+	}
+	sim_unlock();
+	return (ins != NULL) ? 0 : -1;
+}
+
+int gpibSimSetHS488(int board, int pad, int sad, int on)
+{
+	pthread_mutex_lock(&sim_lock);
+	sim_init();
+	SimInstrument *ins = sim_find(board, pad, sad);
+	if (ins != NULL)
+		ins->hs488 = (on != 0);
+	sim_unlock();
+	return (ins != NULL) ? 0 : -1;
+}
+
+int gpibSimSetTiming(int board, int pad, int sad, int timing)
+{
+	pthread_mutex_lock(&sim_lock);
+	sim_init();
+	SimInstrument *ins = sim_find(board, pad, sad);
+	if (ins != NULL)
+		ins->timing = timing;
+	sim_unlock();
+	return (ins != NULL) ? 0 : -1;
+}
+
+int gpibSimSetFillSize(int board, int pad, int sad, long size)
+{
+	pthread_mutex_lock(&sim_lock);
+	sim_init();
+	SimInstrument *ins = sim_find(board, pad, sad);
+	if (ins != NULL)
+		ins->fill_size = size;
+	sim_unlock();
+	return (ins != NULL) ? 0 : -1;
+}
+
+void gpibSimSetLatency(long handshake_ns, long byte_ns, double scale)
+{
+	pthread_mutex_lock(&sim_lock);
+	sim_init();
+	sim_handshake_ns = handshake_ns;
+	sim_byte_ns = byte_ns;
+	sim_scale = scale;
+	sim_unlock();
+}
+
+int gpibSimSetTap(int board, int tapped)
+{
+	pthread_mutex_lock(&sim_lock);
+	sim_init();
+	int r = -1;
+	if ( (board >= 0) && (board < SIM_MAX_BOARDS) && sim_boards[board].present &&
+	     (tapped >= -1) && (tapped < SIM_MAX_BOARDS) && (tapped != board) )
+	{
+		sim_boards[board].tap = tapped;
+		r = 0;
+	}
+	sim_unlock();
+	return r;
+}
+
+long gpibSimMonitorRead(int board, long long *times, unsigned char *bytes,
+                        unsigned char *flags, long max, long wait_us)
+{
+	pthread_mutex_lock(&sim_lock);
+	sim_init();
+	bool lon = (board >= 0) && (board < SIM_MAX_BOARDS) && sim_boards[board].present &&
+	           sim_boards[board].config.count(IbcLON) && (sim_boards[board].config[IbcLON] != 0);
+	sim_unlock();
+	if (!lon)
+		return -1;
+
+	for (long waited = 0; ; waited += 1000)
+	{
+		long n = 0;
+		pthread_mutex_lock(&sim_tap_lock);
+		deque<SimCycle> &capture = sim_captures[board];
+		for (; (n < max) && !capture.empty(); n++)
+		{
+			times[n] = capture.front().time;
+			bytes[n] = capture.front().byte;
+			flags[n] = capture.front().flags;
+			capture.pop_front();
+		}
+		pthread_mutex_unlock(&sim_tap_lock);
+		if ( (n > 0) || (waited >= wait_us) )
+			return n;
+		usleep(1000);
+	}
+}
+
+int gpibSimReplay(const char *file, double speed)
+{
+	pthread_mutex_lock(&sim_lock);
+	sim_init();
+	int ret = sim_replay_load(file, speed);
+	sim_unlock();
+	return ret;
+}
+
+int gpibSimOpenHandles(void)
+{
+	int n = 0;
+	pthread_mutex_lock(&sim_lock);
+	sim_init();
+	for (int h = SIM_FIRST_DEV_HANDLE; h < SIM_MAX_HANDLES; h++)
+		if (sim_handles[h].used)
+			n++;
+	sim_unlock();
+	return n;
+}
+
+}	/* extern "C" */
@@ -0,0 +1,88 @@
+/*
+ * Simulated GPIB driver.
+ *
+ * gpibSim.cpp implements the NI-488 / NI-488.2 entry points declared in
+ * ugpib.h on top of virtual instruments, so that gpibDevice and the Tango
+ * server can be run and load-tested without gpib hardware. It is selected
+ * at build time with "make linux=1 SIM=1" (GPIB_SIM defined).
+ *
+ * The simulated bus is described by the file named by the GPIBSIM_CONFIG
+ * environment variable (see gpibSim.conf), or built with the functions
+ * below. Without configuration, the bus has one empty board, gpib0.
+ */
+#ifndef _GPIBSIM_H
+#define _GPIBSIM_H
+
+#include "ugpib.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Instrument behaviour for queries which have no scripted reply.
+ */
+#define GPIBSIM_ECHO    0   /* Next read returns the written string      */
+#define GPIBSIM_SCRIPT  1   /* Only scripted replies, else read times out */
+#define GPIBSIM_FILL    2   /* Reads always return a byte pattern        */
+                            /* (of the fill size if set, gpibSimSetFillSize) */
+
+/*
+ * Per-thread copies of ibsta, iberr and ibcntl, as in NI-488.2.
+ */
+extern int  ThreadIbsta(void);
+extern int  ThreadIberr(void);
+extern int  ThreadIbcnt(void);
+extern long ThreadIbcntl(void);
+
+/*
+ * Bus configuration. Secondary addresses use the driver convention:
+ * 0 = none, 0x60-0x7E otherwise.
+ */
+extern int  gpibSimLoad(const char *file);   /* Replace bus with file     */
+extern void gpibSimReset(void);              /* Empty bus, board gpib0    */
+extern int  gpibSimAddBoard(int board);
+extern int  gpibSimAddInstrument(int board, int pad, int sad,
+                                 const char *name, const char *idn, int mode);
+extern int  gpibSimSetReply(int board, int pad, int sad,
+                            const char *query, const char *reply);
+extern int  gpibSimSetPower(int board, int pad, int sad, int on);
+extern int  gpibSimSetStatusByte(int board, int pad, int sad, int stb);
+extern int  gpibSimSetFaults(int board, int pad, int sad,
+                             double timo, double enol, double eabo);
+extern int  gpibSimSetFillSize(int board, int pad, int sad, long size);
+extern int  gpibSimSetHS488(int board, int pad, int sad, int on);
+extern int  gpibSimSetTiming(int board, int pad, int sad, int timing);
+extern void gpibSimSetLatency(long handshake_ns, long byte_ns, double scale);
+
+/*
+ * Bus monitor: board sees the traffic of the bus of board tapped (-1 = no
+ * tap) while in listen-only mode (IbcLON). gpibSimMonitorRead() returns up
+ * to max bytes seen, with their time (CLOCK_MONOTONIC, ns) and flags, after
+ * waiting up to wait_us for the first one. Return -1 if the board is not
+ * in listen-only mode.
+ */
+#define GPIBSIM_ATN     0x01        /* Command byte                  */
+#define GPIBSIM_EOI     0x02        /* Last data byte of a transfer  */
+
+extern int  gpibSimSetTap(int board, int tapped);
+extern long gpibSimMonitorRead(int board, long long *times, unsigned char *bytes,
+                               unsigned char *flags, long max, long wait_us);
+
+/*
+ * Replay a bus traffic log (gpibRecorder.h) on top of the bus, speed = 1
+ * for the original timing, 0 for no waiting. Return -1 if it cannot be
+ * read.
+ */
+extern int  gpibSimReplay(const char *file, double speed);
+
+/*
+ * Bookkeeping, e.g. for leak checks.
+ */
+extern int  gpibSimOpenHandles(void);        /* ibfind/ibdev not ibonl'ed */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _GPIBSIM_H */
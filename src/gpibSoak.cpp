@@ -0,0 +1,223 @@
+/*
+ * Soak test for GpibDeviceServer.
+ *
+ * Loops Init / Close / Open / BCGetConnectedDeviceList / WriteRead cycles
+ * on the devices given on the command line, and samples the server process
+ * every <period> cycles through the "SIM:STATS?" query of the simulated
+ * driver: open driver handles, heap in use and RSS. It fails (exit code 1)
+ * when one of them grows without bound:
+ *  - handles: any sample above the first sample after warm-up,
+ *  - heap and RSS: the lowest value of the last window of samples is above
+ *    the highest value of the first window by more than the tolerance.
+ *
+ * The server must run on the simulated driver (make linux=1 SIM=1) and the
+ * devices be opened by address on gpib0 (GpibDeviceAddress property), as
+ * the Open command uses it:
+ *
+ *   GPIBSIM_CONFIG=gpibSim.conf GpibDeviceServer sim &
+ *   gpibSoak -n 1000000 -p 10000 sim/gpib/load
+ */
+
+#include <tango.h>
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+using namespace std;
+
+struct SoakSample
+{
+	long   cycle;
+	long   handles;
+	double heap;	// bytes
+	double rss;	// kB
+};
+
+static const char *soak_cycle_cmds[] = {"Init", "Close", "Open", "BCGetConnectedDeviceList", "WriteRead"};
+
+/*
+ * Run one cycle on a device. Returns the number of failed commands.
+ */
+static int soak_cycle(Tango::DeviceProxy &proxy, string &last_error)
+{
+	int errors = 0;
+
+	for (unsigned int c = 0; c < sizeof(soak_cycle_cmds) / sizeof(soak_cycle_cmds[0]); c++)
+	{
+		try
+		{
+			if (strcmp(soak_cycle_cmds[c], "WriteRead") == 0)
+			{
+				Tango::DeviceData din;
+				din << string("*IDN?");
+				proxy.command_inout(soak_cycle_cmds[c], din);
+			}
+			else
+				proxy.command_inout(soak_cycle_cmds[c]);
+		}
+		catch (Tango::DevFailed &e)
+		{
+			errors++;
+			last_error = string(soak_cycle_cmds[c]) + ": " + string(e.errors[0].desc.in());
+		}
+	}
+	return errors;
+}
+
+static bool soak_sample(Tango::DeviceProxy &proxy, long cycle, SoakSample &s)
+{
+	string answer;
+	try
+	{
+		Tango::DeviceData din, dout;
+		din << string("SIM:STATS?");
+		dout = proxy.command_inout("WriteRead", din);
+		dout >> answer;
+	}
+	catch (Tango::DevFailed &e)
+	{
+		cerr << "SIM:STATS? failed: " << e.errors[0].desc.in() << endl;
+		return false;
+	}
+
+	unsigned long heap = 0;
+	s.cycle = cycle;
+	s.rss = 0;
+	if (sscanf(answer.c_str(), "handles=%ld heap=%lu rss=%lf", &s.handles, &heap, &s.rss) != 3)
+	{
+		cerr << "Unexpected SIM:STATS? answer '" << answer << "' (server not built with SIM=1 ?)" << endl;
+		return false;
+	}
+	s.heap = heap;
+	return true;
+}
+
+static void usage(const char *prog)
+{
+	cerr << "usage: " << prog << " [-n <cycles>] [-p <period>] [-w <warm-up cycles>]" << endl
+	     << "       [-m <heap/rss tolerance kB>] <device> [<device> ...]" << endl
+	     << "  -n  number of cycles (default 1000000)" << endl
+	     << "  -p  cycles between samples (default 1000)" << endl
+	     << "  -w  cycles before the first reference sample (default 10 periods)" << endl
+	     << "  -m  allowed heap and RSS growth (default 1024 kB)" << endl;
+	exit(1);
+}
+
+int main(int argc, char *argv[])
+{
+	long           cycles = 1000000;
+	long           period = 1000;
+	long           warmup = -1;
+	double         tolerance = 1024;
+	vector<string> devices;
+
+	for (int i = 1; i < argc; i++)
+	{
+		if ( (strcmp(argv[i], "-n") == 0) && (i + 1 < argc) )
+			cycles = atol(argv[++i]);
+		else if ( (strcmp(argv[i], "-p") == 0) && (i + 1 < argc) )
+			period = atol(argv[++i]);
+		else if ( (strcmp(argv[i], "-w") == 0) && (i + 1 < argc) )
+			warmup = atol(argv[++i]);
+		else if ( (strcmp(argv[i], "-m") == 0) && (i + 1 < argc) )
+			tolerance = atof(argv[++i]);
+		else if (argv[i][0] == '-')
+			usage(argv[0]);
+		else
+			devices.push_back(argv[i]);
+	}
+	if ( devices.empty() || (period <= 0) )
+		usage(argv[0]);
+	if (warmup < 0)
+		warmup = 10 * period;
+
+	vector<Tango::DeviceProxy *> proxies;
+	try
+	{
+		for (unsigned int d = 0; d < devices.size(); d++)
+			proxies.push_back(new Tango::DeviceProxy(devices[d]));
+	}
+	catch (Tango::DevFailed &e)
+	{
+		Tango::Except::print_exception(e);
+		return 1;
+	}
+
+	vector<SoakSample> samples;
+	long               errors = 0;
+	string             last_error;
+	time_t             start = time(NULL);
+
+	cout << setw(10) << "cycle" << setw(9) << "handles" << setw(12) << "heap kB"
+	     << setw(10) << "rss kB" << setw(9) << "errors" << setw(10) << "cycles/s" << endl;
+
+	for (long n = 0; n <= cycles; n++)
+	{
+		if ( (n % period == 0) || (n == cycles) )
+		{
+			SoakSample s;
+			if (!soak_sample(*proxies[0], n, s))
+				return 1;
+			if (n >= warmup)
+				samples.push_back(s);
+
+			long elapsed = time(NULL) - start;
+			cout << setw(10) << n << setw(9) << s.handles
+			     << fixed << setprecision(0) << setw(12) << s.heap / 1024 << setw(10) << s.rss
+			     << setw(9) << errors << setw(10) << (elapsed > 0 ? n / elapsed : 0) << endl;
+			if (errors > 0)
+				cout << "           last error: " << last_error << endl;
+
+			// An open handle more than at the reference sample is a leak.
+			if ( (samples.size() > 0) && (s.handles > samples[0].handles) )
+			{
+				cout << "FAILED: driver handles grew from " << samples[0].handles
+				     << " to " << s.handles << " (cycle " << n << ")" << endl;
+				return 1;
+			}
+		}
+		if (n == cycles)
+			break;
+		for (unsigned int d = 0; d < proxies.size(); d++)
+			errors += soak_cycle(*proxies[d], last_error);
+	}
+
+	// Compare the first and last windows of samples.
+	unsigned long window = samples.size() / 4;
+	if (window == 0)
+	{
+		cout << "Not enough samples after warm-up to check heap and RSS growth." << endl;
+		return 0;
+	}
+	double heap_first = 0, rss_first = 0;
+	double heap_last = samples.back().heap, rss_last = samples.back().rss;
+	for (unsigned long i = 0; i < window; i++)
+	{
+		heap_first = max(heap_first, samples[i].heap);
+		rss_first = max(rss_first, samples[i].rss);
+		heap_last = min(heap_last, samples[samples.size() - 1 - i].heap);
+		rss_last = min(rss_last, samples[samples.size() - 1 - i].rss);
+	}
+
+	bool failed = false;
+	if ((heap_last - heap_first) / 1024 > tolerance)
+	{
+		cout << "FAILED: heap in use grew by " << (heap_last - heap_first) / 1024 << " kB" << endl;
+		failed = true;
+	}
+	if (rss_last - rss_first > tolerance)
+	{
+		cout << "FAILED: RSS grew by " << rss_last - rss_first << " kB" << endl;
+		failed = true;
+	}
+	if (!failed)
+		cout << "PASSED: " << cycles << " cycles, " << errors << " command errors." << endl;
+
+	for (unsigned int d = 0; d < proxies.size(); d++)
+		delete proxies[d];
+	return failed ? 1 : 0;
+}
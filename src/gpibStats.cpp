@@ -0,0 +1,365 @@
+#include <string.h>
+#include "gpibStats.h"
+
+#ifdef WIN32
+#include <windows.h>
+#else
+#include <time.h>
+#endif
+
+#if defined(_solaris) && !defined(__GNUC__)
+#include <atomic.h>
+#endif
+
+/**
+ * Operation type names, indexed by GpibOp.
+ */
+static const char *op_names[GPIB_NB_OP] = {
+                                              "write",
+                                              "read",
+                                              "writeRead",
+                                              "binary",
+                                              "probe"
+                                          };
+
+/**
+ * Counter names, indexed by GpibCounter.
+ */
+static const char *counter_names[GPIB_NB_COUNTER] = {
+                                                        "transactions",
+                                                        "bytes_written",
+                                                        "bytes_read",
+                                                        "timeouts",
+                                                        "errors",
+                                                        "probes"
+                                                    };
+
+/**
+ * iberr short names (see error_array in gpibDevice.cpp).
+ */
+static const char *error_names[GPIB_NB_IBERR] = {
+                                                    "EDVR", "ECIC", "ENOL", "EADR", "EARG",
+                                                    "ESAC", "EABO", "ENEB", "EDMA", "EBTO",
+                                                    "E10",  "ECAP", "EFSO", "E13",  "EBUS",
+                                                    "ESTB", "ESRQ", "E17",  "E18",  "E19",
+                                                    "ETAB"
+                                                };
+
+/**
+ * Driver call time of the thread (gpibThreadIoTime).
+ */
+#ifdef WIN32
+static __declspec(thread) long long thread_io = 0;
+#else
+static __thread long long thread_io = 0;
+#endif
+
+/**
+ * Counters of the boards, shared by all gpibDevice objects of the process.
+ */
+static gpibCounters board_counters[GPIB_NB_COUNTED_BOARDS];
+
+
+unsigned long long gpibAtomicAdd(volatile unsigned long long *p, unsigned long long n)
+{
+#if defined(WIN32)
+	return (unsigned long long) InterlockedExchangeAdd64((volatile LONGLONG *) p, (LONGLONG) n) + n;
+#elif defined(__GNUC__)
+	return __sync_add_and_fetch(p, n);
+#elif defined(_solaris)
+	return atomic_add_64_nv((volatile uint64_t *) p, (int64_t) n);
+#else
+	return *p += n;
+#endif
+}
+
+
+unsigned long long gpibAtomicCompareExchange(volatile unsigned long long *p,
+                                             unsigned long long old, unsigned long long v)
+{
+#if defined(WIN32)
+	return (unsigned long long) InterlockedCompareExchange64((volatile LONGLONG *) p, (LONGLONG) v, (LONGLONG) old);
+#elif defined(__GNUC__)
+	return __sync_val_compare_and_swap(p, old, v);
+#elif defined(_solaris)
+	return atomic_cas_64((volatile uint64_t *) p, old, v);
+#else
+	unsigned long long seen = *p;
+	if (seen == old)
+		*p = v;
+	return seen;
+#endif
+}
+
+
+unsigned long long gpibAtomicExchange(volatile unsigned long long *p, unsigned long long v)
+{
+	unsigned long long old = gpibAtomicAdd(p, 0);
+
+	for (;;)
+	{
+		unsigned long long seen = gpibAtomicCompareExchange(p, old, v);
+		if (seen == old)
+			return old;
+		old = seen;
+	}
+}
+
+
+void gpibAtomicMax(volatile unsigned long long *p, unsigned long long v)
+{
+	unsigned long long old = gpibAtomicAdd(p, 0);
+
+	while (old < v)
+	{
+		unsigned long long seen = gpibAtomicCompareExchange(p, old, v);
+		if (seen == old)
+			return;
+		old = seen;
+	}
+}
+
+
+void gpibMemoryBarrier()
+{
+#if defined(WIN32)
+	MemoryBarrier();
+#elif defined(__GNUC__)
+	__sync_synchronize();
+#elif defined(_solaris)
+	membar_enter();
+	membar_exit();
+#endif
+}
+
+
+long long gpibClock()
+{
+#ifdef WIN32
+	static LARGE_INTEGER freq;
+	LARGE_INTEGER        now;
+	if (freq.QuadPart == 0)
+		QueryPerformanceFrequency(&freq);
+	QueryPerformanceCounter(&now);
+	return (long long) ((double) now.QuadPart * 1e9 / (double) freq.QuadPart);
+#else
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (long long) ts.tv_sec * 1000000000LL + ts.tv_nsec;
+#endif
+}
+
+
+const char *gpibOpName(int op)
+{
+	if ( (op < 0) || (op >= GPIB_NB_OP) )
+		return "unknown";
+	return op_names[op];
+}
+
+
+long long gpibThreadIoTime()
+{
+	return thread_io;
+}
+
+
+void gpibThreadIoAdd(long long ns)
+{
+	thread_io += ns;
+}
+
+
+const char *gpibCounterName(int c)
+{
+	if ( (c < 0) || (c >= GPIB_NB_COUNTER) )
+		return "unknown";
+	return counter_names[c];
+}
+
+
+const char *gpibErrorName(int iberr)
+{
+	if ( (iberr < 0) || (iberr >= GPIB_NB_IBERR) )
+		return "unknown";
+	return error_names[iberr];
+}
+
+
+gpibHistogram::gpibHistogram()
+{
+	reset();
+}
+
+
+void gpibHistogram::reset()
+{
+	memset((void *) counts, 0, sizeof(counts));
+	total = 0;
+	highest = 0;
+	sum = 0;
+}
+
+
+/**
+ * Values below 16 us: one bucket per us. Above: 16 buckets for each power
+ * of 2, bucket = 16 * (log2(v) - 3) + 4 next bits of the value.
+ */
+int gpibHistogram::bucket(long long us)
+{
+	if (us < GPIB_HIST_SUB_BUCKETS)
+		return (us < 0) ? 0 : (int) us;
+
+	int msb = 4;
+	while ( (msb < 62) && ((us >> (msb + 1)) != 0) )
+		msb++;
+	int b = GPIB_HIST_SUB_BUCKETS * (msb - 3) + (int) ((us >> (msb - 4)) & (GPIB_HIST_SUB_BUCKETS - 1));
+	return (b < GPIB_HIST_BUCKETS) ? b : GPIB_HIST_BUCKETS - 1;
+}
+
+
+long long gpibHistogram::bucketLimit(int b)
+{
+	if (b < GPIB_HIST_SUB_BUCKETS)
+		return b;
+	int msb = b / GPIB_HIST_SUB_BUCKETS + 3;
+	int sub = b % GPIB_HIST_SUB_BUCKETS;
+	return ((long long) (GPIB_HIST_SUB_BUCKETS + sub + 1) << (msb - 4)) - 1;
+}
+
+
+void gpibHistogram::record(long long us)
+{
+	if (us < 0)
+		us = 0;
+	gpibAtomicAdd(&counts[bucket(us)], 1);
+	gpibAtomicAdd(&sum, (unsigned long long) us);
+	gpibAtomicMax(&highest, (unsigned long long) us);
+	gpibAtomicAdd(&total, 1);
+}
+
+
+unsigned long long gpibHistogram::count()
+{
+	return gpibAtomicAdd(&total, 0);
+}
+
+
+long long gpibHistogram::max()
+{
+	return (long long) gpibAtomicAdd(&highest, 0);
+}
+
+
+double gpibHistogram::mean()
+{
+	unsigned long long n = count();
+	if (n == 0)
+		return 0.0;
+	return (double) gpibAtomicAdd(&sum, 0) / (double) n;
+}
+
+
+unsigned long long gpibHistogram::bucketCount(int b)
+{
+	if ( (b < 0) || (b >= GPIB_HIST_BUCKETS) )
+		return 0;
+	return gpibAtomicAdd(&counts[b], 0);
+}
+
+
+/**
+ * Return the highest value of the bucket holding the p percentile, limited
+ * to the highest value recorded. Return 0 when the histogram is empty.
+ */
+long long gpibHistogram::percentile(double p)
+{
+	unsigned long long n = count();
+	long long          top = max();
+
+	if (n == 0)
+		return 0;
+
+	unsigned long long rank = (unsigned long long) (p / 100.0 * n + 0.5);
+	if (rank < 1)
+		rank = 1;
+	if (rank > n)
+		rank = n;
+
+	// The total is counted after the bucket: the buckets hold at least
+	// the n values read above.
+	unsigned long long seen = 0;
+	for (int b = 0; b < GPIB_HIST_BUCKETS; b++)
+	{
+		seen += bucketCount(b);
+		if (seen >= rank)
+		{
+			long long v = bucketLimit(b);
+			return (v < top) ? v : top;
+		}
+	}
+	return top;
+}
+
+
+void gpibLatency::record(int op, long long ns)
+{
+	if ( (op >= 0) && (op < GPIB_NB_OP) )
+		hist[op].record(ns / 1000);
+}
+
+
+void gpibLatency::reset()
+{
+	for (int op = 0; op < GPIB_NB_OP; op++)
+		hist[op].reset();
+}
+
+
+gpibCounters::gpibCounters()
+{
+	memset((void *) counters, 0, sizeof(counters));
+	memset((void *) errors, 0, sizeof(errors));
+}
+
+
+void gpibCounters::add(int c, unsigned long long n)
+{
+	if ( (c >= 0) && (c < GPIB_NB_COUNTER) )
+		gpibAtomicAdd(&counters[c], n);
+}
+
+
+void gpibCounters::addError(int iberr)
+{
+	if ( (iberr >= 0) && (iberr < GPIB_NB_IBERR) )
+		gpibAtomicAdd(&errors[iberr], 1);
+}
+
+
+/**
+ * The read is an atomic add of 0: a plain 64 bits read is not atomic on
+ * 32 bits hosts.
+ */
+unsigned long long gpibCounters::get(int c)
+{
+	if ( (c < 0) || (c >= GPIB_NB_COUNTER) )
+		return 0;
+	return gpibAtomicAdd(&counters[c], 0);
+}
+
+
+unsigned long long gpibCounters::getError(int iberr)
+{
+	if ( (iberr < 0) || (iberr >= GPIB_NB_IBERR) )
+		return 0;
+	return gpibAtomicAdd(&errors[iberr], 0);
+}
+
+
+gpibCounters *gpibBoardCounters(int board)
+{
+	if ( (board < 0) || (board >= GPIB_NB_COUNTED_BOARDS) )
+		return NULL;
+	return &board_counters[board];
+}
@@ -0,0 +1,172 @@
+#ifndef _GPIBSTATS_H
+#define _GPIBSTATS_H
+
+#include <string>
+
+using namespace std;
+
+/**
+ * Operation types measured by gpibDevice.
+ */
+enum GpibOp
+{
+    GPIB_OP_WRITE = 0,      // write()
+    GPIB_OP_READ = 1,       // read(), read(size)
+    GPIB_OP_WRITE_READ = 2, // writeRead(), both transfers
+    GPIB_OP_BINARY = 3,     // sendData(), receiveData()
+    GPIB_OP_PROBE = 4,      // isAlive()
+    GPIB_NB_OP = 5
+};
+
+/**
+ * Counters kept by gpibDevice, per device and per board.
+ */
+enum GpibCounter
+{
+    GPIB_CNT_TRANSACTIONS = 0,  // driver calls
+    GPIB_CNT_BYTES_WRITTEN = 1, // ibcnt of write operations
+    GPIB_CNT_BYTES_READ = 2,    // ibcnt of read operations
+    GPIB_CNT_TIMEOUTS = 3,      // driver calls ended with TIMO
+    GPIB_CNT_ERRORS = 4,        // driver calls ended with ERR
+    GPIB_CNT_PROBES = 5,        // isAlive()
+    GPIB_NB_COUNTER = 6
+};
+
+/**
+ * Errors are also counted by iberr code, EDVR (0) to ETAB (20).
+ */
+#define GPIB_NB_IBERR            21
+
+/**
+ * Boards with counters: gpib0 to gpib31.
+ */
+#define GPIB_NB_COUNTED_BOARDS   32
+
+/**
+ * Histogram buckets: values below 16 us have their own bucket, above each
+ * power of 2 is split in 16 buckets (precision better than 6.25 %), up to
+ * 2^31 us (35 minutes).
+ */
+#define GPIB_HIST_SUB_BUCKETS    16
+#define GPIB_HIST_BUCKETS        448
+
+/**
+ * Monotonic time in ns.
+ */
+long long gpibClock(void);
+
+/**
+ * Return the name of an operation type, e.g. "write".
+ */
+const char *gpibOpName(int op);
+
+/**
+ * Driver call time of the calling thread since its start, ns: gpibDevice
+ * adds the duration of each driver call.
+ */
+long long gpibThreadIoTime(void);
+void gpibThreadIoAdd(long long ns);
+
+/**
+ * Atomic add to a 64 bits value, return the new value (add 0 to read).
+ */
+unsigned long long gpibAtomicAdd(volatile unsigned long long *p, unsigned long long n);
+
+/**
+ * Atomically raise a 64 bits value to v if it is lower.
+ */
+void gpibAtomicMax(volatile unsigned long long *p, unsigned long long v);
+
+/**
+ * Atomically set a 64 bits value to v if it is old. Return the value seen
+ * (old if it was set).
+ */
+unsigned long long gpibAtomicCompareExchange(volatile unsigned long long *p,
+                                             unsigned long long old, unsigned long long v);
+
+/**
+ * Atomically set a 64 bits value to v, return its previous value.
+ */
+unsigned long long gpibAtomicExchange(volatile unsigned long long *p, unsigned long long v);
+
+/**
+ * Full memory barrier.
+ */
+void gpibMemoryBarrier(void);
+
+/**
+ * Return the name of a counter, e.g. "bytes_read".
+ */
+const char *gpibCounterName(int c);
+
+/**
+ * Return the short name of an iberr code, e.g. "EABO".
+ */
+const char *gpibErrorName(int iberr);
+
+/**
+ * HDR style latency histogram, values in us.
+ * Updates and reads are atomic, without lock: a device is opened on an
+ * init pool lane while its attributes can be read. A reader may see a
+ * value counted in its bucket but not yet in the total; reset() is not
+ * atomic.
+ */
+class gpibHistogram
+{
+public:
+	gpibHistogram();
+	void record(long long us);  // Add a value.
+	void reset(void);           // Remove all values.
+	unsigned long long count(void);        // Number of values.
+	long long percentile(double p);        // Value at p (0-100), us.
+	long long max(void);                   // Highest value, us.
+	double mean(void);                     // Average value, us.
+	unsigned long long bucketCount(int b); // Number of values in bucket b.
+	static int bucket(long long us);       // Bucket of a value.
+	static long long bucketLimit(int b);   // Highest value of bucket b, us.
+
+private:
+	volatile unsigned long long counts[GPIB_HIST_BUCKETS];
+	volatile unsigned long long total;
+	volatile unsigned long long highest;
+	volatile unsigned long long sum;
+};
+
+/**
+ * One latency histogram per operation type, for a gpibDevice
+ * (see gpibDevice::setLatency).
+ */
+class gpibLatency
+{
+public:
+	void record(int op, long long ns);  // Add a duration in ns.
+	void reset(void);
+	gpibHistogram hist[GPIB_NB_OP];
+};
+
+/**
+ * Transfer and error counters. Updates and reads are atomic, without lock:
+ * the counters of a board are shared by all its gpibDevice objects, which
+ * may run in different threads.
+ */
+class gpibCounters
+{
+public:
+	gpibCounters();
+	void add(int c, unsigned long long n);  // Add n to counter c.
+	void addError(int iberr);               // Count an error by iberr code.
+	unsigned long long get(int c);          // Value of counter c.
+	unsigned long long getError(int iberr); // Number of errors with iberr.
+
+private:
+	volatile unsigned long long counters[GPIB_NB_COUNTER];
+	volatile unsigned long long errors[GPIB_NB_IBERR];
+};
+
+/**
+ * Return the counters of a board, shared by the process, or NULL if the
+ * board index is not below GPIB_NB_COUNTED_BOARDS.
+ */
+gpibCounters *gpibBoardCounters(int board);
+
+#endif /* _GPIBSTATS_H */
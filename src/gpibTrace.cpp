@@ -0,0 +1,400 @@
+#include <fstream>
+#include <iomanip>
+#include <set>
+#include <sstream>
+#include <algorithm>
+#include <string.h>
+#include "gpibStats.h"
+#include "gpibTrace.h"
+
+#ifdef WIN32
+#include <windows.h>
+#else
+#include <pthread.h>
+#endif
+
+/**
+ * The flight recorder ring and the number of events ever recorded.
+ */
+static gpibTraceEvent              trace_ring[GPIB_TRACE_EVENTS];
+static volatile unsigned long long trace_head = 0;
+
+/**
+ * Trace messages of a thread. Only the thread writes in its ring, but the
+ * shared ring.
+ */
+struct gpibLogRing
+{
+	volatile unsigned long long head;	// Number of messages ever written.
+	volatile unsigned long long used;	// 1 while a thread owns the ring.
+	unsigned long      thread;
+	gpibLogEvent       events[GPIB_LOG_EVENTS];
+};
+
+/**
+ * Rings of the threads which wrote a message. A ring is kept after the
+ * end of its thread, so that its last messages can still be dumped, and
+ * given to the next new thread. The threads which find no ring write in
+ * the shared one.
+ */
+static gpibLogRing *volatile       log_rings[GPIB_LOG_THREADS];
+static volatile unsigned long long log_nb_rings = 0;
+static gpibLogRing                 log_shared;
+
+#ifdef WIN32
+static __declspec(thread) gpibLogRing *log_ring = NULL;
+#else
+static __thread gpibLogRing *log_ring = NULL;
+static pthread_key_t         log_key;
+static pthread_once_t        log_key_once = PTHREAD_ONCE_INIT;
+#endif
+
+/**
+ * Chrome trace process of the trace messages (boards are 0 to 31).
+ */
+#define LOG_PID     100
+
+
+static unsigned long trace_thread(void)
+{
+#ifdef WIN32
+	return (unsigned long) GetCurrentThreadId();
+#else
+	return (unsigned long) pthread_self();
+#endif
+}
+
+
+/**
+ * The slot is marked as being written (seq = 0) before its fields, and
+ * given its event number after them. A writer lapped by another one on the
+ * same slot (GPIB_TRACE_EVENTS calls during one record) may leave a mixed
+ * event: it is acceptable for a diagnostic tool.
+ */
+void gpibTraceRecord(const char *call, long long start, long long duration, long long wait,
+                     int board, int addr, unsigned long count, int ibsta, int iberr)
+{
+	unsigned long long n = gpibAtomicAdd(&trace_head, 1);
+	gpibTraceEvent    &e = trace_ring[(n - 1) & (GPIB_TRACE_EVENTS - 1)];
+
+	e.seq = 0;
+	gpibMemoryBarrier();
+	e.call = call;
+	e.start = start;
+	e.duration = duration;
+	e.wait = wait;
+	e.board = board;
+	e.addr = addr;
+	e.count = count;
+	e.ibsta = ibsta;
+	e.iberr = iberr;
+	e.thread = trace_thread();
+	gpibMemoryBarrier();
+	e.seq = n;
+}
+
+
+#ifndef WIN32
+/*
+ * End of a thread which owns a ring: the ring is free for a new thread.
+ */
+static void log_release(void *ring)
+{
+	gpibMemoryBarrier();
+	gpibAtomicExchange(&((gpibLogRing *) ring)->used, 0);
+}
+
+static void log_key_create(void)
+{
+	pthread_key_create(&log_key, log_release);
+}
+#endif
+
+
+/*
+ * Ring of the calling thread: a free ring, a new one, or the shared ring
+ * when GPIB_LOG_THREADS threads own one. Windows threads do not give
+ * their ring back.
+ */
+static gpibLogRing *log_ring_get(void)
+{
+	gpibLogRing *r = NULL;
+	unsigned long long nb = gpibAtomicAdd(&log_nb_rings, 0);
+
+	if (nb > GPIB_LOG_THREADS)
+		nb = GPIB_LOG_THREADS;
+	for (unsigned long long t = 0; (r == NULL) && (t < nb); t++)
+	{
+		gpibLogRing *f = log_rings[t];
+		if ( (f != NULL) && (gpibAtomicCompareExchange(&f->used, 0, 1) == 0) )
+			r = f;
+	}
+	if (r == NULL)
+	{
+		unsigned long long n = gpibAtomicAdd(&log_nb_rings, 1);
+		if (n > GPIB_LOG_THREADS)
+			return &log_shared;
+		r = new gpibLogRing;
+		r->head = 0;
+		r->used = 1;
+		for (int i = 0; i < GPIB_LOG_EVENTS; i++)
+			r->events[i].seq = 0;
+		gpibMemoryBarrier();
+		log_rings[n - 1] = r;
+	}
+	r->thread = trace_thread();
+#ifndef WIN32
+	pthread_once(&log_key_once, log_key_create);
+	pthread_setspecific(log_key, r);
+#endif
+	return r;
+}
+
+
+void gpibLog(int level, const char *format, const char *text, long long a, long long b)
+{
+	gpibLogRing *r = log_ring;
+
+	if (r == NULL)
+		r = log_ring = log_ring_get();
+
+	unsigned long long n;
+	unsigned long      thread;
+	if (r == &log_shared)
+	{
+		n = gpibAtomicAdd(&r->head, 1);
+		thread = trace_thread();
+	}
+	else
+	{
+		n = ++r->head;
+		thread = r->thread;
+	}
+	gpibLogEvent &e = r->events[(n - 1) & (GPIB_LOG_EVENTS - 1)];
+
+	e.seq = 0;
+	gpibMemoryBarrier();
+	e.time = gpibClock();
+	e.level = level;
+	e.format = format;
+	e.arg[0] = a;
+	e.arg[1] = b;
+	if (text != NULL)
+	{
+		strncpy(e.text, text, sizeof(e.text) - 1);
+		e.text[sizeof(e.text) - 1] = 0;
+	}
+	else
+		e.text[0] = 0;
+	e.thread = thread;
+	gpibMemoryBarrier();
+	e.seq = n;
+}
+
+
+static bool log_before(const gpibLogEvent &a, const gpibLogEvent &b)
+{
+	return a.time < b.time;
+}
+
+
+void gpibLogSnapshot(vector<gpibLogEvent> &events)
+{
+	unsigned long long nb = gpibAtomicAdd(&log_nb_rings, 0);
+
+	events.clear();
+	if (nb > GPIB_LOG_THREADS)
+		nb = GPIB_LOG_THREADS;
+	for (unsigned long long t = 0; t <= nb; t++)
+	{
+		gpibLogRing *r = (t < nb) ? log_rings[t] : &log_shared;
+		if (r == NULL)
+			continue;	// Being created.
+		gpibMemoryBarrier();
+		for (int i = 0; i < GPIB_LOG_EVENTS; i++)
+		{
+			gpibLogEvent &slot = r->events[i];
+			gpibLogEvent  copy;
+			unsigned long long seq = slot.seq;
+
+			if (seq == 0)
+				continue;
+			gpibMemoryBarrier();
+			memcpy((void *) &copy, (const void *) &slot, sizeof(copy));
+			gpibMemoryBarrier();
+			if (slot.seq != seq)
+				continue;	// Overwritten meanwhile.
+			events.push_back(copy);
+		}
+	}
+	sort(events.begin(), events.end(), log_before);
+}
+
+
+string gpibLogFormat(const gpibLogEvent &e)
+{
+	ostringstream out;
+	int           a = 0;
+
+	for (const char *p = e.format; *p != 0; p++)
+	{
+		if ( (*p != '%') || (p[1] == 0) )
+		{
+			out << *p;
+			continue;
+		}
+		p++;
+		if (*p == 's')
+			out << e.text;
+		else if ( (*p == 'd') && (a < 2) )
+			out << e.arg[a++];
+		else if ( (*p == 'x') && (a < 2) )
+			out << hex << e.arg[a++] << dec;
+		else
+			out << *p;
+	}
+	return out.str();
+}
+
+
+void gpibTraceSnapshot(vector<gpibTraceEvent> &events)
+{
+	unsigned long long head = gpibAtomicAdd(&trace_head, 0);
+	unsigned long long first = (head > GPIB_TRACE_EVENTS) ? head - GPIB_TRACE_EVENTS : 0;
+
+	events.clear();
+	events.reserve(head - first);
+	for (unsigned long long n = first + 1; n <= head; n++)
+	{
+		gpibTraceEvent &slot = trace_ring[(n - 1) & (GPIB_TRACE_EVENTS - 1)];
+		gpibTraceEvent  copy;
+
+		if (slot.seq != n)
+			continue;	// Being written, or already overwritten.
+		gpibMemoryBarrier();
+		memcpy((void *) &copy, (const void *) &slot, sizeof(copy));
+		gpibMemoryBarrier();
+		if (slot.seq != n)
+			continue;
+		events.push_back(copy);
+	}
+}
+
+
+/*
+ * Write a string as a JSON string.
+ */
+static void trace_string(ofstream &out, const string &s)
+{
+	out << '"';
+	for (unsigned long i = 0; i < s.length(); i++)
+	{
+		unsigned char c = (unsigned char) s[i];
+		if ( (c == '"') || (c == '\\') )
+			out << '\\' << c;
+		else if (c < 0x20)
+			out << "\\u" << hex << setw(4) << setfill('0') << (int) c << dec << setfill(' ');
+		else
+			out << c;
+	}
+	out << '"';
+}
+
+
+/*
+ * Chrome trace-event timestamps are in us.
+ */
+static void trace_us(ofstream &out, long long ns)
+{
+	out << ns / 1000 << "." << setw(3) << setfill('0') << ns % 1000 << setfill(' ');
+}
+
+
+long gpibTraceDump(const string &file)
+{
+	vector<gpibTraceEvent> events;
+	vector<gpibLogEvent>   logs;
+	set<int>               boards;
+	set<pair<int, int> >   devices;
+	set<unsigned long>     threads;
+	static const char     *levels[] = {"off", "error", "info", "debug"};
+
+	gpibTraceSnapshot(events);
+	gpibLogSnapshot(logs);
+
+	ofstream out(file.c_str());
+	if (!out)
+		return -1;
+
+	out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[" << endl;
+	for (unsigned long i = 0; i < events.size(); i++)
+	{
+		gpibTraceEvent &e = events[i];
+
+		boards.insert(e.board);
+		devices.insert(make_pair(e.board, e.addr));
+
+		// Time spent by the request off the bus before this call.
+		if (e.wait > 0)
+		{
+			out << "{\"name\":\"wait\",\"cat\":\"wait\",\"ph\":\"X\",\"ts\":";
+			trace_us(out, e.start - e.wait);
+			out << ",\"dur\":";
+			trace_us(out, e.wait);
+			out << ",\"pid\":" << e.board << ",\"tid\":" << e.addr << "}," << endl;
+		}
+
+		out << "{\"name\":\"" << e.call << "\",\"cat\":\"gpib\",\"ph\":\"X\",\"ts\":";
+		trace_us(out, e.start);
+		out << ",\"dur\":";
+		trace_us(out, e.duration);
+		out << ",\"pid\":" << e.board << ",\"tid\":" << e.addr
+		    << ",\"args\":{\"count\":" << e.count
+		    << ",\"ibsta\":\"0x" << hex << e.ibsta << dec << "\""
+		    << ",\"iberr\":" << e.iberr
+		    << ",\"wait_us\":" << e.wait / 1000
+		    << ",\"thread\":" << e.thread << "}}," << endl;
+	}
+
+	for (unsigned long i = 0; i < logs.size(); i++)
+	{
+		gpibLogEvent &e = logs[i];
+
+		threads.insert(e.thread);
+		out << "{\"name\":";
+		trace_string(out, gpibLogFormat(e));
+		out << ",\"cat\":\"log\",\"ph\":\"i\",\"s\":\"t\",\"ts\":";
+		trace_us(out, e.time);
+		out << ",\"pid\":" << LOG_PID << ",\"tid\":" << e.thread
+		    << ",\"args\":{\"level\":\"" << levels[e.level & 3] << "\"}}," << endl;
+	}
+
+	for (set<int>::iterator b = boards.begin(); b != boards.end(); ++b)
+		out << "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":" << *b
+		    << ",\"args\":{\"name\":\"gpib" << *b << "\"}}," << endl;
+	for (set<pair<int, int> >::iterator d = devices.begin(); d != devices.end(); ++d)
+	{
+		out << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":" << d->first
+		    << ",\"tid\":" << d->second << ",\"args\":{\"name\":\"pad " << (d->second & 0xff);
+		if ( (d->second >> 8) != 0 )
+			out << " sad " << (d->second >> 8);
+		out << "\"}}," << endl;
+	}
+
+	if (!logs.empty())
+		out << "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":" << LOG_PID
+		    << ",\"args\":{\"name\":\"log\"}}," << endl;
+	for (set<unsigned long>::iterator t = threads.begin(); t != threads.end(); ++t)
+		out << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":" << LOG_PID
+		    << ",\"tid\":" << *t << ",\"args\":{\"name\":\"thread " << *t << "\"}}," << endl;
+
+	// Closing event: JSON does not allow a trailing comma.
+	out << "{\"name\":\"dump\",\"ph\":\"i\",\"s\":\"g\",\"ts\":";
+	trace_us(out, gpibClock());
+	out << ",\"pid\":0,\"tid\":0}" << endl << "]}" << endl;
+
+	out.close();
+	if (!out)
+		return -1;
+	return (long) (events.size() + logs.size());
+}
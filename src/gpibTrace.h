@@ -0,0 +1,122 @@
+#ifndef _GPIBTRACE_H
+#define _GPIBTRACE_H
+
+#include <string>
+#include <vector>
+
+using namespace std;
+
+/**
+ * Number of driver calls kept by the flight recorder (power of 2).
+ */
+#define GPIB_TRACE_EVENTS        16384
+
+/**
+ * One driver call of a gpibDevice, as kept by the flight recorder.
+ */
+struct gpibTraceEvent
+{
+	volatile unsigned long long seq;  // Event number + 1, 0 while written.
+	const char   *call;      // Driver function, e.g. "ibwrt" (static string).
+	long long     start;     // gpibClock() before the call, ns.
+	long long     duration;  // Duration of the call, ns.
+	long long     wait;      // Time since the request start or the previous
+	                         // call of the request (0 if unknown), ns.
+	int           board;     // Board index.
+	int           addr;      // Address of the device, pad + 256 * sad.
+	unsigned long count;     // ibcnt.
+	int           ibsta;
+	int           iberr;
+	unsigned long thread;    // Caller thread id.
+};
+
+/**
+ * Trace messages. Their level is set at compile time by GPIB_TRACE (e.g.
+ * make GPIB_TRACE=3): the macros of the levels above compile to nothing.
+ * The others store a binary event in a ring of the calling thread, without
+ * lock or formatting; the message is only formatted when the flight
+ * recorder is dumped.
+ */
+#define GPIB_LEVEL_OFF           0
+#define GPIB_LEVEL_ERROR         1
+#define GPIB_LEVEL_INFO          2
+#define GPIB_LEVEL_DEBUG         3
+
+#ifndef GPIB_TRACE
+#define GPIB_TRACE               GPIB_LEVEL_INFO
+#endif
+
+/**
+ * Messages kept per thread (power of 2), and number of rings: a ring is
+ * given to a new thread at the end of its thread, the messages of the
+ * threads which find no ring go to a shared one.
+ */
+#define GPIB_LOG_EVENTS          256
+#define GPIB_LOG_THREADS         256
+
+/**
+ * One trace message. The format is a static string: "%s" is replaced by
+ * text (truncated), "%d" and "%x" by the next number.
+ */
+struct gpibLogEvent
+{
+	volatile unsigned long long seq;  // Event number + 1 in the thread, 0 while written.
+	long long     time;      // gpibClock(), ns.
+	int           level;     // GPIB_LEVEL_ERROR ... GPIB_LEVEL_DEBUG.
+	const char   *format;
+	long long     arg[2];
+	char          text[48];
+	unsigned long thread;    // Caller thread id.
+};
+
+void gpibLog(int level, const char *format, const char *text, long long a, long long b);
+
+#if GPIB_TRACE >= GPIB_LEVEL_ERROR
+#define GPIB_LOG_ERROR(f, t, a, b)   gpibLog(GPIB_LEVEL_ERROR, f, t, (long long) (a), (long long) (b))
+#else
+#define GPIB_LOG_ERROR(f, t, a, b)   ((void) 0)
+#endif
+#if GPIB_TRACE >= GPIB_LEVEL_INFO
+#define GPIB_LOG_INFO(f, t, a, b)    gpibLog(GPIB_LEVEL_INFO, f, t, (long long) (a), (long long) (b))
+#else
+#define GPIB_LOG_INFO(f, t, a, b)    ((void) 0)
+#endif
+#if GPIB_TRACE >= GPIB_LEVEL_DEBUG
+#define GPIB_LOG_DEBUG(f, t, a, b)   gpibLog(GPIB_LEVEL_DEBUG, f, t, (long long) (a), (long long) (b))
+#else
+#define GPIB_LOG_DEBUG(f, t, a, b)   ((void) 0)
+#endif
+
+/**
+ * Copy the trace messages of all threads, oldest first.
+ */
+void gpibLogSnapshot(vector<gpibLogEvent> &events);
+
+/**
+ * Format a trace message.
+ */
+string gpibLogFormat(const gpibLogEvent &e);
+
+/**
+ * Add an event to the flight recorder. It does not take any lock: writers
+ * get their slot with an atomic increment and readers skip the slots being
+ * written. The oldest events are overwritten.
+ */
+void gpibTraceRecord(const char *call, long long start, long long duration, long long wait,
+                     int board, int addr, unsigned long count, int ibsta, int iberr);
+
+/**
+ * Copy the events of the flight recorder, oldest first.
+ */
+void gpibTraceSnapshot(vector<gpibTraceEvent> &events);
+
+/**
+ * Write the events of the flight recorder in a file, in Chrome trace-event
+ * JSON format (chrome://tracing, Perfetto): one process per board, one
+ * thread per device address, and the trace messages as instant events of
+ * a "log" process. Return the number of events written, -1 if the file
+ * cannot be written.
+ */
+long gpibTraceDump(const string &file);
+
+#endif /* _GPIBTRACE_H */